@@ -0,0 +1,64 @@
+#pragma once
+
+#include "starlet-serializer/data/mesh_data.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <string>
+
+namespace SSerializer = Starlet::Serializer;
+
+// Best wall-clock time of `iterations` runs, in milliseconds. setup() runs untimed before each run.
+template <typename Setup, typename Fn>
+double measureMs(int iterations, Setup&& setup, Fn&& fn) {
+  double best = 1e30;
+  for (int i = 0; i < iterations; ++i) {
+    setup();
+    const auto start = std::chrono::steady_clock::now();
+    fn();
+    const auto end = std::chrono::steady_clock::now();
+    const double ms = std::chrono::duration<double, std::milli>(end - start).count();
+    if (ms < best) best = ms;
+  }
+  return best;
+}
+
+template <typename Fn>
+double measureMs(int iterations, Fn&& fn) {
+  return measureMs(iterations, []() {}, fn);
+}
+
+inline void report(const std::string& name, double ms, double items, const char* unit) {
+  printf("%-40s %10.3f ms %12.2f M%s/s\n", name.c_str(), ms, items / (ms * 1000.0), unit);
+}
+
+// Wavy (size x size) quad grid with normals and UVs, two triangles per quad
+inline SSerializer::MeshData makeTexturedGrid(unsigned int size) {
+  SSerializer::MeshData mesh;
+  const unsigned int side = size + 1;
+  mesh.vertices.resize(static_cast<size_t>(side) * side);
+  for (unsigned int y = 0; y < side; ++y) {
+    for (unsigned int x = 0; x < side; ++x) {
+      Starlet::Math::Vertex& v = mesh.vertices[static_cast<size_t>(y) * side + x];
+      const float fx = static_cast<float>(x) / size, fy = static_cast<float>(y) / size;
+      v.pos = { fx, fy, 0.05f * std::sin(fx * 40.0f) * std::cos(fy * 40.0f) };
+      v.norm = { 0.0f, 0.0f, 1.0f };
+      v.texCoord = { fx * 4.0f, fy * 4.0f };
+    }
+  }
+
+  mesh.indices.reserve(static_cast<size_t>(size) * size * 6);
+  for (unsigned int y = 0; y < size; ++y) {
+    for (unsigned int x = 0; x < size; ++x) {
+      const unsigned int i0 = y * side + x, i1 = i0 + 1, i2 = i0 + side + 1, i3 = i0 + side;
+      mesh.indices.insert(mesh.indices.end(), { i0, i1, i2, i0, i2, i3 });
+    }
+  }
+
+  mesh.numVertices = static_cast<unsigned int>(mesh.vertices.size());
+  mesh.numIndices = static_cast<unsigned int>(mesh.indices.size());
+  mesh.numTriangles = mesh.numIndices / 3;
+  mesh.hasNormals = mesh.hasTexCoords = true;
+  return mesh;
+}
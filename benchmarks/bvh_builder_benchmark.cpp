@@ -0,0 +1,29 @@
+#include "benchmark_helpers.hpp"
+
+#include "starlet-serializer/processor/mesh/bvh_builder.hpp"
+#include "starlet-serializer/data/bvh_data.hpp"
+
+int main() {
+  SSerializer::BvhBuilder builder;
+  SSerializer::BvhQuery query;
+
+  for (unsigned int size : { 256u, 724u }) {
+    const SSerializer::MeshData mesh = makeTexturedGrid(size);
+    SSerializer::BvhData bvh;
+
+    const double buildMs = measureMs(3, [&]() { builder.build(mesh, bvh); });
+    report("BvhBuilder " + std::to_string(mesh.numTriangles) + " tris", buildMs, mesh.numTriangles, "tri");
+
+    constexpr unsigned int RAYS = 1u << 18;
+    unsigned int hits = 0;
+    const double rayMs = measureMs(3, [&]() { hits = 0; }, [&]() {
+      SSerializer::RayHit hit;
+      for (unsigned int i = 0; i < RAYS; ++i) {
+        const float x = static_cast<float>(i % 512) / 512.0f, y = static_cast<float>(i / 512) / 512.0f;
+        hits += query.raycast(mesh, bvh, { x, y, 1.0f }, { 0.1f, -0.05f, -1.0f }, hit) ? 1 : 0;
+      }
+    });
+    report("BvhQuery::raycast " + std::to_string(mesh.numTriangles) + " tris", rayMs, RAYS, "ray");
+  }
+  return 0;
+}
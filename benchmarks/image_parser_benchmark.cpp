@@ -0,0 +1,137 @@
+#include "benchmark_helpers.hpp"
+
+#include "starlet-serializer/parser/image_parser.hpp"
+#include "starlet-serializer/data/image_data.hpp"
+#include "starlet-serializer/utils/qoi_codec.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace {
+  constexpr uint32_t SIZE = 4096;
+
+  void writeLe(std::string& data, size_t offset, uint32_t value, size_t bytes) {
+    for (size_t i = 0; i < bytes; ++i) data[offset + i] = static_cast<char>((value >> (i * 8)) & 0xFF);
+  }
+
+  std::string makeBody(size_t bytes) {
+    std::string body(bytes, '\0');
+    for (size_t i = 0; i < bytes; ++i) body[i] = static_cast<char>(i * 31);
+    return body;
+  }
+
+  // Bottom-up 24-bit BMP without row padding
+  std::string makeBmp() {
+    std::string data(54, '\0');
+    data[0] = 'B'; data[1] = 'M';
+    writeLe(data, 10, 54, 4);
+    writeLe(data, 14, 40, 4);
+    writeLe(data, 18, SIZE, 4);
+    writeLe(data, 22, SIZE, 4);
+    writeLe(data, 26, 1, 2);
+    writeLe(data, 28, 24, 2);
+    return data + makeBody(static_cast<size_t>(SIZE) * SIZE * 3);
+  }
+
+  // Bottom-up 8-bit palettized BMP with a 256-entry grey ramp
+  std::string makeBmp8() {
+    std::string data(54, '\0');
+    data[0] = 'B'; data[1] = 'M';
+    writeLe(data, 10, 54 + 1024, 4);
+    writeLe(data, 14, 40, 4);
+    writeLe(data, 18, SIZE, 4);
+    writeLe(data, 22, SIZE, 4);
+    writeLe(data, 26, 1, 2);
+    writeLe(data, 28, 8, 2);
+    std::string palette(1024, '\0');
+    for (uint32_t i = 0; i < 256; ++i) writeLe(palette, i * 4, i * 0x010101u, 4);
+    return data + palette + makeBody(static_cast<size_t>(SIZE) * SIZE);
+  }
+
+  // Bottom-up 32-bit TGA, uncompressed or RLE alternating 64-pixel run and raw packets
+  std::string makeTga(bool rle) {
+    std::string data(18, '\0');
+    data[2] = rle ? 10 : 2;
+    writeLe(data, 12, SIZE, 2);
+    writeLe(data, 14, SIZE, 2);
+    data[16] = 32;
+    if (!rle) return data + makeBody(static_cast<size_t>(SIZE) * SIZE * 4);
+
+    const std::string raw = makeBody(64 * 4);
+    for (size_t packet = 0; packet < static_cast<size_t>(SIZE) * SIZE / 64; ++packet) {
+      if (packet & 1) data += static_cast<char>(0x3F) + raw;
+      else data += static_cast<char>(0xBF) + raw.substr(0, 4);
+    }
+    return data;
+  }
+
+  void writeFile(const std::string& path, const std::string& data) {
+    std::ofstream file(path, std::ios::binary);
+    file.write(data.data(), static_cast<std::streamsize>(data.size()));
+  }
+
+  // The same pixels as a TGA image, re-encoded as QOI
+  std::string makeQoi(const std::string& tga) {
+    writeFile("benchmark_source.tga", tga);
+    SSerializer::ImageParser parser;
+    SSerializer::ImageData image;
+    SSerializer::ImageParseOptions options;
+    options.format = SSerializer::PixelFormat::RGBA8;
+    parser.parse("benchmark_source.tga", image, options);
+    std::filesystem::remove("benchmark_source.tga");
+
+    std::vector<uint8_t> out;
+    const double ms = measureMs(5, [&]() { out.clear(); }, [&]() {
+      SSerializer::Utils::QoiEncoder encoder(out, SIZE, SIZE, 4);
+      encoder.encode(image.pixels.data(), static_cast<size_t>(SIZE) * SIZE);
+      encoder.finish();
+    });
+    report("QOI encode 4k RGBA8 (" + std::to_string(out.size() >> 20) + " MiB)", ms, static_cast<double>(SIZE) * SIZE, "px");
+    return std::string(out.begin(), out.end());
+  }
+}
+
+int main() {
+  SSerializer::ImageParser parser;
+  SSerializer::ImageData out;
+  const double pixels = static_cast<double>(SIZE) * SIZE;
+
+  const struct { const char* path; std::string data; } files[] = {
+    { "benchmark.bmp", makeBmp() }, { "benchmark_8bit.bmp", makeBmp8() },
+    { "benchmark.tga", makeTga(false) }, { "benchmark_rle.tga", makeTga(true) },
+    { "benchmark.qoi", makeQoi(makeTga(false)) }, { "benchmark_rle.qoi", makeQoi(makeTga(true)) }
+  };
+
+  for (const auto& file : files) {
+    writeFile(file.path, file.data);
+
+    const struct { const char* name; SSerializer::PixelFormat format; bool native; } modes[] = {
+      { "RGB8", SSerializer::PixelFormat::RGB8, false },
+      { "RGBA8", SSerializer::PixelFormat::RGBA8, false },
+      { "native", SSerializer::PixelFormat::RGB8, true },
+    };
+    for (const auto& mode : modes) {
+      SSerializer::ImageParseOptions options;
+      options.format = mode.format;
+      options.nativeLayout = mode.native;
+      const double ms = measureMs(5, [&]() { parser.parse(file.path, out, options); });
+      report(std::string(file.path) + " 4k " + mode.name, ms, pixels, "px");
+    }
+
+    // Two-step decode straight into a reused staging buffer, as for a mapped upload buffer
+    SSerializer::ImageParseOptions options;
+    options.format = SSerializer::PixelFormat::RGBA8;
+    SSerializer::ImageInfo info;
+    double ms = measureMs(5, [&]() { parser.probe(file.path, info, options); });
+    report(std::string(file.path) + " 4k probe", ms, 1.0, "files");
+    std::vector<unsigned char> staging(info.byteSize);
+    ms = measureMs(5, [&]() { parser.decode(file.path, staging.data(), staging.size(), info.rowSize, options); });
+    report(std::string(file.path) + " 4k RGBA8 decode", ms, pixels, "px");
+
+    std::filesystem::remove(file.path);
+  }
+  return 0;
+}
@@ -0,0 +1,67 @@
+#include "benchmark_helpers.hpp"
+
+#include "starlet-serializer/writer/writer.hpp"
+#include "starlet-serializer/data/image_data.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace {
+  constexpr uint32_t SIZE = 4096;
+
+  // Horizontal bands of flat colour and noisy gradient, like a baked lightmap or atlas
+  SSerializer::ImageData makeImage(SSerializer::PixelFormat format) {
+    SSerializer::ImageData image;
+    image.width = image.height = static_cast<int32_t>(SIZE);
+    image.format = format;
+    image.pixelSize = SSerializer::pixelFormatSize(format);
+    image.byteSize = static_cast<size_t>(SIZE) * SIZE * image.pixelSize;
+    image.pixels.resize(image.byteSize);
+
+    uint32_t seed = 1;
+    for (size_t i = 0; i < image.byteSize; ++i) {
+      seed = seed * 1103515245u + 12345u;
+      const size_t pixel = i / image.pixelSize, x = pixel % SIZE, y = pixel / SIZE;
+      image.pixels[i] = (y / 64) % 2 == 0 ? static_cast<uint8_t>(y / 64 * 8) : static_cast<uint8_t>(x / 16 + ((seed >> 16) & 3));
+    }
+    return image;
+  }
+}
+
+int main() {
+  SSerializer::Writer writer;
+  std::vector<unsigned char> encoded;
+  const double pixels = static_cast<double>(SIZE) * SIZE;
+
+  const struct { const char* name; SSerializer::ImageFormat format; bool rle; } containers[] = {
+    { "bmp", SSerializer::ImageFormat::BMP, false },
+    { "tga", SSerializer::ImageFormat::TGA, false },
+    { "tga rle", SSerializer::ImageFormat::TGA, true },
+    { "qoi", SSerializer::ImageFormat::QOI, false },
+  };
+  const struct { const char* name; SSerializer::PixelFormat format; } formats[] = {
+    { "RGB8", SSerializer::PixelFormat::RGB8 }, { "RGBA8", SSerializer::PixelFormat::RGBA8 }, { "BGRA8", SSerializer::PixelFormat::BGRA8 }
+  };
+
+  for (const auto& format : formats) {
+    const SSerializer::ImageData image = makeImage(format.format);
+    for (const auto& container : containers) {
+      SSerializer::ImageWriteOptions options;
+      options.format = container.format;
+      options.rle = container.rle;
+      const double ms = measureMs(5, [&]() { writer.encodeImage(image, encoded, options); });
+      report(std::string(container.name) + " 4k " + format.name + " encode (" + std::to_string(encoded.size() >> 20) + " MiB)", ms, pixels, "px");
+    }
+  }
+
+  // Encode plus the single file write
+  const SSerializer::ImageData image = makeImage(SSerializer::PixelFormat::RGBA8);
+  for (const char* path : { "benchmark_out.bmp", "benchmark_out.tga", "benchmark_out.qoi" }) {
+    const double ms = measureMs(5, [&]() { writer.writeImage(image, path); });
+    report(std::string(path) + " 4k RGBA8 write", ms, pixels, "px");
+    std::filesystem::remove(path);
+  }
+  return 0;
+}
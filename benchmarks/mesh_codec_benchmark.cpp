@@ -0,0 +1,46 @@
+#include "benchmark_helpers.hpp"
+
+#include "starlet-serializer/processor/mesh/mesh_codec.hpp"
+#include "starlet-serializer/parser/mesh/mesh_cache_parser.hpp"
+#include "starlet-serializer/data/mesh_cache_data.hpp"
+#include "starlet-serializer/writer/writer.hpp"
+
+#include <filesystem>
+
+int main() {
+  SSerializer::MeshCodec codec;
+  const SSerializer::MeshData mesh = makeTexturedGrid(1024);
+  const double indexBytes = static_cast<double>(mesh.indices.size() * sizeof(unsigned int));
+  const double vertexBytes = static_cast<double>(mesh.vertices.size() * sizeof(Starlet::Math::Vertex));
+
+  std::vector<unsigned char> indices, vertices;
+  codec.encodeIndices(mesh.indices, indices);
+  codec.encodeVertices(mesh, vertices);
+  printf("Indices  %10.0f -> %10zu bytes (%.2fx)\n", indexBytes, indices.size(), indexBytes / indices.size());
+  printf("Vertices %10.0f -> %10zu bytes (%.2fx)\n", vertexBytes, vertices.size(), vertexBytes / vertices.size());
+
+  std::vector<unsigned int> decodedIndices;
+  double ms = measureMs(5, [&]() { codec.decodeIndices(indices.data(), indices.size(), decodedIndices); });
+  report("MeshCodec decode indices", ms, indexBytes, "B");
+
+  SSerializer::MeshData decoded;
+  ms = measureMs(5, [&]() { codec.decodeVertices(vertices.data(), vertices.size(), decoded); });
+  report("MeshCodec decode vertices", ms, vertexBytes, "B");
+
+  // Whole-file cache loads, raw floats against the compressed chunk
+  SSerializer::Writer writer;
+  SSerializer::MeshCacheParser parser;
+  SSerializer::MeshCacheData data;
+  data.mesh = mesh;
+  for (bool compressed : { false, true }) {
+    data.compressed = compressed;
+    const std::string path = compressed ? "codec_compressed.smesh" : "codec_raw.smesh";
+    writer.writeMeshCache(data, path);
+
+    SSerializer::MeshCacheData out;
+    ms = measureMs(5, [&]() { parser.parse(path, out); });
+    report(std::string("MeshCacheParser ") + (compressed ? "compressed " : "raw ") + std::to_string(std::filesystem::file_size(path) / 1024) + " KiB", ms, mesh.numVertices, "vert");
+    std::filesystem::remove(path);
+  }
+  return 0;
+}
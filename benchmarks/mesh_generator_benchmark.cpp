@@ -0,0 +1,41 @@
+#include "benchmark_helpers.hpp"
+
+#include "starlet-serializer/processor/mesh/mesh_generator.hpp"
+
+#include <algorithm>
+#include <cstdint>
+
+int main() {
+  SSerializer::MeshGenerator generator;
+  SSerializer::GridData grid;
+  grid.type = SSerializer::GridType::Cube;
+  grid.spacing = 1.5f;
+
+  // Merged geometry is limited by 32-bit indices; 96^3 cubes is ~21M vertices
+  for (unsigned int count : { 32u, 96u }) {
+    grid.count = count;
+    SSerializer::MeshData mesh;
+    const double ms = measureMs(3, [&]() { mesh = SSerializer::MeshData{}; }, [&]() { generator.generateGrid(grid, mesh); });
+    report("MeshGenerator merged " + std::to_string(count) + "^3 cubes", ms, static_cast<double>(mesh.numVertices), "vert");
+  }
+
+  for (unsigned int count : { 256u, 400u }) {
+    grid.count = count;
+    std::vector<Starlet::Math::Vec3<float>> offsets;
+    const double ms = measureMs(3, [&]() { generator.generateGridOffsets(grid, offsets); });
+    report("MeshGenerator offsets " + std::to_string(count) + "^3 cubes", ms, static_cast<double>(offsets.size()), "inst");
+  }
+
+  // 1000^3 instances streamed through one reused 2^24-offset (192 MiB) buffer
+  grid.count = 1000;
+  const uint64_t elements = SSerializer::MeshGenerator::gridElementCount(grid);
+  constexpr size_t RANGE = size_t(1) << 24;
+  std::vector<Starlet::Math::Vec3<float>> offsets;
+  const double ms = measureMs(1, [&]() {
+    for (uint64_t first = 0; first < elements; first += RANGE) {
+      generator.generateGridOffsets(grid, first, static_cast<size_t>(std::min<uint64_t>(RANGE, elements - first)), offsets);
+    }
+  });
+  report("MeshGenerator offset ranges 1000^3 cubes", ms, static_cast<double>(elements), "inst");
+  return 0;
+}
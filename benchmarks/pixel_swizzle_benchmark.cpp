@@ -0,0 +1,48 @@
+#include "benchmark_helpers.hpp"
+
+#include "starlet-serializer/utils/pixel_swizzle.hpp"
+
+#include <cstdint>
+#include <vector>
+
+int main() {
+  using Starlet::Serializer::Utils::SimdLevel;
+  constexpr size_t PIXELS = 8192u * 8192u;
+  constexpr size_t ROW = 8192u, ROW_REPEATS = 2048u;
+
+  std::vector<uint8_t> rgb(PIXELS * 3), rgba(PIXELS * 4), out(PIXELS * 4);
+  for (size_t i = 0; i < rgba.size(); ++i) rgba[i] = static_cast<uint8_t>(i * 31);
+  for (size_t i = 0; i < rgb.size(); ++i) rgb[i] = static_cast<uint8_t>(i * 17);
+
+  const struct { SimdLevel level; const char* name; } levels[] = {
+    { SimdLevel::Scalar, "scalar" }, { SimdLevel::Ssse3, "ssse3" }, { SimdLevel::Avx2, "avx2" }
+  };
+
+  for (const auto& l : levels) {
+    if (l.level > SSerializer::Utils::simdLevel()) {
+      printf("%-40s unsupported on this CPU\n", l.name);
+      continue;
+    }
+
+    double ms = measureMs(5, [&]() { SSerializer::Utils::swapRedBlue24(rgb.data(), out.data(), PIXELS, l.level); });
+    report(std::string("swapRedBlue24 8k ") + l.name, ms, static_cast<double>(rgb.size()), "B");
+
+    ms = measureMs(5, [&]() { SSerializer::Utils::swapRedBlue32(rgba.data(), out.data(), PIXELS, l.level); });
+    report(std::string("swapRedBlue32 8k ") + l.name, ms, static_cast<double>(rgba.size()), "B");
+
+    ms = measureMs(5, [&]() { SSerializer::Utils::bgraToRgb(rgba.data(), out.data(), PIXELS, l.level); });
+    report(std::string("bgraToRgb 8k ") + l.name, ms, static_cast<double>(rgba.size()), "B");
+
+    // One cache-resident row converted repeatedly, as the parsers do per scanline
+    ms = measureMs(5, [&]() {
+      for (size_t r = 0; r < ROW_REPEATS; ++r) SSerializer::Utils::swapRedBlue24(rgb.data(), out.data(), ROW, l.level);
+    });
+    report(std::string("swapRedBlue24 row ") + l.name, ms, static_cast<double>(ROW * 3 * ROW_REPEATS), "B");
+
+    ms = measureMs(5, [&]() {
+      for (size_t r = 0; r < ROW_REPEATS; ++r) SSerializer::Utils::bgraToRgb(rgba.data(), out.data(), ROW, l.level);
+    });
+    report(std::string("bgraToRgb row ") + l.name, ms, static_cast<double>(ROW * 4 * ROW_REPEATS), "B");
+  }
+  return 0;
+}
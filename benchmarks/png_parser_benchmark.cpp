@@ -0,0 +1,167 @@
+#include "benchmark_helpers.hpp"
+
+#include "starlet-serializer/parser/image_parser.hpp"
+#include "starlet-serializer/data/image_data.hpp"
+#include "starlet-serializer/utils/inflate.hpp"
+#include "starlet-serializer/utils/png_filter.hpp"
+
+#ifdef STARLET_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace {
+  constexpr uint32_t SIZE = 2048;
+  constexpr size_t CHANNELS = 4;
+  constexpr size_t ROW_BYTES = SIZE * CHANNELS;
+
+  void appendBe32(std::vector<uint8_t>& out, uint32_t value) {
+    for (int shift = 24; shift >= 0; shift -= 8) out.push_back(static_cast<uint8_t>(value >> shift));
+  }
+
+  // CRCs are left zero; the parser does not check them
+  void appendChunk(std::vector<uint8_t>& out, const char* type, const std::vector<uint8_t>& data) {
+    appendBe32(out, static_cast<uint32_t>(data.size()));
+    out.insert(out.end(), type, type + 4);
+    out.insert(out.end(), data.begin(), data.end());
+    appendBe32(out, 0);
+  }
+
+  uint8_t paeth(int a, int b, int c) {
+    const int pa = std::abs(b - c), pb = std::abs(a - c), pc = std::abs(a + b - 2 * c);
+    return static_cast<uint8_t>(pa <= pb && pa <= pc ? a : pb <= pc ? b : c);
+  }
+
+  // Smooth RGBA gradients with low-amplitude noise, Paeth-filtered like a typical encoder's output
+  std::vector<uint8_t> makeFilteredImage() {
+    std::vector<uint8_t> raw(ROW_BYTES * SIZE);
+    uint32_t seed = 1;
+    for (size_t y = 0; y < SIZE; ++y) {
+      for (size_t x = 0; x < SIZE; ++x) {
+        seed = seed * 1103515245u + 12345u;
+        uint8_t* px = raw.data() + y * ROW_BYTES + x * CHANNELS;
+        px[0] = static_cast<uint8_t>(x / 8 + ((seed >> 16) & 3));
+        px[1] = static_cast<uint8_t>(y / 8 + ((seed >> 20) & 3));
+        px[2] = static_cast<uint8_t>((x + y) / 16);
+        px[3] = 255;
+      }
+    }
+
+    std::vector<uint8_t> filtered;
+    filtered.reserve((ROW_BYTES + 1) * SIZE);
+    for (size_t y = 0; y < SIZE; ++y) {
+      filtered.push_back(4);
+      for (size_t i = 0; i < ROW_BYTES; ++i) {
+        const uint8_t* row = raw.data() + y * ROW_BYTES;
+        const int a = i >= CHANNELS ? row[i - CHANNELS] : 0;
+        const int b = y > 0 ? row[i - ROW_BYTES] : 0;
+        const int c = y > 0 && i >= CHANNELS ? row[i - ROW_BYTES - CHANNELS] : 0;
+        filtered.push_back(static_cast<uint8_t>(row[i] - paeth(a, b, c)));
+      }
+    }
+    return filtered;
+  }
+
+#ifndef STARLET_HAVE_ZLIB
+  // Stored blocks when no compressor is available
+  std::vector<uint8_t> storedZlib(const std::vector<uint8_t>& data) {
+    std::vector<uint8_t> out{ 0x78, 0x01 };
+    for (size_t offset = 0; offset < data.size();) {
+      const size_t length = std::min<size_t>(65535, data.size() - offset);
+      out.push_back(offset + length == data.size() ? 1 : 0);
+      out.push_back(static_cast<uint8_t>(length));
+      out.push_back(static_cast<uint8_t>(length >> 8));
+      out.push_back(static_cast<uint8_t>(~length));
+      out.push_back(static_cast<uint8_t>(~length >> 8));
+      out.insert(out.end(), data.begin() + offset, data.begin() + offset + length);
+      offset += length;
+    }
+    appendBe32(out, SSerializer::Utils::adler32(data.data(), data.size()));
+    return out;
+  }
+#endif
+}
+
+int main() {
+  using Starlet::Serializer::Utils::SimdLevel;
+  const std::vector<uint8_t> filtered = makeFilteredImage();
+  const double pixels = static_cast<double>(SIZE) * SIZE;
+
+#ifdef STARLET_HAVE_ZLIB
+  uLongf compressedSize = compressBound(static_cast<uLong>(filtered.size()));
+  std::vector<uint8_t> stream(compressedSize);
+  compress2(stream.data(), &compressedSize, filtered.data(), static_cast<uLong>(filtered.size()), 6);
+  stream.resize(compressedSize);
+#else
+  printf("System zlib not found: timing stored-block streams only\n");
+  const std::vector<uint8_t> stream = storedZlib(filtered);
+#endif
+
+  std::vector<uint8_t> inflated(filtered.size());
+  double ms = measureMs(5, [&]() { SSerializer::Utils::inflateZlib(stream.data(), stream.size(), inflated.data(), inflated.size()); });
+  report("inflate 2k RGBA", ms, static_cast<double>(filtered.size()), "B");
+  if (inflated != filtered) printf("inflate output mismatch\n");
+
+#ifdef STARLET_HAVE_ZLIB
+  ms = measureMs(5, [&]() {
+    uLongf size = static_cast<uLongf>(inflated.size());
+    uncompress(inflated.data(), &size, stream.data(), static_cast<uLong>(stream.size()));
+  });
+  report("zlib uncompress 2k RGBA", ms, static_cast<double>(filtered.size()), "B");
+#endif
+
+  ms = measureMs(5, [&]() { SSerializer::Utils::adler32(filtered.data(), filtered.size()); });
+  report("adler32 2k RGBA", ms, static_cast<double>(filtered.size()), "B");
+
+  // Unfiltering alone, per kernel level, on a copy of the filtered rows
+  const struct { SimdLevel level; const char* name; } levels[] = { { SimdLevel::Scalar, "scalar" }, { SimdLevel::Ssse3, "ssse3" } };
+  for (uint8_t filter = 1; filter <= 4; ++filter) {
+    for (const auto& l : levels) {
+      if (l.level > SSerializer::Utils::simdLevel()) continue;
+      std::vector<uint8_t> rows(filtered.size());
+      const std::vector<uint8_t> zero(ROW_BYTES, 0);
+      ms = measureMs(5, [&]() { rows = filtered; }, [&]() {
+        const uint8_t* prev = zero.data();
+        for (size_t y = 0; y < SIZE; ++y) {
+          uint8_t* row = rows.data() + y * (ROW_BYTES + 1) + 1;
+          SSerializer::Utils::unfilterRow(filter, row, prev, ROW_BYTES, CHANNELS, l.level);
+          prev = row;
+        }
+      });
+      const char* names[] = { "", "Sub", "Up", "Average", "Paeth" };
+      report(std::string("unfilter ") + names[filter] + " " + l.name, ms, pixels, "px");
+    }
+  }
+
+  // Whole-file decode through ImageParser
+  std::vector<uint8_t> png{ 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+  std::vector<uint8_t> header;
+  appendBe32(header, SIZE);
+  appendBe32(header, SIZE);
+  header.insert(header.end(), { 8, 6, 0, 0, 0 });
+  appendChunk(png, "IHDR", header);
+  appendChunk(png, "IDAT", stream);
+  appendChunk(png, "IEND", {});
+  {
+    std::ofstream file("benchmark.png", std::ios::binary);
+    file.write(reinterpret_cast<const char*>(png.data()), static_cast<std::streamsize>(png.size()));
+  }
+
+  SSerializer::ImageParser parser;
+  SSerializer::ImageData out;
+  SSerializer::ImageParseOptions options;
+  for (SSerializer::PixelFormat format : { SSerializer::PixelFormat::RGBA8, SSerializer::PixelFormat::RGB8 }) {
+    options.format = format;
+    ms = measureMs(5, [&]() { parser.parse("benchmark.png", out, options); });
+    report(format == SSerializer::PixelFormat::RGBA8 ? "benchmark.png 2k RGBA8" : "benchmark.png 2k RGB8", ms, pixels, "px");
+  }
+
+  std::filesystem::remove("benchmark.png");
+  return 0;
+}
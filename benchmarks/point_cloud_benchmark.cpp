@@ -0,0 +1,38 @@
+#include "benchmark_helpers.hpp"
+
+#include "starlet-serializer/processor/mesh/point_cloud_processor.hpp"
+
+#include <random>
+
+int main() {
+  SSerializer::PointCloudProcessor processor;
+
+  for (size_t count : { size_t{ 1 } << 20, size_t{ 10 } << 20 }) {
+    SSerializer::MeshData source;
+    source.vertices.resize(count);
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> dist(0.0f, 100.0f);
+    for (Starlet::Math::Vertex& v : source.vertices) {
+      v.pos = { dist(rng), dist(rng), dist(rng) * 0.1f };
+      v.col = { v.pos.x / 100.0f, v.pos.y / 100.0f, 0.5f, 1.0f };
+    }
+    source.numVertices = static_cast<unsigned int>(count);
+    source.hasColours = true;
+
+    SSerializer::MeshData cloud;
+    std::vector<uint64_t> codes;
+    const double sortMs = measureMs(3, [&]() { cloud = source; }, [&]() { processor.mortonSort(cloud, &codes); });
+    report("PointCloud mortonSort " + std::to_string(count) + " pts", sortMs, static_cast<double>(count), "pt");
+
+    std::vector<SSerializer::MeshData> levels;
+    const double levelMs = measureMs(3, [&]() { processor.buildLevels(cloud, codes, {}, levels); });
+    report("PointCloud buildLevels " + std::to_string(count) + " pts", levelMs, static_cast<double>(count), "pt");
+
+    // Any non-zero budget below the radix sort's scratch selects the in-place path
+    SSerializer::PointCloudOptions budgeted;
+    budgeted.memoryBudget = 1;
+    const double budgetMs = measureMs(3, [&]() { cloud = source; }, [&]() { processor.process(cloud, budgeted, levels); });
+    report("PointCloud process (in-place) " + std::to_string(count) + " pts", budgetMs, static_cast<double>(count), "pt");
+  }
+  return 0;
+}
@@ -0,0 +1,16 @@
+#include "benchmark_helpers.hpp"
+
+#include "starlet-serializer/processor/mesh/tangent_generator.hpp"
+
+int main() {
+  SSerializer::TangentGenerator generator;
+
+  for (unsigned int size : { 256u, 1024u, 2048u }) {
+    const SSerializer::MeshData source = makeTexturedGrid(size);
+    SSerializer::MeshData mesh;
+
+    const double ms = measureMs(5, [&]() { mesh = source; }, [&]() { generator.generate(mesh); });
+    report("TangentGenerator " + std::to_string(source.numTriangles) + " tris", ms, source.numTriangles, "tri");
+  }
+  return 0;
+}
@@ -0,0 +1,34 @@
+#include "benchmark_helpers.hpp"
+
+#include "starlet-serializer/processor/mesh/terrain_generator.hpp"
+#include "starlet-serializer/data/terrain_data.hpp"
+#include "starlet-serializer/data/image_data.hpp"
+
+int main() {
+  SSerializer::TerrainGenerator generator;
+  SSerializer::TerrainOptions options;
+  options.lodCount = 4;
+  options.skirtDepth = 2.0f;
+
+  // Single-channel heightmaps streamed chunk by chunk, so only one batch of chunks is alive at a time
+  for (int size : { 4096, 16384 }) {
+    SSerializer::ImageData image;
+    image.width = image.height = size;
+    image.pixelSize = 1;
+    image.byteSize = static_cast<size_t>(size) * size;
+    image.pixels.resize(image.byteSize);
+    for (size_t i = 0; i < image.byteSize; ++i)
+      image.pixels[i] = static_cast<uint8_t>(128.0f + 60.0f * std::sin(static_cast<float>(i % size) * 0.01f) * std::cos(static_cast<float>(i / size) * 0.013f));
+
+    size_t vertices = 0;
+    const double ms = measureMs(1, [&]() {
+      vertices = 0;
+      generator.generate(image, options, [&](SSerializer::TerrainChunk& chunk) {
+        vertices += chunk.mesh.vertices.size();
+        return true;
+      });
+    });
+    report("TerrainGenerator " + std::to_string(size) + "^2 streamed", ms, static_cast<double>(vertices), "vert");
+  }
+  return 0;
+}
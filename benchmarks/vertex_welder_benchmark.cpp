@@ -0,0 +1,24 @@
+#include "benchmark_helpers.hpp"
+
+#include "starlet-serializer/processor/mesh/vertex_welder.hpp"
+
+int main() {
+  SSerializer::VertexWelder welder;
+
+  // Triangle soups of textured grids: six vertices per quad that weld back to one
+  for (unsigned int size : { 256u, 1292u }) {
+    const SSerializer::MeshData grid = makeTexturedGrid(size);
+    SSerializer::MeshData source = grid;
+    source.vertices.clear();
+    for (unsigned int& i : source.indices) {
+      source.vertices.push_back(grid.vertices[i]);
+      i = static_cast<unsigned int>(source.vertices.size() - 1);
+    }
+    source.numVertices = static_cast<unsigned int>(source.vertices.size());
+
+    SSerializer::MeshData mesh;
+    const double ms = measureMs(3, [&]() { mesh = source; }, [&]() { welder.weld(mesh); });
+    report("VertexWelder " + std::to_string(source.numVertices) + " verts", ms, source.numVertices, "vert");
+  }
+  return 0;
+}
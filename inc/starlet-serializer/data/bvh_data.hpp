@@ -0,0 +1,32 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+namespace Starlet::Serializer {
+
+// 32-byte node. Interior nodes have count == 0 and children at leftFirst and leftFirst + 1;
+// leaves reference BvhData::triangles[leftFirst .. leftFirst + count).
+struct BvhNode {
+	float boundsMin[3]{ 0.0f, 0.0f, 0.0f };
+	uint32_t leftFirst{ 0 };
+	float boundsMax[3]{ 0.0f, 0.0f, 0.0f };
+	uint32_t count{ 0 };
+
+	bool isLeaf() const { return count > 0; }
+};
+static_assert(sizeof(BvhNode) == 32, "BvhNode must stay 32 bytes");
+
+// Bounding volume hierarchy over the triangles of a MeshData; nodes[0] is the root
+struct BvhData {
+	std::vector<BvhNode> nodes;
+	std::vector<unsigned int> triangles; // Triangle indices (into MeshData::indices / 3) in leaf order
+};
+
+struct RayHit {
+	float distance{ 0.0f };
+	unsigned int triangle{ 0 };
+	float u{ 0.0f }, v{ 0.0f }; // Barycentrics of the hit point relative to the second and third vertex
+};
+
+}
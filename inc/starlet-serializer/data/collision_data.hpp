@@ -0,0 +1,47 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+
+#include "starlet-math/vec3.hpp"
+
+namespace Starlet::Serializer {
+
+// Triangulated convex hull; triangles wind counter-clockwise seen from outside
+struct ConvexHullData {
+	std::vector<Math::Vec3<float>> vertices;
+	std::vector<unsigned int> indices;
+};
+
+// 26-DOP: slab extents along 13 fixed unit axes (3 coordinate axes, 4 cube diagonals, 6 edge diagonals)
+struct KDopData {
+	static constexpr size_t AXIS_COUNT = 13;
+	float min[AXIS_COUNT]{};
+	float max[AXIS_COUNT]{};
+
+	static Math::Vec3<float> axis(size_t i) {
+		constexpr float D = 0.57735027f; // 1 / sqrt(3)
+		constexpr float E = 0.70710678f; // 1 / sqrt(2)
+		constexpr float AXES[AXIS_COUNT][3] = {
+			{ 1, 0, 0 }, { 0, 1, 0 }, { 0, 0, 1 },
+			{ D, D, D }, { D, D, -D }, { D, -D, D }, { -D, D, D },
+			{ E, E, 0 }, { E, -E, 0 }, { E, 0, E }, { E, 0, -E }, { 0, E, E }, { 0, E, -E }
+		};
+		return { AXES[i][0], AXES[i][1], AXES[i][2] };
+	}
+};
+
+struct ObbData {
+	Math::Vec3<float> center{ 0.0f, 0.0f, 0.0f };
+	Math::Vec3<float> axes[3]{ { 1.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f }, { 0.0f, 0.0f, 1.0f } }; // Orthonormal, right-handed
+	Math::Vec3<float> halfExtents{ 0.0f, 0.0f, 0.0f };
+};
+
+// Collision proxies derived from a MeshData, stored in the .smesh cache next to the mesh
+struct CollisionData {
+	ConvexHullData hull;
+	KDopData kdop;
+	ObbData obb;
+};
+
+}
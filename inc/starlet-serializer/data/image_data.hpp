@@ -2,12 +2,58 @@
 
 #include <vector>
 #include <cstdint> 
+#include <cstddef>
 
 namespace Starlet::Serializer {
 
+// Byte layout of one pixel, 8 bits per channel in memory order
+enum class PixelFormat : uint8_t {
+	Unknown,
+	R8,
+	RGB8,
+	RGBA8,
+	BGR8,
+	BGRA8
+};
+
+constexpr uint8_t pixelFormatSize(PixelFormat format) {
+	switch (format) {
+	case PixelFormat::R8:    return 1;
+	case PixelFormat::RGB8:
+	case PixelFormat::BGR8:  return 3;
+	case PixelFormat::RGBA8:
+	case PixelFormat::BGRA8: return 4;
+	default:                 return 0;
+	}
+}
+
+// Container format, detected from the file's leading bytes or its extension
+enum class ImageFormat : uint8_t {
+	BMP,
+	TGA,
+	PNG,
+	QOI,
+	UNKNOWN
+};
+
+// What a header probe reports: the stored layout and the layout and size a decode will produce
+struct ImageInfo {
+	ImageFormat fileFormat{ ImageFormat::UNKNOWN };
+	uint32_t width{ 0 }, height{ 0 };
+	PixelFormat sourceFormat{ PixelFormat::Unknown };
+	bool sourceBottomUp{ false };
+
+	PixelFormat format{ PixelFormat::Unknown };
+	bool bottomUp{ false };
+	size_t rowSize{ 0 };  // Tightly packed bytes per output row
+	size_t byteSize{ 0 }; // rowSize * height
+};
+
 struct ImageData {
 	int32_t width{ 0 }, height{ 0 };
 	std::vector<uint8_t> pixels;
+	PixelFormat format{ PixelFormat::Unknown };
+	bool bottomUp{ false }; // First row in pixels is the bottom of the image
 	uint8_t  pixelSize{ 0 };
 	size_t   byteSize{ 0 };
 };
@@ -0,0 +1,14 @@
+#pragma once
+
+#include <vector>
+
+namespace Starlet::Serializer {
+
+// One level of detail: an index buffer over the vertices of the mesh it was built from
+struct LodData {
+	std::vector<unsigned int> indices;
+	unsigned int numIndices{ 0 }, numTriangles{ 0 };
+	float error{ 0.0f }; // Geometric deviation relative to the mesh extent
+};
+
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include "starlet-math/vertex.hpp"
+#include "starlet-math/vec4.hpp"
+
+namespace Starlet::Serializer {
+
+// Range of one source mesh inside MeshBatchData. The first five fields are laid out as an indexed
+// indirect draw command (indexCount, instanceCount, firstIndex, baseVertex, baseInstance), so the
+// entries can back an indirect buffer read with a stride of sizeof(MeshBatchEntry).
+struct MeshBatchEntry {
+	uint32_t indexCount{ 0 };
+	uint32_t instanceCount{ 1 };
+	uint32_t firstIndex{ 0 };
+	int32_t  baseVertex{ 0 }; // 0 when the batch was built with rebaseIndices
+	uint32_t baseInstance{ 0 };
+
+	uint32_t firstVertex{ 0 };
+	uint32_t vertexCount{ 0 };
+	Math::Vec3<float> boundsMin{ 0.0f, 0.0f, 0.0f }, boundsMax{ 0.0f, 0.0f, 0.0f };
+};
+
+// Many meshes packed into one vertex buffer and one index buffer
+struct MeshBatchData {
+	std::vector<Math::Vertex> vertices;
+	std::vector<unsigned int> indices; // Relative to each entry's firstVertex unless built with rebaseIndices
+	std::vector<Math::Vec4<float>> tangents; // Filled when any source mesh has tangents; { 0, 0, 0, 1 } elsewhere
+	std::vector<MeshBatchEntry> entries;
+
+	bool hasTangents{ false }, rebasedIndices{ false };
+};
+
+}
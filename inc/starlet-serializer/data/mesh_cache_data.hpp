@@ -0,0 +1,49 @@
+#pragma once
+
+#include "mesh_data.hpp"
+#include "meshlet_data.hpp"
+#include "bvh_data.hpp"
+#include "collision_data.hpp"
+
+#include <cstdint>
+
+namespace Starlet::Serializer {
+
+// Contents of a binary mesh cache (.smesh): the mesh plus any derived data built at load time
+struct MeshCacheData {
+	MeshData mesh;
+
+	// Store the mesh through MeshCodec: indices exactly, vertex attributes quantized to 16 bits.
+	// The writer then refits the BVH and meshlet bounds and rebuilds the collision proxies from the
+	// quantized positions, so they bound the mesh a reader decodes
+	bool compressed{ false };
+
+	bool hasMeshlets{ false };
+	MeshletData meshlets;
+
+	bool hasBvh{ false };
+	BvhData bvh;
+
+	bool hasCollision{ false };
+	CollisionData collision;
+};
+
+// On-disk layout: "SMSH", u32 version, then chunks of { char[4] id, u64 size, payload } until the
+// end of the file. All values are little-endian; readers skip chunks they do not know.
+namespace MeshCacheFormat {
+	constexpr char     MAGIC[5] = "SMSH";
+	constexpr uint32_t VERSION = 1;
+
+	constexpr char MESH_CHUNK[5] = "MESH";
+	constexpr char COMPRESSED_MESH_CHUNK[5] = "MSHZ";
+	constexpr char MESHLET_CHUNK[5] = "MLET";
+	constexpr char BVH_CHUNK[5] = "BVH ";
+	constexpr char COLLISION_CHUNK[5] = "COLL";
+
+	constexpr uint32_t MESH_HAS_NORMALS   = 1u << 0;
+	constexpr uint32_t MESH_HAS_COLOURS   = 1u << 1;
+	constexpr uint32_t MESH_HAS_TEXCOORDS = 1u << 2;
+	constexpr uint32_t MESH_HAS_TANGENTS  = 1u << 3;
+}
+
+}
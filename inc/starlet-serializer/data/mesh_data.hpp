@@ -3,6 +3,7 @@
 #include <vector>
 
 #include "starlet-math/vertex.hpp"
+#include "starlet-math/vec4.hpp"
 
 namespace Starlet::Serializer {
 
@@ -11,8 +12,16 @@ struct MeshData {
 	std::vector<unsigned int> indices;
 	unsigned int numVertices{ 0 }, numIndices{ 0 }, numTriangles{ 0 };
 
-	bool hasNormals{ false }, hasColours{ false }, hasTexCoords{ false };
+	// Per-vertex tangents, parallel to vertices. w holds the bitangent sign: bitangent = cross(norm, tangent.xyz) * w
+	std::vector<Math::Vec4<float>> tangents;
+
+	bool hasNormals{ false }, hasColours{ false }, hasTexCoords{ false }, hasTangents{ false };
 	float minY{ 0.0f }, maxY{ 0.0 };
+
+	// Bounds of the vertex positions, filled by every mesh parser (see BoundsCalculator)
+	Math::Vec3<float> boundsMin{ 0.0f, 0.0f, 0.0f }, boundsMax{ 0.0f, 0.0f, 0.0f };
+	Math::Vec3<float> sphereCenter{ 0.0f, 0.0f, 0.0f };
+	float sphereRadius{ 0.0f };
 };
 
-}
\ No newline at end of file
+}
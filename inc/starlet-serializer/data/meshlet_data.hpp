@@ -0,0 +1,30 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+
+#include "starlet-math/vec3.hpp"
+
+namespace Starlet::Serializer {
+
+struct Meshlet {
+	unsigned int vertexOffset{ 0 }, vertexCount{ 0 };     // Range in MeshletData::vertices
+	unsigned int triangleOffset{ 0 }, triangleCount{ 0 }; // Triangle range; local indices start at triangles[3 * triangleOffset]
+
+	Math::Vec3<float> center{ 0.0f };
+	float radius{ 0.0f };
+
+	// The meshlet is back-facing from `eye` when dot(normalize(coneApex - eye), coneAxis) >= coneCutoff
+	Math::Vec3<float> coneApex{ 0.0f };
+	Math::Vec3<float> coneAxis{ 0.0f };
+	float coneCutoff{ 1.0f };
+};
+
+struct MeshletData {
+	std::vector<Meshlet> meshlets;
+	std::vector<unsigned int> vertices; // Meshlet-local vertex -> mesh vertex
+	std::vector<uint8_t> triangles;     // Three meshlet-local vertex indices per triangle
+	unsigned int maxVertices{ 0 }, maxTriangles{ 0 };
+};
+
+}
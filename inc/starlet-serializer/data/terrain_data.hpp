@@ -0,0 +1,24 @@
+#pragma once
+
+#include "mesh_data.hpp"
+#include "lod_data.hpp"
+
+#include <vector>
+
+namespace Starlet::Serializer {
+
+// One square patch of a heightmap terrain. Vertices are the full-resolution grid, row by row,
+// followed by the skirt vertices. Each LOD indexes that shared buffer at half the previous
+// resolution (skirts included); lods[0] matches mesh.indices.
+struct TerrainChunk {
+	unsigned int chunkX{ 0 }, chunkZ{ 0 };
+	MeshData mesh;
+	std::vector<LodData> lods;
+};
+
+struct TerrainData {
+	unsigned int chunksX{ 0 }, chunksZ{ 0 };
+	std::vector<TerrainChunk> chunks; // Row-major: chunkZ * chunksX + chunkX
+};
+
+}
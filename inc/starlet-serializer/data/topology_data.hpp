@@ -0,0 +1,36 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+namespace Starlet::Serializer {
+
+struct MeshEdge {
+	unsigned int v0{ 0 }, v1{ 0 }; // v0 < v1
+	unsigned int faceCount{ 0 };
+};
+
+// Implicit half-edge structure over MeshData::indices. Half-edge h = 3 * triangle + k runs from
+// corner k to corner (k + 1) % 3 of the triangle, so next/prev/face are arithmetic and only the
+// twin is stored.
+struct TopologyData {
+	static constexpr uint32_t NO_TWIN = 0xFFFFFFFFu;
+
+	std::vector<uint32_t> twins;             // Opposite half-edge, or NO_TWIN on boundary, non-manifold and degenerate edges
+	std::vector<uint32_t> boundaryHalfEdges; // Half-edges whose edge belongs to a single triangle
+	std::vector<MeshEdge> nonManifoldEdges;  // Edges shared by more than two triangles
+	size_t edgeCount{ 0 };                   // Unique non-degenerate edges
+	size_t flippedEdges{ 0 };                // Twinned edges whose triangles disagree on winding
+
+	static uint32_t next(uint32_t halfEdge) { return halfEdge - halfEdge % 3 + (halfEdge % 3 + 1) % 3; }
+	static uint32_t face(uint32_t halfEdge) { return halfEdge / 3; }
+
+	// Triangle across edge k of triangle t, or NO_TWIN
+	uint32_t neighbour(uint32_t triangle, uint32_t k) const {
+		const uint32_t twin = twins[triangle * 3 + k];
+		return twin == NO_TWIN ? NO_TWIN : twin / 3;
+	}
+};
+
+}
@@ -4,14 +4,37 @@
 
 namespace Starlet::Serializer {
 
+// Uncompressed 1/4/8-bit palettized and 16/24/32-bit BMP, BI_BITFIELDS/BI_ALPHABITFIELDS masks and
+// RLE8/RLE4. 32-bit BI_RGB is BGRX: the fourth byte is ignored and pixels are opaque.
 class BmpParser : public ImageParserBase {
-public:
-	bool parse(const std::string& path, ImageData& out) override;
+protected:
+	size_t headerSize() const override;
+	bool parseHeader(const unsigned char* p, size_t fileSize, ImageInfo& info, uint32_t& dataOffset) override;
+	bool copyPixelData(const unsigned char* p, size_t fileSize, uint32_t dataOffset, const ImageInfo& info, unsigned char* dst, size_t rowPitch) const override;
+	bool isStoredLayout(const ImageInfo& info) const override;
 
 private:
-	bool parseHeader(const unsigned char* p, size_t fileSize, uint32_t& width, int32_t& height, uint32_t& dataOffset);
+	// Fields of the last parsed header that decoding needs beyond ImageInfo
+	struct Layout {
+		uint16_t bpp{ 0 };
+		uint32_t compression{ 0 };
+		uint32_t paletteOffset{ 0 }, paletteSize{ 0 };
+		uint32_t masks[4]{}; // Red, green, blue, alpha
+
+		bool isRle() const { return compression == 1 || compression == 2; }
+		bool isPalettized() const { return bpp <= 8; }
+	};
+	Layout layout;
+
 	bool validateFileSignature(const unsigned char* p, size_t fileSize) const;
-	bool copyPixelData(const unsigned char* p, size_t fileSize, uint32_t dataOffset, ImageData& out, uint32_t width, uint32_t height, bool bottomUp) const;
+	bool readMasks(const unsigned char* p, size_t fileSize, uint32_t dibSize);
+	size_t rowStride(uint32_t width) const;
+	// True when stored rows are already in info.sourceFormat: 24-bit, or 32-bit with byte-aligned BGRA masks
+	bool isDirectColour() const;
+	// True for 32-bit rows with byte-aligned BGR masks and no alpha, including every 32-bit BI_RGB file
+	bool isBgrx() const;
+	void buildPaletteTable(const unsigned char* p, PixelFormat format, uint32_t indexBits, std::vector<unsigned char>& table) const;
+	bool decodeRle(const unsigned char* src, const unsigned char* end, const ImageInfo& info, std::vector<unsigned char>& indices) const;
 };
 
 }
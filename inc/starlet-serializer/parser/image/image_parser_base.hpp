@@ -1,31 +1,59 @@
 #pragma once
 
 #include "starlet-serializer/parser/parser.hpp"
+#include "starlet-serializer/data/image_data.hpp"
 
 #include <cstdint> 
 #include <optional>
 
 namespace Starlet::Serializer {
 
-struct ImageData;
+struct ImageParseOptions {
+	// Layout written to ImageData::pixels; sources are converted while decoding. Unknown picks RGBA8
+	// for sources with an alpha channel or a transparent colour key and RGB8 for the rest.
+	PixelFormat format{ PixelFormat::Unknown };
+
+	// Keep the file's channel order and row orientation instead, ignoring `format`. ImageData::format
+	// and bottomUp report the layout; unpadded files decode as a single copy.
+	bool nativeLayout{ false };
+};
 
 class ImageParserBase : public Parser {
 public:
 	virtual ~ImageParserBase() = default;
 
-	virtual bool parse(const std::string& path, ImageData& out) = 0;
+	bool parse(const std::string& path, ImageData& out);
+	bool parse(const std::string& path, ImageData& out, const ImageParseOptions& options);
+
+	// Two-step decode into caller memory such as a mapped upload buffer: probe reads only the header,
+	// then decode writes info.height rows of info.rowSize bytes, rowPitch bytes apart, into dst
+	bool probe(const std::string& path, ImageInfo& out, const ImageParseOptions& options = {});
+	bool decode(const std::string& path, unsigned char* dst, size_t dstSize, size_t rowPitch, const ImageParseOptions& options = {});
 
 protected:
+	// Bytes probe needs to read for parseHeader
+	virtual size_t headerSize() const = 0;
+	// Bytes parseHeader needs given the first `available` ones, for headers that span chunks; probe
+	// rereads until this stops growing
+	virtual size_t probeSize(const unsigned char* p, size_t available) const;
+	// Fills the source fields of info and the pixel data offset, checking the file holds the pixel data
+	virtual bool parseHeader(const unsigned char* p, size_t fileSize, ImageInfo& info, uint32_t& dataOffset) = 0;
+	virtual bool copyPixelData(const unsigned char* p, size_t fileSize, uint32_t dataOffset, const ImageInfo& info, unsigned char* dst, size_t rowPitch) const = 0;
+	// True when the stored pixel block is already the output layout, letting parse adopt the file buffer
+	virtual bool isStoredLayout(const ImageInfo& info) const = 0;
+
 	void clearImageData(ImageData& imageData) const;
 	std::optional<std::vector<unsigned char>> loadImageData(const std::string& path);
 
 	bool validateDimensions(uint32_t width, uint32_t height) const;
+	bool readHeader(const unsigned char* p, size_t fileSize, const ImageParseOptions& options, ImageInfo& info, uint32_t& dataOffset);
 
-	bool allocatePixelBuffer(ImageData& out, uint32_t width, uint32_t height) const;
-	void convertBgrToRgb(const unsigned char* src, unsigned char* dst, uint32_t width) const;
+	void setPixelLayout(ImageData& out, const ImageInfo& info) const;
+	bool allocatePixelBuffer(ImageData& out) const;
+	void adoptPixelData(std::vector<unsigned char>& file, size_t offset, ImageData& out) const;
 
 	uint32_t readUint32(const unsigned char* p, size_t offset) const;
 	uint16_t readUint16(const unsigned char* p, size_t offset) const;
 };
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include "starlet-serializer/parser/image/image_parser_base.hpp"
+
+#include <utility>
+#include <vector>
+
+namespace Starlet::Serializer {
+
+// PNG of every colour type and bit depth, interlaced or not, decoded with the in-tree inflate.
+// 16-bit samples are truncated to their high byte (not rounded). Palette transparency (tRNS)
+// becomes alpha; a grey or RGB colour key (tRNS) makes matching pixels transparent when the
+// output format has alpha, compared at the full sample depth, and makes the default output RGBA8.
+// Chunk CRCs are not checked.
+class PngParser : public ImageParserBase {
+protected:
+	size_t headerSize() const override;
+	size_t probeSize(const unsigned char* p, size_t available) const override;
+	bool parseHeader(const unsigned char* p, size_t fileSize, ImageInfo& info, uint32_t& dataOffset) override;
+	bool copyPixelData(const unsigned char* p, size_t fileSize, uint32_t dataOffset, const ImageInfo& info, unsigned char* dst, size_t rowPitch) const override;
+	bool isStoredLayout(const ImageInfo& info) const override;
+
+private:
+	// Fields of the last parsed header that decoding needs beyond ImageInfo
+	struct Layout {
+		uint8_t bitDepth{ 0 };
+		uint8_t colourType{ 0 };
+		bool interlaced{ false };
+
+		uint32_t channels() const;
+		// Format expandRow writes, ignoring any colour key
+		PixelFormat rowFormat() const;
+		size_t rowBytes(uint32_t width) const { return (static_cast<size_t>(width) * channels() * bitDepth + 7) / 8; }
+	};
+	Layout layout;
+
+	// Byte ranges of the ancillary and data chunks decoding needs
+	struct Chunks {
+		const unsigned char* palette{ nullptr };
+		size_t paletteSize{ 0 };
+		const unsigned char* transparency{ nullptr };
+		size_t transparencySize{ 0 };
+		std::vector<std::pair<const unsigned char*, size_t>> data;
+	};
+
+	bool validateFileSignature(const unsigned char* p, size_t fileSize) const;
+	// Whether a grey or RGB image has a tRNS key before its image data
+	bool hasColourKey(const unsigned char* p, size_t fileSize) const;
+	bool readChunks(const unsigned char* p, size_t fileSize, uint32_t dataOffset, Chunks& chunks) const;
+	void buildPalette(const Chunks& chunks, unsigned char* palette) const;
+	// Grey or RGB tRNS key at the image's bit depth; false when the image has none
+	bool readColourKey(const Chunks& chunks, uint16_t (&key)[3]) const;
+	// Unfiltered row to layout.rowFormat()
+	void expandRow(const unsigned char* src, uint32_t width, const unsigned char* palette, unsigned char* dst) const;
+	// Unfiltered grey or RGB row to RGBA8, with alpha 0 where the pixel equals the colour key
+	void expandKeyedRow(const unsigned char* src, uint32_t width, const uint16_t (&key)[3], unsigned char* dst) const;
+};
+
+}
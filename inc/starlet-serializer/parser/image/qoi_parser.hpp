@@ -0,0 +1,20 @@
+#pragma once
+
+#include "starlet-serializer/parser/image/image_parser_base.hpp"
+
+namespace Starlet::Serializer {
+
+// QOI ("Quite OK Image") with 3 or 4 channels. RGB8 and RGBA8 outputs decode straight into the
+// destination rows; other formats go through a row buffer and a conversion.
+class QoiParser : public ImageParserBase {
+protected:
+	size_t headerSize() const override;
+	bool parseHeader(const unsigned char* p, size_t fileSize, ImageInfo& info, uint32_t& dataOffset) override;
+	bool copyPixelData(const unsigned char* p, size_t fileSize, uint32_t dataOffset, const ImageInfo& info, unsigned char* dst, size_t rowPitch) const override;
+	bool isStoredLayout(const ImageInfo& info) const override;
+
+private:
+	bool validateFileSignature(const unsigned char* p, size_t fileSize) const;
+};
+
+}
@@ -4,14 +4,34 @@
 
 namespace Starlet::Serializer {
 
+// Uncompressed and RLE true-colour (15/16/24/32-bit), colour-mapped (8/16-bit indices) and
+// 8-bit greyscale TGA
 class TgaParser : public ImageParserBase {
-public:
-	bool parse(const std::string& path, ImageData& out) override;
+protected:
+	size_t headerSize() const override;
+	bool parseHeader(const unsigned char* p, size_t fileSize, ImageInfo& info, uint32_t& dataOffset) override;
+	bool copyPixelData(const unsigned char* p, size_t fileSize, uint32_t dataOffset, const ImageInfo& info, unsigned char* dst, size_t rowPitch) const override;
+	bool isStoredLayout(const ImageInfo& info) const override;
 
 private:
-	bool parseHeader(const unsigned char* p, size_t fileSize, uint32_t& width, uint32_t& height, uint8_t& bpp, bool& topDown, uint32_t& dataOffset);
+	// Fields of the last parsed header that decoding needs beyond ImageInfo
+	struct Layout {
+		uint8_t imageType{ 0 };
+		uint8_t bpp{ 0 };
+		uint8_t colourMapEntrySize{ 0 };
+		uint16_t colourMapFirst{ 0 }, colourMapLength{ 0 };
+		uint32_t colourMapOffset{ 0 };
+
+		bool isRle() const { return imageType >= 9; }
+		bool isColourMapped() const { return imageType == 1 || imageType == 9; }
+	};
+	Layout layout;
+
 	bool validateFileSignature(const unsigned char* p, size_t fileSize) const;
-	bool copyPixelData(const unsigned char* p, size_t fileSize, uint32_t dataOffset, ImageData& out, uint32_t width, uint32_t height, uint8_t bpp, bool topDown) const;
+	// True when stored pixels are already in info.sourceFormat, with no palette or 16-bit expansion
+	bool isDirectColour(const ImageInfo& info) const;
+	void buildColourMap(const unsigned char* p, PixelFormat format, std::vector<unsigned char>& table) const;
+	void expandRow(const unsigned char* src, const ImageInfo& info, const std::vector<unsigned char>& colourMap, unsigned char* dst) const;
 };
 
 }
@@ -1,23 +1,27 @@
 #pragma once
 
 #include "parser.hpp"
+#include "image/image_parser_base.hpp"
 
-namespace Starlet::Serializer {
+#include <memory>
 
-struct ImageData;
+namespace Starlet::Serializer {
 
 class ImageParser : public Parser {
 public:
 	bool parse(const std::string& path, ImageData& out);
+	bool parse(const std::string& path, ImageData& out, const ImageParseOptions& options);
 
-private:
-	enum class ImageFormat {
-		BMP,
-		TGA,
-		UNKNOWN
-	};
+	// See ImageParserBase::probe/decode
+	bool probe(const std::string& path, ImageInfo& out, const ImageParseOptions& options = {});
+	bool decode(const std::string& path, unsigned char* dst, size_t dstSize, size_t rowPitch, const ImageParseOptions& options = {});
 
+	// Identifies the format from the file's signature, falling back to the extension when the
+	// leading bytes are not conclusive (TGA has no magic number, so its header fields are checked)
 	ImageFormat detectFormat(const std::string& path);
+
+private:
+	std::unique_ptr<ImageParserBase> createParser(const std::string& path);
 };
 
 }
\ No newline at end of file
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "starlet-serializer/parser/parser.hpp"
+
+#include <cstdint>
+
+namespace Starlet::Serializer {
+
+namespace Utils {
+	class ByteReader;
+}
+
+struct MeshData;
+struct MeshletData;
+struct BvhData;
+struct CollisionData;
+struct MeshCacheData;
+
+class MeshCacheParser : public Parser {
+public:
+	bool parse(const std::string& path, MeshCacheData& out);
+
+private:
+	bool parseMeshChunk(Utils::ByteReader& reader, MeshData& out);
+	bool parseCompressedMeshChunk(Utils::ByteReader& reader, MeshData& out);
+	bool parseMeshletChunk(Utils::ByteReader& reader, MeshletData& out);
+	bool parseBvhChunk(Utils::ByteReader& reader, BvhData& out);
+	bool parseCollisionChunk(Utils::ByteReader& reader, CollisionData& out);
+};
+
+}
@@ -2,22 +2,48 @@
 
 #include "parser.hpp"
 
+#include "starlet-serializer/processor/mesh/normal_generator.hpp"
+#include "starlet-serializer/processor/mesh/vertex_welder.hpp"
+
 namespace Starlet::Serializer {
 
 struct MeshData;
+struct ModelData;
+
+struct MeshParseOptions {
+	// Merge duplicate and near-duplicate vertices before any other processing
+	bool weldVertices{ false };
+	WeldOptions weld;
+
+	// Generate smooth normals when the source file does not provide any
+	bool generateNormals{ false };
+	NormalWeighting normalWeighting{ NormalWeighting::Angle };
+	float creaseAngle{ 180.0f };
+
+	// Generate tangents for textured meshes, generating normals first if the file has none
+	bool generateTangents{ false };
+
+	// Bake this model's ColourMode into the vertex colours once the other stages have run
+	const ModelData* colourModel{ nullptr };
+};
 
 class MeshParser : public Parser {
 public:
 	bool parse(const std::string& path, MeshData& out);
+	bool parse(const std::string& path, MeshData& out, const MeshParseOptions& options);
 
 private:
 	enum class MeshFormat {
 		PLY,
 		OBJ,
+		SMESH,
 		UNKNOWN
 	};
 
+	// Identifies the format from the file's signature, falling back to the extension
 	MeshFormat detectFormat(const std::string& path);
+	bool parseFormat(const std::string& path, MeshData& out);
+	bool applyOptions(MeshData& out, const MeshParseOptions& options);
 };
 
-}
\ No newline at end of file
+}
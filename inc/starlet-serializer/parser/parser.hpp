@@ -45,6 +45,8 @@ public:
 
 	bool loadFile(std::string& out, const std::string& path);
 	bool loadBinaryFile(std::vector<unsigned char>& dataOut, const std::string& path);
+	// Reads at most maxBytes from the start of the file, reporting the full size in fileSize
+	bool loadBinaryFilePrefix(std::vector<unsigned char>& dataOut, const std::string& path, size_t maxBytes, size_t& fileSize);
 
 	bool parseBool(const unsigned char*& p, bool& out);
 	bool parseUInt(const unsigned char*& p, unsigned int& out);
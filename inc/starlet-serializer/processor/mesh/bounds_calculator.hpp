@@ -0,0 +1,14 @@
+#pragma once
+
+namespace Starlet::Serializer {
+
+struct MeshData;
+
+class BoundsCalculator {
+public:
+	// Fills the AABB, bounding sphere and minY/maxY of the mesh from its vertex positions using a
+	// parallel SSE reduction. The sphere is centred on the AABB with the exact enclosing radius.
+	void compute(MeshData& mesh) const;
+};
+
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace Starlet {
+
+namespace Math {
+	template <typename T> struct Vec3;
+}
+
+namespace Serializer {
+
+struct MeshData;
+struct BvhData;
+struct BvhNode;
+struct RayHit;
+
+class BvhBuilder {
+public:
+	static constexpr unsigned int DEFAULT_MAX_LEAF_SIZE = 4;
+
+	// Builds a binned-SAH hierarchy over the mesh triangles. The upper levels are split on the
+	// calling thread, then the remaining subtrees are built in parallel and stitched together
+	// in a fixed order, so the node array is identical on every run.
+	bool build(const MeshData& mesh, BvhData& out, unsigned int maxLeafSize = DEFAULT_MAX_LEAF_SIZE);
+
+	// Recomputes every node's bounds from the current vertex positions, keeping the topology, e.g.
+	// after the vertices were moved or quantized
+	bool refit(const MeshData& mesh, BvhData& bvh) const;
+
+private:
+	struct Context;
+	struct Subtree;
+
+	void buildNode(Context& ctx, std::vector<BvhNode>& nodes, size_t nodeIndex, size_t begin, size_t end, size_t depth, std::vector<Subtree>* deferred, size_t deferBelow) const;
+	bool findSplit(const Context& ctx, const BvhNode& node, size_t begin, size_t end, int& axis, float& position) const;
+};
+
+class BvhQuery {
+public:
+	// Closest hit along origin + t * direction for t in [0, maxDistance]
+	bool raycast(const MeshData& mesh, const BvhData& bvh, const Math::Vec3<float>& origin, const Math::Vec3<float>& direction, RayHit& hit, float maxDistance = 3.4e38f) const;
+
+	// Appends every triangle that intersects the box [boundsMin, boundsMax]
+	void overlapAabb(const MeshData& mesh, const BvhData& bvh, const Math::Vec3<float>& boundsMin, const Math::Vec3<float>& boundsMax, std::vector<unsigned int>& triangles) const;
+};
+
+}
+
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <vector>
+
+namespace Starlet {
+
+namespace Math {
+	template <typename T> struct Vec3;
+}
+
+namespace Serializer {
+
+struct MeshData;
+struct CollisionData;
+struct ConvexHullData;
+struct KDopData;
+struct ObbData;
+
+struct CollisionOptions {
+	// Hull growth stops once this many vertices are on the hull; the farthest remaining point is
+	// always added next, so a limited hull keeps the most significant extremes
+	unsigned int maxHullVertices{ 64 };
+};
+
+class CollisionBuilder {
+public:
+	// Builds a quickhull convex hull, a 26-DOP and a PCA-fitted OBB from the vertex positions
+	bool build(const MeshData& mesh, CollisionData& out, const CollisionOptions& options = {});
+
+	bool buildHull(const std::vector<Math::Vec3<float>>& points, ConvexHullData& out, unsigned int maxVertices);
+	void buildKDop(const std::vector<Math::Vec3<float>>& points, KDopData& out) const;
+	void buildObb(const std::vector<Math::Vec3<float>>& points, ObbData& out) const;
+
+	// Grows existing proxies so they still contain every point after it moves by up to `margin`
+	// along each axis. The hull is scaled about its centroid until each face clears the margin;
+	// a hull with no interior is left as is and reported.
+	void inflate(CollisionData& collision, const Math::Vec3<float>& margin) const;
+};
+
+}
+
+}
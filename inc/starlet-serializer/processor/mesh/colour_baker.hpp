@@ -0,0 +1,19 @@
+#pragma once
+
+namespace Starlet::Serializer {
+
+struct MeshData;
+struct ModelData;
+
+// Bakes a model's ColourMode into its mesh's vertex colours so static models need no per-frame
+// colour work. The mesh's minY/maxY must be filled (every parser does this).
+class ColourBaker {
+public:
+	// Solid: the model colour. Random: a colour per vertex hashed from the model name and vertex
+	// index, so it is stable across runs. VerticalGradient: a rainbow from red at minY to violet at
+	// maxY. VertexColour: the file's colours, or the model colour if the file has none. Alpha
+	// always comes from the model colour, except for file-provided vertex colours.
+	bool bake(const ModelData& model, MeshData& mesh) const;
+};
+
+}
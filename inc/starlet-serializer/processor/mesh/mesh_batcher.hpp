@@ -0,0 +1,20 @@
+#pragma once
+
+#include <vector>
+
+namespace Starlet::Serializer {
+
+struct MeshData;
+struct MeshBatchData;
+
+class MeshBatcher {
+public:
+	// Packs the meshes, in order, into one vertex and index allocation. Offsets are prefix sums of
+	// the mesh sizes, so the copies run in parallel over evenly sized slices of the output.
+	// With rebaseIndices the stored indices already include each mesh's firstVertex, for APIs
+	// without a base vertex, and every baseVertex is 0.
+	bool build(const std::vector<const MeshData*>& meshes, MeshBatchData& out, bool rebaseIndices = false);
+	bool build(const std::vector<MeshData>& meshes, MeshBatchData& out, bool rebaseIndices = false);
+};
+
+}
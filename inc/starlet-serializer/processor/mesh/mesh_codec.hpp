@@ -0,0 +1,43 @@
+#pragma once
+
+#include "starlet-serializer/utils/cpu_features.hpp"
+
+#include <cstddef>
+#include <vector>
+
+namespace Starlet {
+
+namespace Math {
+	template <typename T> struct Vec3;
+}
+
+namespace Serializer {
+
+struct MeshData;
+
+// Compact encodings for mesh buffers, used by the .smesh cache
+class MeshCodec {
+public:
+	// Lossless. Each index is delta coded against the previous one, zigzagged and stored in 1-4
+	// bytes, with the byte counts of four values packed into one control byte ahead of the data.
+	// Decoding expands four values per control byte with a single SSSE3 shuffle when available.
+	void encodeIndices(const std::vector<unsigned int>& indices, std::vector<unsigned char>& out) const;
+	bool decodeIndices(const unsigned char* data, size_t size, std::vector<unsigned int>& out, Utils::SimdLevel level = Utils::simdLevel()) const;
+
+	// Lossy. Every component of the attributes present (position, normal, colour, texture
+	// coordinate, tangent) is quantized to 16 bits over its range, delta coded against the
+	// previous vertex and zigzagged. Each group of 16 values stores nothing, its low byte plane,
+	// or both byte planes, so coherent vertex orders shrink to a few bytes per vertex. Attributes
+	// without a stream decode to the parsers' defaults (opaque white colours). Any level above
+	// Scalar decodes groups with SSE2 on x86.
+	void encodeVertices(const MeshData& mesh, std::vector<unsigned char>& out) const;
+	bool decodeVertices(const unsigned char* data, size_t size, MeshData& out, Utils::SimdLevel level = Utils::simdLevel()) const;
+
+	// Largest distance along each axis between a position of `mesh` and its decoded value: half a
+	// quantization step, plus float rounding
+	Math::Vec3<float> positionError(const MeshData& mesh) const;
+};
+
+}
+
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "starlet-serializer/data/primitive_data.hpp"
+#include "starlet-serializer/data/grid_data.hpp"
+
+#include "starlet-math/vec3.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Starlet::Serializer {
+
+struct MeshData;
+
+// Geometry for scene primitives and grids. Unit meshes are centred on the origin with unit extent,
+// face +Z (triangle, square) or outwards (cube), and carry normals and texture coordinates.
+class MeshGenerator {
+public:
+	// Shared unit mesh for a primitive type, built once and reused by every caller. The primitive's
+	// transform is applied by the renderer.
+	static const MeshData& unitMesh(PrimitiveType type);
+
+	// One mesh holding every element of a square (count x count) or cube (count^3) grid. Element
+	// (x, y, z) is the unit square or cube scaled by transform.size and moved to (x, y, z) * spacing;
+	// transform.pos and transform.rot place the whole grid and are left to the renderer.
+	bool generateGrid(const GridData& grid, MeshData& out) const;
+
+	// Elements in a square (count^2) or cube and model (count^3) grid
+	static uint64_t gridElementCount(const GridData& grid);
+
+	// Per-element offsets for drawing the grid's unit mesh (or a model, for Model grids) instanced,
+	// in the same order and grid space as generateGrid. One call fills at most 2^28 offsets.
+	bool generateGridOffsets(const GridData& grid, std::vector<Math::Vec3<float>>& out) const;
+	// Offsets of elements [first, first + count) only, so grids past the single-call limit (up to
+	// 2^21 per axis, e.g. 1000^3) can be streamed through a reused buffer
+	bool generateGridOffsets(const GridData& grid, uint64_t first, size_t count, std::vector<Math::Vec3<float>>& out) const;
+};
+
+}
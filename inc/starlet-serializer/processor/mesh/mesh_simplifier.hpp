@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace Starlet::Serializer {
+
+struct MeshData;
+struct LodData;
+
+struct SimplifyOptions {
+	float maxError{ 1e-2f }; // Relative to the mesh extent; collapses above this are rejected
+	bool lockBorder{ true }; // Keep vertices on open edges in place
+
+	// Cost of blending attributes across a collapse, only applied when the mesh has them
+	float normalWeight{ 0.01f };
+	float texCoordWeight{ 0.01f };
+	float colourWeight{ 0.01f };
+};
+
+class MeshSimplifier {
+public:
+	// Collapses edges of the triangle list `indices` (over mesh.vertices) until it has at most
+	// targetTriangles triangles or no collapse stays under options.maxError. Vertices are never
+	// moved or created, so the result indexes the same vertex buffer. Vertices duplicated along an
+	// attribute seam collapse only along that seam, both copies together.
+	bool simplify(const MeshData& mesh, const std::vector<unsigned int>& indices, size_t targetTriangles, LodData& out, const SimplifyOptions& options = {});
+
+	// Builds one level per ratio (fractions of the original triangle count, in decreasing order),
+	// each simplified further from the previous level. Error is accumulated along the chain, so every
+	// level reports (and options.maxError bounds) its deviation from the source mesh.
+	bool buildLodChain(const MeshData& mesh, const std::vector<float>& ratios, std::vector<LodData>& out, const SimplifyOptions& options = {});
+
+private:
+	struct Context;
+
+	bool prepare(const MeshData& mesh, const std::vector<unsigned int>& indices, const SimplifyOptions& options, Context& ctx) const;
+	void classifyVertices(const std::vector<unsigned int>& indices, const SimplifyOptions& options, Context& ctx) const;
+	void computeQuadrics(const std::vector<unsigned int>& indices, const SimplifyOptions& options, Context& ctx) const;
+	size_t collapsePass(std::vector<unsigned int>& indices, size_t targetTriangles, float maxErrorSq, Context& ctx, float& resultError) const;
+};
+
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+namespace Starlet::Serializer {
+
+struct MeshData;
+struct MeshletData;
+struct Meshlet;
+struct VertexAdjacency;
+
+class MeshletBuilder {
+public:
+	static constexpr unsigned int DEFAULT_MAX_VERTICES = 64;
+	static constexpr unsigned int DEFAULT_MAX_TRIANGLES = 124;
+
+	// Splits the triangles of mesh into clusters of at most maxVertices unique vertices (<= 255)
+	// and maxTriangles triangles, growing each cluster through shared vertices, then computes
+	// bounding spheres and normal cones for culling.
+	bool build(const MeshData& mesh, MeshletData& out, unsigned int maxVertices = DEFAULT_MAX_VERTICES, unsigned int maxTriangles = DEFAULT_MAX_TRIANGLES);
+
+	// Recomputes the bounding spheres and normal cones from the current vertex positions, keeping
+	// the clusters
+	bool refit(const MeshData& mesh, MeshletData& meshlets) const;
+
+private:
+	void partition(const MeshData& mesh, const VertexAdjacency& adjacency, MeshletData& out) const;
+	void computeBounds(const MeshData& mesh, MeshletData& out) const;
+	void computeMeshletBounds(const MeshData& mesh, const MeshletData& data, Meshlet& meshlet) const;
+};
+
+}
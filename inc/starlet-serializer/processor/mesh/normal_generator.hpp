@@ -0,0 +1,44 @@
+#pragma once
+
+#include <vector>
+
+namespace Starlet {
+
+namespace Math {
+	template <typename T> struct Vec3;
+}
+
+namespace Serializer {
+
+struct MeshData;
+struct VertexAdjacency;
+
+enum class NormalWeighting {
+	Area,
+	Angle
+};
+
+class NormalGenerator {
+public:
+	// Replaces the vertex normals of an indexed triangle mesh with smooth normals.
+	// Faces meeting at more than creaseAngle degrees are not smoothed together; the
+	// vertices they share are split so each side keeps its own normal.
+	bool generate(MeshData& mesh, NormalWeighting weighting = NormalWeighting::Angle, float creaseAngle = 180.0f);
+
+private:
+	void computeFaceNormals(const MeshData& mesh, NormalWeighting weighting,
+		std::vector<Math::Vec3<float>>& faceNormals, std::vector<float>& cornerWeights) const;
+
+	void gatherVertexNormals(MeshData& mesh, const VertexAdjacency& adjacency,
+		const std::vector<Math::Vec3<float>>& faceNormals, const std::vector<float>& cornerWeights) const;
+
+	void gatherCornerNormals(const VertexAdjacency& adjacency, float cosCrease,
+		const std::vector<Math::Vec3<float>>& faceNormals, const std::vector<float>& cornerWeights,
+		std::vector<Math::Vec3<float>>& cornerNormals) const;
+
+	void splitCreasedVertices(MeshData& mesh, const VertexAdjacency& adjacency, const std::vector<Math::Vec3<float>>& cornerNormals) const;
+};
+
+}
+
+}
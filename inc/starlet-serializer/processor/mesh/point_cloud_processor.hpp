@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Starlet::Serializer {
+
+struct MeshData;
+
+struct PointCloudOptions {
+	// Level 0 uses 2^finestGridBits voxels along the longest side of the bounds; each further level halves that
+	unsigned int finestGridBits{ 10 };
+	unsigned int levelCount{ 4 };
+	// Bytes of sort scratch allowed on top of the point data; 0 means unlimited. Over budget the
+	// sort runs in place and the codes are recomputed from positions instead of stored
+	size_t memoryBudget{ 0 };
+};
+
+class PointCloudProcessor {
+public:
+	static constexpr unsigned int MORTON_BITS = 21; // Per axis
+
+	// Reorders the vertices (and tangents, remapping any indices) along a 3D Morton curve over the
+	// mesh bounds. The default radix sort needs radixSortBytes() of scratch (24 B per point, 28 B
+	// with indices). When that exceeds a non-zero memoryBudget an in-place MSD radix sort is used
+	// instead, needing no per-point scratch without indices and 8 B per point with them. codes,
+	// when given, receives the sorted 63-bit Morton codes (8 B per point more).
+	bool mortonSort(MeshData& cloud, std::vector<uint64_t>* codes = nullptr, size_t memoryBudget = 0);
+
+	// Voxel-grid downsampled levels of a Morton-sorted cloud: one vertex per occupied voxel with the
+	// average position, colour and normal. Voxels are contiguous runs in Morton order, so every level
+	// is a linear pass over the previous one and needs no hash table. codes may be empty, in which
+	// case level 0 recomputes them from the positions and the bounds of `sorted`.
+	bool buildLevels(const MeshData& sorted, const std::vector<uint64_t>& codes, const PointCloudOptions& options, std::vector<MeshData>& levels);
+
+	// Sorts and builds levels. The whole cloud is held in memory: the budget bounds the scratch on
+	// top of it, not the cloud itself, beyond 16 B per level-0 voxel for its codes and weights.
+	bool process(MeshData& cloud, const PointCloudOptions& options, std::vector<MeshData>& levels);
+
+	static size_t radixSortBytes(size_t count, bool indexed);
+
+private:
+	static void remapIndices(MeshData& cloud, const std::vector<uint32_t>& order);
+};
+
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace Starlet {
+
+namespace Math {
+	template <typename T> struct Vec3;
+}
+
+namespace Serializer {
+
+struct MeshData;
+struct VertexAdjacency;
+
+class TangentGenerator {
+public:
+	// Fills MeshData::tangents from the texture coordinates and normals of an indexed triangle mesh.
+	// Vertices whose corners disagree on UV handedness (mirrored UVs) are split so each copy has a
+	// single bitangent sign. Results do not depend on the number of worker threads.
+	bool generate(MeshData& mesh);
+
+private:
+	void computeFaceTangents(const MeshData& mesh, std::vector<Math::Vec3<float>>& faceTangents,
+		std::vector<Math::Vec3<float>>& faceBitangents, std::vector<float>& cornerWeights) const;
+
+	void assignHandedness(const MeshData& mesh, const VertexAdjacency& adjacency, const std::vector<Math::Vec3<float>>& faceTangents,
+		const std::vector<Math::Vec3<float>>& faceBitangents, std::vector<unsigned int>& slotGroups, std::vector<float>& slotSigns) const;
+
+	void gatherTangents(MeshData& mesh, const VertexAdjacency& adjacency, size_t vertexCount, const std::vector<Math::Vec3<float>>& faceTangents,
+		const std::vector<float>& cornerWeights, const std::vector<unsigned int>& slotGroups, const std::vector<float>& slotSigns) const;
+};
+
+}
+
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <functional>
+
+namespace Starlet::Serializer {
+
+struct ImageData;
+struct TerrainChunk;
+struct TerrainData;
+
+struct TerrainOptions {
+	unsigned int channel{ 0 };     // Byte of each pixel read as the height
+	float horizontalScale{ 1.0f }; // World distance between neighbouring pixels (along X and Z)
+	float heightScale{ 1.0f };     // World height of a 255 sample
+
+	unsigned int chunkSize{ 256 }; // Quads per chunk side
+	unsigned int lodCount{ 1 };    // Levels per chunk; each doubles the sample spacing
+	float skirtDepth{ 0.0f };      // Walls hanging below every chunk edge to hide LOD cracks; 0 disables
+};
+
+// Builds Y-up terrain chunks from one channel of a heightmap. Pixel (x, z), counting z from the
+// image's top row whatever ImageData::bottomUp says, lands at (x, height, z) * scale with normals
+// from central differences over the whole image, so chunk borders match exactly.
+class TerrainGenerator {
+public:
+	bool generate(const ImageData& image, const TerrainOptions& options, TerrainData& out) const;
+
+	// Hands chunks to `sink` in row-major order as they are built. Chunks are built in parallel one
+	// batch (a chunk per worker) at a time, so memory stays bounded by the batch and not the image.
+	// Returning false from the sink stops generation.
+	bool generate(const ImageData& image, const TerrainOptions& options, const std::function<bool(TerrainChunk&)>& sink) const;
+
+private:
+	bool validate(const ImageData& image, const TerrainOptions& options) const;
+	void buildChunk(const ImageData& image, const TerrainOptions& options, unsigned int chunkX, unsigned int chunkZ, TerrainChunk& out) const;
+};
+
+}
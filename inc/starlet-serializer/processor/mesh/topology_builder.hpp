@@ -0,0 +1,16 @@
+#pragma once
+
+namespace Starlet::Serializer {
+
+struct MeshData;
+struct TopologyData;
+
+class TopologyBuilder {
+public:
+	// Matches half-edges by radix-sorting packed (min vertex, max vertex) keys, then links each run
+	// of equal keys in parallel. Runs of one are boundary edges, runs of more than two are
+	// non-manifold and left unlinked.
+	bool build(const MeshData& mesh, TopologyData& out);
+};
+
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <vector>
+
+namespace Starlet::Serializer {
+
+struct MeshData;
+
+// Compressed vertex -> corner map. A corner is 3 * triangle + k, where k is the
+// position of the vertex within the triangle. Corners of vertex v are stored in
+// corners[offsets[v] .. offsets[v + 1]) in ascending order.
+struct VertexAdjacency {
+	std::vector<unsigned int> offsets;
+	std::vector<unsigned int> corners;
+
+	unsigned int count(unsigned int vertex) const { return offsets[vertex + 1] - offsets[vertex]; }
+};
+
+bool buildVertexAdjacency(const MeshData& mesh, VertexAdjacency& out);
+
+// Splits vertices whose corners were assigned to different groups. slotGroups runs parallel to
+// adjacency.corners; group 0 keeps the original vertex and every other group gets a copy appended
+// to mesh.vertices, with the corner's index redirected to it. Group g > 0 of vertex v ends up at
+// vertexCount + copyOffsets[v] + g - 1, where vertexCount is the size before splitting.
+void splitVertexGroups(MeshData& mesh, const VertexAdjacency& adjacency, const std::vector<unsigned int>& slotGroups, std::vector<unsigned int>& copyOffsets);
+
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <vector>
+
+namespace Starlet::Serializer {
+
+struct MeshData;
+
+struct WeldOptions {
+	float positionEpsilon{ 1e-6f };
+	// Normals, colours, texture coordinates and tangents present on the mesh must also agree
+	// within this tolerance, so UV seams and hard edges survive welding
+	float attributeEpsilon{ 1e-4f };
+	bool positionOnly{ false };
+	bool removeDegenerate{ true };
+};
+
+class VertexWelder {
+public:
+	// Merges vertices closer than positionEpsilon using a spatial hash grid, keeping the lowest
+	// index of each group, then compacts the vertex buffer and remaps indices. Merging is
+	// transitive: a chain of matches forms one group, whatever the index order along it. remap,
+	// when given, receives the new index of every original vertex.
+	bool weld(MeshData& mesh, const WeldOptions& options = {}, std::vector<unsigned int>* remap = nullptr);
+
+private:
+	void findRepresentatives(const MeshData& mesh, const WeldOptions& options, std::vector<unsigned int>& representatives) const;
+	void compact(MeshData& mesh, const std::vector<unsigned int>& representatives, std::vector<unsigned int>& remap) const;
+	void remapIndices(MeshData& mesh, const std::vector<unsigned int>& remap, bool removeDegenerate) const;
+};
+
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace Starlet::Serializer::Utils {
+
+// Appends little-endian values to a byte buffer
+class ByteWriter {
+public:
+	explicit ByteWriter(std::vector<unsigned char>& buffer) : buffer(buffer) {}
+
+	void u8(uint8_t value) { buffer.push_back(value); }
+	void u16(uint16_t value) {
+		buffer.push_back(static_cast<unsigned char>(value));
+		buffer.push_back(static_cast<unsigned char>(value >> 8));
+	}
+	void u32(uint32_t value) {
+		for (int shift = 0; shift < 32; shift += 8) buffer.push_back(static_cast<unsigned char>(value >> shift));
+	}
+	void u64(uint64_t value) {
+		for (int shift = 0; shift < 64; shift += 8) buffer.push_back(static_cast<unsigned char>(value >> shift));
+	}
+	void f32(float value) {
+		uint32_t bits;
+		memcpy(&bits, &value, sizeof(bits));
+		u32(bits);
+	}
+	void bytes(const void* data, size_t size) {
+		const unsigned char* p = static_cast<const unsigned char*>(data);
+		buffer.insert(buffer.end(), p, p + size);
+	}
+	void tag(const char (&id)[5]) { bytes(id, 4); }
+
+	size_t size() const { return buffer.size(); }
+
+	// Overwrites a u64 written earlier at offset, for sizes only known after the payload
+	void patchU64(size_t offset, uint64_t value) {
+		for (int i = 0; i < 8; ++i) buffer[offset + i] = static_cast<unsigned char>(value >> (i * 8));
+	}
+
+private:
+	std::vector<unsigned char>& buffer;
+};
+
+// Bounds-checked little-endian reads; every read fails once the data runs out
+class ByteReader {
+public:
+	ByteReader(const unsigned char* data, size_t size) : data(data), end(size) {}
+
+	bool u8(uint8_t& out) { return read(&out, 1); }
+	bool u16(uint16_t& out) {
+		unsigned char b[2];
+		if (!read(b, 2)) return false;
+		out = static_cast<uint16_t>(b[0] | (b[1] << 8));
+		return true;
+	}
+	bool u32(uint32_t& out) {
+		unsigned char b[4];
+		if (!read(b, 4)) return false;
+		out = static_cast<uint32_t>(b[0]) | (static_cast<uint32_t>(b[1]) << 8) | (static_cast<uint32_t>(b[2]) << 16) | (static_cast<uint32_t>(b[3]) << 24);
+		return true;
+	}
+	bool u64(uint64_t& out) {
+		uint32_t lo, hi;
+		if (!u32(lo) || !u32(hi)) return false;
+		out = static_cast<uint64_t>(lo) | (static_cast<uint64_t>(hi) << 32);
+		return true;
+	}
+	bool f32(float& out) {
+		uint32_t bits;
+		if (!u32(bits)) return false;
+		memcpy(&out, &bits, sizeof(out));
+		return true;
+	}
+	bool bytes(void* out, size_t size) { return read(out, size); }
+	bool tag(char (&id)[5]) {
+		id[4] = '\0';
+		return read(id, 4);
+	}
+
+	bool skip(size_t size) {
+		if (size > end - pos) return false;
+		pos += size;
+		return true;
+	}
+
+	const unsigned char* current() const { return data + pos; }
+	size_t offset() const { return pos; }
+	size_t remaining() const { return end - pos; }
+
+private:
+	bool read(void* out, size_t size) {
+		if (size > end - pos) return false;
+		memcpy(out, data + pos, size);
+		pos += size;
+		return true;
+	}
+
+	const unsigned char* data;
+	size_t pos{ 0 };
+	size_t end;
+};
+
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+// Runtime CPU feature checks for kernels compiled for a higher instruction set than the build
+// baseline. STARLET_TARGET marks such a kernel; callers must check the matching cpuHas* first.
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define STARLET_X86 1
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define STARLET_TARGET(isa)
+#else
+#define STARLET_TARGET(isa) __attribute__((target(isa)))
+#endif
+#else
+#define STARLET_TARGET(isa)
+#endif
+
+namespace Starlet::Serializer::Utils {
+
+#ifdef STARLET_X86
+#if defined(_MSC_VER) && !defined(__clang__)
+inline bool cpuHasSsse3() {
+	int info[4];
+	__cpuid(info, 1);
+	return (info[2] & (1 << 9)) != 0;
+}
+inline bool cpuHasAvx2() {
+	int info[4];
+	__cpuid(info, 0);
+	if (info[0] < 7) return false;
+	__cpuid(info, 1);
+	const bool osSavesYmm = (info[2] & (1 << 27)) != 0 && (_xgetbv(0) & 0x6) == 0x6;
+	__cpuidex(info, 7, 0);
+	return osSavesYmm && (info[1] & (1 << 5)) != 0;
+}
+#else
+inline bool cpuHasSsse3() { return __builtin_cpu_supports("ssse3"); }
+inline bool cpuHasAvx2() { return __builtin_cpu_supports("avx2"); }
+#endif
+#else
+inline bool cpuHasSsse3() { return false; }
+inline bool cpuHasAvx2() { return false; }
+#endif
+
+// Widest kernel family the CPU supports; kernels take a level so tests and benchmarks can force narrower ones
+enum class SimdLevel {
+	Scalar,
+	Ssse3,
+	Avx2
+};
+
+inline SimdLevel simdLevel() {
+	static const SimdLevel level = cpuHasAvx2() ? SimdLevel::Avx2 : cpuHasSsse3() ? SimdLevel::Ssse3 : SimdLevel::Scalar;
+	return level;
+}
+
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Starlet::Serializer::Utils {
+
+// Decompresses a zlib stream (RFC 1950 wrapper around RFC 1951 deflate) into dst, which must be
+// exactly the size of the decompressed data. Huffman codes decode through two-level lookup tables.
+// Returns false for malformed or truncated data, an Adler-32 mismatch, preset dictionaries, or
+// output that does not fill dst exactly.
+bool inflateZlib(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstSize);
+
+// Adler-32 checksum as used by the zlib wrapper; pass a previous result to continue a running sum
+uint32_t adler32(const uint8_t* data, size_t size, uint32_t adler = 1);
+
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace Starlet::Serializer::Utils {
+
+inline size_t workerCount() {
+	const unsigned int hw = std::thread::hardware_concurrency();
+	return hw == 0 ? 1 : static_cast<size_t>(hw);
+}
+
+// Number of chunks parallelForChunks will split `count` items into
+inline size_t chunkCount(size_t count, size_t minGrain) {
+	if (count == 0) return 0;
+	if (minGrain == 0) minGrain = 1;
+	const size_t maxChunks = (count + minGrain - 1) / minGrain;
+	return std::min(workerCount(), maxChunks);
+}
+
+// Splits [0, count) into contiguous ranges of at least minGrain items and calls fn(chunk, begin, end)
+// once per range. Ranges run on separate threads; the calling thread takes the first one.
+template <typename Fn>
+void parallelForChunks(size_t count, size_t minGrain, Fn&& fn) {
+	const size_t chunks = chunkCount(count, minGrain);
+	if (chunks == 0) return;
+	if (chunks == 1) {
+		fn(size_t{ 0 }, size_t{ 0 }, count);
+		return;
+	}
+
+	const size_t chunkSize = (count + chunks - 1) / chunks;
+	std::vector<std::jthread> threads;
+	threads.reserve(chunks - 1);
+	for (size_t chunk = 1; chunk < chunks; ++chunk) {
+		const size_t begin = chunk * chunkSize;
+		const size_t end = std::min(count, begin + chunkSize);
+		if (begin >= end) break;
+		threads.emplace_back([&fn, chunk, begin, end]() { fn(chunk, begin, end); });
+	}
+	fn(size_t{ 0 }, size_t{ 0 }, std::min(count, chunkSize));
+}
+
+template <typename Fn>
+void parallelFor(size_t count, size_t minGrain, Fn&& fn) {
+	parallelForChunks(count, minGrain, [&fn](size_t, size_t begin, size_t end) { fn(begin, end); });
+}
+
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "cpu_features.hpp"
+
+#include "starlet-serializer/data/image_data.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Starlet::Serializer::Utils {
+
+// Channel reorders between the BGR(A) layouts of BMP/TGA and RGB(A). Each call runs the widest
+// kernel up to `level` that the CPU supports, finishing the last few pixels in scalar code.
+// src and dst may be the same buffer, except for the 3-to-4 byte expansions.
+
+// BGR <-> RGB
+void swapRedBlue24(const uint8_t* src, uint8_t* dst, size_t pixels, SimdLevel level = simdLevel());
+// BGRA <-> RGBA
+void swapRedBlue32(const uint8_t* src, uint8_t* dst, size_t pixels, SimdLevel level = simdLevel());
+// BGRA -> RGB, dropping alpha
+void bgraToRgb(const uint8_t* src, uint8_t* dst, size_t pixels, SimdLevel level = simdLevel());
+// RGBA -> RGB (or BGRA -> BGR), dropping alpha
+void rgbaToRgb(const uint8_t* src, uint8_t* dst, size_t pixels, SimdLevel level = simdLevel());
+// BGR -> RGBA with opaque alpha
+void bgrToRgba(const uint8_t* src, uint8_t* dst, size_t pixels, SimdLevel level = simdLevel());
+// RGB -> RGBA (or BGR -> BGRA) with opaque alpha
+void rgbToRgba(const uint8_t* src, uint8_t* dst, size_t pixels, SimdLevel level = simdLevel());
+
+// Converts between any two 8-bit PixelFormats using the kernels above. Colour to R8 takes
+// Rec. 601 luma; R8 to colour replicates grey with opaque alpha. Returns false for Unknown.
+bool convertPixels(const uint8_t* src, PixelFormat srcFormat, uint8_t* dst, PixelFormat dstFormat, size_t pixels);
+
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "cpu_features.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Starlet::Serializer::Utils {
+
+// PNG scanline filter types, stored as the first byte of each filtered row
+enum class PngFilter : uint8_t {
+	None,
+	Sub,
+	Up,
+	Average,
+	Paeth
+};
+
+// Reverses one scanline's filter in place. prev is the previous reconstructed scanline of the same
+// image or interlace pass (all zeros for the first) and bpp the filter's byte distance: bytes per
+// complete pixel, at least 1. 3- and 4-byte pixels, and Up for any size, run SSSE3 kernels when
+// `level` and the CPU allow. Returns false for an unknown filter type.
+bool unfilterRow(uint8_t filter, uint8_t* row, const uint8_t* prev, size_t rowBytes, size_t bpp, SimdLevel level = simdLevel());
+
+}
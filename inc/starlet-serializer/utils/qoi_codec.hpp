@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Starlet::Serializer::Utils {
+
+constexpr size_t QOI_HEADER_SIZE = 14;    // "qoif", big-endian width and height, channels, colourspace
+constexpr size_t QOI_END_MARKER_SIZE = 8; // Seven zero bytes and a one
+
+// Streams the chunk data that follows a QOI header, so rows can be decoded one at a time into
+// memory with any pitch. The end marker doubles as read-ahead padding: ops are read without
+// per-byte bounds checks as long as each starts before it.
+class QoiDecoder {
+public:
+	// data/size cover the chunks and the end marker, i.e. everything after the header
+	QoiDecoder(const uint8_t* data, size_t size);
+
+	// Decodes the next `pixels` pixels as RGBA8 (channels 4) or RGB8 (channels 3; alpha is still
+	// tracked for the ops that follow). Returns false once the chunks run out.
+	bool decode(uint8_t* dst, size_t pixels, uint8_t channels);
+
+private:
+	template <size_t Channels>
+	bool decodePixels(uint8_t* dst, size_t pixels);
+
+	const uint8_t* p;
+	const uint8_t* limit;
+	uint32_t pixel{ 0xFF000000 }; // Packed with red in the low byte; starts opaque black
+	uint32_t index[64]{};
+	uint32_t run{ 0 };
+};
+
+// Appends a QOI image to a byte buffer from RGB8 (channels 3) or RGBA8 (channels 4) pixels fed in
+// any number of calls, top row first. The buffer is grown once to the worst-case size and ops are
+// written through a raw pointer; finish() trims it back.
+class QoiEncoder {
+public:
+	// Writes the header; colourspace is 0 for sRGB with linear alpha, 1 for all channels linear
+	QoiEncoder(std::vector<uint8_t>& out, uint32_t width, uint32_t height, uint8_t channels, uint8_t colourspace = 0);
+
+	void encode(const uint8_t* src, size_t pixels);
+	// Flushes a pending run and appends the end marker; call once after the last pixel
+	void finish();
+
+private:
+	template <size_t Channels>
+	void encodePixels(const uint8_t* src, size_t pixels);
+
+	std::vector<uint8_t>& out;
+	uint8_t* cursor;
+	uint8_t channels;
+	uint32_t pixel{ 0xFF000000 };
+	uint32_t index[64]{};
+	uint32_t run{ 0 };
+};
+
+}
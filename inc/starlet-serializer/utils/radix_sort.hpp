@@ -0,0 +1,65 @@
+#pragma once
+
+#include "parallel.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace Starlet::Serializer::Utils {
+
+// Stable LSD radix sort of (key, value) pairs on the low keyBits bits of the keys, 11 bits per
+// pass. Each pass counts digits per chunk in parallel, then scatters every chunk to its own
+// precomputed offsets, so the result does not depend on the number of threads.
+inline void radixSortPairs(std::vector<uint64_t>& keys, std::vector<uint32_t>& values, unsigned int keyBits) {
+	constexpr unsigned int RADIX_BITS = 11;
+	constexpr size_t BUCKETS = size_t{ 1 } << RADIX_BITS;
+	constexpr size_t RADIX_GRAIN = 64 * 1024;
+
+	const size_t count = keys.size();
+	if (count < 2 || keyBits == 0) return;
+
+	const size_t chunks = chunkCount(count, RADIX_GRAIN);
+	std::vector<uint64_t> keysOut(count);
+	std::vector<uint32_t> valuesOut(count);
+	std::vector<size_t> histogram(chunks * BUCKETS);
+
+	for (unsigned int shift = 0; shift < keyBits; shift += RADIX_BITS) {
+		std::fill(histogram.begin(), histogram.end(), 0);
+		parallelForChunks(count, RADIX_GRAIN, [&](size_t chunk, size_t begin, size_t end) {
+			size_t* row = &histogram[chunk * BUCKETS];
+			for (size_t i = begin; i < end; ++i) ++row[(keys[i] >> shift) & (BUCKETS - 1)];
+		});
+
+		size_t offset = 0;
+		for (size_t bucket = 0; bucket < BUCKETS; ++bucket) {
+			for (size_t chunk = 0; chunk < chunks; ++chunk) {
+				const size_t n = histogram[chunk * BUCKETS + bucket];
+				histogram[chunk * BUCKETS + bucket] = offset;
+				offset += n;
+			}
+		}
+
+		parallelForChunks(count, RADIX_GRAIN, [&](size_t chunk, size_t begin, size_t end) {
+			size_t* row = &histogram[chunk * BUCKETS];
+			for (size_t i = begin; i < end; ++i) {
+				const size_t target = row[(keys[i] >> shift) & (BUCKETS - 1)]++;
+				keysOut[target] = keys[i];
+				valuesOut[target] = values[i];
+			}
+		});
+		keys.swap(keysOut);
+		values.swap(valuesOut);
+	}
+}
+
+// Number of bits needed to store values in [0, maxValue]
+inline unsigned int bitWidth(uint64_t maxValue) {
+	unsigned int bits = 0;
+	while (maxValue) {
+		++bits;
+		maxValue >>= 1;
+	}
+	return bits;
+}
+
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "starlet-math/vec3.hpp"
+
+#include <cmath>
+
+namespace Starlet::Serializer::Utils {
+
+inline Math::Vec3<float> add(const Math::Vec3<float>& a, const Math::Vec3<float>& b) {
+	return { a.x + b.x, a.y + b.y, a.z + b.z };
+}
+inline Math::Vec3<float> sub(const Math::Vec3<float>& a, const Math::Vec3<float>& b) {
+	return { a.x - b.x, a.y - b.y, a.z - b.z };
+}
+inline Math::Vec3<float> scale(const Math::Vec3<float>& a, float s) {
+	return { a.x * s, a.y * s, a.z * s };
+}
+
+inline float dot(const Math::Vec3<float>& a, const Math::Vec3<float>& b) {
+	return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+inline Math::Vec3<float> cross(const Math::Vec3<float>& a, const Math::Vec3<float>& b) {
+	return { a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x };
+}
+
+inline float length(const Math::Vec3<float>& a) {
+	return std::sqrt(dot(a, a));
+}
+inline Math::Vec3<float> normalize(const Math::Vec3<float>& a) {
+	const float len = length(a);
+	if (len <= 0.0f) return { 0.0f, 0.0f, 0.0f };
+	return scale(a, 1.0f / len);
+}
+
+}
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "starlet-serializer/data/image_data.hpp"
+
 #include <string>
 #include <vector>
 #include <fstream>
@@ -16,13 +18,38 @@ do { \
 } while(0)
 #endif
 
+namespace Utils {
+	class ByteWriter;
+}
+
 struct SceneData;
 struct TransformData;
 struct ModelData;
+struct MeshData;
+struct MeshletData;
+struct BvhData;
+struct CollisionData;
+struct MeshCacheData;
+
+struct ImageWriteOptions {
+	// Container to emit; UNKNOWN picks it from the path's extension (.bmp, .tga, .qoi)
+	ImageFormat format{ ImageFormat::UNKNOWN };
+
+	// TGA only: run-length encode each row (image types 10/11)
+	bool rle{ false };
+};
 
 class Writer {
 public:
 	bool writeScene(const SceneData& data, const std::string& path);
+	bool writeMeshCache(const MeshCacheData& data, const std::string& path);
+
+	// BMP (24-bit, 32-bit BGRA bitfields, or 8-bit grey palette for R8), TGA (true-colour or
+	// greyscale, optionally RLE) or QOI from any PixelFormat and row order. Rows are converted
+	// straight into one output buffer, which is written with a single call.
+	bool writeImage(const ImageData& data, const std::string& path, const ImageWriteOptions& options = {});
+	// Same encoding into memory; options.format must name the container
+	bool encodeImage(const ImageData& data, std::vector<unsigned char>& out, const ImageWriteOptions& options);
 
 private:
 	bool writeCameras(std::ostream& file, const SceneData& data);
@@ -37,6 +64,18 @@ private:
 
 	bool writeTransform(std::ostream& file, const TransformData& transform, bool includeSize = true);
 	bool writeColourMode(std::ostream& file, const ModelData& model);
+
+	void writeMeshChunk(Utils::ByteWriter& out, const MeshData& mesh);
+	void writeCompressedMeshChunk(Utils::ByteWriter& out, const std::vector<unsigned char>& vertices, const std::vector<unsigned int>& meshIndices);
+	void writeMeshletChunk(Utils::ByteWriter& out, const MeshletData& meshlets);
+	void writeBvhChunk(Utils::ByteWriter& out, const BvhData& bvh);
+	void writeCollisionChunk(Utils::ByteWriter& out, const CollisionData& collision);
+
+	bool validateImage(const ImageData& data);
+	bool encodeBmp(const ImageData& data, std::vector<unsigned char>& out);
+	bool encodeTga(const ImageData& data, std::vector<unsigned char>& out, bool rle);
+	void encodeQoi(const ImageData& data, std::vector<unsigned char>& out);
+	bool writeBinaryFile(const std::vector<unsigned char>& data, const std::string& path);
 };
 
 }
\ No newline at end of file
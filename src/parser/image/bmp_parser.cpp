@@ -1,46 +1,91 @@
 #include "starlet-serializer/parser/image/bmp_parser.hpp"
 #include "starlet-serializer/data/image_data.hpp"
+#include "starlet-serializer/utils/pixel_swizzle.hpp"
 
 #include "starlet-logger/logger.hpp"
 
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
 namespace Starlet::Serializer {
 
 namespace {
 	constexpr size_t BMP_HEADER_SIZE = 54;
+	constexpr size_t BMP_PROBE_SIZE = 70; // File header plus a V4/V5 DIB header up to the alpha mask
 	constexpr uint16_t BMP_SIGNATURE = 0x4D42; // "BM"
 	constexpr uint16_t BMP_PLANES_EXPECTED = 1;
-	constexpr uint16_t BMP_BPP_24 = 24;
 	constexpr uint32_t BMP_COMPRESSION_NONE = 0;
+	constexpr uint32_t BMP_COMPRESSION_RLE8 = 1;
+	constexpr uint32_t BMP_COMPRESSION_RLE4 = 2;
+	constexpr uint32_t BMP_COMPRESSION_BITFIELDS = 3;
+	constexpr uint32_t BMP_COMPRESSION_ALPHABITFIELDS = 6;
 	constexpr uint32_t BMP_DIB_HEADER_SIZE_MIN = 40;
-}
+	constexpr uint32_t BMP_DIB_HEADER_SIZE_V3 = 56; // First header with an alpha mask
+	constexpr size_t BMP_MASKS_OFFSET = 54;
+	constexpr uint32_t BMP_BGRA_MASKS[4] = { 0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000 };
+	constexpr uint32_t BMP_BGRX_MASKS[4] = { 0x00FF0000, 0x0000FF00, 0x000000FF, 0 };
+	constexpr uint32_t BMP_555_MASKS[4] = { 0x7C00, 0x03E0, 0x001F, 0 };
 
-bool BmpParser::parse(const std::string& path, ImageData& out) {
-	clearImageData(out);
+	// One mask channel: extract, then scale to 8 bits through a lookup table
+	struct MaskChannel {
+		uint32_t mask{ 0 }, shift{ 0 }, drop{ 0 };
+		uint8_t scale[256]{};
 
-	std::optional<std::vector<unsigned char>> file = loadImageData(path);
-	if (!file.has_value()) return false;
+		explicit MaskChannel(uint32_t m) : mask(m) {
+			if (m == 0) return;
+			shift = static_cast<uint32_t>(std::countr_zero(m));
+			const uint32_t bits = static_cast<uint32_t>(std::popcount(m));
+			drop = bits > 8 ? bits - 8 : 0;
+			const uint32_t max = (1u << (bits - drop)) - 1;
+			for (uint32_t i = 0; i <= max; ++i) scale[i] = static_cast<uint8_t>((i * 255 + max / 2) / max);
+		}
 
-	const unsigned char* p = file->data();
-	uint32_t width{ 0 };
-	int32_t  height{ 0 };
-	uint32_t dataOffset{ 0 };
+		uint8_t operator()(uint32_t v) const { return scale[((v & mask) >> shift) >> drop]; }
+	};
 
-	if (!parseHeader(p, file->size(), width, height, dataOffset))
-		return false;
+	// Stored 16/32-bit pixels to BGR8 or BGRA8; a missing alpha mask reads as opaque
+	void unpackMasked(const unsigned char* src, uint32_t width, uint16_t bpp, const MaskChannel* channels, unsigned char* dst, size_t dstPixelSize) {
+		const size_t srcPixelSize = bpp / 8u;
+		const bool hasAlpha = channels[3].mask != 0;
+		for (uint32_t i = 0; i < width; ++i, src += srcPixelSize, dst += dstPixelSize) {
+			uint32_t v = static_cast<uint32_t>(src[0]) | (static_cast<uint32_t>(src[1]) << 8);
+			if (srcPixelSize == 4) v |= (static_cast<uint32_t>(src[2]) << 16) | (static_cast<uint32_t>(src[3]) << 24);
+			dst[0] = channels[2](v);
+			dst[1] = channels[1](v);
+			dst[2] = channels[0](v);
+			if (dstPixelSize == 4) dst[3] = hasAlpha ? channels[3](v) : 255;
+		}
+	}
 
-	const bool bottomUp = (height > 0);
-	const uint32_t absHeight = static_cast<uint32_t>(bottomUp ? height : -height);
+	template <size_t N>
+	void copyChunks(const unsigned char* src, uint32_t count, const unsigned char* table, unsigned char* dst) {
+		for (uint32_t i = 0; i < count; ++i, dst += N) std::memcpy(dst, table + src[i] * N, N);
+	}
 
-	if (!allocatePixelBuffer(out, width, absHeight)) 
-		return false;
+	// Each index byte looks up a table entry holding all the pixels it packs, already in the output format
+	void expandIndices(const unsigned char* src, uint32_t width, uint32_t indexBits, const unsigned char* table, size_t pixelSize, unsigned char* dst) {
+		const uint32_t perByte = 8 / indexBits;
+		const size_t chunk = perByte * pixelSize;
+		const uint32_t whole = width / perByte;
+		switch (chunk) {
+		case 1:  copyChunks<1>(src, whole, table, dst); break;
+		case 3:  copyChunks<3>(src, whole, table, dst); break;
+		case 4:  copyChunks<4>(src, whole, table, dst); break;
+		default:
+			for (uint32_t i = 0; i < whole; ++i) std::memcpy(dst + i * chunk, table + src[i] * chunk, chunk);
+		}
 
-	if (!copyPixelData(p, file->size(), dataOffset, out, width, absHeight, bottomUp))
-		return false;
+		const uint32_t tail = width % perByte;
+		if (tail) std::memcpy(dst + whole * chunk, table + src[whole] * chunk, tail * pixelSize);
+	}
+}
 
-	return true;
+size_t BmpParser::headerSize() const {
+	return BMP_PROBE_SIZE;
 }
 
-bool BmpParser::parseHeader(const unsigned char* p, size_t fileSize, uint32_t& width, int32_t& height, uint32_t& dataOffset) {
+bool BmpParser::parseHeader(const unsigned char* p, size_t fileSize, ImageInfo& info, uint32_t& dataOffset) {
 	if (!validateFileSignature(p, fileSize)) return false;
 
 	dataOffset = readUint32(p, 10);
@@ -51,20 +96,56 @@ bool BmpParser::parseHeader(const unsigned char* p, size_t fileSize, uint32_t& w
 	uint32_t dibSize = readUint32(p, 14);
 	if (dibSize < BMP_DIB_HEADER_SIZE_MIN) return Logger::error("BmpParser", "parseHeader", "Unsupported DIB header size: " + std::to_string(dibSize));
 
-	width = readUint32(p, 18);
-	height = static_cast<int32_t>(readUint32(p, 22));
+	const uint32_t width = readUint32(p, 18);
+	const int32_t height = static_cast<int32_t>(readUint32(p, 22));
 	const uint32_t absHeight = static_cast<uint32_t>(height > 0 ? height : -height);
 	if (!validateDimensions(width, absHeight)) return false;
 
 	uint16_t planes = readUint16(p, 26);
 	if (planes != BMP_PLANES_EXPECTED) return Logger::error("BmpParser", "parseHeader", "Planes != 1: " + std::to_string(planes));
 
-	uint16_t bpp = readUint16(p, 28);
-	if (bpp != BMP_BPP_24) return Logger::error("BmpParser", "parseHeader", "Only 24bpp supported: " + std::to_string(bpp));
+	layout = Layout{};
+	const uint16_t bpp = readUint16(p, 28);
+	if (bpp != 1 && bpp != 4 && bpp != 8 && bpp != 16 && bpp != 24 && bpp != 32)
+		return Logger::error("BmpParser", "parseHeader", "Unsupported BMP bits per pixel: " + std::to_string(bpp));
+	layout.bpp = bpp;
 
-	uint32_t compression = readUint32(p, 30);
-	if (compression != BMP_COMPRESSION_NONE) return Logger::error("BmpParser", "parseHeader", "Compressed BMP not supported: " + std::to_string(compression));
+	const uint32_t compression = readUint32(p, 30);
+	const bool validCompression = compression == BMP_COMPRESSION_NONE
+		|| (compression == BMP_COMPRESSION_RLE8 && bpp == 8)
+		|| (compression == BMP_COMPRESSION_RLE4 && bpp == 4)
+		|| ((compression == BMP_COMPRESSION_BITFIELDS || compression == BMP_COMPRESSION_ALPHABITFIELDS) && (bpp == 16 || bpp == 32));
+	if (!validCompression)
+		return Logger::error("BmpParser", "parseHeader", "Unsupported BMP compression " + std::to_string(compression) + " for " + std::to_string(bpp) + "bpp");
+	layout.compression = compression;
+
+	if (layout.isRle() && height < 0)
+		return Logger::error("BmpParser", "parseHeader", "Top-down RLE BMP is invalid");
+
+	if (!readMasks(p, fileSize, dibSize)) return false;
+
+	if (layout.isPalettized()) {
+		// Colours used, clamped to the index range and to what fits before the pixels
+		layout.paletteOffset = 14 + dibSize;
+		const uint32_t maxColours = 1u << bpp;
+		const uint32_t coloursUsed = readUint32(p, 46);
+		const uint32_t available = dataOffset > layout.paletteOffset ? (dataOffset - layout.paletteOffset) / 4 : 0;
+		layout.paletteSize = std::min({ coloursUsed == 0 ? maxColours : coloursUsed, maxColours, available });
+		if (layout.paletteSize == 0)
+			return Logger::error("BmpParser", "parseHeader", "Palettized BMP has no palette");
+	}
+
+	if (!layout.isRle()) {
+		const size_t needed = static_cast<size_t>(dataOffset) + rowStride(width) * absHeight;
+		if (needed > actualDataSize)
+			return Logger::error("BmpParser", "parseHeader", "File too small for declared dimensions: " + std::to_string(fileSize) + " bytes, need " + std::to_string(needed) + " bytes");
+	}
 
+	info.fileFormat = ImageFormat::BMP;
+	info.width = width;
+	info.height = absHeight;
+	info.sourceFormat = (bpp == 16 || bpp == 32) && layout.masks[3] != 0 ? PixelFormat::BGRA8 : PixelFormat::BGR8;
+	info.sourceBottomUp = height > 0;
 	return true;
 }
 
@@ -74,30 +155,188 @@ bool BmpParser::validateFileSignature(const unsigned char* p, size_t fileSize) c
 	if (fileSize < BMP_HEADER_SIZE) 
 		return Logger::error("BmpParser", "validateFileSignature", "File too small: " + std::to_string(fileSize) + " bytes");
 
-	if (p[0] != 'B' || p[1] != 'M') 
+	if (readUint16(p, 0) != BMP_SIGNATURE)
 		return Logger::error("BmpParser", "validateFileSignature", "Bad signature (not BM)");
 
 	return true;
 }
 
-bool BmpParser::copyPixelData(const unsigned char* p, size_t fileSize, uint32_t dataOffset, ImageData& out, uint32_t width, uint32_t height, bool bottomUp) const {
-	const size_t rowStridePadded = (static_cast<size_t>(width) * 3 + 3) & ~static_cast<size_t>(3);
-	const size_t needed = static_cast<size_t>(dataOffset) + rowStridePadded * static_cast<size_t>(height);
+// Bitfield masks sit inside V3+ DIB headers, or directly after a 40-byte one
+bool BmpParser::readMasks(const unsigned char* p, size_t fileSize, uint32_t dibSize) {
+	if (layout.compression == BMP_COMPRESSION_NONE) {
+		if      (layout.bpp == 16) std::memcpy(layout.masks, BMP_555_MASKS, sizeof(layout.masks));
+		else if (layout.bpp == 32) std::memcpy(layout.masks, BMP_BGRX_MASKS, sizeof(layout.masks));
+		return true;
+	}
+	if (layout.compression != BMP_COMPRESSION_BITFIELDS && layout.compression != BMP_COMPRESSION_ALPHABITFIELDS)
+		return true;
 
-	const size_t actualDataSize = fileSize > 0 ? fileSize - 1 : 0;
-	if (needed > actualDataSize)
-		return Logger::error("BmpParser", "copyPixelData", "File too small for declared dimensions: " + std::to_string(fileSize) + " bytes, need " + std::to_string(needed) + " bytes");
+	const bool hasAlphaMask = layout.compression == BMP_COMPRESSION_ALPHABITFIELDS || dibSize >= BMP_DIB_HEADER_SIZE_V3;
+	const size_t maskCount = hasAlphaMask ? 4 : 3;
+	if (BMP_MASKS_OFFSET + maskCount * 4 > fileSize - 1)
+		return Logger::error("BmpParser", "readMasks", "File too small for colour masks");
+
+	for (size_t i = 0; i < maskCount; ++i) layout.masks[i] = readUint32(p, BMP_MASKS_OFFSET + i * 4);
+	if (layout.bpp == 16)
+		for (uint32_t& mask : layout.masks) mask &= 0xFFFF;
+
+	if ((layout.masks[0] | layout.masks[1] | layout.masks[2]) == 0)
+		return Logger::error("BmpParser", "readMasks", "BMP colour masks are all zero");
 
+	// MaskChannel scales a channel by its bit count, which only bounds its value when the bits are adjacent
+	for (size_t i = 0; i < maskCount; ++i) {
+		const uint32_t mask = layout.masks[i];
+		const uint32_t shifted = mask == 0 ? 0 : mask >> std::countr_zero(mask);
+		if ((shifted & (shifted + 1)) != 0)
+			return Logger::error("BmpParser", "readMasks", "BMP colour mask " + std::to_string(i) + " is not contiguous: " + std::to_string(mask));
+	}
+	return true;
+}
+
+bool BmpParser::copyPixelData(const unsigned char* p, size_t fileSize, uint32_t dataOffset, const ImageInfo& info, unsigned char* dst, size_t rowPitch) const {
+	const size_t srcStride = rowStride(info.width);
 	const unsigned char* srcPixels = p + dataOffset;
+	const bool flipRows = info.sourceBottomUp != info.bottomUp;
+	auto dstRow = [&](uint32_t row) { return dst + rowPitch * (flipRows ? (info.height - 1 - row) : row); };
+
+	if (isDirectColour() && !flipRows && info.format == info.sourceFormat && srcStride == info.rowSize && rowPitch == info.rowSize) {
+		std::memcpy(dst, srcPixels, info.byteSize);
+		return true;
+	}
 
-	for (uint32_t row = 0; row < height; ++row) {
-		const uint32_t srcRow = bottomUp ? (height - 1 - row) : row;
-		const unsigned char* src = srcPixels + rowStridePadded * static_cast<size_t>(srcRow);
-		unsigned char* dst = out.pixels.data() + static_cast<size_t>(row) * static_cast<size_t>(width) * 3;
+	if (layout.isPalettized()) {
+		// RLE expands to one index byte per pixel first; fileSize counts the terminator loadBinaryFile appends
+		std::vector<unsigned char> indices;
+		if (layout.isRle() && !decodeRle(srcPixels, p + fileSize - 1, info, indices))
+			return false;
+
+		const uint32_t indexBits = layout.isRle() ? 8u : layout.bpp;
+		const unsigned char* indexRows = layout.isRle() ? indices.data() : srcPixels;
+		const size_t indexStride = layout.isRle() ? info.width : srcStride;
+
+		std::vector<unsigned char> table;
+		buildPaletteTable(p, info.format, indexBits, table);
+		const size_t pixelSize = pixelFormatSize(info.format);
+		for (uint32_t row = 0; row < info.height; ++row)
+			expandIndices(indexRows + indexStride * row, info.width, indexBits, table.data(), pixelSize, dstRow(row));
+		return true;
+	}
 
-		convertBgrToRgb(src, dst, width);
+	if (isDirectColour()) {
+		for (uint32_t row = 0; row < info.height; ++row)
+			Utils::convertPixels(srcPixels + srcStride * row, info.sourceFormat, dstRow(row), info.format, info.width);
+		return true;
 	}
 
+	// BGRX rows convert as BGRA, then any alpha the output keeps is forced opaque
+	if (isBgrx()) {
+		const bool hasAlpha = pixelFormatSize(info.format) == 4;
+		for (uint32_t row = 0; row < info.height; ++row) {
+			unsigned char* target = dstRow(row);
+			Utils::convertPixels(srcPixels + srcStride * row, PixelFormat::BGRA8, target, info.format, info.width);
+			if (hasAlpha)
+				for (uint32_t i = 0; i < info.width; ++i) target[i * 4 + 3] = 255;
+		}
+		return true;
+	}
+
+	// 16-bit and non-standard 32-bit masks unpack through per-channel scale tables
+	const MaskChannel channels[4] = { MaskChannel(layout.masks[0]), MaskChannel(layout.masks[1]), MaskChannel(layout.masks[2]), MaskChannel(layout.masks[3]) };
+	const bool toSource = info.format == info.sourceFormat;
+	const size_t sourceSize = pixelFormatSize(info.sourceFormat);
+	std::vector<unsigned char> scratch(toSource ? 0 : static_cast<size_t>(info.width) * sourceSize);
+	for (uint32_t row = 0; row < info.height; ++row) {
+		unsigned char* target = toSource ? dstRow(row) : scratch.data();
+		unpackMasked(srcPixels + srcStride * row, info.width, layout.bpp, channels, target, sourceSize);
+		if (!toSource) Utils::convertPixels(target, info.sourceFormat, dstRow(row), info.format, info.width);
+	}
+	return true;
+}
+
+bool BmpParser::isStoredLayout(const ImageInfo& info) const {
+	return isDirectColour() && info.sourceBottomUp == info.bottomUp && info.format == info.sourceFormat && rowStride(info.width) == info.rowSize;
+}
+
+bool BmpParser::isDirectColour() const {
+	if (layout.bpp == 24) return true;
+	return layout.bpp == 32 && std::memcmp(layout.masks, BMP_BGRA_MASKS, sizeof(layout.masks)) == 0;
+}
+
+bool BmpParser::isBgrx() const {
+	return layout.bpp == 32 && std::memcmp(layout.masks, BMP_BGRX_MASKS, sizeof(layout.masks)) == 0;
+}
+
+size_t BmpParser::rowStride(uint32_t width) const {
+	// Rows are padded to 4 bytes
+	return ((static_cast<size_t>(width) * layout.bpp + 31) / 32) * 4;
+}
+
+// Palette converted once to the output format, then spread into a 256-entry table keyed by index
+// byte so 1/4-bit rows expand 8 or 2 pixels per lookup
+void BmpParser::buildPaletteTable(const unsigned char* p, PixelFormat format, uint32_t indexBits, std::vector<unsigned char>& table) const {
+	unsigned char palette[256 * 3]{};
+	const unsigned char* entry = p + layout.paletteOffset;
+	for (uint32_t i = 0; i < layout.paletteSize; ++i, entry += 4) std::memcpy(palette + i * 3, entry, 3);
+
+	const size_t pixelSize = pixelFormatSize(format);
+	std::vector<unsigned char> converted(256 * pixelSize);
+	Utils::convertPixels(palette, PixelFormat::BGR8, converted.data(), format, 256);
+
+	const uint32_t perByte = 8 / indexBits;
+	const uint32_t indexMask = (1u << indexBits) - 1;
+	table.resize(256 * perByte * pixelSize);
+	unsigned char* out = table.data();
+	for (uint32_t byte = 0; byte < 256; ++byte) {
+		for (uint32_t k = 0; k < perByte; ++k, out += pixelSize) {
+			const uint32_t index = (byte >> (8 - indexBits * (k + 1))) & indexMask;
+			std::memcpy(out, converted.data() + index * pixelSize, pixelSize);
+		}
+	}
+}
+
+// Pixels skipped by deltas, early line ends or a missing end-of-bitmap keep palette index 0
+bool BmpParser::decodeRle(const unsigned char* src, const unsigned char* end, const ImageInfo& info, std::vector<unsigned char>& indices) const {
+	const uint32_t width = info.width;
+	const bool rle4 = layout.compression == BMP_COMPRESSION_RLE4;
+	indices.assign(static_cast<size_t>(width) * info.height, 0);
+
+	uint32_t x = 0, y = 0;
+	while (y < info.height && end - src >= 2) {
+		const uint8_t count = src[0];
+		const uint8_t value = src[1];
+		src += 2;
+		unsigned char* row = indices.data() + static_cast<size_t>(y) * width;
+
+		if (count > 0) {
+			const uint32_t n = count < width - x ? count : width - x;
+			if (!rle4) std::memset(row + x, value, n);
+			else for (uint32_t i = 0; i < n; ++i) row[x + i] = (i & 1) ? (value & 0x0F) : (value >> 4);
+			x += n;
+			continue;
+		}
+
+		if (value == 0) { x = 0; ++y; continue; }
+		if (value == 1) return true;
+		if (value == 2) {
+			if (end - src < 2) return Logger::error("BmpParser", "decodeRle", "Truncated RLE data at row " + std::to_string(y));
+			x += src[0];
+			y += src[1];
+			src += 2;
+			if (x > width) x = width;
+			continue;
+		}
+
+		// Absolute run of `value` indices, padded to a 16-bit boundary
+		const size_t bytes = rle4 ? (value + 1u) / 2 : value;
+		if (static_cast<size_t>(end - src) < bytes)
+			return Logger::error("BmpParser", "decodeRle", "Truncated RLE data at row " + std::to_string(y));
+
+		const uint32_t n = value < width - x ? value : width - x;
+		if (!rle4) std::memcpy(row + x, src, n);
+		else for (uint32_t i = 0; i < n; ++i) row[x + i] = (i & 1) ? (src[i / 2] & 0x0F) : (src[i / 2] >> 4);
+		x += n;
+		src += std::min((bytes + 1) & ~static_cast<size_t>(1), static_cast<size_t>(end - src));
+	}
 	return true;
 }
 
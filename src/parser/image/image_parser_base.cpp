@@ -3,10 +3,88 @@
 
 #include "starlet-logger/logger.hpp"
 
+#include <cstring>
+
 namespace Starlet::Serializer {
 
+bool ImageParserBase::parse(const std::string& path, ImageData& out) {
+	return parse(path, out, ImageParseOptions{});
+}
+
+bool ImageParserBase::parse(const std::string& path, ImageData& out, const ImageParseOptions& options) {
+	clearImageData(out);
+
+	std::optional<std::vector<unsigned char>> file = loadImageData(path);
+	if (!file.has_value()) return false;
+
+	ImageInfo info;
+	uint32_t dataOffset{ 0 };
+	if (!readHeader(file->data(), file->size(), options, info, dataOffset))
+		return false;
+
+	setPixelLayout(out, info);
+	if (isStoredLayout(info)) {
+		adoptPixelData(*file, dataOffset, out);
+		return true;
+	}
+
+	if (!allocatePixelBuffer(out))
+		return false;
+
+	return copyPixelData(file->data(), file->size(), dataOffset, info, out.pixels.data(), info.rowSize);
+}
+
+bool ImageParserBase::probe(const std::string& path, ImageInfo& out, const ImageParseOptions& options) {
+	out = ImageInfo{};
+
+	std::vector<unsigned char> header;
+	size_t fileSize{ 0 };
+	size_t prefix = headerSize();
+	if (!loadBinaryFilePrefix(header, path, prefix, fileSize)) return false;
+	if (fileSize == 0) return Logger::error("ImageParserBase", "probe", "File is empty");
+
+	// Headers that span chunks grow the prefix until parseHeader has every byte it reads
+	size_t needed = probeSize(header.data(), header.size() - 1);
+	while (needed > prefix && prefix < fileSize) {
+		prefix = needed;
+		if (!loadBinaryFilePrefix(header, path, prefix, fileSize)) return false;
+		needed = probeSize(header.data(), header.size() - 1);
+	}
+
+	// Sizes passed to parseHeader count the terminator loadBinaryFile appends
+	uint32_t dataOffset{ 0 };
+	return readHeader(header.data(), fileSize + 1, options, out, dataOffset);
+}
+
+bool ImageParserBase::decode(const std::string& path, unsigned char* dst, size_t dstSize, size_t rowPitch, const ImageParseOptions& options) {
+	if (!dst) return Logger::error("ImageParserBase", "decode", "Null destination buffer");
+
+	std::optional<std::vector<unsigned char>> file = loadImageData(path);
+	if (!file.has_value()) return false;
+
+	ImageInfo info;
+	uint32_t dataOffset{ 0 };
+	if (!readHeader(file->data(), file->size(), options, info, dataOffset))
+		return false;
+
+	if (rowPitch < info.rowSize)
+		return Logger::error("ImageParserBase", "decode", "Row pitch too small: " + std::to_string(rowPitch) + " bytes, need " + std::to_string(info.rowSize) + " bytes");
+
+	const size_t needed = rowPitch * (info.height - 1) + info.rowSize;
+	if (dstSize < needed)
+		return Logger::error("ImageParserBase", "decode", "Destination buffer too small: " + std::to_string(dstSize) + " bytes, need " + std::to_string(needed) + " bytes");
+
+	return copyPixelData(file->data(), file->size(), dataOffset, info, dst, rowPitch);
+}
+
+size_t ImageParserBase::probeSize(const unsigned char*, size_t) const {
+	return headerSize();
+}
+
 void ImageParserBase::clearImageData(ImageData& data) const {
 	data.pixels.clear();
+	data.format = PixelFormat::Unknown;
+	data.bottomUp = false;
 	data.byteSize = data.pixelSize = 0;
 	data.width = data.height = 0;
 }
@@ -43,11 +121,32 @@ uint16_t ImageParserBase::readUint16(const unsigned char* p, size_t offset) cons
 		  | (static_cast<uint16_t>(p[offset + 1]) << 8);
 }
 
-bool ImageParserBase::allocatePixelBuffer(ImageData& out, uint32_t width, uint32_t height) const {
-	out.width = width;
-	out.height = height;
-	out.pixelSize = 3;
-	out.byteSize = static_cast<size_t>(width) * static_cast<size_t>(height) * out.pixelSize;
+bool ImageParserBase::readHeader(const unsigned char* p, size_t fileSize, const ImageParseOptions& options, ImageInfo& info, uint32_t& dataOffset) {
+	if (!parseHeader(p, fileSize, info, dataOffset))
+		return false;
+
+	if (options.nativeLayout)                     info.format = info.sourceFormat;
+	else if (options.format != PixelFormat::Unknown) info.format = options.format;
+	else info.format = pixelFormatSize(info.sourceFormat) == 4 ? PixelFormat::RGBA8 : PixelFormat::RGB8;
+	info.bottomUp = options.nativeLayout && info.sourceBottomUp;
+	if (pixelFormatSize(info.format) == 0)
+		return Logger::error("ImageParserBase", "readHeader", "Unsupported output pixel format");
+
+	info.rowSize = static_cast<size_t>(info.width) * pixelFormatSize(info.format);
+	info.byteSize = info.rowSize * info.height;
+	return true;
+}
+
+void ImageParserBase::setPixelLayout(ImageData& out, const ImageInfo& info) const {
+	out.width = static_cast<int32_t>(info.width);
+	out.height = static_cast<int32_t>(info.height);
+	out.format = info.format;
+	out.bottomUp = info.bottomUp;
+	out.pixelSize = pixelFormatSize(info.format);
+	out.byteSize = info.byteSize;
+}
+
+bool ImageParserBase::allocatePixelBuffer(ImageData& out) const {
 	out.pixels.resize(out.byteSize);
 
 	if (out.pixels.empty())
@@ -55,13 +154,13 @@ bool ImageParserBase::allocatePixelBuffer(ImageData& out, uint32_t width, uint32
 
 	return true;
 }
-void ImageParserBase::convertBgrToRgb(const unsigned char* src, unsigned char* dst, uint32_t width) const {
-	for (uint32_t col = 0; col < width; ++col) {
-		const size_t offset = static_cast<size_t>(col) * 3;
-		dst[offset + 0] = src[offset + 2];
-		dst[offset + 1] = src[offset + 1];
-		dst[offset + 2] = src[offset + 0];
-	}
+
+// The file's pixel block already matches the output layout: move it to the front of the loaded
+// buffer and hand that buffer over, instead of copying into a second allocation
+void ImageParserBase::adoptPixelData(std::vector<unsigned char>& file, size_t offset, ImageData& out) const {
+	if (offset > 0) std::memmove(file.data(), file.data() + offset, out.byteSize);
+	file.resize(out.byteSize);
+	out.pixels = std::move(file);
 }
 
 }
\ No newline at end of file
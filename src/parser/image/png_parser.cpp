@@ -0,0 +1,335 @@
+#include "starlet-serializer/parser/image/png_parser.hpp"
+#include "starlet-serializer/data/image_data.hpp"
+#include "starlet-serializer/utils/inflate.hpp"
+#include "starlet-serializer/utils/pixel_swizzle.hpp"
+#include "starlet-serializer/utils/png_filter.hpp"
+
+#include "starlet-logger/logger.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace Starlet::Serializer {
+
+namespace {
+	constexpr size_t PNG_SIGNATURE_SIZE = 8;
+	constexpr size_t PNG_HEADER_SIZE = 33; // Signature plus the IHDR chunk
+	constexpr size_t PNG_CHUNK_OVERHEAD = 12; // Length, type and CRC
+	constexpr uint32_t PNG_IHDR_SIZE = 13;
+	constexpr unsigned char PNG_SIGNATURE[PNG_SIGNATURE_SIZE] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+
+	constexpr uint8_t PNG_COLOUR_GREY = 0;
+	constexpr uint8_t PNG_COLOUR_RGB = 2;
+	constexpr uint8_t PNG_COLOUR_PALETTE = 3;
+	constexpr uint8_t PNG_COLOUR_GREY_ALPHA = 4;
+	constexpr uint8_t PNG_COLOUR_RGBA = 6;
+
+	// Adam7 passes: first column, first row, column step, row step
+	constexpr uint32_t ADAM7[7][4] = { { 0, 0, 8, 8 }, { 4, 0, 8, 8 }, { 0, 4, 4, 8 }, { 2, 0, 4, 4 }, { 0, 2, 2, 4 }, { 1, 0, 2, 2 }, { 0, 1, 1, 2 } };
+
+	uint32_t readBe32(const unsigned char* p) {
+		return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) | (static_cast<uint32_t>(p[2]) << 8) | p[3];
+	}
+
+	struct Pass {
+		uint32_t x0, y0, dx, dy, width, height;
+	};
+
+	Pass passGeometry(uint32_t pass, uint32_t width, uint32_t height, bool interlaced) {
+		if (!interlaced) return { 0, 0, 1, 1, width, height };
+		const uint32_t* a = ADAM7[pass];
+		const uint32_t w = width > a[0] ? (width - a[0] + a[2] - 1) / a[2] : 0;
+		const uint32_t h = height > a[1] ? (height - a[1] + a[3] - 1) / a[3] : 0;
+		return { a[0], a[1], a[2], a[3], w, h };
+	}
+
+	bool isValidDepth(uint8_t colourType, uint8_t depth) {
+		switch (colourType) {
+		case PNG_COLOUR_GREY:    return depth == 1 || depth == 2 || depth == 4 || depth == 8 || depth == 16;
+		case PNG_COLOUR_PALETTE: return depth == 1 || depth == 2 || depth == 4 || depth == 8;
+		default:                 return depth == 8 || depth == 16;
+		}
+	}
+}
+
+uint32_t PngParser::Layout::channels() const {
+	switch (colourType) {
+	case PNG_COLOUR_RGB:        return 3;
+	case PNG_COLOUR_GREY_ALPHA: return 2;
+	case PNG_COLOUR_RGBA:       return 4;
+	default:                    return 1;
+	}
+}
+
+PixelFormat PngParser::Layout::rowFormat() const {
+	return colourType == PNG_COLOUR_GREY ? PixelFormat::R8 : colourType == PNG_COLOUR_RGB ? PixelFormat::RGB8 : PixelFormat::RGBA8;
+}
+
+size_t PngParser::headerSize() const {
+	return PNG_HEADER_SIZE;
+}
+
+// tRNS precedes the first IDAT, so the prefix up to that chunk's header is all parseHeader reads
+size_t PngParser::probeSize(const unsigned char* p, size_t available) const {
+	if (available < PNG_HEADER_SIZE || std::memcmp(p, PNG_SIGNATURE, PNG_SIGNATURE_SIZE) != 0)
+		return PNG_HEADER_SIZE;
+
+	size_t offset = PNG_HEADER_SIZE;
+	while (offset + 8 <= available) {
+		if (std::memcmp(p + offset + 4, "IDAT", 4) == 0 || std::memcmp(p + offset + 4, "IEND", 4) == 0) break;
+		offset += PNG_CHUNK_OVERHEAD + readBe32(p + offset);
+	}
+	return offset + 8;
+}
+
+bool PngParser::parseHeader(const unsigned char* p, size_t fileSize, ImageInfo& info, uint32_t& dataOffset) {
+	if (!validateFileSignature(p, fileSize)) return false;
+
+	const uint32_t width = readBe32(p + 16);
+	const uint32_t height = readBe32(p + 20);
+	if (!validateDimensions(width, height)) return false;
+
+	const uint8_t bitDepth = p[24], colourType = p[25], compression = p[26], filter = p[27], interlace = p[28];
+	if (colourType != PNG_COLOUR_GREY && colourType != PNG_COLOUR_RGB && colourType != PNG_COLOUR_PALETTE
+		&& colourType != PNG_COLOUR_GREY_ALPHA && colourType != PNG_COLOUR_RGBA)
+		return Logger::error("PngParser", "parseHeader", "Unsupported PNG colour type: " + std::to_string(colourType));
+	if (!isValidDepth(colourType, bitDepth))
+		return Logger::error("PngParser", "parseHeader", "Unsupported PNG bit depth " + std::to_string(bitDepth) + " for colour type " + std::to_string(colourType));
+	if (compression != 0 || filter != 0)
+		return Logger::error("PngParser", "parseHeader", "Unsupported PNG compression or filter method");
+	if (interlace > 1)
+		return Logger::error("PngParser", "parseHeader", "Unsupported PNG interlace method: " + std::to_string(interlace));
+
+	layout = Layout{ bitDepth, colourType, interlace == 1 };
+	dataOffset = static_cast<uint32_t>(PNG_HEADER_SIZE);
+
+	info.fileFormat = ImageFormat::PNG;
+	info.width = width;
+	info.height = height;
+	// A colour key is alpha the default output must keep, so keyed grey and RGB report RGBA8
+	info.sourceFormat = hasColourKey(p, fileSize) ? PixelFormat::RGBA8 : layout.rowFormat();
+	info.sourceBottomUp = false;
+	return true;
+}
+
+bool PngParser::validateFileSignature(const unsigned char* p, size_t fileSize) const {
+	if (!p)	return Logger::error("PngParser", "validateFileSignature", "Null buffer");
+
+	if (fileSize < PNG_HEADER_SIZE)
+		return Logger::error("PngParser", "validateFileSignature", "File too small: " + std::to_string(fileSize) + " bytes");
+
+	if (std::memcmp(p, PNG_SIGNATURE, PNG_SIGNATURE_SIZE) != 0)
+		return Logger::error("PngParser", "validateFileSignature", "Bad signature (not PNG)");
+
+	if (readBe32(p + 8) != PNG_IHDR_SIZE || std::memcmp(p + 12, "IHDR", 4) != 0)
+		return Logger::error("PngParser", "validateFileSignature", "Missing IHDR chunk");
+
+	return true;
+}
+
+bool PngParser::hasColourKey(const unsigned char* p, size_t fileSize) const {
+	const size_t samples = layout.colourType == PNG_COLOUR_GREY ? 1 : layout.colourType == PNG_COLOUR_RGB ? 3 : 0;
+	if (samples == 0) return false;
+
+	// fileSize counts the terminator loadBinaryFile appends
+	const size_t size = fileSize - 1;
+	for (size_t offset = PNG_HEADER_SIZE; offset + 8 <= size;) {
+		const size_t length = readBe32(p + offset);
+		const unsigned char* type = p + offset + 4;
+		if (std::memcmp(type, "IDAT", 4) == 0 || std::memcmp(type, "IEND", 4) == 0) break;
+		if (std::memcmp(type, "tRNS", 4) == 0) return length >= samples * 2;
+		offset += PNG_CHUNK_OVERHEAD + length;
+	}
+	return false;
+}
+
+bool PngParser::readChunks(const unsigned char* p, size_t fileSize, uint32_t dataOffset, Chunks& chunks) const {
+	// fileSize counts the terminator loadBinaryFile appends
+	const size_t size = fileSize - 1;
+	for (size_t offset = dataOffset; offset + PNG_CHUNK_OVERHEAD <= size;) {
+		const size_t length = readBe32(p + offset);
+		const unsigned char* type = p + offset + 4;
+		const unsigned char* data = p + offset + 8;
+		if (length > size - offset - PNG_CHUNK_OVERHEAD)
+			return Logger::error("PngParser", "readChunks", "Truncated chunk at offset " + std::to_string(offset));
+
+		if      (std::memcmp(type, "IDAT", 4) == 0) chunks.data.emplace_back(data, length);
+		else if (std::memcmp(type, "PLTE", 4) == 0) { chunks.palette = data; chunks.paletteSize = length / 3; }
+		else if (std::memcmp(type, "tRNS", 4) == 0) { chunks.transparency = data; chunks.transparencySize = length; }
+		else if (std::memcmp(type, "IEND", 4) == 0) break;
+		offset += PNG_CHUNK_OVERHEAD + length;
+	}
+
+	if (chunks.data.empty())
+		return Logger::error("PngParser", "readChunks", "No IDAT chunk");
+	if (layout.colourType == PNG_COLOUR_PALETTE && chunks.paletteSize == 0)
+		return Logger::error("PngParser", "readChunks", "Palette image has no PLTE chunk");
+	return true;
+}
+
+bool PngParser::copyPixelData(const unsigned char* p, size_t fileSize, uint32_t dataOffset, const ImageInfo& info, unsigned char* dst, size_t rowPitch) const {
+	Chunks chunks;
+	if (!readChunks(p, fileSize, dataOffset, chunks)) return false;
+
+	// The zlib stream may be split across IDAT chunks; only then does it need joining
+	std::vector<unsigned char> joined;
+	const unsigned char* stream = chunks.data[0].first;
+	size_t streamSize = chunks.data[0].second;
+	if (chunks.data.size() > 1) {
+		for (const auto& [data, length] : chunks.data) joined.insert(joined.end(), data, data + length);
+		stream = joined.data();
+		streamSize = joined.size();
+	}
+
+	const uint32_t passCount = layout.interlaced ? 7 : 1;
+	size_t filteredSize = 0;
+	for (uint32_t pass = 0; pass < passCount; ++pass) {
+		const Pass geometry = passGeometry(pass, info.width, info.height, layout.interlaced);
+		if (geometry.width > 0 && geometry.height > 0)
+			filteredSize += (1 + layout.rowBytes(geometry.width)) * geometry.height;
+	}
+
+	std::vector<unsigned char> filtered(filteredSize);
+	if (!Utils::inflateZlib(stream, streamSize, filtered.data(), filtered.size()))
+		return Logger::error("PngParser", "copyPixelData", "Corrupt or truncated image data");
+
+	unsigned char palette[256 * 4];
+	if (layout.colourType == PNG_COLOUR_PALETTE) buildPalette(chunks, palette);
+
+	// A colour key only matters when the output can hold alpha; keyed rows then expand to RGBA8
+	const size_t outputSize = pixelFormatSize(info.format);
+	uint16_t key[3];
+	const bool keyed = outputSize == 4 && readColourKey(chunks, key);
+	const PixelFormat rowFormat = keyed ? PixelFormat::RGBA8 : layout.rowFormat();
+
+	// Rows already in the source format go straight to conversion
+	const bool expand = keyed || layout.bitDepth != 8 || layout.colourType == PNG_COLOUR_PALETTE || layout.colourType == PNG_COLOUR_GREY_ALPHA;
+	const size_t filterDistance = std::max<size_t>(1, layout.channels() * layout.bitDepth / 8);
+	std::vector<unsigned char> expanded(expand ? static_cast<size_t>(info.width) * pixelFormatSize(rowFormat) : 0);
+	std::vector<unsigned char> converted(layout.interlaced ? static_cast<size_t>(info.width) * outputSize : 0);
+	std::vector<unsigned char> zeroRow(layout.rowBytes(info.width), 0);
+
+	unsigned char* row = filtered.data();
+	for (uint32_t pass = 0; pass < passCount; ++pass) {
+		const Pass geometry = passGeometry(pass, info.width, info.height, layout.interlaced);
+		if (geometry.width == 0 || geometry.height == 0) continue;
+
+		const size_t rowBytes = layout.rowBytes(geometry.width);
+		const unsigned char* prev = zeroRow.data();
+		for (uint32_t y = 0; y < geometry.height; ++y, row += rowBytes + 1) {
+			unsigned char* data = row + 1;
+			if (!Utils::unfilterRow(row[0], data, prev, rowBytes, filterDistance))
+				return Logger::error("PngParser", "copyPixelData", "Unknown filter type " + std::to_string(row[0]) + " in row " + std::to_string(y));
+			prev = data;
+
+			const unsigned char* src = data;
+			if (keyed) expandKeyedRow(data, geometry.width, key, expanded.data());
+			else if (expand) expandRow(data, geometry.width, palette, expanded.data());
+			if (expand) src = expanded.data();
+
+			unsigned char* dstRow = dst + rowPitch * (geometry.y0 + y * geometry.dy);
+			if (!layout.interlaced) {
+				Utils::convertPixels(src, rowFormat, dstRow, info.format, info.width);
+				continue;
+			}
+
+			// Interlaced rows convert whole, then scatter to every dx-th pixel
+			Utils::convertPixels(src, rowFormat, converted.data(), info.format, geometry.width);
+			for (uint32_t x = 0; x < geometry.width; ++x)
+				std::memcpy(dstRow + (geometry.x0 + x * geometry.dx) * outputSize, converted.data() + x * outputSize, outputSize);
+		}
+	}
+
+	return true;
+}
+
+bool PngParser::isStoredLayout(const ImageInfo&) const {
+	return false;
+}
+
+// RGBA entries, opaque unless tRNS gives alpha; indices past the palette read as opaque black
+void PngParser::buildPalette(const Chunks& chunks, unsigned char* palette) const {
+	for (size_t i = 0; i < 256; ++i) {
+		unsigned char* entry = palette + i * 4;
+		if (i < chunks.paletteSize) std::memcpy(entry, chunks.palette + i * 3, 3);
+		else entry[0] = entry[1] = entry[2] = 0;
+		entry[3] = i < chunks.transparencySize ? chunks.transparency[i] : 255;
+	}
+}
+
+bool PngParser::readColourKey(const Chunks& chunks, uint16_t (&key)[3]) const {
+	const size_t samples = layout.colourType == PNG_COLOUR_GREY ? 1 : layout.colourType == PNG_COLOUR_RGB ? 3 : 0;
+	if (samples == 0 || chunks.transparencySize < samples * 2) return false;
+
+	// Keys are stored as 16-bit values whatever the depth; only the low bitDepth bits are meaningful
+	const uint32_t mask = (1u << layout.bitDepth) - 1;
+	for (size_t c = 0; c < 3; ++c) {
+		const unsigned char* sample = chunks.transparency + (c < samples ? c : 0) * 2;
+		key[c] = static_cast<uint16_t>(((sample[0] << 8) | sample[1]) & mask);
+	}
+	return true;
+}
+
+void PngParser::expandRow(const unsigned char* src, uint32_t width, const unsigned char* palette, unsigned char* dst) const {
+	const uint32_t depth = layout.bitDepth;
+
+	if (depth < 8) {
+		// Packed samples, most significant bits first; grey scales up to the full 8-bit range
+		const uint32_t mask = (1u << depth) - 1;
+		const uint32_t scale = 255 / mask;
+		for (uint32_t i = 0; i < width; ++i) {
+			const size_t bit = static_cast<size_t>(i) * depth;
+			const uint32_t value = (src[bit >> 3] >> (8 - depth - (bit & 7))) & mask;
+			if (layout.colourType == PNG_COLOUR_PALETTE) std::memcpy(dst + i * 4, palette + value * 4, 4);
+			else dst[i] = static_cast<unsigned char>(value * scale);
+		}
+		return;
+	}
+
+	if (layout.colourType == PNG_COLOUR_PALETTE) {
+		for (uint32_t i = 0; i < width; ++i) std::memcpy(dst + i * 4, palette + src[i] * 4, 4);
+		return;
+	}
+
+	// 16-bit samples are big-endian; the output keeps only the high byte, truncating rather than
+	// rounding, which is within one 8-bit step of the exact value
+	const size_t step = depth / 8;
+	const uint32_t channels = layout.channels();
+	if (layout.colourType == PNG_COLOUR_GREY_ALPHA) {
+		for (uint32_t i = 0; i < width; ++i, src += 2 * step, dst += 4) {
+			dst[0] = dst[1] = dst[2] = src[0];
+			dst[3] = src[step];
+		}
+		return;
+	}
+	const size_t samples = static_cast<size_t>(width) * channels;
+	for (size_t i = 0; i < samples; ++i) dst[i] = src[i * step];
+}
+
+void PngParser::expandKeyedRow(const unsigned char* src, uint32_t width, const uint16_t (&key)[3], unsigned char* dst) const {
+	const uint32_t depth = layout.bitDepth;
+	const uint32_t channels = layout.channels();
+	const uint32_t mask = (1u << depth) - 1;
+	const uint32_t scale = depth < 8 ? 255 / mask : 1;
+
+	// Full-depth sample `index` of the row, and its 8-bit output value
+	const auto sample = [&](size_t index) -> uint32_t {
+		if (depth == 16) return (static_cast<uint32_t>(src[index * 2]) << 8) | src[index * 2 + 1];
+		if (depth == 8) return src[index];
+		const size_t bit = index * depth;
+		return (src[bit >> 3] >> (8 - depth - (bit & 7))) & mask;
+	};
+	const auto toByte = [&](uint32_t value) {
+		return static_cast<unsigned char>(depth == 16 ? value >> 8 : value * scale);
+	};
+
+	for (uint32_t i = 0; i < width; ++i, dst += 4) {
+		uint32_t values[3];
+		for (uint32_t c = 0; c < 3; ++c) values[c] = sample(static_cast<size_t>(i) * channels + (c < channels ? c : 0));
+		const bool transparent = values[0] == key[0] && values[1] == key[1] && values[2] == key[2];
+		for (uint32_t c = 0; c < 3; ++c) dst[c] = toByte(values[c]);
+		dst[3] = transparent ? 0 : 255;
+	}
+}
+
+}
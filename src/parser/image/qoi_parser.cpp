@@ -0,0 +1,85 @@
+#include "starlet-serializer/parser/image/qoi_parser.hpp"
+#include "starlet-serializer/data/image_data.hpp"
+#include "starlet-serializer/utils/pixel_swizzle.hpp"
+#include "starlet-serializer/utils/qoi_codec.hpp"
+
+#include "starlet-logger/logger.hpp"
+
+#include <cstring>
+
+namespace Starlet::Serializer {
+
+namespace {
+	constexpr uint8_t QOI_COLOURSPACE_LINEAR = 1;
+
+	uint32_t readBe32(const unsigned char* p) {
+		return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) | (static_cast<uint32_t>(p[2]) << 8) | p[3];
+	}
+}
+
+size_t QoiParser::headerSize() const {
+	return Utils::QOI_HEADER_SIZE;
+}
+
+bool QoiParser::parseHeader(const unsigned char* p, size_t fileSize, ImageInfo& info, uint32_t& dataOffset) {
+	if (!validateFileSignature(p, fileSize)) return false;
+
+	const uint32_t width = readBe32(p + 4);
+	const uint32_t height = readBe32(p + 8);
+	if (!validateDimensions(width, height)) return false;
+
+	const uint8_t channels = p[12], colourspace = p[13];
+	if (channels != 3 && channels != 4)
+		return Logger::error("QoiParser", "parseHeader", "Unsupported QOI channel count: " + std::to_string(channels));
+	if (colourspace > QOI_COLOURSPACE_LINEAR)
+		return Logger::error("QoiParser", "parseHeader", "Unsupported QOI colourspace: " + std::to_string(colourspace));
+
+	dataOffset = static_cast<uint32_t>(Utils::QOI_HEADER_SIZE);
+
+	info.fileFormat = ImageFormat::QOI;
+	info.width = width;
+	info.height = height;
+	info.sourceFormat = channels == 4 ? PixelFormat::RGBA8 : PixelFormat::RGB8;
+	info.sourceBottomUp = false;
+	return true;
+}
+
+bool QoiParser::validateFileSignature(const unsigned char* p, size_t fileSize) const {
+	if (!p)	return Logger::error("QoiParser", "validateFileSignature", "Null buffer");
+
+	// fileSize counts the terminator loadBinaryFile appends
+	if (fileSize - 1 < Utils::QOI_HEADER_SIZE + Utils::QOI_END_MARKER_SIZE)
+		return Logger::error("QoiParser", "validateFileSignature", "File too small: " + std::to_string(fileSize) + " bytes");
+
+	if (std::memcmp(p, "qoif", 4) != 0)
+		return Logger::error("QoiParser", "validateFileSignature", "Bad signature (not QOI)");
+
+	return true;
+}
+
+bool QoiParser::copyPixelData(const unsigned char* p, size_t fileSize, uint32_t dataOffset, const ImageInfo& info, unsigned char* dst, size_t rowPitch) const {
+	Utils::QoiDecoder decoder(p + dataOffset, fileSize - 1 - dataOffset);
+
+	// The decoder emits RGB8 or RGBA8 itself, whatever the header's channel count says
+	const bool direct = info.format == PixelFormat::RGBA8 || info.format == PixelFormat::RGB8;
+	if (direct && rowPitch == info.rowSize) {
+		if (!decoder.decode(dst, static_cast<size_t>(info.width) * info.height, pixelFormatSize(info.format)))
+			return Logger::error("QoiParser", "copyPixelData", "Truncated image data");
+		return true;
+	}
+
+	std::vector<unsigned char> row(direct ? 0 : static_cast<size_t>(info.width) * 4);
+	for (uint32_t y = 0; y < info.height; ++y) {
+		unsigned char* dstRow = dst + rowPitch * y;
+		if (!decoder.decode(direct ? dstRow : row.data(), info.width, direct ? pixelFormatSize(info.format) : 4))
+			return Logger::error("QoiParser", "copyPixelData", "Truncated image data at row " + std::to_string(y));
+		if (!direct) Utils::convertPixels(row.data(), PixelFormat::RGBA8, dstRow, info.format, info.width);
+	}
+	return true;
+}
+
+bool QoiParser::isStoredLayout(const ImageInfo&) const {
+	return false;
+}
+
+}
@@ -1,70 +1,165 @@
 #include "starlet-serializer/parser/image/tga_parser.hpp"
 #include "starlet-serializer/data/image_data.hpp"
+#include "starlet-serializer/utils/pixel_swizzle.hpp"
 
 #include "starlet-logger/logger.hpp"
 
+#include <cstring>
+
 namespace Starlet::Serializer {
 
 namespace {
-	constexpr uint8_t TGA_IMAGE_TYPE_UNCOMPRESSED_TRUE_COLOR = 2;
-	constexpr uint8_t TGA_COLOUR_MAP_TYPE_NONE = 0;
+	constexpr uint8_t TGA_IMAGE_TYPE_COLOUR_MAPPED = 1;
+	constexpr uint8_t TGA_IMAGE_TYPE_TRUE_COLOUR = 2;
+	constexpr uint8_t TGA_IMAGE_TYPE_GREYSCALE = 3;
+	constexpr uint8_t TGA_IMAGE_TYPE_RLE_OFFSET = 8; // Types 9/10/11 are RLE versions of 1/2/3
+	constexpr uint8_t TGA_COLOUR_MAP_TYPE_PRESENT = 1;
 	constexpr uint8_t TGA_ORIGIN_TOP_BIT = 0x20; // Bit 5 of image descriptor byte
 	constexpr size_t  TGA_HEADER_SIZE = 18;
-}
 
-bool TgaParser::parse(const std::string& path, ImageData& out) {
-	clearImageData(out);
+	// 5-bit channel to 8-bit, replicating the high bits into the low ones
+	constexpr uint8_t expand5(uint32_t v) { return static_cast<uint8_t>((v << 3) | (v >> 2)); }
 
-	std::optional<std::vector<unsigned char>> file = loadImageData(path);
-	if (!file.has_value()) return false;
+	// 16-bit ARRRRRGG GGGBBBBB little-endian pixel to BGR8; the attribute bit is ignored
+	void unpack555(const unsigned char* src, unsigned char* dst) {
+		const uint32_t v = static_cast<uint32_t>(src[0]) | (static_cast<uint32_t>(src[1]) << 8);
+		dst[0] = expand5(v & 0x1F);
+		dst[1] = expand5((v >> 5) & 0x1F);
+		dst[2] = expand5((v >> 10) & 0x1F);
+	}
 
-	const unsigned char* p = file->data();
-	uint32_t width{ 0 }, height{ 0 };
-	uint8_t bpp{ 0 };
-	bool topDown{ false };
-	uint32_t dataOffset{ 0 };
+	// Streams RLE packets across rows; a packet may continue into the next row
+	struct RleReader {
+		const unsigned char* p;
+		const unsigned char* end;
+		size_t pixelSize;
+		uint32_t remaining{ 0 };
+		bool run{ false };
+		unsigned char value[4]{};
 
-	if (!parseHeader(p, file->size(), width, height, bpp, topDown, dataOffset))
-		return false;
+		bool decodeRow(unsigned char* dst, uint32_t width) {
+			while (width > 0) {
+				if (remaining == 0) {
+					if (p >= end) return false;
+					const uint8_t packet = *p++;
+					remaining = (packet & 0x7F) + 1u;
+					run = (packet & 0x80) != 0;
+					if (run) {
+						if (static_cast<size_t>(end - p) < pixelSize) return false;
+						std::memcpy(value, p, pixelSize);
+						p += pixelSize;
+					}
+				}
 
-	if (!allocatePixelBuffer(out, width, height))
-		return false;
+				const uint32_t count = remaining < width ? remaining : width;
+				const size_t bytes = static_cast<size_t>(count) * pixelSize;
+				if (run) fill(dst, count);
+				else {
+					if (static_cast<size_t>(end - p) < bytes) return false;
+					std::memcpy(dst, p, bytes);
+					p += bytes;
+				}
+				dst += bytes;
+				remaining -= count;
+				width -= count;
+			}
+			return true;
+		}
 
-	if (!copyPixelData(p, file->size(), dataOffset, out, width, height, bpp, topDown))
-		return false;
+		// Runs are written in 48-byte blocks, a whole number of pixels for every pixel size, so the
+		// copies compile to wide stores
+		void fill(unsigned char* dst, uint32_t count) const {
+			constexpr size_t BLOCK = 48;
+			size_t bytes = static_cast<size_t>(count) * pixelSize;
+			if (pixelSize == 1) {
+				std::memset(dst, value[0], bytes);
+				return;
+			}
+			if (bytes < BLOCK) {
+				for (size_t i = 0; i < bytes; i += pixelSize) std::memcpy(dst + i, value, pixelSize);
+				return;
+			}
 
-	return true;
+			unsigned char pattern[BLOCK];
+			for (size_t i = 0; i < BLOCK; i += pixelSize) std::memcpy(pattern + i, value, pixelSize);
+			for (; bytes >= BLOCK; bytes -= BLOCK, dst += BLOCK) std::memcpy(dst, pattern, BLOCK);
+			std::memcpy(dst, pattern, bytes);
+		}
+	};
 }
 
-bool TgaParser::parseHeader(const unsigned char* p, size_t fileSize, uint32_t& width, uint32_t& height, uint8_t& bpp, bool& topDown, uint32_t& dataOffset) {
+size_t TgaParser::headerSize() const {
+	return TGA_HEADER_SIZE;
+}
+
+bool TgaParser::parseHeader(const unsigned char* p, size_t fileSize, ImageInfo& info, uint32_t& dataOffset) {
 	if (!validateFileSignature(p, fileSize)) return false;
 
 	const uint8_t idLength      = p[0];
 	const uint8_t colourMapType = p[1];
 	const uint8_t imageType     = p[2];
 
-	if (imageType != TGA_IMAGE_TYPE_UNCOMPRESSED_TRUE_COLOR)
-		return Logger::error("TgaParser", "parseHeader", "Unsupported TGA image type (only uncompressed true-colour TGA supported (2)), got: " + std::to_string(imageType));
+	const uint8_t baseType = imageType > TGA_IMAGE_TYPE_RLE_OFFSET ? static_cast<uint8_t>(imageType - TGA_IMAGE_TYPE_RLE_OFFSET) : imageType;
+	if (baseType < TGA_IMAGE_TYPE_COLOUR_MAPPED || baseType > TGA_IMAGE_TYPE_GREYSCALE)
+		return Logger::error("TgaParser", "parseHeader", "Unsupported TGA image type (supported: 1, 2, 3, 9, 10, 11), got: " + std::to_string(imageType));
+
+	if (colourMapType > TGA_COLOUR_MAP_TYPE_PRESENT)
+		return Logger::error("TgaParser", "parseHeader", "Unsupported TGA colour map type (only 0 or 1 supported), got: " + std::to_string(colourMapType));
 
-	if (colourMapType != TGA_COLOUR_MAP_TYPE_NONE)
-		return Logger::error("TgaParser", "parseHeader", "Unsupported TGA colour map type (only no colour map supported (0)), got: " + std::to_string(colourMapType));
+	layout = Layout{};
+	layout.imageType = imageType;
+	layout.colourMapFirst = readUint16(p, 3);
+	layout.colourMapLength = readUint16(p, 5);
+	layout.colourMapEntrySize = p[7];
+	if (colourMapType != TGA_COLOUR_MAP_TYPE_PRESENT) layout.colourMapLength = layout.colourMapEntrySize = 0;
 
-	width = static_cast<uint32_t>(readUint16(p, 12));
-	height = static_cast<uint32_t>(readUint16(p, 14));
+	if (layout.isColourMapped() && layout.colourMapLength == 0)
+		return Logger::error("TgaParser", "parseHeader", "Colour-mapped TGA has no colour map");
+
+	const uint32_t width = static_cast<uint32_t>(readUint16(p, 12));
+	const uint32_t height = static_cast<uint32_t>(readUint16(p, 14));
 	if (!validateDimensions(width, height))
 		return false;
 
-	bpp = p[16];
-	if (bpp != 24 && bpp != 32)
-		return Logger::error("TgaParser", "parseHeader", "Unsupported TGA bits per pixel (only 24 and 32 supported), got: " + std::to_string(bpp));
+	const uint8_t bpp = p[16];
+	layout.bpp = bpp;
+	PixelFormat sourceFormat = PixelFormat::Unknown;
+	if (baseType == TGA_IMAGE_TYPE_TRUE_COLOUR) {
+		if      (bpp == 15 || bpp == 16 || bpp == 24) sourceFormat = PixelFormat::BGR8;
+		else if (bpp == 32)                           sourceFormat = PixelFormat::BGRA8;
+	}
+	else if (baseType == TGA_IMAGE_TYPE_GREYSCALE) {
+		if (bpp == 8) sourceFormat = PixelFormat::R8;
+	}
+	else if (bpp == 8 || bpp == 16) {
+		const uint8_t entry = layout.colourMapEntrySize;
+		if      (entry == 15 || entry == 16 || entry == 24) sourceFormat = PixelFormat::BGR8;
+		else if (entry == 32)                               sourceFormat = PixelFormat::BGRA8;
+		else return Logger::error("TgaParser", "parseHeader", "Unsupported TGA colour map entry size: " + std::to_string(entry));
+	}
+	if (sourceFormat == PixelFormat::Unknown)
+		return Logger::error("TgaParser", "parseHeader", "Unsupported TGA bits per pixel for image type " + std::to_string(imageType) + ", got: " + std::to_string(bpp));
 
 	const uint8_t imageDescriptor = p[17];
-	topDown = (imageDescriptor & TGA_ORIGIN_TOP_BIT) != 0;
+	const bool topDown = (imageDescriptor & TGA_ORIGIN_TOP_BIT) != 0;
 
-	dataOffset = TGA_HEADER_SIZE + idLength;
+	// Any colour map sits between the ID field and the pixels, even when an image type ignores it
+	layout.colourMapOffset = TGA_HEADER_SIZE + idLength;
+	dataOffset = layout.colourMapOffset + layout.colourMapLength * ((layout.colourMapEntrySize + 7u) / 8u);
 	if (dataOffset >= fileSize)
 		return Logger::error("TgaParser", "parseHeader", "Invalid data offset");
 
+	if (!layout.isRle()) {
+		const size_t needed = static_cast<size_t>(dataOffset) + static_cast<size_t>(width) * ((bpp + 7u) / 8u) * height;
+		if (needed > fileSize)
+			return Logger::error("TgaParser", "parseHeader", "File too small for declared dimensions: " + std::to_string(fileSize) + " bytes, need " + std::to_string(needed) + " bytes");
+	}
+
+	info.fileFormat = ImageFormat::TGA;
+	info.width = width;
+	info.height = height;
+	info.sourceFormat = sourceFormat;
+	info.sourceBottomUp = !topDown;
 	return true;
 }
 
@@ -77,33 +172,97 @@ bool TgaParser::validateFileSignature(const unsigned char* p, size_t fileSize) c
 	return true;
 }
 
-bool TgaParser::copyPixelData(const unsigned char* p, size_t fileSize, uint32_t dataOffset, ImageData& out, uint32_t width, uint32_t height, uint8_t bpp, bool topDown) const {
-	const size_t rowStride = static_cast<size_t>(width) * ((bpp == 24) ? 3 : 4);
-	const size_t needed = static_cast<size_t>(dataOffset) + rowStride * static_cast<size_t>(height);
+bool TgaParser::copyPixelData(const unsigned char* p, size_t fileSize, uint32_t dataOffset, const ImageInfo& info, unsigned char* dst, size_t rowPitch) const {
+	const size_t storedSize = (layout.bpp + 7u) / 8u;
+	const size_t storedStride = static_cast<size_t>(info.width) * storedSize;
+	const unsigned char* srcPixels = p + dataOffset;
+	const bool flipRows = info.sourceBottomUp != info.bottomUp;
+	const bool direct = isDirectColour(info);
 
-	if (needed > fileSize)
-		return Logger::error("TgaParser", "copyPixelData", "File too small for declared dimensions: " + std::to_string(fileSize) + " bytes, need " + std::to_string(needed) + " bytes");
+	if (!layout.isRle() && direct && !flipRows && info.format == info.sourceFormat && rowPitch == info.rowSize) {
+		std::memcpy(dst, srcPixels, info.byteSize);
+		return true;
+	}
 
-	const unsigned char* srcPixels = p + dataOffset;
+	std::vector<unsigned char> colourMap;
+	if (layout.isColourMapped()) buildColourMap(p, info.sourceFormat, colourMap);
 
-	for (uint32_t row = 0; row < height; ++row) {
-		const uint32_t srcRow = topDown ? row : (height - 1 - row);
-		const unsigned char* srcRowPtr = srcPixels + srcRow * rowStride;
-		unsigned char* dstRowPtr = out.pixels.data() + static_cast<size_t>(row) * static_cast<size_t>(width) * out.pixelSize;
-
-		if (bpp == 24) convertBgrToRgb(srcRowPtr, dstRowPtr, width);
-		else {
-			for (uint32_t col = 0; col < width; ++col) {
-				const unsigned char* srcPixelPtr = srcRowPtr + col * 4;
-				unsigned char* dstPixelPtr = dstRowPtr + static_cast<size_t>(col) * out.pixelSize;
-				dstPixelPtr[0] = srcPixelPtr[2];
-				dstPixelPtr[1] = srcPixelPtr[1];
-				dstPixelPtr[2] = srcPixelPtr[0];
-			}
+	// RLE rows decode straight into the output when no conversion follows
+	const bool rleInPlace = layout.isRle() && direct && info.format == info.sourceFormat;
+	std::vector<unsigned char> stored(layout.isRle() && !rleInPlace ? storedStride : 0);
+	std::vector<unsigned char> expanded(direct ? 0 : static_cast<size_t>(info.width) * pixelFormatSize(info.sourceFormat));
+	// fileSize counts the terminator loadBinaryFile appends
+	RleReader rle{ srcPixels, p + fileSize - 1, storedSize };
+
+	for (uint32_t row = 0; row < info.height; ++row) {
+		unsigned char* dstRow = dst + rowPitch * (flipRows ? (info.height - 1 - row) : row);
+
+		const unsigned char* src = nullptr;
+		if (layout.isRle()) {
+			unsigned char* target = rleInPlace ? dstRow : stored.data();
+			if (!rle.decodeRow(target, info.width))
+				return Logger::error("TgaParser", "copyPixelData", "RLE data ends early at row " + std::to_string(row));
+			if (rleInPlace) continue;
+			src = target;
 		}
+		else src = srcPixels + storedStride * row;
+
+		if (!direct) {
+			expandRow(src, info, colourMap, expanded.data());
+			src = expanded.data();
+		}
+		Utils::convertPixels(src, info.sourceFormat, dstRow, info.format, info.width);
 	}
 
 	return true;
 }
 
-}
\ No newline at end of file
+bool TgaParser::isStoredLayout(const ImageInfo& info) const {
+	return !layout.isRle() && isDirectColour(info) && info.sourceBottomUp == info.bottomUp && info.format == info.sourceFormat;
+}
+
+bool TgaParser::isDirectColour(const ImageInfo& info) const {
+	return !layout.isColourMapped() && (layout.bpp + 7u) / 8u == pixelFormatSize(info.sourceFormat);
+}
+
+// Lookup table covering every possible index; entries outside the file's map stay black
+void TgaParser::buildColourMap(const unsigned char* p, PixelFormat format, std::vector<unsigned char>& table) const {
+	const size_t entryBytes = (layout.colourMapEntrySize + 7u) / 8u;
+	const size_t pixelSize = pixelFormatSize(format);
+	table.assign((layout.bpp == 8 ? 256u : 65536u) * pixelSize, 0);
+
+	const unsigned char* entry = p + layout.colourMapOffset;
+	for (size_t i = 0; i < layout.colourMapLength; ++i, entry += entryBytes) {
+		const size_t index = layout.colourMapFirst + i;
+		if (index * pixelSize >= table.size()) break;
+
+		unsigned char* out = table.data() + index * pixelSize;
+		if (entryBytes == 2) unpack555(entry, out);
+		else std::memcpy(out, entry, pixelSize);
+	}
+}
+
+void TgaParser::expandRow(const unsigned char* src, const ImageInfo& info, const std::vector<unsigned char>& colourMap, unsigned char* dst) const {
+	const uint32_t width = info.width;
+	if (!layout.isColourMapped()) {
+		for (uint32_t i = 0; i < width; ++i) unpack555(src + i * 2, dst + i * 3);
+		return;
+	}
+
+	const unsigned char* table = colourMap.data();
+	const bool wideIndex = layout.bpp == 16;
+	if (pixelFormatSize(info.sourceFormat) == 4) {
+		for (uint32_t i = 0; i < width; ++i) {
+			const size_t index = wideIndex ? static_cast<size_t>(src[i * 2]) | (static_cast<size_t>(src[i * 2 + 1]) << 8) : src[i];
+			std::memcpy(dst + i * 4, table + index * 4, 4);
+		}
+	}
+	else {
+		for (uint32_t i = 0; i < width; ++i) {
+			const size_t index = wideIndex ? static_cast<size_t>(src[i * 2]) | (static_cast<size_t>(src[i * 2 + 1]) << 8) : src[i];
+			std::memcpy(dst + i * 3, table + index * 3, 3);
+		}
+	}
+}
+
+}
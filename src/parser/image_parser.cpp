@@ -1,29 +1,84 @@
 #include "starlet-serializer/parser/image_parser.hpp"
 
 #include "starlet-serializer/parser/image/bmp_parser.hpp"
+#include "starlet-serializer/parser/image/png_parser.hpp"
+#include "starlet-serializer/parser/image/qoi_parser.hpp"
 #include "starlet-serializer/parser/image/tga_parser.hpp"
 
 #include "starlet-logger/logger.hpp"
 
+#include <cstring>
+#include <filesystem>
+
 namespace Starlet::Serializer {
 
-bool ImageParser::parse(const std::string& path, ImageData& out) {
-	switch (detectFormat(path)) {
-	case ImageFormat::BMP: {
-		BmpParser parser;
-		return parser.parse(path, out);
+namespace {
+	constexpr size_t SIGNATURE_BYTES = 64;
+
+	// A signature only counts once the file is long enough to hold that format's fixed header
+	bool isTgaHeader(const unsigned char* p, size_t size) {
+		if (size < 18) return false;
+		const uint8_t colourMapType = p[1], imageType = p[2], bpp = p[16], descriptor = p[17];
+		const bool colourMapped = imageType == 1 || imageType == 9;
+		const bool knownType = colourMapped || imageType == 2 || imageType == 3 || imageType == 10 || imageType == 11;
+		const bool knownDepth = bpp == 8 || bpp == 15 || bpp == 16 || bpp == 24 || bpp == 32;
+		const uint16_t width = static_cast<uint16_t>(p[12] | p[13] << 8), height = static_cast<uint16_t>(p[14] | p[15] << 8);
+		return knownType && knownDepth && colourMapType <= 1 && (!colourMapped || colourMapType == 1)
+			&& width > 0 && height > 0 && (descriptor & 0xC0) == 0;
 	}
-	case ImageFormat::TGA: {
-		TgaParser parser;
-		return parser.parse(path, out);
+
+	ImageFormat detectSignature(const unsigned char* p, size_t size) {
+		static constexpr unsigned char PNG_SIGNATURE[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+		if (size >= 26 && p[0] == 'B' && p[1] == 'M')             return ImageFormat::BMP;
+		if (size >= 33 && std::memcmp(p, PNG_SIGNATURE, 8) == 0) return ImageFormat::PNG;
+		if (size >= 14 && std::memcmp(p, "qoif", 4) == 0)        return ImageFormat::QOI;
+		if (isTgaHeader(p, size))                                return ImageFormat::TGA;
+		return ImageFormat::UNKNOWN;
 	}
+}
+
+bool ImageParser::parse(const std::string& path, ImageData& out) {
+	return parse(path, out, ImageParseOptions{});
+}
+
+bool ImageParser::parse(const std::string& path, ImageData& out, const ImageParseOptions& options) {
+	std::unique_ptr<ImageParserBase> parser = createParser(path);
+	return parser && parser->parse(path, out, options);
+}
+
+bool ImageParser::probe(const std::string& path, ImageInfo& out, const ImageParseOptions& options) {
+	std::unique_ptr<ImageParserBase> parser = createParser(path);
+	return parser && parser->probe(path, out, options);
+}
+
+bool ImageParser::decode(const std::string& path, unsigned char* dst, size_t dstSize, size_t rowPitch, const ImageParseOptions& options) {
+	std::unique_ptr<ImageParserBase> parser = createParser(path);
+	return parser && parser->decode(path, dst, dstSize, rowPitch, options);
+}
+
+std::unique_ptr<ImageParserBase> ImageParser::createParser(const std::string& path) {
+	switch (detectFormat(path)) {
+	case ImageFormat::BMP: return std::make_unique<BmpParser>();
+	case ImageFormat::TGA: return std::make_unique<TgaParser>();
+	case ImageFormat::PNG: return std::make_unique<PngParser>();
+	case ImageFormat::QOI: return std::make_unique<QoiParser>();
 	default:
-		Logger::error("ImageParser", "parse", "Unsupported image format: " + path);
-		return false;
+		Logger::error("ImageParser", "createParser", "Unsupported image format: " + path);
+		return nullptr;
 	}
 }
 
-ImageParser::ImageFormat ImageParser::detectFormat(const std::string& path) {
+ImageFormat ImageParser::detectFormat(const std::string& path) {
+	std::error_code error;
+	if (std::filesystem::is_regular_file(path, error)) {
+		std::vector<unsigned char> header;
+		size_t fileSize{ 0 };
+		if (loadBinaryFilePrefix(header, path, SIGNATURE_BYTES, fileSize)) {
+			const ImageFormat format = detectSignature(header.data(), header.size() - 1);
+			if (format != ImageFormat::UNKNOWN) return format;
+		}
+	}
+
 	size_t dotPos = path.find_last_of('.');
 	if (dotPos == std::string::npos || dotPos == path.length() - 1) 
 		return ImageFormat::UNKNOWN;
@@ -33,6 +88,8 @@ ImageParser::ImageFormat ImageParser::detectFormat(const std::string& path) {
 	
 	if      (extension == "bmp") return ImageFormat::BMP;
 	else if (extension == "tga") return ImageFormat::TGA;
+	else if (extension == "png") return ImageFormat::PNG;
+	else if (extension == "qoi") return ImageFormat::QOI;
 	else                         return ImageFormat::UNKNOWN;
 }
 
@@ -0,0 +1,250 @@
+#include "starlet-serializer/parser/mesh/mesh_cache_parser.hpp"
+#include "starlet-serializer/data/mesh_cache_data.hpp"
+#include "starlet-serializer/processor/mesh/bounds_calculator.hpp"
+#include "starlet-serializer/processor/mesh/mesh_codec.hpp"
+
+#include "starlet-serializer/utils/binary_io.hpp"
+
+#include "starlet-logger/logger.hpp"
+
+namespace Starlet::Serializer {
+
+namespace {
+	constexpr size_t VERTEX_BYTES = 12 * sizeof(float);
+	constexpr size_t TANGENT_BYTES = 4 * sizeof(float);
+	constexpr size_t MESHLET_BYTES = 4 * sizeof(uint32_t) + 11 * sizeof(float);
+	constexpr size_t BVH_NODE_BYTES = 2 * sizeof(uint32_t) + 6 * sizeof(float);
+	constexpr size_t COLLISION_FIXED_BYTES = (2 * KDopData::AXIS_COUNT + 15) * sizeof(float);
+
+	bool readVec3(Utils::ByteReader& reader, Math::Vec3<float>& out) {
+		return reader.f32(out.x) && reader.f32(out.y) && reader.f32(out.z);
+	}
+}
+
+bool MeshCacheParser::parse(const std::string& path, MeshCacheData& out) {
+	std::vector<unsigned char> file;
+	if (!loadBinaryFile(file, path)) return false;
+
+	// loadBinaryFile appends a terminator that is not part of the file
+	Utils::ByteReader reader(file.data(), file.size() - 1);
+
+	char magic[5];
+	uint32_t version{ 0 };
+	if (!reader.tag(magic) || strcmp(magic, MeshCacheFormat::MAGIC) != 0)
+		return Logger::error("MeshCacheParser", "parse", "Bad signature (not SMSH): " + path);
+	if (!reader.u32(version) || version != MeshCacheFormat::VERSION)
+		return Logger::error("MeshCacheParser", "parse", "Unsupported mesh cache version: " + std::to_string(version));
+
+	out = MeshCacheData{};
+	bool hasMesh = false;
+	while (reader.remaining() > 0) {
+		char id[5];
+		uint64_t size{ 0 };
+		if (!reader.tag(id) || !reader.u64(size) || size > reader.remaining())
+			return Logger::error("MeshCacheParser", "parse", "Truncated chunk at byte " + std::to_string(reader.offset()));
+
+		Utils::ByteReader chunk(reader.current(), static_cast<size_t>(size));
+		reader.skip(static_cast<size_t>(size));
+
+		if (strcmp(id, MeshCacheFormat::MESH_CHUNK) == 0) {
+			if (!parseMeshChunk(chunk, out.mesh)) return false;
+			hasMesh = true;
+		}
+		else if (strcmp(id, MeshCacheFormat::COMPRESSED_MESH_CHUNK) == 0) {
+			if (!parseCompressedMeshChunk(chunk, out.mesh)) return false;
+			out.compressed = hasMesh = true;
+		}
+		else if (strcmp(id, MeshCacheFormat::MESHLET_CHUNK) == 0) {
+			if (!parseMeshletChunk(chunk, out.meshlets)) return false;
+			out.hasMeshlets = true;
+		}
+		else if (strcmp(id, MeshCacheFormat::BVH_CHUNK) == 0) {
+			if (!parseBvhChunk(chunk, out.bvh)) return false;
+			out.hasBvh = true;
+		}
+		else if (strcmp(id, MeshCacheFormat::COLLISION_CHUNK) == 0) {
+			if (!parseCollisionChunk(chunk, out.collision)) return false;
+			out.hasCollision = true;
+		}
+		else Logger::debug("MeshCacheParser", "parse", "Skipping unknown chunk: " + std::string(id));
+	}
+
+	if (!hasMesh) return Logger::error("MeshCacheParser", "parse", "Mesh cache has no mesh chunk");
+	if (out.hasBvh && out.bvh.triangles.size() != out.mesh.numTriangles)
+		return Logger::error("MeshCacheParser", "parse", "BVH does not match the mesh triangle count");
+	if (out.hasMeshlets) {
+		for (unsigned int v : out.meshlets.vertices)
+			if (v >= out.mesh.numVertices)
+				return Logger::error("MeshCacheParser", "parse", "Meshlet vertex out of bounds: " + std::to_string(v));
+	}
+	return true;
+}
+
+bool MeshCacheParser::parseMeshChunk(Utils::ByteReader& reader, MeshData& out) {
+	uint32_t vertexCount{ 0 }, indexCount{ 0 }, flags{ 0 };
+	if (!reader.u32(vertexCount) || !reader.u32(indexCount) || !reader.u32(flags) || !reader.f32(out.minY) || !reader.f32(out.maxY))
+		return Logger::error("MeshCacheParser", "parseMeshChunk", "Truncated mesh header");
+
+	const bool hasTangents = (flags & MeshCacheFormat::MESH_HAS_TANGENTS) != 0;
+	const size_t needed = static_cast<size_t>(vertexCount) * (VERTEX_BYTES + (hasTangents ? TANGENT_BYTES : 0))
+		+ static_cast<size_t>(indexCount) * sizeof(uint32_t);
+	if (needed > reader.remaining() || indexCount % 3 != 0)
+		return Logger::error("MeshCacheParser", "parseMeshChunk", "Mesh chunk too small for " + std::to_string(vertexCount) + " vertices and " + std::to_string(indexCount) + " indices");
+
+	out.vertices.resize(vertexCount);
+	for (Math::Vertex& v : out.vertices) {
+		readVec3(reader, v.pos);
+		readVec3(reader, v.norm);
+		reader.f32(v.col.x); reader.f32(v.col.y); reader.f32(v.col.z); reader.f32(v.col.w);
+		reader.f32(v.texCoord.x); reader.f32(v.texCoord.y);
+	}
+
+	out.indices.resize(indexCount);
+	for (size_t i = 0; i < indexCount; ++i) {
+		reader.u32(out.indices[i]);
+		if (out.indices[i] >= vertexCount)
+			return Logger::error("MeshCacheParser", "parseMeshChunk", "Index out of bounds at " + std::to_string(i) + ": " + std::to_string(out.indices[i]));
+	}
+
+	if (hasTangents) {
+		out.tangents.resize(vertexCount);
+		for (Math::Vec4<float>& t : out.tangents) {
+			reader.f32(t.x); reader.f32(t.y); reader.f32(t.z); reader.f32(t.w);
+		}
+	}
+
+	out.numVertices = vertexCount;
+	out.numIndices = indexCount;
+	out.numTriangles = indexCount / 3;
+	out.hasNormals   = (flags & MeshCacheFormat::MESH_HAS_NORMALS) != 0;
+	out.hasColours   = (flags & MeshCacheFormat::MESH_HAS_COLOURS) != 0;
+	out.hasTexCoords = (flags & MeshCacheFormat::MESH_HAS_TEXCOORDS) != 0;
+	out.hasTangents  = hasTangents;
+	BoundsCalculator().compute(out);
+	return true;
+}
+
+bool MeshCacheParser::parseCompressedMeshChunk(Utils::ByteReader& reader, MeshData& out) {
+	uint64_t vertexBytes{ 0 };
+	if (!reader.u64(vertexBytes) || vertexBytes > reader.remaining())
+		return Logger::error("MeshCacheParser", "parseCompressedMeshChunk", "Truncated compressed mesh header");
+
+	MeshCodec codec;
+	const unsigned char* vertices = reader.current();
+	reader.skip(static_cast<size_t>(vertexBytes));
+	if (!codec.decodeVertices(vertices, static_cast<size_t>(vertexBytes), out) || !codec.decodeIndices(reader.current(), reader.remaining(), out.indices))
+		return Logger::error("MeshCacheParser", "parseCompressedMeshChunk", "Failed to decode compressed mesh");
+
+	const size_t vertexCount = out.vertices.size();
+	if (out.indices.size() % 3 != 0)
+		return Logger::error("MeshCacheParser", "parseCompressedMeshChunk", "Index count is not a multiple of 3: " + std::to_string(out.indices.size()));
+	for (size_t i = 0; i < out.indices.size(); ++i) {
+		if (out.indices[i] >= vertexCount)
+			return Logger::error("MeshCacheParser", "parseCompressedMeshChunk", "Index out of bounds at " + std::to_string(i) + ": " + std::to_string(out.indices[i]));
+	}
+
+	out.numIndices = static_cast<unsigned int>(out.indices.size());
+	out.numTriangles = out.numIndices / 3;
+	BoundsCalculator().compute(out);
+	return true;
+}
+
+bool MeshCacheParser::parseMeshletChunk(Utils::ByteReader& reader, MeshletData& out) {
+	uint32_t meshletCount{ 0 }, vertexCount{ 0 }, triangleCount{ 0 };
+	if (!reader.u32(meshletCount) || !reader.u32(vertexCount) || !reader.u32(triangleCount) || !reader.u32(out.maxVertices) || !reader.u32(out.maxTriangles))
+		return Logger::error("MeshCacheParser", "parseMeshletChunk", "Truncated meshlet header");
+
+	const size_t needed = static_cast<size_t>(meshletCount) * MESHLET_BYTES + static_cast<size_t>(vertexCount) * sizeof(uint32_t) + static_cast<size_t>(triangleCount) * 3;
+	if (needed > reader.remaining())
+		return Logger::error("MeshCacheParser", "parseMeshletChunk", "Meshlet chunk too small for " + std::to_string(meshletCount) + " meshlets");
+
+	out.meshlets.resize(meshletCount);
+	for (Meshlet& m : out.meshlets) {
+		reader.u32(m.vertexOffset);   reader.u32(m.vertexCount);
+		reader.u32(m.triangleOffset); reader.u32(m.triangleCount);
+		readVec3(reader, m.center); reader.f32(m.radius);
+		readVec3(reader, m.coneApex);
+		readVec3(reader, m.coneAxis); reader.f32(m.coneCutoff);
+
+		if (static_cast<uint64_t>(m.vertexOffset) + m.vertexCount > vertexCount || static_cast<uint64_t>(m.triangleOffset) + m.triangleCount > triangleCount)
+			return Logger::error("MeshCacheParser", "parseMeshletChunk", "Meshlet range out of bounds");
+	}
+
+	out.vertices.resize(vertexCount);
+	for (unsigned int& v : out.vertices) reader.u32(v);
+
+	out.triangles.resize(static_cast<size_t>(triangleCount) * 3);
+	reader.bytes(out.triangles.data(), out.triangles.size());
+
+	for (size_t i = 0; i < out.meshlets.size(); ++i) {
+		const Meshlet& m = out.meshlets[i];
+		const uint8_t* local = out.triangles.data() + static_cast<size_t>(m.triangleOffset) * 3;
+		for (size_t c = 0; c < static_cast<size_t>(m.triangleCount) * 3; ++c)
+			if (local[c] >= m.vertexCount)
+				return Logger::error("MeshCacheParser", "parseMeshletChunk", "Meshlet " + std::to_string(i) + " local index out of bounds: " + std::to_string(local[c]));
+	}
+	return true;
+}
+
+bool MeshCacheParser::parseBvhChunk(Utils::ByteReader& reader, BvhData& out) {
+	uint32_t nodeCount{ 0 }, triangleCount{ 0 };
+	if (!reader.u32(nodeCount) || !reader.u32(triangleCount))
+		return Logger::error("MeshCacheParser", "parseBvhChunk", "Truncated BVH header");
+
+	const size_t needed = static_cast<size_t>(nodeCount) * BVH_NODE_BYTES + static_cast<size_t>(triangleCount) * sizeof(uint32_t);
+	if (nodeCount == 0 || needed > reader.remaining())
+		return Logger::error("MeshCacheParser", "parseBvhChunk", "BVH chunk too small for " + std::to_string(nodeCount) + " nodes");
+
+	// Children must come after their parent so a corrupt file cannot send traversal into a loop
+	out.nodes.resize(nodeCount);
+	for (size_t i = 0; i < nodeCount; ++i) {
+		BvhNode& node = out.nodes[i];
+		reader.f32(node.boundsMin[0]); reader.f32(node.boundsMin[1]); reader.f32(node.boundsMin[2]);
+		reader.u32(node.leftFirst);
+		reader.f32(node.boundsMax[0]); reader.f32(node.boundsMax[1]); reader.f32(node.boundsMax[2]);
+		reader.u32(node.count);
+
+		const bool valid = node.isLeaf()
+			? static_cast<uint64_t>(node.leftFirst) + node.count <= triangleCount
+			: node.leftFirst > i && static_cast<uint64_t>(node.leftFirst) + 1 < nodeCount;
+		if (!valid) return Logger::error("MeshCacheParser", "parseBvhChunk", "BVH node " + std::to_string(i) + " out of bounds");
+	}
+
+	out.triangles.resize(triangleCount);
+	for (unsigned int& t : out.triangles) {
+		reader.u32(t);
+		if (t >= triangleCount) return Logger::error("MeshCacheParser", "parseBvhChunk", "BVH triangle out of bounds: " + std::to_string(t));
+	}
+	return true;
+}
+
+bool MeshCacheParser::parseCollisionChunk(Utils::ByteReader& reader, CollisionData& out) {
+	uint32_t vertexCount{ 0 }, indexCount{ 0 };
+	if (!reader.u32(vertexCount) || !reader.u32(indexCount))
+		return Logger::error("MeshCacheParser", "parseCollisionChunk", "Truncated collision header");
+
+	const size_t needed = COLLISION_FIXED_BYTES + static_cast<size_t>(vertexCount) * 3 * sizeof(float) + static_cast<size_t>(indexCount) * sizeof(uint32_t);
+	if (needed > reader.remaining() || indexCount % 3 != 0)
+		return Logger::error("MeshCacheParser", "parseCollisionChunk", "Collision chunk too small for " + std::to_string(vertexCount) + " hull vertices");
+
+	for (size_t a = 0; a < KDopData::AXIS_COUNT; ++a) {
+		reader.f32(out.kdop.min[a]);
+		reader.f32(out.kdop.max[a]);
+	}
+
+	readVec3(reader, out.obb.center);
+	for (Math::Vec3<float>& axis : out.obb.axes) readVec3(reader, axis);
+	readVec3(reader, out.obb.halfExtents);
+
+	out.hull.vertices.resize(vertexCount);
+	for (Math::Vec3<float>& v : out.hull.vertices) readVec3(reader, v);
+
+	out.hull.indices.resize(indexCount);
+	for (unsigned int& i : out.hull.indices) {
+		reader.u32(i);
+		if (i >= vertexCount) return Logger::error("MeshCacheParser", "parseCollisionChunk", "Hull index out of bounds: " + std::to_string(i));
+	}
+	return true;
+}
+
+}
@@ -1,5 +1,6 @@
 #include "starlet-serializer/parser/mesh/obj_parser.hpp"
 #include "starlet-serializer/data/mesh_data.hpp"
+#include "starlet-serializer/processor/mesh/bounds_calculator.hpp"
 #include "starlet-logger/logger.hpp"
 
 #include "starlet-math/vertex.hpp"
@@ -299,6 +300,10 @@ void ObjParser::fillMeshData(
 	out.hasTexCoords = usedTexCoords;
 	out.hasNormals = usedNormals;
 	out.hasColours = usedColours;
+	out.tangents.clear();
+	out.hasTangents = false;
+
+	BoundsCalculator().compute(out);
 }
 
 }
\ No newline at end of file
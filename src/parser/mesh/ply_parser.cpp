@@ -1,10 +1,10 @@
 #include "starlet-serializer/parser/mesh/ply_parser.hpp"
 #include "starlet-serializer/data/mesh_data.hpp"
+#include "starlet-serializer/processor/mesh/bounds_calculator.hpp"
 
 #include "starlet-logger/logger.hpp"
 
 #include <cstring>  
-#include <cfloat>
 
 namespace Starlet::Serializer {
 
@@ -25,6 +25,8 @@ bool PlyParser::parse(const std::string& path, MeshData& out) {
 
 	const unsigned char* p = file.data();
 	std::string errorMsg;
+	out.tangents.clear();
+	out.hasTangents = false;
 	while (true) {
 		if (!parseHeaderLine(p, out.numVertices, out.numTriangles, out.hasNormals, out.hasColours, out.hasTexCoords)) {
 			errorMsg = "header, 'end_header' not found";
@@ -153,7 +155,6 @@ bool PlyParser::parseVertices(const unsigned char*& p, MeshData& out) {
 	if (!p) return Logger::error("PlyParser", "parseVertices", "Input pointer is null");
 	if (!out.numVertices) return Logger::error("PlyParser", "parseVertices", "No vertices declared in header");
 
-	float minY = FLT_MAX, maxY = -FLT_MAX;	
 	unsigned int i = 0;
 	while (i < out.numVertices && *p) {
 		Math::Vertex& v = out.vertices[i];
@@ -215,9 +216,6 @@ bool PlyParser::parseVertices(const unsigned char*& p, MeshData& out) {
 				return Logger::error("PlyParser", "parseVertices", "Failed to parse texCoord Y at vertex " + std::to_string(i));
 		}
 
-		if (v.pos.y < minY) minY = v.pos.y;
-		if (v.pos.y > maxY) maxY = v.pos.y;
-
 		++i;
 		p = nextLine;
 	}
@@ -225,8 +223,7 @@ bool PlyParser::parseVertices(const unsigned char*& p, MeshData& out) {
 	if (i != out.numVertices) 
 		return Logger::error("PlyParser", "parseVertices", "Vertex count declared: " + std::to_string(out.numVertices) + " but parsed: " + std::to_string(i));
 
-	out.minY = minY;
-	out.maxY = maxY;
+	BoundsCalculator().compute(out);
 	return true;
 }
 bool PlyParser::parseIndices(const unsigned char*& p, MeshData& out) {
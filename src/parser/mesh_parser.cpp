@@ -1,13 +1,31 @@
 #include "starlet-serializer/parser/mesh_parser.hpp"
+#include "starlet-serializer/data/mesh_data.hpp"
+#include "starlet-serializer/data/mesh_cache_data.hpp"
 
 #include "starlet-serializer/parser/mesh/ply_parser.hpp"
 #include "starlet-serializer/parser/mesh/obj_parser.hpp"
+#include "starlet-serializer/parser/mesh/mesh_cache_parser.hpp"
+
+#include "starlet-serializer/processor/mesh/tangent_generator.hpp"
+#include "starlet-serializer/processor/mesh/colour_baker.hpp"
 
 #include "starlet-logger/logger.hpp"
 
+#include <cstring>
+#include <filesystem>
+
 namespace Starlet::Serializer {
 
 bool MeshParser::parse(const std::string& path, MeshData& out) {
+	return parseFormat(path, out);
+}
+
+bool MeshParser::parse(const std::string& path, MeshData& out, const MeshParseOptions& options) {
+	if (!parseFormat(path, out)) return false;
+	return applyOptions(out, options);
+}
+
+bool MeshParser::parseFormat(const std::string& path, MeshData& out) {
 	switch (detectFormat(path)) {
 	case MeshFormat::PLY: {
 		PlyParser parser;
@@ -17,13 +35,62 @@ bool MeshParser::parse(const std::string& path, MeshData& out) {
 		ObjParser parser;
 		return parser.parse(path, out);
 	}
+	case MeshFormat::SMESH: {
+		MeshCacheParser parser;
+		MeshCacheData cache;
+		if (!parser.parse(path, cache)) return false;
+		out = std::move(cache.mesh);
+		return true;
+	}
 	default:
 		Logger::error("MeshParser", "parse", "Unsupported mesh format: " + path);
 		return false;
 	}
 }
 
+bool MeshParser::applyOptions(MeshData& out, const MeshParseOptions& options) {
+	if (options.weldVertices && !out.vertices.empty()) {
+		VertexWelder welder;
+		if (!welder.weld(out, options.weld))
+			return Logger::error("MeshParser", "applyOptions", "Failed to weld vertices");
+	}
+
+	const bool wantTangents = options.generateTangents && out.hasTexCoords && out.numTriangles > 0;
+
+	if ((options.generateNormals || wantTangents) && !out.hasNormals && out.numTriangles > 0) {
+		NormalGenerator generator;
+		if (!generator.generate(out, options.normalWeighting, options.creaseAngle))
+			return Logger::error("MeshParser", "applyOptions", "Failed to generate normals");
+	}
+
+	if (wantTangents) {
+		TangentGenerator generator;
+		if (!generator.generate(out))
+			return Logger::error("MeshParser", "applyOptions", "Failed to generate tangents");
+	}
+
+	if (options.colourModel && !out.vertices.empty()) {
+		ColourBaker baker;
+		if (!baker.bake(*options.colourModel, out))
+			return Logger::error("MeshParser", "applyOptions", "Failed to bake vertex colours");
+	}
+
+	return true;
+}
+
 MeshParser::MeshFormat MeshParser::detectFormat(const std::string& path) {
+	// Signatures first: "ply" on its own line, or the SMESH magic. OBJ has none.
+	std::error_code error;
+	if (std::filesystem::is_regular_file(path, error)) {
+		std::vector<unsigned char> header;
+		size_t fileSize{ 0 };
+		if (loadBinaryFilePrefix(header, path, 8, fileSize)) {
+			const char* p = reinterpret_cast<const char*>(header.data());
+			if (fileSize >= 4 && std::memcmp(p, "ply", 3) == 0 && (p[3] == '\n' || p[3] == '\r')) return MeshFormat::PLY;
+			if (fileSize >= 8 && std::memcmp(p, MeshCacheFormat::MAGIC, 4) == 0)                  return MeshFormat::SMESH;
+		}
+	}
+
 	size_t dotPos = path.find_last_of('.');
 	if (dotPos == std::string::npos || dotPos == path.length() - 1) 
 		return MeshFormat::UNKNOWN;
@@ -31,9 +98,10 @@ MeshParser::MeshFormat MeshParser::detectFormat(const std::string& path) {
 	std::string extension = path.substr(dotPos + 1);
 	for (char& c : extension) c = static_cast<char>(tolower(c));
 
-	if (extension == "ply") return MeshFormat::PLY;
-	if (extension == "obj") return MeshFormat::OBJ;
-	else                    return MeshFormat::UNKNOWN;
+	if (extension == "ply")   return MeshFormat::PLY;
+	if (extension == "obj")   return MeshFormat::OBJ;
+	if (extension == "smesh") return MeshFormat::SMESH;
+	else                      return MeshFormat::UNKNOWN;
 }
 
 }
@@ -69,6 +69,29 @@ bool Parser::loadBinaryFile(std::vector<unsigned char>& dataOut, const std::stri
 	return true;
 }
 
+bool Parser::loadBinaryFilePrefix(std::vector<unsigned char>& dataOut, const std::string& path, size_t maxBytes, size_t& fileSize) {
+	FILE* file = fopen(path.c_str(), "rb");
+	if (!file) return Logger::error("Parser", "loadBinaryFilePrefix", "Failed to open file: " + path);
+
+	if (!getFileSize(file, fileSize)) {
+		fclose(file);
+		return Logger::error("Parser", "loadBinaryFilePrefix", "Failed to get file size");
+	}
+
+	const size_t readSize = fileSize < maxBytes ? fileSize : maxBytes;
+	dataOut.resize(readSize + 1);
+	size_t bytesRead = fread(dataOut.data(), 1, readSize, file);
+	fclose(file);
+
+	if (bytesRead != readSize) {
+		dataOut.clear();
+		return Logger::error("Parser", "loadBinaryFilePrefix", "fread failed. Expected " + std::to_string(readSize) + ", got " + std::to_string(bytesRead));
+	}
+
+	dataOut[readSize] = '\0';
+	return true;
+}
+
 
 
 bool Parser::parseBool(const unsigned char*& p, bool& out) {
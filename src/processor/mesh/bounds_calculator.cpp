@@ -0,0 +1,140 @@
+#include "starlet-serializer/processor/mesh/bounds_calculator.hpp"
+#include "starlet-serializer/data/mesh_data.hpp"
+
+#include "starlet-serializer/utils/parallel.hpp"
+
+#include "starlet-math/vertex.hpp"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define STARLET_BOUNDS_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace Starlet::Serializer {
+
+namespace {
+	constexpr size_t BOUNDS_GRAIN = 64 * 1024;
+
+	struct Range {
+		float min[4]{ FLT_MAX, FLT_MAX, FLT_MAX, FLT_MAX };
+		float max[4]{ -FLT_MAX, -FLT_MAX, -FLT_MAX, -FLT_MAX };
+	};
+
+	// The SSE paths load pos as four floats; the fourth lane reads the next member of the vertex and
+	// is ignored. The final vertex of the buffer is always handled by the scalar tail.
+	static_assert(sizeof(Math::Vec3<float>) == 3 * sizeof(float), "Vertex positions must be packed floats");
+
+	void scalarRange(const Math::Vertex* vertices, size_t begin, size_t end, Range& range) {
+		for (size_t i = begin; i < end; ++i) {
+			const Math::Vec3<float>& p = vertices[i].pos;
+			range.min[0] = std::min(range.min[0], p.x); range.max[0] = std::max(range.max[0], p.x);
+			range.min[1] = std::min(range.min[1], p.y); range.max[1] = std::max(range.max[1], p.y);
+			range.min[2] = std::min(range.min[2], p.z); range.max[2] = std::max(range.max[2], p.z);
+		}
+	}
+
+	float scalarRadiusSq(const Math::Vertex* vertices, size_t begin, size_t end, const Math::Vec3<float>& centre) {
+		float best = 0.0f;
+		for (size_t i = begin; i < end; ++i) {
+			const Math::Vec3<float>& p = vertices[i].pos;
+			const float dx = p.x - centre.x, dy = p.y - centre.y, dz = p.z - centre.z;
+			best = std::max(best, dx * dx + dy * dy + dz * dz);
+		}
+		return best;
+	}
+
+	void positionRange(const Math::Vertex* vertices, size_t begin, size_t end, size_t last, Range& range) {
+#ifdef STARLET_BOUNDS_SSE2
+		const size_t simdEnd = std::min(end, last);
+		__m128 min0 = _mm_set1_ps(FLT_MAX), min1 = min0;
+		__m128 max0 = _mm_set1_ps(-FLT_MAX), max1 = max0;
+		size_t i = begin;
+		for (; i + 2 <= simdEnd; i += 2) {
+			const __m128 a = _mm_loadu_ps(&vertices[i].pos.x);
+			const __m128 b = _mm_loadu_ps(&vertices[i + 1].pos.x);
+			min0 = _mm_min_ps(min0, a); max0 = _mm_max_ps(max0, a);
+			min1 = _mm_min_ps(min1, b); max1 = _mm_max_ps(max1, b);
+		}
+		_mm_storeu_ps(range.min, _mm_min_ps(min0, min1));
+		_mm_storeu_ps(range.max, _mm_max_ps(max0, max1));
+		scalarRange(vertices, i, end, range);
+#else
+		(void)last;
+		scalarRange(vertices, begin, end, range);
+#endif
+	}
+
+	float radiusSq(const Math::Vertex* vertices, size_t begin, size_t end, size_t last, const Math::Vec3<float>& centre) {
+#ifdef STARLET_BOUNDS_SSE2
+		const size_t simdEnd = std::min(end, last);
+		const __m128 c = _mm_setr_ps(centre.x, centre.y, centre.z, 0.0f);
+		__m128 best = _mm_setzero_ps();
+		size_t i = begin;
+		for (; i + 4 <= simdEnd; i += 4) {
+			__m128 d0 = _mm_sub_ps(_mm_loadu_ps(&vertices[i].pos.x), c);
+			__m128 d1 = _mm_sub_ps(_mm_loadu_ps(&vertices[i + 1].pos.x), c);
+			__m128 d2 = _mm_sub_ps(_mm_loadu_ps(&vertices[i + 2].pos.x), c);
+			__m128 d3 = _mm_sub_ps(_mm_loadu_ps(&vertices[i + 3].pos.x), c);
+			d0 = _mm_mul_ps(d0, d0); d1 = _mm_mul_ps(d1, d1);
+			d2 = _mm_mul_ps(d2, d2); d3 = _mm_mul_ps(d3, d3);
+			_MM_TRANSPOSE4_PS(d0, d1, d2, d3);
+			best = _mm_max_ps(best, _mm_add_ps(_mm_add_ps(d0, d1), d2)); // Row 3 holds the ignored lanes
+		}
+		float lanes[4];
+		_mm_storeu_ps(lanes, best);
+		const float simdBest = std::max(std::max(lanes[0], lanes[1]), std::max(lanes[2], lanes[3]));
+		return std::max(simdBest, scalarRadiusSq(vertices, i, end, centre));
+#else
+		(void)last;
+		return scalarRadiusSq(vertices, begin, end, centre);
+#endif
+	}
+}
+
+void BoundsCalculator::compute(MeshData& mesh) const {
+	const size_t count = mesh.vertices.size();
+	if (count == 0) {
+		mesh.boundsMin = mesh.boundsMax = mesh.sphereCenter = Math::Vec3<float>{ 0.0f, 0.0f, 0.0f };
+		mesh.sphereRadius = 0.0f;
+		mesh.minY = mesh.maxY = 0.0f;
+		return;
+	}
+
+	const Math::Vertex* vertices = mesh.vertices.data();
+	const size_t last = count - 1;
+
+	std::vector<Range> ranges(std::max<size_t>(1, Utils::chunkCount(count, BOUNDS_GRAIN)));
+	Utils::parallelForChunks(count, BOUNDS_GRAIN, [&](size_t chunk, size_t begin, size_t end) {
+		positionRange(vertices, begin, end, last, ranges[chunk]);
+	});
+
+	Range total;
+	for (const Range& r : ranges) {
+		for (int a = 0; a < 3; ++a) {
+			total.min[a] = std::min(total.min[a], r.min[a]);
+			total.max[a] = std::max(total.max[a], r.max[a]);
+		}
+	}
+	mesh.boundsMin = { total.min[0], total.min[1], total.min[2] };
+	mesh.boundsMax = { total.max[0], total.max[1], total.max[2] };
+	mesh.sphereCenter = {
+		(total.min[0] + total.max[0]) * 0.5f,
+		(total.min[1] + total.max[1]) * 0.5f,
+		(total.min[2] + total.max[2]) * 0.5f
+	};
+
+	std::vector<float> radii(ranges.size(), 0.0f);
+	Utils::parallelForChunks(count, BOUNDS_GRAIN, [&](size_t chunk, size_t begin, size_t end) {
+		radii[chunk] = radiusSq(vertices, begin, end, last, mesh.sphereCenter);
+	});
+	mesh.sphereRadius = std::sqrt(*std::max_element(radii.begin(), radii.end()));
+
+	mesh.minY = mesh.boundsMin.y;
+	mesh.maxY = mesh.boundsMax.y;
+}
+
+}
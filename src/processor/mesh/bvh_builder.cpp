@@ -0,0 +1,493 @@
+#include "starlet-serializer/processor/mesh/bvh_builder.hpp"
+#include "starlet-serializer/data/mesh_data.hpp"
+#include "starlet-serializer/data/bvh_data.hpp"
+
+#include "starlet-serializer/utils/parallel.hpp"
+#include "starlet-serializer/utils/vec_ops.hpp"
+
+#include "starlet-logger/logger.hpp"
+
+#include "starlet-math/vertex.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cfloat>
+#include <cmath>
+
+namespace Starlet::Serializer {
+
+namespace {
+	constexpr size_t BIN_COUNT = 16;
+	constexpr size_t BVH_GRAIN = 16 * 1024;
+	constexpr size_t PARALLEL_BIN_THRESHOLD = 128 * 1024;
+	constexpr size_t TASKS_PER_WORKER = 4;
+	constexpr size_t MIN_DEFERRED_SIZE = 4 * 1024;
+	constexpr unsigned int MAX_SAH_LEAF_SIZE = 16; // Larger ranges are always split, even when SAH prefers a leaf
+	constexpr size_t MAX_SAH_DEPTH = 24;          // Deeper nodes use median splits, keeping the query stack bounded
+	constexpr float  TRAVERSAL_COST = 1.0f;
+	constexpr size_t STACK_SIZE = 64;             // Covers every tree build() makes; deeper ones (e.g. from a cache) spill to the heap
+
+	// LIFO of node indices on the stack, continuing on the heap once the fixed part is full so that
+	// no node is ever dropped
+	class TraversalStack {
+	public:
+		bool empty() const { return top == 0; }
+
+		void push(uint32_t node) {
+			if (top < STACK_SIZE) local[top++] = node;
+			else overflow.push_back(node);
+		}
+
+		uint32_t pop() {
+			if (overflow.empty()) return local[--top];
+			const uint32_t node = overflow.back();
+			overflow.pop_back();
+			return node;
+		}
+
+	private:
+		uint32_t local[STACK_SIZE];
+		size_t top{ 0 };
+		std::vector<uint32_t> overflow;
+	};
+
+	struct Aabb {
+		float min[3]{ FLT_MAX, FLT_MAX, FLT_MAX };
+		float max[3]{ -FLT_MAX, -FLT_MAX, -FLT_MAX };
+
+		void grow(const float p[3]) {
+			for (int i = 0; i < 3; ++i) {
+				min[i] = std::min(min[i], p[i]);
+				max[i] = std::max(max[i], p[i]);
+			}
+		}
+		void grow(const Aabb& b) {
+			for (int i = 0; i < 3; ++i) {
+				min[i] = std::min(min[i], b.min[i]);
+				max[i] = std::max(max[i], b.max[i]);
+			}
+		}
+		float area() const {
+			const float dx = max[0] - min[0], dy = max[1] - min[1], dz = max[2] - min[2];
+			if (dx < 0.0f) return 0.0f;
+			return dx * dy + dy * dz + dz * dx;
+		}
+	};
+
+	struct Bin {
+		Aabb bounds;
+		size_t count{ 0 };
+	};
+	using AxisBins = std::array<std::array<Bin, BIN_COUNT>, 3>;
+
+	void storeBounds(BvhNode& node, const Aabb& bounds) {
+		for (int i = 0; i < 3; ++i) {
+			node.boundsMin[i] = bounds.min[i];
+			node.boundsMax[i] = bounds.max[i];
+		}
+	}
+
+	// Slab test; returns the entry distance or FLT_MAX on a miss
+	float intersectNode(const BvhNode& node, const float origin[3], const float invDir[3], float maxDistance) {
+		float tMin = 0.0f, tMax = maxDistance;
+		for (int i = 0; i < 3; ++i) {
+			float t0 = (node.boundsMin[i] - origin[i]) * invDir[i];
+			float t1 = (node.boundsMax[i] - origin[i]) * invDir[i];
+			if (t0 > t1) std::swap(t0, t1);
+			tMin = std::max(tMin, t0);
+			tMax = std::min(tMax, t1);
+		}
+		return tMin <= tMax ? tMin : FLT_MAX;
+	}
+
+	bool overlapsNode(const BvhNode& node, const Math::Vec3<float>& boundsMin, const Math::Vec3<float>& boundsMax) {
+		return node.boundsMin[0] <= boundsMax.x && node.boundsMax[0] >= boundsMin.x
+			&& node.boundsMin[1] <= boundsMax.y && node.boundsMax[1] >= boundsMin.y
+			&& node.boundsMin[2] <= boundsMax.z && node.boundsMax[2] >= boundsMin.z;
+	}
+
+	// Separating axis test between a triangle and a box given by centre and half extents
+	bool triangleOverlapsBox(const Math::Vec3<float>& a, const Math::Vec3<float>& b, const Math::Vec3<float>& c, const Math::Vec3<float>& centre, const Math::Vec3<float>& half) {
+		const Math::Vec3<float> v[3] = { Utils::sub(a, centre), Utils::sub(b, centre), Utils::sub(c, centre) };
+		const float h[3] = { half.x, half.y, half.z };
+
+		for (int axis = 0; axis < 3; ++axis) {
+			const float p0 = (&v[0].x)[axis], p1 = (&v[1].x)[axis], p2 = (&v[2].x)[axis];
+			if (std::min({ p0, p1, p2 }) > h[axis] || std::max({ p0, p1, p2 }) < -h[axis]) return false;
+		}
+
+		const Math::Vec3<float> edges[3] = { Utils::sub(v[1], v[0]), Utils::sub(v[2], v[1]), Utils::sub(v[0], v[2]) };
+		const Math::Vec3<float> units[3] = { { 1.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f }, { 0.0f, 0.0f, 1.0f } };
+		for (const Math::Vec3<float>& edge : edges) {
+			for (const Math::Vec3<float>& unit : units) {
+				const Math::Vec3<float> axis = Utils::cross(edge, unit);
+				const float p0 = Utils::dot(axis, v[0]), p1 = Utils::dot(axis, v[1]), p2 = Utils::dot(axis, v[2]);
+				const float r = h[0] * std::fabs(axis.x) + h[1] * std::fabs(axis.y) + h[2] * std::fabs(axis.z);
+				if (std::min({ p0, p1, p2 }) > r || std::max({ p0, p1, p2 }) < -r) return false;
+			}
+		}
+
+		const Math::Vec3<float> normal = Utils::cross(edges[0], edges[1]);
+		const float r = h[0] * std::fabs(normal.x) + h[1] * std::fabs(normal.y) + h[2] * std::fabs(normal.z);
+		return std::fabs(Utils::dot(normal, v[0])) <= r;
+	}
+}
+
+struct BvhBuilder::Context {
+	std::vector<Aabb> triangleBounds;
+	std::vector<float> centroids; // xyz per triangle
+	std::vector<unsigned int>* triangles{ nullptr };
+	unsigned int maxLeafSize{ DEFAULT_MAX_LEAF_SIZE };
+};
+
+struct BvhBuilder::Subtree {
+	size_t nodeIndex, begin, end, depth;
+	std::vector<BvhNode> nodes;
+};
+
+bool BvhBuilder::build(const MeshData& mesh, BvhData& out, unsigned int maxLeafSize) {
+	out.nodes.clear();
+	out.triangles.clear();
+
+	if (mesh.indices.size() < 3 || mesh.indices.size() % 3 != 0)
+		return Logger::error("BvhBuilder", "build", "Mesh has no triangle list");
+	if (maxLeafSize == 0)
+		return Logger::error("BvhBuilder", "build", "Max leaf size must be at least 1");
+	for (size_t i = 0; i < mesh.indices.size(); ++i)
+		if (mesh.indices[i] >= mesh.vertices.size())
+			return Logger::error("BvhBuilder", "build", "Index out of bounds at " + std::to_string(i) + ": " + std::to_string(mesh.indices[i]));
+
+	const size_t triangleCount = mesh.indices.size() / 3;
+	Context ctx;
+	ctx.triangles = &out.triangles;
+	ctx.maxLeafSize = maxLeafSize;
+	ctx.triangleBounds.resize(triangleCount);
+	ctx.centroids.resize(triangleCount * 3);
+	out.triangles.resize(triangleCount);
+
+	Utils::parallelFor(triangleCount, BVH_GRAIN, [&](size_t begin, size_t end) {
+		for (size_t t = begin; t < end; ++t) {
+			Aabb bounds;
+			for (size_t k = 0; k < 3; ++k) {
+				const Math::Vec3<float>& p = mesh.vertices[mesh.indices[t * 3 + k]].pos;
+				const float point[3] = { p.x, p.y, p.z };
+				bounds.grow(point);
+			}
+			for (int i = 0; i < 3; ++i) ctx.centroids[t * 3 + i] = (bounds.min[i] + bounds.max[i]) * 0.5f;
+			ctx.triangleBounds[t] = bounds;
+			out.triangles[t] = static_cast<unsigned int>(t);
+		}
+	});
+
+	out.nodes.reserve(triangleCount * 2);
+	out.nodes.emplace_back();
+
+	const size_t workers = Utils::workerCount();
+	if (workers == 1) {
+		buildNode(ctx, out.nodes, 0, 0, triangleCount, 0, nullptr, 0);
+		return true;
+	}
+
+	std::vector<Subtree> deferred;
+	const size_t deferBelow = std::max(MIN_DEFERRED_SIZE, triangleCount / (workers * TASKS_PER_WORKER));
+	buildNode(ctx, out.nodes, 0, 0, triangleCount, 0, &deferred, deferBelow);
+
+	Utils::parallelFor(deferred.size(), 1, [&](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i) {
+			Subtree& task = deferred[i];
+			task.nodes.reserve((task.end - task.begin) * 2);
+			task.nodes.push_back(out.nodes[task.nodeIndex]);
+			buildNode(ctx, task.nodes, 0, task.begin, task.end, task.depth, nullptr, 0);
+		}
+	});
+
+	// Local index i > 0 of a subtree lands at offset + i - 1; its root replaces the placeholder
+	for (const Subtree& task : deferred) {
+		const uint32_t offset = static_cast<uint32_t>(out.nodes.size());
+		for (size_t i = 0; i < task.nodes.size(); ++i) {
+			BvhNode node = task.nodes[i];
+			if (!node.isLeaf()) node.leftFirst = offset + node.leftFirst - 1;
+			if (i == 0) out.nodes[task.nodeIndex] = node;
+			else        out.nodes.push_back(node);
+		}
+	}
+	return true;
+}
+
+bool BvhBuilder::refit(const MeshData& mesh, BvhData& bvh) const {
+	const size_t triangleCount = mesh.indices.size() / 3;
+	for (size_t i = 0; i < bvh.nodes.size(); ++i) {
+		const BvhNode& node = bvh.nodes[i];
+		const bool valid = node.isLeaf()
+			? static_cast<size_t>(node.leftFirst) + node.count <= bvh.triangles.size()
+			: node.leftFirst > i && static_cast<size_t>(node.leftFirst) + 1 < bvh.nodes.size();
+		if (!valid) return Logger::error("BvhBuilder", "refit", "Node " + std::to_string(i) + " is out of order or out of bounds");
+	}
+	for (size_t i = 0; i < bvh.triangles.size(); ++i) {
+		const unsigned int t = bvh.triangles[i];
+		if (t >= triangleCount || mesh.indices[t * 3] >= mesh.vertices.size() || mesh.indices[t * 3 + 1] >= mesh.vertices.size() || mesh.indices[t * 3 + 2] >= mesh.vertices.size())
+			return Logger::error("BvhBuilder", "refit", "Triangle out of bounds at " + std::to_string(i));
+	}
+
+	// Children always follow their parent, so a reverse sweep sees them first
+	for (size_t i = bvh.nodes.size(); i-- > 0;) {
+		BvhNode& node = bvh.nodes[i];
+		Aabb bounds;
+		if (node.isLeaf()) {
+			for (uint32_t j = node.leftFirst; j < node.leftFirst + node.count; ++j)
+				for (size_t k = 0; k < 3; ++k) {
+					const Math::Vec3<float>& p = mesh.vertices[mesh.indices[bvh.triangles[j] * 3 + k]].pos;
+					const float point[3] = { p.x, p.y, p.z };
+					bounds.grow(point);
+				}
+		}
+		else {
+			for (uint32_t child = node.leftFirst; child < node.leftFirst + 2; ++child) {
+				Aabb childBounds;
+				std::copy(bvh.nodes[child].boundsMin, bvh.nodes[child].boundsMin + 3, childBounds.min);
+				std::copy(bvh.nodes[child].boundsMax, bvh.nodes[child].boundsMax + 3, childBounds.max);
+				bounds.grow(childBounds);
+			}
+		}
+		std::copy(bounds.min, bounds.min + 3, node.boundsMin);
+		std::copy(bounds.max, bounds.max + 3, node.boundsMax);
+	}
+	return true;
+}
+
+void BvhBuilder::buildNode(Context& ctx, std::vector<BvhNode>& nodes, size_t nodeIndex, size_t begin, size_t end, size_t depth, std::vector<Subtree>* deferred, size_t deferBelow) const {
+	std::vector<unsigned int>& triangles = *ctx.triangles;
+	const size_t count = end - begin;
+
+	Aabb bounds;
+	if (count >= PARALLEL_BIN_THRESHOLD) {
+		std::vector<Aabb> partial(Utils::chunkCount(count, BVH_GRAIN));
+		Utils::parallelForChunks(count, BVH_GRAIN, [&](size_t chunk, size_t first, size_t last) {
+			for (size_t i = begin + first; i < begin + last; ++i) partial[chunk].grow(ctx.triangleBounds[triangles[i]]);
+		});
+		for (const Aabb& b : partial) bounds.grow(b);
+	}
+	else {
+		for (size_t i = begin; i < end; ++i) bounds.grow(ctx.triangleBounds[triangles[i]]);
+	}
+	storeBounds(nodes[nodeIndex], bounds);
+	nodes[nodeIndex].leftFirst = static_cast<uint32_t>(begin);
+	nodes[nodeIndex].count = static_cast<uint32_t>(count);
+
+	if (count <= ctx.maxLeafSize) return;
+	if (deferred && count < deferBelow) {
+		deferred->push_back({ nodeIndex, begin, end, depth, {} });
+		return;
+	}
+
+	int axis = 0;
+	float position = 0.0f;
+	size_t mid = begin;
+	if (depth >= MAX_SAH_DEPTH) {
+		const BvhNode& node = nodes[nodeIndex];
+		for (int a = 1; a < 3; ++a)
+			if (node.boundsMax[a] - node.boundsMin[a] > node.boundsMax[axis] - node.boundsMin[axis]) axis = a;
+	}
+	else if (findSplit(ctx, nodes[nodeIndex], begin, end, axis, position)) {
+		mid = static_cast<size_t>(std::partition(triangles.begin() + begin, triangles.begin() + end, [&](unsigned int t) {
+			return ctx.centroids[static_cast<size_t>(t) * 3 + axis] < position;
+		}) - triangles.begin());
+	}
+	else if (count <= MAX_SAH_LEAF_SIZE) {
+		return;
+	}
+
+	if (mid == begin || mid == end) {
+		// Depth limit or coincident centroids: split evenly so the depth stays bounded
+		mid = begin + count / 2;
+		std::nth_element(triangles.begin() + begin, triangles.begin() + mid, triangles.begin() + end, [&](unsigned int a, unsigned int b) {
+			return ctx.centroids[static_cast<size_t>(a) * 3 + axis] < ctx.centroids[static_cast<size_t>(b) * 3 + axis];
+		});
+	}
+
+	const size_t children = nodes.size();
+	nodes.emplace_back();
+	nodes.emplace_back();
+	nodes[nodeIndex].leftFirst = static_cast<uint32_t>(children);
+	nodes[nodeIndex].count = 0;
+
+	buildNode(ctx, nodes, children, begin, mid, depth + 1, deferred, deferBelow);
+	buildNode(ctx, nodes, children + 1, mid, end, depth + 1, deferred, deferBelow);
+}
+
+bool BvhBuilder::findSplit(const Context& ctx, const BvhNode& node, size_t begin, size_t end, int& axis, float& position) const {
+	const std::vector<unsigned int>& triangles = *ctx.triangles;
+	const size_t count = end - begin;
+
+	Aabb centroidBounds;
+	for (size_t i = begin; i < end; ++i) centroidBounds.grow(&ctx.centroids[static_cast<size_t>(triangles[i]) * 3]);
+
+	float binScale[3];
+	for (int a = 0; a < 3; ++a) {
+		const float extent = centroidBounds.max[a] - centroidBounds.min[a];
+		binScale[a] = extent > 0.0f ? static_cast<float>(BIN_COUNT) / extent : 0.0f;
+	}
+
+	const auto binRange = [&](AxisBins& bins, size_t first, size_t last) {
+		for (size_t i = first; i < last; ++i) {
+			const unsigned int t = triangles[i];
+			for (int a = 0; a < 3; ++a) {
+				if (binScale[a] == 0.0f) continue;
+				const size_t bin = std::min(BIN_COUNT - 1, static_cast<size_t>((ctx.centroids[static_cast<size_t>(t) * 3 + a] - centroidBounds.min[a]) * binScale[a]));
+				bins[a][bin].bounds.grow(ctx.triangleBounds[t]);
+				++bins[a][bin].count;
+			}
+		}
+	};
+
+	AxisBins bins{};
+	if (count >= PARALLEL_BIN_THRESHOLD) {
+		std::vector<AxisBins> partial(Utils::chunkCount(count, BVH_GRAIN));
+		Utils::parallelForChunks(count, BVH_GRAIN, [&](size_t chunk, size_t first, size_t last) {
+			binRange(partial[chunk], begin + first, begin + last);
+		});
+		for (const AxisBins& p : partial) {
+			for (int a = 0; a < 3; ++a) {
+				for (size_t b = 0; b < BIN_COUNT; ++b) {
+					bins[a][b].bounds.grow(p[a][b].bounds);
+					bins[a][b].count += p[a][b].count;
+				}
+			}
+		}
+	}
+	else binRange(bins, begin, end);
+
+	float bestCost = FLT_MAX;
+	for (int a = 0; a < 3; ++a) {
+		if (binScale[a] == 0.0f) continue;
+
+		float rightArea[BIN_COUNT];
+		size_t rightCount[BIN_COUNT];
+		Aabb accumulated;
+		size_t accumulatedCount = 0;
+		for (size_t b = BIN_COUNT - 1; b > 0; --b) {
+			accumulated.grow(bins[a][b].bounds);
+			accumulatedCount += bins[a][b].count;
+			rightArea[b] = accumulated.area();
+			rightCount[b] = accumulatedCount;
+		}
+
+		accumulated = Aabb{};
+		accumulatedCount = 0;
+		for (size_t b = 0; b + 1 < BIN_COUNT; ++b) {
+			accumulated.grow(bins[a][b].bounds);
+			accumulatedCount += bins[a][b].count;
+			if (accumulatedCount == 0 || rightCount[b + 1] == 0) continue;
+
+			const float cost = accumulated.area() * accumulatedCount + rightArea[b + 1] * rightCount[b + 1];
+			if (cost < bestCost) {
+				bestCost = cost;
+				axis = a;
+				position = centroidBounds.min[a] + static_cast<float>(b + 1) / binScale[a];
+			}
+		}
+	}
+	if (bestCost == FLT_MAX) return false;
+
+	Aabb nodeBounds;
+	for (int i = 0; i < 3; ++i) {
+		nodeBounds.min[i] = node.boundsMin[i];
+		nodeBounds.max[i] = node.boundsMax[i];
+	}
+	const float area = nodeBounds.area();
+	if (area <= 0.0f) return true;
+
+	const float splitCost = TRAVERSAL_COST + bestCost / area;
+	return splitCost < static_cast<float>(count) || count > MAX_SAH_LEAF_SIZE;
+}
+
+bool BvhQuery::raycast(const MeshData& mesh, const BvhData& bvh, const Math::Vec3<float>& origin, const Math::Vec3<float>& direction, RayHit& hit, float maxDistance) const {
+	if (bvh.nodes.empty()) return false;
+
+	const float o[3] = { origin.x, origin.y, origin.z };
+	const float invDir[3] = { 1.0f / direction.x, 1.0f / direction.y, 1.0f / direction.z };
+
+	bool found = false;
+	float closest = maxDistance;
+	if (intersectNode(bvh.nodes[0], o, invDir, closest) == FLT_MAX) return false;
+	TraversalStack stack;
+	stack.push(0);
+
+	while (!stack.empty()) {
+		const BvhNode& node = bvh.nodes[stack.pop()];
+
+		if (node.isLeaf()) {
+			for (uint32_t i = node.leftFirst; i < node.leftFirst + node.count; ++i) {
+				const unsigned int t = bvh.triangles[i];
+				const Math::Vec3<float>& p0 = mesh.vertices[mesh.indices[t * 3 + 0]].pos;
+				const Math::Vec3<float>& p1 = mesh.vertices[mesh.indices[t * 3 + 1]].pos;
+				const Math::Vec3<float>& p2 = mesh.vertices[mesh.indices[t * 3 + 2]].pos;
+
+				// Moller-Trumbore
+				const Math::Vec3<float> e1 = Utils::sub(p1, p0), e2 = Utils::sub(p2, p0);
+				const Math::Vec3<float> pv = Utils::cross(direction, e2);
+				const float det = Utils::dot(e1, pv);
+				if (std::fabs(det) < 1e-12f) continue;
+
+				const float invDet = 1.0f / det;
+				const Math::Vec3<float> tv = Utils::sub(origin, p0);
+				const float u = Utils::dot(tv, pv) * invDet;
+				if (u < 0.0f || u > 1.0f) continue;
+
+				const Math::Vec3<float> qv = Utils::cross(tv, e1);
+				const float v = Utils::dot(direction, qv) * invDet;
+				if (v < 0.0f || u + v > 1.0f) continue;
+
+				const float distance = Utils::dot(e2, qv) * invDet;
+				if (distance < 0.0f || distance > closest) continue;
+
+				closest = distance;
+				hit = { distance, t, u, v };
+				found = true;
+			}
+			continue;
+		}
+
+		// Push the far child first so the near one is visited next
+		const uint32_t left = node.leftFirst, right = node.leftFirst + 1;
+		const float dLeft = intersectNode(bvh.nodes[left], o, invDir, closest);
+		const float dRight = intersectNode(bvh.nodes[right], o, invDir, closest);
+		const bool leftFirst = dLeft <= dRight;
+		const uint32_t nearChild = leftFirst ? left : right, farChild = leftFirst ? right : left;
+		const float nearDistance = leftFirst ? dLeft : dRight, farDistance = leftFirst ? dRight : dLeft;
+
+		if (farDistance != FLT_MAX) stack.push(farChild);
+		if (nearDistance != FLT_MAX) stack.push(nearChild);
+	}
+	return found;
+}
+
+void BvhQuery::overlapAabb(const MeshData& mesh, const BvhData& bvh, const Math::Vec3<float>& boundsMin, const Math::Vec3<float>& boundsMax, std::vector<unsigned int>& triangles) const {
+	if (bvh.nodes.empty()) return;
+
+	const Math::Vec3<float> centre = Utils::scale(Utils::add(boundsMin, boundsMax), 0.5f);
+	const Math::Vec3<float> half = Utils::scale(Utils::sub(boundsMax, boundsMin), 0.5f);
+
+	TraversalStack stack;
+	stack.push(0);
+	while (!stack.empty()) {
+		const BvhNode& node = bvh.nodes[stack.pop()];
+		if (!overlapsNode(node, boundsMin, boundsMax)) continue;
+
+		if (!node.isLeaf()) {
+			stack.push(node.leftFirst + 1);
+			stack.push(node.leftFirst);
+			continue;
+		}
+
+		for (uint32_t i = node.leftFirst; i < node.leftFirst + node.count; ++i) {
+			const unsigned int t = bvh.triangles[i];
+			const Math::Vec3<float>& p0 = mesh.vertices[mesh.indices[t * 3 + 0]].pos;
+			const Math::Vec3<float>& p1 = mesh.vertices[mesh.indices[t * 3 + 1]].pos;
+			const Math::Vec3<float>& p2 = mesh.vertices[mesh.indices[t * 3 + 2]].pos;
+			if (triangleOverlapsBox(p0, p1, p2, centre, half)) triangles.push_back(t);
+		}
+	}
+}
+
+}
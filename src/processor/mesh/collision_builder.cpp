@@ -0,0 +1,430 @@
+#include "starlet-serializer/processor/mesh/collision_builder.hpp"
+#include "starlet-serializer/data/collision_data.hpp"
+#include "starlet-serializer/data/mesh_data.hpp"
+
+#include "starlet-serializer/utils/parallel.hpp"
+#include "starlet-serializer/utils/vec_ops.hpp"
+
+#include "starlet-logger/logger.hpp"
+
+#include "starlet-math/vertex.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <unordered_set>
+
+namespace Starlet::Serializer {
+
+namespace {
+	constexpr size_t   COLLISION_GRAIN = 64 * 1024;
+	constexpr uint32_t NONE = 0xFFFFFFFFu;
+	constexpr int      JACOBI_SWEEPS = 32;
+
+	struct HullFace {
+		uint32_t v[3]{ 0, 0, 0 };
+		Math::Vec3<float> normal;
+		float offset{ 0.0f };
+		std::vector<uint32_t> outside;
+		uint32_t farthest{ NONE };
+		float farthestDistance{ 0.0f };
+		bool alive{ true };
+	};
+
+	HullFace makeFace(const std::vector<Math::Vec3<float>>& points, uint32_t a, uint32_t b, uint32_t c) {
+		HullFace face;
+		face.v[0] = a; face.v[1] = b; face.v[2] = c;
+		face.normal = Utils::normalize(Utils::cross(Utils::sub(points[b], points[a]), Utils::sub(points[c], points[a])));
+		face.offset = Utils::dot(face.normal, points[a]);
+		return face;
+	}
+
+	float faceDistance(const HullFace& face, const Math::Vec3<float>& p) {
+		return Utils::dot(face.normal, p) - face.offset;
+	}
+
+	void addOutside(HullFace& face, uint32_t point, float distance) {
+		face.outside.push_back(point);
+		if (distance > face.farthestDistance) {
+			face.farthestDistance = distance;
+			face.farthest = point;
+		}
+	}
+
+	uint64_t edgeKey(uint32_t a, uint32_t b) { return (static_cast<uint64_t>(a) << 32) | b; }
+
+	// Eigenvectors of a symmetric 3x3 matrix by cyclic Jacobi rotations, returned as columns of v
+	void jacobiEigenvectors(double a[3][3], double v[3][3]) {
+		for (int i = 0; i < 3; ++i)
+			for (int j = 0; j < 3; ++j) v[i][j] = i == j ? 1.0 : 0.0;
+
+		for (int sweep = 0; sweep < JACOBI_SWEEPS; ++sweep) {
+			const double off = a[0][1] * a[0][1] + a[0][2] * a[0][2] + a[1][2] * a[1][2];
+			if (off < 1e-24) break;
+
+			for (int p = 0; p < 2; ++p) {
+				for (int q = p + 1; q < 3; ++q) {
+					if (std::fabs(a[p][q]) < 1e-30) continue;
+					const double theta = (a[q][q] - a[p][p]) / (2.0 * a[p][q]);
+					const double t = (theta >= 0.0 ? 1.0 : -1.0) / (std::fabs(theta) + std::sqrt(theta * theta + 1.0));
+					const double c = 1.0 / std::sqrt(t * t + 1.0), s = t * c;
+
+					for (int k = 0; k < 3; ++k) {
+						const double akp = a[k][p], akq = a[k][q];
+						a[k][p] = c * akp - s * akq;
+						a[k][q] = s * akp + c * akq;
+					}
+					for (int k = 0; k < 3; ++k) {
+						const double apk = a[p][k], aqk = a[q][k];
+						a[p][k] = c * apk - s * aqk;
+						a[q][k] = s * apk + c * aqk;
+					}
+					for (int k = 0; k < 3; ++k) {
+						const double vkp = v[k][p], vkq = v[k][q];
+						v[k][p] = c * vkp - s * vkq;
+						v[k][q] = s * vkp + c * vkq;
+					}
+				}
+			}
+		}
+	}
+
+	// Min/max of the points projected on three axes
+	void projectedRange(const std::vector<Math::Vec3<float>>& points, const Math::Vec3<float> (&axes)[3], float (&min)[3], float (&max)[3]) {
+		struct Range { float min[3]{ FLT_MAX, FLT_MAX, FLT_MAX }, max[3]{ -FLT_MAX, -FLT_MAX, -FLT_MAX }; };
+		std::vector<Range> ranges(std::max<size_t>(1, Utils::chunkCount(points.size(), COLLISION_GRAIN)));
+		Utils::parallelForChunks(points.size(), COLLISION_GRAIN, [&](size_t chunk, size_t begin, size_t end) {
+			Range& r = ranges[chunk];
+			for (size_t i = begin; i < end; ++i) {
+				for (int a = 0; a < 3; ++a) {
+					const float d = Utils::dot(points[i], axes[a]);
+					r.min[a] = std::min(r.min[a], d);
+					r.max[a] = std::max(r.max[a], d);
+				}
+			}
+		});
+		for (int a = 0; a < 3; ++a) {
+			min[a] = FLT_MAX;
+			max[a] = -FLT_MAX;
+			for (const Range& r : ranges) {
+				min[a] = std::min(min[a], r.min[a]);
+				max[a] = std::max(max[a], r.max[a]);
+			}
+		}
+	}
+}
+
+bool CollisionBuilder::build(const MeshData& mesh, CollisionData& out, const CollisionOptions& options) {
+	if (mesh.vertices.empty()) return Logger::error("CollisionBuilder", "build", "Mesh has no vertices");
+
+	std::vector<Math::Vec3<float>> points(mesh.vertices.size());
+	Utils::parallelFor(points.size(), COLLISION_GRAIN, [&](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i) points[i] = mesh.vertices[i].pos;
+	});
+
+	if (!buildHull(points, out.hull, options.maxHullVertices)) return false;
+	buildKDop(points, out.kdop);
+	buildObb(points, out.obb);
+	return true;
+}
+
+bool CollisionBuilder::buildHull(const std::vector<Math::Vec3<float>>& points, ConvexHullData& out, unsigned int maxVertices) {
+	out.vertices.clear();
+	out.indices.clear();
+	if (maxVertices < 4) return Logger::error("CollisionBuilder", "buildHull", "Max hull vertices must be at least 4");
+	if (points.size() < 4) return Logger::error("CollisionBuilder", "buildHull", "Need at least 4 points for a convex hull");
+
+	// Extreme points along each axis, plus the coordinate scale for the plane tolerance
+	struct Extremes { uint32_t min[3]{ 0, 0, 0 }, max[3]{ 0, 0, 0 }; float scale{ 0.0f }; };
+	std::vector<Extremes> partial(std::max<size_t>(1, Utils::chunkCount(points.size(), COLLISION_GRAIN)));
+	Utils::parallelForChunks(points.size(), COLLISION_GRAIN, [&](size_t chunk, size_t begin, size_t end) {
+		Extremes& e = partial[chunk];
+		for (int a = 0; a < 3; ++a) e.min[a] = e.max[a] = static_cast<uint32_t>(begin);
+		for (size_t i = begin; i < end; ++i) {
+			const float p[3] = { points[i].x, points[i].y, points[i].z };
+			for (int a = 0; a < 3; ++a) {
+				if (p[a] < (&points[e.min[a]].x)[a]) e.min[a] = static_cast<uint32_t>(i);
+				if (p[a] > (&points[e.max[a]].x)[a]) e.max[a] = static_cast<uint32_t>(i);
+			}
+			e.scale = std::max(e.scale, std::fabs(p[0]) + std::fabs(p[1]) + std::fabs(p[2]));
+		}
+	});
+	Extremes extremes = partial[0];
+	for (const Extremes& e : partial) {
+		for (int a = 0; a < 3; ++a) {
+			if ((&points[e.min[a]].x)[a] < (&points[extremes.min[a]].x)[a]) extremes.min[a] = e.min[a];
+			if ((&points[e.max[a]].x)[a] > (&points[extremes.max[a]].x)[a]) extremes.max[a] = e.max[a];
+		}
+		extremes.scale = std::max(extremes.scale, e.scale);
+	}
+	const float epsilon = 3.0f * FLT_EPSILON * std::max(extremes.scale, FLT_MIN);
+
+	// Initial tetrahedron: the most distant extreme pair, the point farthest from that line, then
+	// the point farthest from their plane
+	uint32_t v0 = extremes.min[0], v1 = extremes.max[0];
+	float best = -1.0f;
+	for (int a = 0; a < 3; ++a) {
+		const Math::Vec3<float> d = Utils::sub(points[extremes.max[a]], points[extremes.min[a]]);
+		if (Utils::dot(d, d) > best) {
+			best = Utils::dot(d, d);
+			v0 = extremes.min[a];
+			v1 = extremes.max[a];
+		}
+	}
+	if (std::sqrt(best) <= epsilon) return Logger::error("CollisionBuilder", "buildHull", "Points are coincident; cannot build a convex hull");
+
+	const auto farthestPoint = [&](auto&& metric) {
+		std::vector<std::pair<float, uint32_t>> bests(partial.size(), { -1.0f, 0u });
+		Utils::parallelForChunks(points.size(), COLLISION_GRAIN, [&](size_t chunk, size_t begin, size_t end) {
+			for (size_t i = begin; i < end; ++i) {
+				const float m = metric(points[i]);
+				if (m > bests[chunk].first) bests[chunk] = { m, static_cast<uint32_t>(i) };
+			}
+		});
+		return *std::max_element(bests.begin(), bests.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+	};
+
+	const Math::Vec3<float> lineDir = Utils::normalize(Utils::sub(points[v1], points[v0]));
+	const auto [lineDistance, v2] = farthestPoint([&](const Math::Vec3<float>& p) {
+		return Utils::length(Utils::cross(Utils::sub(p, points[v0]), lineDir));
+	});
+	if (lineDistance <= epsilon) return Logger::error("CollisionBuilder", "buildHull", "Points are collinear; cannot build a convex hull");
+
+	const Math::Vec3<float> planeNormal = Utils::normalize(Utils::cross(Utils::sub(points[v1], points[v0]), Utils::sub(points[v2], points[v0])));
+	const auto [planeDistance, v3] = farthestPoint([&](const Math::Vec3<float>& p) {
+		return std::fabs(Utils::dot(Utils::sub(p, points[v0]), planeNormal));
+	});
+	if (planeDistance <= epsilon) return Logger::error("CollisionBuilder", "buildHull", "Points are coplanar; cannot build a convex hull");
+
+	std::vector<HullFace> faces;
+	faces.push_back(makeFace(points, v0, v1, v2));
+	faces.push_back(makeFace(points, v0, v3, v1));
+	faces.push_back(makeFace(points, v1, v3, v2));
+	faces.push_back(makeFace(points, v2, v3, v0));
+	const Math::Vec3<float> centroid = Utils::scale(Utils::add(Utils::add(points[v0], points[v1]), Utils::add(points[v2], points[v3])), 0.25f);
+	for (HullFace& face : faces)
+		if (faceDistance(face, centroid) > 0.0f) face = makeFace(points, face.v[0], face.v[2], face.v[1]);
+
+	// Initial outside sets, gathered per chunk and appended in chunk order
+	std::vector<std::array<std::vector<uint32_t>, 4>> chunkOutside(partial.size());
+	Utils::parallelForChunks(points.size(), COLLISION_GRAIN, [&](size_t chunk, size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i) {
+			int bestFace = -1;
+			float bestDistance = epsilon;
+			for (int f = 0; f < 4; ++f) {
+				const float d = faceDistance(faces[f], points[i]);
+				if (d > bestDistance) {
+					bestDistance = d;
+					bestFace = f;
+				}
+			}
+			if (bestFace >= 0) chunkOutside[chunk][bestFace].push_back(static_cast<uint32_t>(i));
+		}
+	});
+	for (const auto& lists : chunkOutside)
+		for (int f = 0; f < 4; ++f)
+			for (uint32_t p : lists[f]) addOutside(faces[f], p, faceDistance(faces[f], points[p]));
+
+	unsigned int hullVertices = 4;
+	std::vector<size_t> visible;
+	std::vector<std::pair<uint32_t, uint32_t>> horizon;
+	std::unordered_set<uint64_t> visibleEdges;
+	std::vector<uint32_t> orphans;
+
+	while (hullVertices < maxVertices) {
+		size_t next = NONE;
+		for (size_t f = 0; f < faces.size(); ++f)
+			if (faces[f].alive && faces[f].farthest != NONE && (next == NONE || faces[f].farthestDistance > faces[next].farthestDistance))
+				next = f;
+		if (next == NONE) break;
+
+		const uint32_t eye = faces[next].farthest;
+		const Math::Vec3<float>& eyePoint = points[eye];
+
+		visible.clear();
+		visibleEdges.clear();
+		for (size_t f = 0; f < faces.size(); ++f) {
+			if (!faces[f].alive || (f != next && faceDistance(faces[f], eyePoint) <= epsilon)) continue;
+			visible.push_back(f);
+			for (int k = 0; k < 3; ++k) visibleEdges.insert(edgeKey(faces[f].v[k], faces[f].v[(k + 1) % 3]));
+		}
+
+		horizon.clear();
+		orphans.clear();
+		for (size_t f : visible) {
+			HullFace& face = faces[f];
+			for (int k = 0; k < 3; ++k) {
+				const uint32_t a = face.v[k], b = face.v[(k + 1) % 3];
+				if (!visibleEdges.count(edgeKey(b, a))) horizon.push_back({ a, b });
+			}
+			for (uint32_t p : face.outside)
+				if (p != eye) orphans.push_back(p);
+			face.alive = false;
+			std::vector<uint32_t>().swap(face.outside);
+		}
+
+		const size_t firstNew = faces.size();
+		for (const auto& [a, b] : horizon) faces.push_back(makeFace(points, a, b, eye));
+
+		for (uint32_t p : orphans) {
+			size_t bestFace = NONE;
+			float bestDistance = epsilon;
+			for (size_t f = firstNew; f < faces.size(); ++f) {
+				const float d = faceDistance(faces[f], points[p]);
+				if (d > bestDistance) {
+					bestDistance = d;
+					bestFace = f;
+				}
+			}
+			if (bestFace != NONE) addOutside(faces[bestFace], p, bestDistance);
+		}
+		++hullVertices;
+	}
+
+	std::vector<uint32_t> remap(points.size(), NONE);
+	for (const HullFace& face : faces) {
+		if (!face.alive) continue;
+		for (uint32_t v : face.v) {
+			if (remap[v] == NONE) {
+				remap[v] = static_cast<uint32_t>(out.vertices.size());
+				out.vertices.push_back(points[v]);
+			}
+			out.indices.push_back(remap[v]);
+		}
+	}
+	return true;
+}
+
+void CollisionBuilder::buildKDop(const std::vector<Math::Vec3<float>>& points, KDopData& out) const {
+	struct Slabs { float min[KDopData::AXIS_COUNT], max[KDopData::AXIS_COUNT]; };
+	Math::Vec3<float> axes[KDopData::AXIS_COUNT];
+	for (size_t a = 0; a < KDopData::AXIS_COUNT; ++a) axes[a] = KDopData::axis(a);
+
+	std::vector<Slabs> partial(std::max<size_t>(1, Utils::chunkCount(points.size(), COLLISION_GRAIN)));
+	for (Slabs& s : partial) {
+		std::fill(std::begin(s.min), std::end(s.min), FLT_MAX);
+		std::fill(std::begin(s.max), std::end(s.max), -FLT_MAX);
+	}
+	Utils::parallelForChunks(points.size(), COLLISION_GRAIN, [&](size_t chunk, size_t begin, size_t end) {
+		Slabs& s = partial[chunk];
+		for (size_t i = begin; i < end; ++i) {
+			for (size_t a = 0; a < KDopData::AXIS_COUNT; ++a) {
+				const float d = Utils::dot(points[i], axes[a]);
+				s.min[a] = std::min(s.min[a], d);
+				s.max[a] = std::max(s.max[a], d);
+			}
+		}
+	});
+
+	for (size_t a = 0; a < KDopData::AXIS_COUNT; ++a) {
+		out.min[a] = FLT_MAX;
+		out.max[a] = -FLT_MAX;
+		for (const Slabs& s : partial) {
+			out.min[a] = std::min(out.min[a], s.min[a]);
+			out.max[a] = std::max(out.max[a], s.max[a]);
+		}
+	}
+}
+
+void CollisionBuilder::buildObb(const std::vector<Math::Vec3<float>>& points, ObbData& out) const {
+	out = ObbData{};
+	if (points.empty()) return;
+
+	// Mean and covariance, accumulated in double per chunk
+	struct Moments { double sum[3]{}, cov[6]{}; };
+	std::vector<Moments> partial(std::max<size_t>(1, Utils::chunkCount(points.size(), COLLISION_GRAIN)));
+	Utils::parallelForChunks(points.size(), COLLISION_GRAIN, [&](size_t chunk, size_t begin, size_t end) {
+		Moments& m = partial[chunk];
+		for (size_t i = begin; i < end; ++i) {
+			const double x = points[i].x, y = points[i].y, z = points[i].z;
+			m.sum[0] += x; m.sum[1] += y; m.sum[2] += z;
+			m.cov[0] += x * x; m.cov[1] += x * y; m.cov[2] += x * z;
+			m.cov[3] += y * y; m.cov[4] += y * z; m.cov[5] += z * z;
+		}
+	});
+	Moments total;
+	for (const Moments& m : partial) {
+		for (int i = 0; i < 3; ++i) total.sum[i] += m.sum[i];
+		for (int i = 0; i < 6; ++i) total.cov[i] += m.cov[i];
+	}
+
+	const double n = static_cast<double>(points.size());
+	const double mean[3] = { total.sum[0] / n, total.sum[1] / n, total.sum[2] / n };
+	double cov[3][3] = {
+		{ total.cov[0] / n - mean[0] * mean[0], total.cov[1] / n - mean[0] * mean[1], total.cov[2] / n - mean[0] * mean[2] },
+		{ 0.0,                                  total.cov[3] / n - mean[1] * mean[1], total.cov[4] / n - mean[1] * mean[2] },
+		{ 0.0,                                  0.0,                                  total.cov[5] / n - mean[2] * mean[2] }
+	};
+	cov[1][0] = cov[0][1]; cov[2][0] = cov[0][2]; cov[2][1] = cov[1][2];
+
+	double vectors[3][3];
+	jacobiEigenvectors(cov, vectors);
+
+	Math::Vec3<float> pcaAxes[3];
+	for (int a = 0; a < 2; ++a)
+		pcaAxes[a] = Utils::normalize({ static_cast<float>(vectors[0][a]), static_cast<float>(vectors[1][a]), static_cast<float>(vectors[2][a]) });
+	pcaAxes[2] = Utils::normalize(Utils::cross(pcaAxes[0], pcaAxes[1]));
+
+	// PCA boxes can be worse than the AABB (e.g. for axis-aligned boxes with uneven density), so keep the smaller
+	const Math::Vec3<float> worldAxes[3] = { { 1.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f }, { 0.0f, 0.0f, 1.0f } };
+	float pcaMin[3], pcaMax[3], aabbMin[3], aabbMax[3];
+	projectedRange(points, pcaAxes, pcaMin, pcaMax);
+	projectedRange(points, worldAxes, aabbMin, aabbMax);
+
+	const float pcaVolume = (pcaMax[0] - pcaMin[0]) * (pcaMax[1] - pcaMin[1]) * (pcaMax[2] - pcaMin[2]);
+	const float aabbVolume = (aabbMax[0] - aabbMin[0]) * (aabbMax[1] - aabbMin[1]) * (aabbMax[2] - aabbMin[2]);
+	const bool usePca = pcaVolume < aabbVolume * 0.999f;
+	const Math::Vec3<float>* axes = usePca ? pcaAxes : worldAxes;
+	const float* min = usePca ? pcaMin : aabbMin;
+	const float* max = usePca ? pcaMax : aabbMax;
+
+	out.center = { 0.0f, 0.0f, 0.0f };
+	for (int a = 0; a < 3; ++a) {
+		out.axes[a] = axes[a];
+		out.center = Utils::add(out.center, Utils::scale(axes[a], (min[a] + max[a]) * 0.5f));
+	}
+	out.halfExtents = { (max[0] - min[0]) * 0.5f, (max[1] - min[1]) * 0.5f, (max[2] - min[2]) * 0.5f };
+}
+
+void CollisionBuilder::inflate(CollisionData& collision, const Math::Vec3<float>& margin) const {
+	// Support of the margin box along a unit direction
+	const auto reach = [&](const Math::Vec3<float>& n) {
+		return std::fabs(n.x) * margin.x + std::fabs(n.y) * margin.y + std::fabs(n.z) * margin.z;
+	};
+
+	for (size_t a = 0; a < KDopData::AXIS_COUNT; ++a) {
+		const float r = reach(KDopData::axis(a));
+		collision.kdop.min[a] -= r;
+		collision.kdop.max[a] += r;
+	}
+
+	ObbData& obb = collision.obb;
+	obb.halfExtents = { obb.halfExtents.x + reach(obb.axes[0]), obb.halfExtents.y + reach(obb.axes[1]), obb.halfExtents.z + reach(obb.axes[2]) };
+
+	ConvexHullData& hull = collision.hull;
+	if (hull.vertices.empty()) return;
+	Math::Vec3<float> centroid{ 0.0f, 0.0f, 0.0f };
+	for (const Math::Vec3<float>& v : hull.vertices) centroid = Utils::add(centroid, v);
+	centroid = Utils::scale(centroid, 1.0f / static_cast<float>(hull.vertices.size()));
+
+	// Scaling by f moves a face at distance d from the centroid out by d * (f - 1)
+	float factor = 1.0f;
+	for (size_t t = 0; t + 2 < hull.indices.size(); t += 3) {
+		const Math::Vec3<float>& a = hull.vertices[hull.indices[t]];
+		const Math::Vec3<float> normal = Utils::normalize(Utils::cross(Utils::sub(hull.vertices[hull.indices[t + 1]], a), Utils::sub(hull.vertices[hull.indices[t + 2]], a)));
+		const float r = reach(normal);
+		if (r <= 0.0f) continue;
+		const float distance = Utils::dot(normal, Utils::sub(a, centroid));
+		if (distance <= FLT_EPSILON * (Utils::length(a) + Utils::length(centroid))) {
+			Logger::warning("CollisionBuilder", "inflate", "Hull has no interior, leaving it unchanged");
+			return;
+		}
+		factor = std::max(factor, 1.0f + r / distance);
+	}
+	for (Math::Vec3<float>& v : hull.vertices)
+		v = Utils::add(centroid, Utils::scale(Utils::sub(v, centroid), factor));
+}
+
+}
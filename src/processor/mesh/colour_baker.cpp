@@ -0,0 +1,146 @@
+#include "starlet-serializer/processor/mesh/colour_baker.hpp"
+#include "starlet-serializer/data/mesh_data.hpp"
+#include "starlet-serializer/data/model_data.hpp"
+
+#include "starlet-serializer/utils/parallel.hpp"
+
+#include "starlet-logger/logger.hpp"
+
+#include "starlet-math/vertex.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define STARLET_COLOUR_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace Starlet::Serializer {
+
+namespace {
+	constexpr size_t COLOUR_GRAIN = 64 * 1024;
+	constexpr float  RAINBOW_HUE_RANGE = 5.0f / 6.0f; // Stop at violet rather than wrapping to red
+
+	static_assert(sizeof(Math::Vec4<float>) == 4 * sizeof(float), "Vertex colours must be packed floats");
+
+	uint32_t hashName(const std::string& name) {
+		uint32_t hash = 2166136261u;
+		for (unsigned char c : name) hash = (hash ^ c) * 16777619u;
+		return hash;
+	}
+
+	uint32_t hashIndex(uint32_t seed, uint32_t index) {
+		uint32_t x = seed ^ (index * 0x9E3779B9u);
+		x ^= x >> 16; x *= 0x7FEB352Du;
+		x ^= x >> 15; x *= 0x846CA68Bu;
+		x ^= x >> 16;
+		return x;
+	}
+
+	// Hue in sextants [0, 6) to a fully saturated colour: each channel is a clamped triangle wave.
+	// The SSE path below evaluates the same expressions in the same order.
+	void hueToRgb(float h, float& r, float& g, float& b) {
+		r = std::clamp(std::abs(h - 3.0f) - 1.0f, 0.0f, 1.0f);
+		g = std::clamp(2.0f - std::abs(h - 2.0f), 0.0f, 1.0f);
+		b = std::clamp(2.0f - std::abs(h - 4.0f), 0.0f, 1.0f);
+	}
+
+	void fillSolid(Math::Vertex* vertices, size_t begin, size_t end, const Math::Vec4<float>& colour) {
+		for (size_t i = begin; i < end; ++i) vertices[i].col = colour;
+	}
+
+	void fillRandom(Math::Vertex* vertices, size_t begin, size_t end, uint32_t seed, float alpha) {
+		constexpr float toUnit = 1.0f / 255.0f;
+		for (size_t i = begin; i < end; ++i) {
+			const uint32_t h = hashIndex(seed, static_cast<uint32_t>(i));
+			vertices[i].col = {
+				static_cast<float>(h & 0xFF) * toUnit,
+				static_cast<float>((h >> 8) & 0xFF) * toUnit,
+				static_cast<float>((h >> 16) & 0xFF) * toUnit,
+				alpha
+			};
+		}
+	}
+
+	void fillGradientScalar(Math::Vertex* vertices, size_t begin, size_t end, float minY, float hueScale, float alpha) {
+		for (size_t i = begin; i < end; ++i) {
+			float r, g, b;
+			hueToRgb(std::min(std::max((vertices[i].pos.y - minY) * (hueScale * 6.0f), 0.0f), RAINBOW_HUE_RANGE * 6.0f), r, g, b);
+			vertices[i].col = { r, g, b, alpha };
+		}
+	}
+
+	void fillGradient(Math::Vertex* vertices, size_t begin, size_t end, float minY, float hueScale, float alpha) {
+#ifdef STARLET_COLOUR_SSE2
+		const __m128 one = _mm_set1_ps(1.0f), two = _mm_set1_ps(2.0f), three = _mm_set1_ps(3.0f), four = _mm_set1_ps(4.0f);
+		const __m128 zero = _mm_setzero_ps(), maxHue = _mm_set1_ps(RAINBOW_HUE_RANGE * 6.0f);
+		const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+		const __m128 base = _mm_set1_ps(minY), scale = _mm_set1_ps(hueScale * 6.0f), a = _mm_set1_ps(alpha);
+
+		size_t i = begin;
+		for (; i + 4 <= end; i += 4) {
+			const __m128 y = _mm_setr_ps(vertices[i].pos.y, vertices[i + 1].pos.y, vertices[i + 2].pos.y, vertices[i + 3].pos.y);
+			const __m128 h = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_sub_ps(y, base), scale), zero), maxHue);
+			__m128 r = _mm_sub_ps(_mm_and_ps(_mm_sub_ps(h, three), absMask), one);
+			__m128 g = _mm_sub_ps(two, _mm_and_ps(_mm_sub_ps(h, two), absMask));
+			__m128 b = _mm_sub_ps(two, _mm_and_ps(_mm_sub_ps(h, four), absMask));
+			r = _mm_min_ps(_mm_max_ps(r, zero), one);
+			g = _mm_min_ps(_mm_max_ps(g, zero), one);
+			b = _mm_min_ps(_mm_max_ps(b, zero), one);
+
+			__m128 alphas = a;
+			_MM_TRANSPOSE4_PS(r, g, b, alphas);
+			_mm_storeu_ps(&vertices[i].col.x, r);
+			_mm_storeu_ps(&vertices[i + 1].col.x, g);
+			_mm_storeu_ps(&vertices[i + 2].col.x, b);
+			_mm_storeu_ps(&vertices[i + 3].col.x, alphas);
+		}
+		fillGradientScalar(vertices, i, end, minY, hueScale, alpha);
+#else
+		fillGradientScalar(vertices, begin, end, minY, hueScale, alpha);
+#endif
+	}
+}
+
+bool ColourBaker::bake(const ModelData& model, MeshData& mesh) const {
+	if (mesh.vertices.empty()) return Logger::error("ColourBaker", "bake", "Mesh has no vertices: " + model.meshPath);
+
+	Math::Vertex* vertices = mesh.vertices.data();
+	const Math::Vec4<float>& colour = model.colour.colour;
+
+	switch (model.mode) {
+	case ColourMode::Solid:
+		Utils::parallelFor(mesh.vertices.size(), COLOUR_GRAIN, [&](size_t begin, size_t end) {
+			fillSolid(vertices, begin, end, colour);
+		});
+		break;
+	case ColourMode::Random: {
+		const uint32_t seed = hashName(model.name);
+		Utils::parallelFor(mesh.vertices.size(), COLOUR_GRAIN, [&](size_t begin, size_t end) {
+			fillRandom(vertices, begin, end, seed, colour.w);
+		});
+		break;
+	}
+	case ColourMode::VerticalGradient: {
+		const float height = mesh.maxY - mesh.minY;
+		const float hueScale = height > 0.0f ? RAINBOW_HUE_RANGE / height : 0.0f;
+		Utils::parallelFor(mesh.vertices.size(), COLOUR_GRAIN, [&](size_t begin, size_t end) {
+			fillGradient(vertices, begin, end, mesh.minY, hueScale, colour.w);
+		});
+		break;
+	}
+	case ColourMode::VertexColour:
+		if (mesh.hasColours) return true;
+		Utils::parallelFor(mesh.vertices.size(), COLOUR_GRAIN, [&](size_t begin, size_t end) {
+			fillSolid(vertices, begin, end, colour);
+		});
+		break;
+	}
+
+	mesh.hasColours = true;
+	return true;
+}
+
+}
@@ -0,0 +1,108 @@
+#include "starlet-serializer/processor/mesh/mesh_batcher.hpp"
+#include "starlet-serializer/data/mesh_batch_data.hpp"
+#include "starlet-serializer/data/mesh_data.hpp"
+
+#include "starlet-serializer/utils/parallel.hpp"
+
+#include "starlet-logger/logger.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+
+namespace Starlet::Serializer {
+
+namespace {
+	constexpr size_t BATCH_GRAIN = 64 * 1024;
+
+	// Calls fn(mesh, localBegin, localEnd, outputBegin) for every part of each mesh that overlaps
+	// the output slice [begin, end), where offsets are the prefix sums of the mesh sizes
+	template <typename Fn>
+	void forEachSegment(const std::vector<size_t>& offsets, size_t begin, size_t end, Fn&& fn) {
+		size_t mesh = static_cast<size_t>(std::upper_bound(offsets.begin(), offsets.end(), begin) - offsets.begin()) - 1;
+		while (begin < end) {
+			const size_t meshEnd = std::min(end, offsets[mesh + 1]);
+			if (meshEnd > begin) fn(mesh, begin - offsets[mesh], meshEnd - offsets[mesh], begin);
+			begin = meshEnd;
+			++mesh;
+		}
+	}
+}
+
+bool MeshBatcher::build(const std::vector<MeshData>& meshes, MeshBatchData& out, bool rebaseIndices) {
+	std::vector<const MeshData*> pointers(meshes.size());
+	for (size_t i = 0; i < meshes.size(); ++i) pointers[i] = &meshes[i];
+	return build(pointers, out, rebaseIndices);
+}
+
+bool MeshBatcher::build(const std::vector<const MeshData*>& meshes, MeshBatchData& out, bool rebaseIndices) {
+	out = MeshBatchData{};
+	if (meshes.empty()) return Logger::error("MeshBatcher", "build", "No meshes to batch");
+
+	std::vector<size_t> vertexOffsets(meshes.size() + 1, 0), indexOffsets(meshes.size() + 1, 0);
+	for (size_t m = 0; m < meshes.size(); ++m) {
+		if (!meshes[m]) return Logger::error("MeshBatcher", "build", "Mesh " + std::to_string(m) + " is null");
+		vertexOffsets[m + 1] = vertexOffsets[m] + meshes[m]->vertices.size();
+		indexOffsets[m + 1] = indexOffsets[m] + meshes[m]->indices.size();
+		out.hasTangents |= meshes[m]->hasTangents && meshes[m]->tangents.size() == meshes[m]->vertices.size();
+	}
+
+	const size_t vertexCount = vertexOffsets.back(), indexCount = indexOffsets.back();
+	if (vertexCount > std::numeric_limits<int32_t>::max() || indexCount > std::numeric_limits<uint32_t>::max())
+		return Logger::error("MeshBatcher", "build", "Batch exceeds 32-bit offsets: " + std::to_string(vertexCount) + " vertices");
+
+	out.entries.resize(meshes.size());
+	for (size_t m = 0; m < meshes.size(); ++m) {
+		MeshBatchEntry& entry = out.entries[m];
+		entry.indexCount = static_cast<uint32_t>(meshes[m]->indices.size());
+		entry.firstIndex = static_cast<uint32_t>(indexOffsets[m]);
+		entry.baseVertex = rebaseIndices ? 0 : static_cast<int32_t>(vertexOffsets[m]);
+		entry.baseInstance = static_cast<uint32_t>(m);
+		entry.firstVertex = static_cast<uint32_t>(vertexOffsets[m]);
+		entry.vertexCount = static_cast<uint32_t>(meshes[m]->vertices.size());
+		entry.boundsMin = meshes[m]->boundsMin;
+		entry.boundsMax = meshes[m]->boundsMax;
+	}
+
+	out.vertices.resize(vertexCount);
+	if (out.hasTangents) out.tangents.resize(vertexCount);
+	Utils::parallelFor(vertexCount, BATCH_GRAIN, [&](size_t begin, size_t end) {
+		forEachSegment(vertexOffsets, begin, end, [&](size_t m, size_t first, size_t last, size_t target) {
+			const MeshData& mesh = *meshes[m];
+			std::copy_n(mesh.vertices.begin() + first, last - first, out.vertices.begin() + target);
+			if (!out.hasTangents) return;
+			if (mesh.tangents.size() == mesh.vertices.size() && mesh.hasTangents)
+				std::copy_n(mesh.tangents.begin() + first, last - first, out.tangents.begin() + target);
+			else
+				std::fill(out.tangents.begin() + target, out.tangents.begin() + target + (last - first), Math::Vec4<float>{ 0.0f, 0.0f, 0.0f, 1.0f });
+		});
+	});
+
+	out.indices.resize(indexCount);
+	std::vector<size_t> badIndex(Utils::chunkCount(indexCount, BATCH_GRAIN), SIZE_MAX);
+	Utils::parallelForChunks(indexCount, BATCH_GRAIN, [&](size_t chunk, size_t begin, size_t end) {
+		forEachSegment(indexOffsets, begin, end, [&](size_t m, size_t first, size_t last, size_t target) {
+			const MeshData& mesh = *meshes[m];
+			const unsigned int base = rebaseIndices ? static_cast<unsigned int>(vertexOffsets[m]) : 0u;
+			const size_t limit = mesh.vertices.size();
+			for (size_t i = first; i < last; ++i, ++target) {
+				const unsigned int index = mesh.indices[i];
+				if (index >= limit && badIndex[chunk] == SIZE_MAX) badIndex[chunk] = target;
+				out.indices[target] = index + base;
+			}
+		});
+	});
+
+	for (size_t bad : badIndex) {
+		if (bad == SIZE_MAX) continue;
+		const size_t m = static_cast<size_t>(std::upper_bound(indexOffsets.begin(), indexOffsets.end(), bad) - indexOffsets.begin()) - 1;
+		const size_t local = bad - indexOffsets[m];
+		out = MeshBatchData{};
+		return Logger::error("MeshBatcher", "build", "Index out of bounds in mesh " + std::to_string(m) + " at " + std::to_string(local) + ": " + std::to_string(meshes[m]->indices[local]));
+	}
+
+	out.rebasedIndices = rebaseIndices;
+	return true;
+}
+
+}
@@ -0,0 +1,411 @@
+#include "starlet-serializer/processor/mesh/mesh_codec.hpp"
+#include "starlet-serializer/data/mesh_data.hpp"
+
+#include "starlet-serializer/utils/binary_io.hpp"
+#include "starlet-serializer/utils/cpu_features.hpp"
+#include "starlet-serializer/utils/parallel.hpp"
+
+#include "starlet-logger/logger.hpp"
+
+#include "starlet-math/vertex.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#ifdef STARLET_X86
+#include <emmintrin.h>
+#include <tmmintrin.h>
+#endif
+
+namespace Starlet::Serializer {
+
+namespace {
+	constexpr size_t   GROUP_SIZE = 16;
+	// Vertex deltas restart every block so blocks decode independently and stay cache resident
+	constexpr size_t   BLOCK_GROUPS = 256;
+	constexpr size_t   BLOCK_VERTICES = BLOCK_GROUPS * GROUP_SIZE;
+	constexpr uint32_t QUANT_MAX = 65535;
+
+	enum VertexStreams : uint32_t {
+		STREAM_NORMALS   = 1u << 0,
+		STREAM_COLOURS   = 1u << 1,
+		STREAM_TEXCOORDS = 1u << 2,
+		STREAM_TANGENTS  = 1u << 3
+	};
+
+	enum GroupMode : uint8_t {
+		GROUP_ZERO = 0,
+		GROUP_LOW  = 1,
+		GROUP_FULL = 2
+	};
+
+	uint32_t zigzag32(uint32_t delta) { return (delta << 1) ^ (0u - (delta >> 31)); }
+	uint32_t unzigzag32(uint32_t value) { return (value >> 1) ^ (0u - (value & 1)); }
+	uint16_t zigzag16(uint16_t delta) { return static_cast<uint16_t>((delta << 1) ^ (0u - (delta >> 15))); }
+
+	unsigned int byteLength(uint32_t value) {
+		return value < (1u << 8) ? 1 : value < (1u << 16) ? 2 : value < (1u << 24) ? 3 : 4;
+	}
+
+	struct IndexTables {
+		std::array<std::array<uint8_t, 16>, 256> shuffle{};
+		std::array<uint8_t, 256> length{};
+
+		IndexTables() {
+			for (int control = 0; control < 256; ++control) {
+				uint8_t offset = 0;
+				for (int lane = 0; lane < 4; ++lane) {
+					const int bytes = ((control >> (lane * 2)) & 3) + 1;
+					for (int k = 0; k < 4; ++k)
+						shuffle[control][lane * 4 + k] = k < bytes ? static_cast<uint8_t>(offset + k) : 0x80;
+					offset = static_cast<uint8_t>(offset + bytes);
+				}
+				length[control] = offset;
+			}
+		}
+	};
+	const IndexTables& indexTables() {
+		static const IndexTables tables;
+		return tables;
+	}
+
+	size_t decodeIndicesScalar(const uint8_t* controls, size_t controlCount, const uint8_t*& data, unsigned int* out, uint32_t& previous) {
+		for (size_t c = 0; c < controlCount; ++c) {
+			for (int lane = 0; lane < 4; ++lane) {
+				const int bytes = ((controls[c] >> (lane * 2)) & 3) + 1;
+				uint32_t value = 0;
+				for (int k = 0; k < bytes; ++k) value |= static_cast<uint32_t>(data[k]) << (8 * k);
+				data += bytes;
+				previous += unzigzag32(value);
+				out[c * 4 + lane] = previous;
+			}
+		}
+		return controlCount * 4;
+	}
+
+#ifdef STARLET_X86
+	// Decodes whole control bytes while 16 payload bytes are readable; returns values written
+	STARLET_TARGET("ssse3")
+	size_t decodeIndicesSsse3(const uint8_t* controls, size_t controlCount, const uint8_t*& data, const uint8_t* dataEnd, unsigned int* out, uint32_t& previous) {
+		const IndexTables& tables = indexTables();
+		const __m128i one = _mm_set1_epi32(1);
+		__m128i carry = _mm_set1_epi32(static_cast<int>(previous));
+
+		size_t c = 0;
+		for (; c < controlCount && dataEnd - data >= 16; ++c) {
+			const uint8_t control = controls[c];
+			const __m128i raw = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+			const __m128i mask = _mm_loadu_si128(reinterpret_cast<const __m128i*>(tables.shuffle[control].data()));
+			__m128i v = _mm_shuffle_epi8(raw, mask);
+			v = _mm_xor_si128(_mm_srli_epi32(v, 1), _mm_sub_epi32(_mm_setzero_si128(), _mm_and_si128(v, one)));
+			v = _mm_add_epi32(v, _mm_slli_si128(v, 4));
+			v = _mm_add_epi32(v, _mm_slli_si128(v, 8));
+			v = _mm_add_epi32(v, carry);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(out + c * 4), v);
+			carry = _mm_shuffle_epi32(v, _MM_SHUFFLE(3, 3, 3, 3));
+			data += tables.length[control];
+		}
+		previous = static_cast<uint32_t>(_mm_cvtsi128_si32(carry));
+		return c * 4;
+	}
+#endif
+
+	uint16_t unzigzag16(uint16_t value) { return static_cast<uint16_t>((value >> 1) ^ (0u - (value & 1))); }
+
+	void decodeGroupsScalar(const uint8_t* modes, size_t firstGroup, size_t groupCount, const uint8_t* data, uint16_t* out) {
+		uint16_t previous = 0;
+		for (size_t g = 0; g < groupCount; ++g) {
+			const uint8_t mode = (modes[(firstGroup + g) / 4] >> (((firstGroup + g) % 4) * 2)) & 3;
+			for (size_t k = 0; k < GROUP_SIZE; ++k) {
+				uint16_t value = 0;
+				if (mode != GROUP_ZERO) value = data[k];
+				if (mode == GROUP_FULL) value = static_cast<uint16_t>(value | data[GROUP_SIZE + k] << 8);
+				previous = static_cast<uint16_t>(previous + unzigzag16(value));
+				out[g * GROUP_SIZE + k] = previous;
+			}
+			data += mode == GROUP_ZERO ? 0 : mode == GROUP_LOW ? GROUP_SIZE : GROUP_SIZE * 2;
+		}
+	}
+
+#ifdef STARLET_X86
+	__m128i prefixSum16(__m128i v, __m128i carry) {
+		v = _mm_add_epi16(v, _mm_slli_si128(v, 2));
+		v = _mm_add_epi16(v, _mm_slli_si128(v, 4));
+		v = _mm_add_epi16(v, _mm_slli_si128(v, 8));
+		return _mm_add_epi16(v, carry);
+	}
+	__m128i unzigzag16x8(__m128i v) {
+		return _mm_xor_si128(_mm_srli_epi16(v, 1), _mm_sub_epi16(_mm_setzero_si128(), _mm_and_si128(v, _mm_set1_epi16(1))));
+	}
+	__m128i broadcastLast16(__m128i v) {
+		const __m128i high = _mm_shufflehi_epi16(v, _MM_SHUFFLE(3, 3, 3, 3));
+		return _mm_unpackhi_epi64(high, high);
+	}
+
+	// SSE2 is part of the x86-64 baseline, so this path needs no runtime check
+	void decodeGroupsSse2(const uint8_t* modes, size_t firstGroup, size_t groupCount, const uint8_t* data, uint16_t* out) {
+		const __m128i zero = _mm_setzero_si128();
+		__m128i carry = zero;
+		for (size_t g = 0; g < groupCount; ++g) {
+			const uint8_t mode = (modes[(firstGroup + g) / 4] >> (((firstGroup + g) % 4) * 2)) & 3;
+			__m128i low = zero, high = zero;
+			if (mode != GROUP_ZERO) low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+			if (mode == GROUP_FULL) high = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + GROUP_SIZE));
+			data += mode == GROUP_ZERO ? 0 : mode == GROUP_LOW ? GROUP_SIZE : GROUP_SIZE * 2;
+
+			__m128i first = prefixSum16(unzigzag16x8(_mm_unpacklo_epi8(low, high)), carry);
+			carry = broadcastLast16(first);
+			__m128i second = prefixSum16(unzigzag16x8(_mm_unpackhi_epi8(low, high)), carry);
+			carry = broadcastLast16(second);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(out + g * GROUP_SIZE), first);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(out + g * GROUP_SIZE + 8), second);
+		}
+	}
+#endif
+
+	// A float attribute component: stride and byte offset inside either the vertex or tangent array
+	struct Component {
+		bool tangent;
+		size_t offset;
+	};
+
+	std::vector<Component> vertexComponents(uint32_t streams) {
+		const Math::Vertex v{};
+		const Math::Vec4<float> t{};
+		const auto at = [&](const float& field) { return static_cast<size_t>(reinterpret_cast<const char*>(&field) - reinterpret_cast<const char*>(&v)); };
+		const auto atTangent = [&](const float& field) { return static_cast<size_t>(reinterpret_cast<const char*>(&field) - reinterpret_cast<const char*>(&t)); };
+
+		std::vector<Component> components = { { false, at(v.pos.x) }, { false, at(v.pos.y) }, { false, at(v.pos.z) } };
+		if (streams & STREAM_NORMALS)   components.insert(components.end(), { { false, at(v.norm.x) }, { false, at(v.norm.y) }, { false, at(v.norm.z) } });
+		if (streams & STREAM_COLOURS)   components.insert(components.end(), { { false, at(v.col.x) }, { false, at(v.col.y) }, { false, at(v.col.z) }, { false, at(v.col.w) } });
+		if (streams & STREAM_TEXCOORDS) components.insert(components.end(), { { false, at(v.texCoord.x) }, { false, at(v.texCoord.y) } });
+		if (streams & STREAM_TANGENTS)  components.insert(components.end(), { { true, atTangent(t.x) }, { true, atTangent(t.y) }, { true, atTangent(t.z) }, { true, atTangent(t.w) } });
+		return components;
+	}
+
+	float readComponent(const MeshData& mesh, const Component& c, size_t i) {
+		const char* base = c.tangent ? reinterpret_cast<const char*>(&mesh.tangents[i]) : reinterpret_cast<const char*>(&mesh.vertices[i]);
+		float value;
+		memcpy(&value, base + c.offset, sizeof(value));
+		return value;
+	}
+}
+
+void MeshCodec::encodeIndices(const std::vector<unsigned int>& indices, std::vector<unsigned char>& out) const {
+	out.clear();
+	Utils::ByteWriter writer(out);
+	writer.u32(static_cast<uint32_t>(indices.size()));
+
+	const size_t controlCount = (indices.size() + 3) / 4;
+	const size_t controlStart = out.size();
+	out.resize(controlStart + controlCount, 0);
+
+	uint32_t previous = 0;
+	for (size_t i = 0; i < controlCount * 4; ++i) {
+		const uint32_t value = i < indices.size() ? zigzag32(indices[i] - previous) : 0;
+		if (i < indices.size()) previous = indices[i];
+		const unsigned int bytes = byteLength(value);
+		out[controlStart + i / 4] |= static_cast<unsigned char>((bytes - 1) << ((i % 4) * 2));
+		for (unsigned int k = 0; k < bytes; ++k) out.push_back(static_cast<unsigned char>(value >> (8 * k)));
+	}
+}
+
+bool MeshCodec::decodeIndices(const unsigned char* data, size_t size, std::vector<unsigned int>& out, Utils::SimdLevel level) const {
+	Utils::ByteReader reader(data, size);
+	uint32_t count{ 0 };
+	if (!reader.u32(count)) return Logger::error("MeshCodec", "decodeIndices", "Truncated index stream");
+
+	const size_t controlCount = (static_cast<size_t>(count) + 3) / 4;
+	if (controlCount > reader.remaining()) return Logger::error("MeshCodec", "decodeIndices", "Truncated index stream");
+
+	const uint8_t* controls = reader.current();
+	const uint8_t* payload = controls + controlCount;
+	const uint8_t* end = data + size;
+
+	const IndexTables& tables = indexTables();
+	size_t payloadSize = 0;
+	for (size_t c = 0; c < controlCount; ++c) payloadSize += tables.length[controls[c]];
+	if (payloadSize > static_cast<size_t>(end - payload)) return Logger::error("MeshCodec", "decodeIndices", "Index stream payload is truncated");
+
+	out.resize(controlCount * 4);
+	uint32_t previous = 0;
+	size_t decoded = 0;
+#ifdef STARLET_X86
+	if (level >= Utils::SimdLevel::Ssse3 && Utils::cpuHasSsse3()) decoded = decodeIndicesSsse3(controls, controlCount, payload, end, out.data(), previous) / 4;
+#else
+	(void)level;
+#endif
+	decodeIndicesScalar(controls + decoded, controlCount - decoded, payload, out.data() + decoded * 4, previous);
+	out.resize(count);
+	return true;
+}
+
+void MeshCodec::encodeVertices(const MeshData& mesh, std::vector<unsigned char>& out) const {
+	out.clear();
+	const size_t count = mesh.vertices.size();
+	uint32_t streams = 0;
+	if (mesh.hasNormals)   streams |= STREAM_NORMALS;
+	if (mesh.hasColours)   streams |= STREAM_COLOURS;
+	if (mesh.hasTexCoords) streams |= STREAM_TEXCOORDS;
+	if (mesh.hasTangents && mesh.tangents.size() == count) streams |= STREAM_TANGENTS;
+	const std::vector<Component> components = vertexComponents(streams);
+
+	const size_t groupCount = (count + GROUP_SIZE - 1) / GROUP_SIZE;
+	struct Encoded {
+		float min{ 0.0f }, scale{ 0.0f };
+		std::vector<unsigned char> bytes;
+	};
+	std::vector<Encoded> encoded(components.size());
+
+	Utils::parallelFor(components.size(), 1, [&](size_t begin, size_t end) {
+		std::vector<uint16_t> deltas(groupCount * GROUP_SIZE, 0);
+		for (size_t c = begin; c < end; ++c) {
+			Encoded& e = encoded[c];
+			float min = count ? readComponent(mesh, components[c], 0) : 0.0f, max = min;
+			for (size_t i = 1; i < count; ++i) {
+				const float value = readComponent(mesh, components[c], i);
+				min = std::min(min, value);
+				max = std::max(max, value);
+			}
+			e.min = min;
+			e.scale = (max - min) / static_cast<float>(QUANT_MAX);
+			const float inverse = max > min ? static_cast<float>(QUANT_MAX) / (max - min) : 0.0f;
+
+			uint16_t previous = 0;
+			for (size_t i = 0; i < count; ++i) {
+				if (i % BLOCK_VERTICES == 0) previous = 0;
+				const float q = std::round((readComponent(mesh, components[c], i) - min) * inverse);
+				const uint16_t value = static_cast<uint16_t>(std::clamp(q, 0.0f, static_cast<float>(QUANT_MAX)));
+				deltas[i] = zigzag16(static_cast<uint16_t>(value - previous));
+				previous = value;
+			}
+			std::fill(deltas.begin() + count, deltas.end(), 0);
+
+			e.bytes.assign((groupCount + 3) / 4, 0);
+			for (size_t g = 0; g < groupCount; ++g) {
+				const uint16_t* group = &deltas[g * GROUP_SIZE];
+				const uint16_t peak = *std::max_element(group, group + GROUP_SIZE);
+				const uint8_t mode = peak == 0 ? GROUP_ZERO : peak < 256 ? GROUP_LOW : GROUP_FULL;
+				e.bytes[g / 4] |= static_cast<unsigned char>(mode << ((g % 4) * 2));
+				if (mode != GROUP_ZERO)
+					for (size_t k = 0; k < GROUP_SIZE; ++k) e.bytes.push_back(static_cast<unsigned char>(group[k]));
+				if (mode == GROUP_FULL)
+					for (size_t k = 0; k < GROUP_SIZE; ++k) e.bytes.push_back(static_cast<unsigned char>(group[k] >> 8));
+			}
+		}
+	});
+
+	Utils::ByteWriter writer(out);
+	writer.u32(static_cast<uint32_t>(count));
+	writer.u32(streams);
+	for (const Encoded& e : encoded) {
+		writer.f32(e.min);
+		writer.f32(e.scale);
+		writer.u64(e.bytes.size());
+	}
+	for (const Encoded& e : encoded) writer.bytes(e.bytes.data(), e.bytes.size());
+}
+
+bool MeshCodec::decodeVertices(const unsigned char* data, size_t size, MeshData& out, Utils::SimdLevel level) const {
+	Utils::ByteReader reader(data, size);
+	uint32_t count{ 0 }, streams{ 0 };
+	if (!reader.u32(count) || !reader.u32(streams) || streams > 0xF)
+		return Logger::error("MeshCodec", "decodeVertices", "Bad vertex stream header");
+
+	const std::vector<Component> components = vertexComponents(streams);
+	std::vector<float> mins(components.size()), scales(components.size());
+	std::vector<const uint8_t*> starts(components.size());
+	std::vector<uint64_t> sizes(components.size());
+	for (size_t c = 0; c < components.size(); ++c)
+		if (!reader.f32(mins[c]) || !reader.f32(scales[c]) || !reader.u64(sizes[c]))
+			return Logger::error("MeshCodec", "decodeVertices", "Bad vertex stream header");
+
+	// Every stream holds at least its mode table, which bounds the count before anything is sized by it
+	const size_t groupCount = (static_cast<size_t>(count) + GROUP_SIZE - 1) / GROUP_SIZE;
+	const size_t modeBytes = (groupCount + 3) / 4;
+	if (modeBytes * components.size() > reader.remaining())
+		return Logger::error("MeshCodec", "decodeVertices", "Vertex count " + std::to_string(count) + " exceeds the stream");
+
+	// Validate every stream's mode table against its payload before decoding anything, noting
+	// where each block's payload starts
+	const size_t blockCount = (groupCount + BLOCK_GROUPS - 1) / BLOCK_GROUPS;
+	std::vector<const uint8_t*> blockStarts(components.size() * blockCount);
+	for (size_t c = 0; c < components.size(); ++c) {
+		if (sizes[c] > reader.remaining() || sizes[c] < modeBytes)
+			return Logger::error("MeshCodec", "decodeVertices", "Vertex stream " + std::to_string(c) + " is truncated");
+		starts[c] = reader.current();
+		size_t payload = 0;
+		for (size_t g = 0; g < groupCount; ++g) {
+			if (g % BLOCK_GROUPS == 0) blockStarts[c * blockCount + g / BLOCK_GROUPS] = starts[c] + modeBytes + payload;
+			const uint8_t mode = (starts[c][g / 4] >> ((g % 4) * 2)) & 3;
+			if (mode > GROUP_FULL) return Logger::error("MeshCodec", "decodeVertices", "Bad group mode in vertex stream " + std::to_string(c));
+			payload += mode == GROUP_ZERO ? 0 : mode == GROUP_LOW ? GROUP_SIZE : GROUP_SIZE * 2;
+		}
+		if (modeBytes + payload != sizes[c])
+			return Logger::error("MeshCodec", "decodeVertices", "Vertex stream " + std::to_string(c) + " has the wrong size");
+		reader.skip(static_cast<size_t>(sizes[c]));
+	}
+
+	// Colour defaults to opaque white like every parser; the colour stream overwrites it when present
+	Math::Vertex blank{};
+	blank.col = { 1.0f, 1.0f, 1.0f, 1.0f };
+	out.vertices.assign(count, blank);
+	out.tangents.assign((streams & STREAM_TANGENTS) ? count : 0, Math::Vec4<float>{ 0.0f, 0.0f, 0.0f, 0.0f });
+
+	using DecodeGroups = void (*)(const uint8_t*, size_t, size_t, const uint8_t*, uint16_t*);
+	DecodeGroups decodeGroups = decodeGroupsScalar;
+#ifdef STARLET_X86
+	if (level != Utils::SimdLevel::Scalar) decodeGroups = decodeGroupsSse2;
+#else
+	(void)level;
+#endif
+
+	Utils::parallelFor(blockCount, 1, [&](size_t begin, size_t end) {
+		std::vector<uint16_t> values(BLOCK_VERTICES);
+		for (size_t b = begin; b < end; ++b) {
+			const size_t firstGroup = b * BLOCK_GROUPS;
+			const size_t groups = std::min(BLOCK_GROUPS, groupCount - firstGroup);
+			const size_t first = b * BLOCK_VERTICES;
+			const size_t last = std::min(first + BLOCK_VERTICES, static_cast<size_t>(count));
+
+			for (size_t c = 0; c < components.size(); ++c) {
+				decodeGroups(starts[c], firstGroup, groups, blockStarts[c * blockCount + b], values.data());
+				char* base = components[c].tangent ? reinterpret_cast<char*>(out.tangents.data()) : reinterpret_cast<char*>(out.vertices.data());
+				const size_t stride = components[c].tangent ? sizeof(Math::Vec4<float>) : sizeof(Math::Vertex);
+				for (size_t i = first; i < last; ++i) {
+					const float value = mins[c] + static_cast<float>(values[i - first]) * scales[c];
+					memcpy(base + i * stride + components[c].offset, &value, sizeof(value));
+				}
+			}
+		}
+	});
+
+	out.numVertices = count;
+	out.hasNormals = (streams & STREAM_NORMALS) != 0;
+	out.hasColours = (streams & STREAM_COLOURS) != 0;
+	out.hasTexCoords = (streams & STREAM_TEXCOORDS) != 0;
+	out.hasTangents = (streams & STREAM_TANGENTS) != 0;
+	return true;
+}
+
+Math::Vec3<float> MeshCodec::positionError(const MeshData& mesh) const {
+	if (mesh.vertices.empty()) return { 0.0f, 0.0f, 0.0f };
+	Math::Vec3<float> min = mesh.vertices[0].pos, max = min;
+	for (const Math::Vertex& v : mesh.vertices) {
+		min = { std::min(min.x, v.pos.x), std::min(min.y, v.pos.y), std::min(min.z, v.pos.z) };
+		max = { std::max(max.x, v.pos.x), std::max(max.y, v.pos.y), std::max(max.z, v.pos.z) };
+	}
+
+	// Encoding and the min + q * scale reconstruction each round to within a few ulps of the range and magnitude
+	const auto error = [](float lo, float hi) {
+		const float range = hi - lo;
+		return range / static_cast<float>(QUANT_MAX) * 0.5f + (range + std::max(std::fabs(lo), std::fabs(hi))) * 4.0f * FLT_EPSILON;
+	};
+	return { error(min.x, max.x), error(min.y, max.y), error(min.z, max.z) };
+}
+
+}
@@ -0,0 +1,284 @@
+#include "starlet-serializer/processor/mesh/mesh_generator.hpp"
+#include "starlet-serializer/data/mesh_data.hpp"
+#include "starlet-serializer/processor/mesh/bounds_calculator.hpp"
+
+#include "starlet-serializer/utils/parallel.hpp"
+#include "starlet-serializer/utils/vec_ops.hpp"
+
+#include "starlet-logger/logger.hpp"
+
+#include "starlet-math/vertex.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <string>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define STARLET_GENERATOR_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace Starlet::Serializer {
+
+namespace {
+	constexpr size_t GRID_GRAIN = 4096;
+
+	struct Face {
+		Math::Vec3<float> normal, u, v;
+	};
+
+	void addQuad(MeshData& mesh, const Face& face) {
+		const unsigned int base = static_cast<unsigned int>(mesh.vertices.size());
+		const float corners[4][2] = { { -0.5f, -0.5f }, { 0.5f, -0.5f }, { 0.5f, 0.5f }, { -0.5f, 0.5f } };
+		for (const auto& c : corners) {
+			Math::Vertex v{};
+			v.pos = {
+				face.normal.x * 0.5f + face.u.x * c[0] + face.v.x * c[1],
+				face.normal.y * 0.5f + face.u.y * c[0] + face.v.y * c[1],
+				face.normal.z * 0.5f + face.u.z * c[0] + face.v.z * c[1]
+			};
+			v.norm = face.normal;
+			v.col = { 1.0f, 1.0f, 1.0f, 1.0f };
+			v.texCoord = { c[0] + 0.5f, c[1] + 0.5f };
+			mesh.vertices.push_back(v);
+		}
+		mesh.indices.insert(mesh.indices.end(), { base, base + 1, base + 2, base, base + 2, base + 3 });
+	}
+
+	MeshData buildUnitMesh(PrimitiveType type) {
+		MeshData mesh;
+		switch (type) {
+		case PrimitiveType::Triangle: {
+			const float corners[3][2] = { { -0.5f, -0.5f }, { 0.5f, -0.5f }, { 0.0f, 0.5f } };
+			for (const auto& c : corners) {
+				Math::Vertex v{};
+				v.pos = { c[0], c[1], 0.0f };
+				v.norm = { 0.0f, 0.0f, 1.0f };
+				v.col = { 1.0f, 1.0f, 1.0f, 1.0f };
+				v.texCoord = { c[0] + 0.5f, c[1] + 0.5f };
+				mesh.vertices.push_back(v);
+			}
+			mesh.indices = { 0, 1, 2 };
+			break;
+		}
+		case PrimitiveType::Square:
+			// Offset the +Z face back onto the origin plane
+			addQuad(mesh, { { 0.0f, 0.0f, 1.0f }, { 1.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f } });
+			for (Math::Vertex& v : mesh.vertices) v.pos.z = 0.0f;
+			break;
+		case PrimitiveType::Cube:
+			addQuad(mesh, { {  1.0f,  0.0f,  0.0f }, {  0.0f, 0.0f, -1.0f }, { 0.0f, 1.0f,  0.0f } });
+			addQuad(mesh, { { -1.0f,  0.0f,  0.0f }, {  0.0f, 0.0f,  1.0f }, { 0.0f, 1.0f,  0.0f } });
+			addQuad(mesh, { {  0.0f,  1.0f,  0.0f }, {  1.0f, 0.0f,  0.0f }, { 0.0f, 0.0f, -1.0f } });
+			addQuad(mesh, { {  0.0f, -1.0f,  0.0f }, {  1.0f, 0.0f,  0.0f }, { 0.0f, 0.0f,  1.0f } });
+			addQuad(mesh, { {  0.0f,  0.0f,  1.0f }, {  1.0f, 0.0f,  0.0f }, { 0.0f, 1.0f,  0.0f } });
+			addQuad(mesh, { {  0.0f,  0.0f, -1.0f }, { -1.0f, 0.0f,  0.0f }, { 0.0f, 1.0f,  0.0f } });
+			break;
+		}
+
+		mesh.numVertices = static_cast<unsigned int>(mesh.vertices.size());
+		mesh.numIndices = static_cast<unsigned int>(mesh.indices.size());
+		mesh.numTriangles = mesh.numIndices / 3;
+		mesh.hasNormals = mesh.hasTexCoords = true;
+		BoundsCalculator().compute(mesh);
+		return mesh;
+	}
+
+	// Largest offset buffer filled by one call, 3 GiB; bigger grids are filled in element ranges
+	constexpr uint64_t MAX_GRID_ELEMENTS = uint64_t(1) << 28;
+	// Keeps count^3 well inside 64 bits
+	constexpr unsigned int MAX_CUBE_GRID_COUNT = 1u << 21;
+
+	// Model grids reference a mesh instead of a primitive and are laid out like cube grids
+	bool gridElement(const GridData& grid, PrimitiveType& type, uint64_t& elements, const char* function) {
+		if (grid.count == 0) return Logger::error("MeshGenerator", function, "Grid count must be positive: " + grid.name);
+		type = grid.type == GridType::Square ? PrimitiveType::Square : PrimitiveType::Cube;
+		if (grid.type != GridType::Square && grid.count > MAX_CUBE_GRID_COUNT)
+			return Logger::error("MeshGenerator", function, "Grid count is too large: " + std::to_string(grid.count));
+		elements = MeshGenerator::gridElementCount(grid);
+		return true;
+	}
+
+	// Checks that one allocation of `elements` offsets is reasonable before it is attempted
+	bool checkOffsetCount(const GridData& grid, uint64_t elements, const char* function) {
+		if (elements > MAX_GRID_ELEMENTS)
+			return Logger::error("MeshGenerator", function, std::to_string(elements) + " elements exceed the " + std::to_string(MAX_GRID_ELEMENTS) + " a single call fills; request element ranges instead: " + grid.name);
+		if (elements > SIZE_MAX / sizeof(Math::Vec3<float>))
+			return Logger::error("MeshGenerator", function, "Grid offsets do not fit in memory: " + grid.name);
+		return true;
+	}
+
+	Math::Vec3<float> elementOffset(const GridData& grid, uint64_t element) {
+		const uint64_t n = grid.count;
+		return {
+			static_cast<float>(element % n) * grid.spacing,
+			static_cast<float>((element / n) % n) * grid.spacing,
+			static_cast<float>(element / (n * n)) * grid.spacing
+		};
+	}
+
+#ifdef STARLET_GENERATOR_SSE2
+	// Vertices are written as whole vectors: the scaled template vertex plus a vector that is zero
+	// everywhere except the position lanes
+	constexpr bool VERTEX_VECTORS = sizeof(Math::Vertex) % sizeof(__m128) == 0;
+	constexpr size_t VERTEX_LANES = sizeof(Math::Vertex) / sizeof(float);
+	constexpr size_t VERTEX_WORDS = sizeof(Math::Vertex) / sizeof(__m128);
+
+	size_t positionLane(int axis) {
+		const Math::Vertex v{};
+		const float* field = axis == 0 ? &v.pos.x : axis == 1 ? &v.pos.y : &v.pos.z;
+		return static_cast<size_t>(reinterpret_cast<const char*>(field) - reinterpret_cast<const char*>(&v)) / sizeof(float);
+	}
+#endif
+
+	void writeElements(const MeshData& unit, const GridData& grid, size_t begin, size_t end, MeshData& out) {
+		const size_t vertexCount = unit.vertices.size();
+		const size_t indexCount = unit.indices.size();
+
+		std::vector<Math::Vertex> scaled = unit.vertices;
+		for (Math::Vertex& v : scaled) {
+			v.pos.x *= grid.transform.size.x;
+			v.pos.y *= grid.transform.size.y;
+			v.pos.z *= grid.transform.size.z;
+		}
+
+#ifdef STARLET_GENERATOR_SSE2
+		if constexpr (VERTEX_VECTORS) {
+			alignas(16) float delta[VERTEX_LANES]{};
+			const size_t lanes[3] = { positionLane(0), positionLane(1), positionLane(2) };
+			const float* templates = reinterpret_cast<const float*>(scaled.data());
+
+			for (size_t e = begin; e < end; ++e) {
+				const Math::Vec3<float> offset = elementOffset(grid, e);
+				delta[lanes[0]] = offset.x;
+				delta[lanes[1]] = offset.y;
+				delta[lanes[2]] = offset.z;
+				__m128 deltas[VERTEX_WORDS];
+				for (size_t w = 0; w < VERTEX_WORDS; ++w) deltas[w] = _mm_load_ps(delta + w * 4);
+
+				float* dst = reinterpret_cast<float*>(out.vertices.data() + e * vertexCount);
+				for (size_t v = 0; v < vertexCount; ++v)
+					for (size_t w = 0; w < VERTEX_WORDS; ++w)
+						_mm_storeu_ps(dst + (v * VERTEX_WORDS + w) * 4, _mm_add_ps(_mm_loadu_ps(templates + (v * VERTEX_WORDS + w) * 4), deltas[w]));
+
+				const __m128i base = _mm_set1_epi32(static_cast<int>(e * vertexCount));
+				unsigned int* indices = out.indices.data() + e * indexCount;
+				size_t i = 0;
+				for (; i + 4 <= indexCount; i += 4) {
+					const __m128i local = _mm_loadu_si128(reinterpret_cast<const __m128i*>(unit.indices.data() + i));
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(indices + i), _mm_add_epi32(local, base));
+				}
+				for (; i < indexCount; ++i) indices[i] = unit.indices[i] + static_cast<unsigned int>(e * vertexCount);
+			}
+			return;
+		}
+#endif
+		for (size_t e = begin; e < end; ++e) {
+			const Math::Vec3<float> offset = elementOffset(grid, e);
+			for (size_t v = 0; v < vertexCount; ++v) {
+				Math::Vertex vertex = scaled[v];
+				vertex.pos.x += offset.x;
+				vertex.pos.y += offset.y;
+				vertex.pos.z += offset.z;
+				out.vertices[e * vertexCount + v] = vertex;
+			}
+			for (size_t i = 0; i < indexCount; ++i)
+				out.indices[e * indexCount + i] = unit.indices[i] + static_cast<unsigned int>(e * vertexCount);
+		}
+	}
+}
+
+const MeshData& MeshGenerator::unitMesh(PrimitiveType type) {
+	static const MeshData triangle = buildUnitMesh(PrimitiveType::Triangle);
+	static const MeshData square = buildUnitMesh(PrimitiveType::Square);
+	static const MeshData cube = buildUnitMesh(PrimitiveType::Cube);
+	switch (type) {
+	case PrimitiveType::Triangle: return triangle;
+	case PrimitiveType::Square:   return square;
+	default:                      return cube;
+	}
+}
+
+bool MeshGenerator::generateGrid(const GridData& grid, MeshData& out) const {
+	if (grid.type == GridType::Model)
+		return Logger::error("MeshGenerator", "generateGrid", "Model grids have no built-in geometry; use generateGridOffsets: " + grid.name);
+
+	PrimitiveType type;
+	uint64_t total;
+	if (!gridElement(grid, type, total, "generateGrid")) return false;
+
+	const MeshData& unit = unitMesh(type);
+	if (total > UINT32_MAX / unit.vertices.size() || total > UINT32_MAX / unit.indices.size())
+		return Logger::error("MeshGenerator", "generateGrid", "Grid exceeds 32-bit indices; draw it instanced with generateGridOffsets, in element ranges for large grids: " + grid.name);
+	const size_t elements = static_cast<size_t>(total);
+
+	out = MeshData{};
+	out.vertices.resize(elements * unit.vertices.size());
+	out.indices.resize(elements * unit.indices.size());
+	Utils::parallelFor(elements, GRID_GRAIN / unit.vertices.size(), [&](size_t begin, size_t end) {
+		writeElements(unit, grid, begin, end, out);
+	});
+
+	out.numVertices = static_cast<unsigned int>(out.vertices.size());
+	out.numIndices = static_cast<unsigned int>(out.indices.size());
+	out.numTriangles = out.numIndices / 3;
+	out.hasNormals = out.hasTexCoords = true;
+
+	// Grid bounds follow from the first and last element; every AABB corner is a vertex, so the
+	// sphere around the AABB centre is exact as well
+	float extent[3];
+	const float size[3] = { grid.transform.size.x, grid.transform.size.y, grid.transform.size.z };
+	const float unitMax[3] = { unit.boundsMax.x, unit.boundsMax.y, unit.boundsMax.z };
+	const Math::Vec3<float> last = elementOffset(grid, elements - 1);
+	for (int a = 0; a < 3; ++a) extent[a] = std::abs(unitMax[a] * size[a]);
+	out.boundsMin = { std::min(last.x, 0.0f) - extent[0], std::min(last.y, 0.0f) - extent[1], std::min(last.z, 0.0f) - extent[2] };
+	out.boundsMax = { std::max(last.x, 0.0f) + extent[0], std::max(last.y, 0.0f) + extent[1], std::max(last.z, 0.0f) + extent[2] };
+	out.sphereCenter = Utils::scale(Utils::add(out.boundsMin, out.boundsMax), 0.5f);
+	out.sphereRadius = Utils::length(Utils::sub(out.boundsMax, out.sphereCenter));
+	out.minY = out.boundsMin.y;
+	out.maxY = out.boundsMax.y;
+	return true;
+}
+
+uint64_t MeshGenerator::gridElementCount(const GridData& grid) {
+	const uint64_t n = grid.count;
+	return grid.type == GridType::Square ? n * n : n * n * n;
+}
+
+bool MeshGenerator::generateGridOffsets(const GridData& grid, std::vector<Math::Vec3<float>>& out) const {
+	PrimitiveType type;
+	uint64_t elements;
+	if (!gridElement(grid, type, elements, "generateGridOffsets")) return false;
+	if (!checkOffsetCount(grid, elements, "generateGridOffsets")) return false;
+	return generateGridOffsets(grid, 0, static_cast<size_t>(elements), out);
+}
+
+bool MeshGenerator::generateGridOffsets(const GridData& grid, uint64_t first, size_t count, std::vector<Math::Vec3<float>>& out) const {
+	PrimitiveType type;
+	uint64_t elements;
+	if (!gridElement(grid, type, elements, "generateGridOffsets")) return false;
+	if (first > elements || count > elements - first)
+		return Logger::error("MeshGenerator", "generateGridOffsets", "Element range " + std::to_string(first) + " + " + std::to_string(count) + " is outside the grid's " + std::to_string(elements) + " elements: " + grid.name);
+	if (!checkOffsetCount(grid, count, "generateGridOffsets")) return false;
+
+	out.resize(count);
+
+	// x varies fastest, so each run up to the end of a row is the same ramp moved in y and z
+	Utils::parallelFor(count, GRID_GRAIN, [&](size_t begin, size_t end) {
+		uint64_t element = first + begin;
+		for (size_t i = begin; i < end;) {
+			const size_t x = static_cast<size_t>(element % grid.count);
+			const size_t run = std::min<size_t>(end - i, grid.count - x);
+			const Math::Vec3<float> start = elementOffset(grid, element);
+			Math::Vec3<float>* dst = out.data() + i;
+			for (size_t k = 0; k < run; ++k)
+				dst[k] = { static_cast<float>(x + k) * grid.spacing, start.y, start.z };
+			i += run;
+			element += run;
+		}
+	});
+	return true;
+}
+
+}
@@ -0,0 +1,484 @@
+#include "starlet-serializer/processor/mesh/mesh_simplifier.hpp"
+#include "starlet-serializer/data/mesh_data.hpp"
+#include "starlet-serializer/data/lod_data.hpp"
+
+#include "starlet-serializer/utils/parallel.hpp"
+#include "starlet-serializer/utils/vec_ops.hpp"
+
+#include "starlet-logger/logger.hpp"
+
+#include "starlet-math/vertex.hpp"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <unordered_map>
+
+namespace Starlet::Serializer {
+
+namespace {
+	constexpr size_t SIMPLIFY_GRAIN = 8 * 1024;
+	constexpr float  FLIP_THRESHOLD = 1e-3f;
+	constexpr double BORDER_WEIGHT = 10.0;
+	constexpr unsigned int NO_VERTEX = std::numeric_limits<unsigned int>::max();
+
+	// Seam vertices have exactly two attribute copies and only move along the seam, taking both
+	// copies with them
+	enum class VertexKind : uint8_t {
+		Manifold,
+		Border,
+		Seam,
+		Locked
+	};
+
+	struct Quadric {
+		double a00{ 0 }, a11{ 0 }, a22{ 0 }, a10{ 0 }, a20{ 0 }, a21{ 0 };
+		double b0{ 0 }, b1{ 0 }, b2{ 0 }, c{ 0 }, w{ 0 };
+
+		void add(const Quadric& q) {
+			a00 += q.a00; a11 += q.a11; a22 += q.a22;
+			a10 += q.a10; a20 += q.a20; a21 += q.a21;
+			b0 += q.b0; b1 += q.b1; b2 += q.b2;
+			c += q.c; w += q.w;
+		}
+
+		double eval(const Math::Vec3<float>& p) const {
+			const double x = p.x, y = p.y, z = p.z;
+			return a00 * x * x + a11 * y * y + a22 * z * z
+				+ 2.0 * (a10 * x * y + a20 * x * z + a21 * y * z)
+				+ 2.0 * (b0 * x + b1 * y + b2 * z) + c;
+		}
+	};
+
+	Quadric planeQuadric(const Math::Vec3<float>& n, const Math::Vec3<float>& p, double weight) {
+		const double a = n.x, b = n.y, c = n.z;
+		const double d = -(a * p.x + b * p.y + c * p.z);
+
+		Quadric q;
+		q.a00 = weight * a * a; q.a11 = weight * b * b; q.a22 = weight * c * c;
+		q.a10 = weight * a * b; q.a20 = weight * a * c; q.a21 = weight * b * c;
+		q.b0 = weight * a * d; q.b1 = weight * b * d; q.b2 = weight * c * d;
+		q.c = weight * d * d;
+		q.w = weight;
+		return q;
+	}
+
+	struct PositionKey {
+		uint32_t x, y, z;
+		bool operator==(const PositionKey& o) const { return x == o.x && y == o.y && z == o.z; }
+	};
+	struct PositionKeyHash {
+		size_t operator()(const PositionKey& k) const {
+			return (static_cast<size_t>(k.x) * 73856093u) ^ (static_cast<size_t>(k.y) * 19349663u) ^ (static_cast<size_t>(k.z) * 83492791u);
+		}
+	};
+
+	uint32_t floatBits(float f) {
+		if (f == 0.0f) f = 0.0f; // Fold -0 into +0
+		uint32_t bits;
+		memcpy(&bits, &f, sizeof(bits));
+		return bits;
+	}
+
+	uint64_t edgeKey(unsigned int a, unsigned int b) {
+		return (static_cast<uint64_t>(a) << 32) | b;
+	}
+
+	struct HalfEdge {
+		uint64_t key; // Canonical endpoints
+		unsigned int from, to;
+	};
+
+	// A seam collapse also moves pairFrom (the other copy of `from`) onto pairTo. Collapses that
+	// would move a locked vertex or break a seam stay invalid whatever the error limit.
+	struct Collapse {
+		unsigned int from, to;
+		float cost;
+		unsigned int pairFrom, pairTo;
+		bool valid;
+	};
+
+	// Canonical vertex -> triangles touching it, in CSR form
+	void buildTriangleAdjacency(const std::vector<unsigned int>& indices, const std::vector<unsigned int>& remap, std::vector<unsigned int>& offsets, std::vector<unsigned int>& triangles) {
+		offsets.assign(remap.size() + 1, 0u);
+		for (unsigned int i : indices) ++offsets[remap[i] + 1];
+		for (size_t v = 0; v < remap.size(); ++v) offsets[v + 1] += offsets[v];
+
+		std::vector<unsigned int> cursor(offsets.begin(), offsets.end() - 1);
+		triangles.resize(indices.size());
+		for (size_t c = 0; c < indices.size(); ++c)
+			triangles[cursor[remap[indices[c]]]++] = static_cast<unsigned int>(c / 3);
+	}
+}
+
+struct MeshSimplifier::Context {
+	const MeshData* mesh{ nullptr };
+	std::vector<Math::Vec3<float>> positions; // Scaled so the largest extent is 1
+	std::vector<unsigned int> remap;          // Vertex -> first vertex with the same position
+	std::vector<VertexKind> kind;             // Indexed by canonical vertex
+	std::vector<Quadric> quadrics;            // Indexed by canonical vertex
+	std::vector<uint64_t> directedEdges;      // Sorted canonical edges of the input triangles
+	std::vector<uint64_t> seamEdges;          // Sorted canonical edges, both directions, whose sides use different vertices
+	float normalWeight{ 0.0f }, texCoordWeight{ 0.0f }, colourWeight{ 0.0f };
+
+	bool isBorderEdge(unsigned int a, unsigned int b) const {
+		return !std::binary_search(directedEdges.begin(), directedEdges.end(), edgeKey(b, a));
+	}
+
+	bool isSeamEdge(unsigned int a, unsigned int b) const {
+		return std::binary_search(seamEdges.begin(), seamEdges.end(), edgeKey(a, b));
+	}
+
+	float attributePenalty(unsigned int from, unsigned int to) const {
+		const Math::Vertex& a = mesh->vertices[from];
+		const Math::Vertex& b = mesh->vertices[to];
+		float penalty = 0.0f;
+		if (normalWeight > 0.0f) {
+			const Math::Vec3<float> d = Utils::sub(a.norm, b.norm);
+			penalty += normalWeight * Utils::dot(d, d);
+		}
+		if (texCoordWeight > 0.0f) {
+			const float du = a.texCoord.x - b.texCoord.x, dv = a.texCoord.y - b.texCoord.y;
+			penalty += texCoordWeight * (du * du + dv * dv);
+		}
+		if (colourWeight > 0.0f) {
+			const float dr = a.col.x - b.col.x, dg = a.col.y - b.col.y, db = a.col.z - b.col.z, da = a.col.w - b.col.w;
+			penalty += colourWeight * (dr * dr + dg * dg + db * db + da * da);
+		}
+		return penalty;
+	}
+
+	float collapseCost(unsigned int from, unsigned int to) const {
+		Quadric q = quadrics[remap[from]];
+		q.add(quadrics[remap[to]]);
+		const double error = q.w > 0.0 ? std::max(0.0, q.eval(positions[to]) / q.w) : 0.0;
+		return static_cast<float>(error) + attributePenalty(from, to);
+	}
+};
+
+bool MeshSimplifier::simplify(const MeshData& mesh, const std::vector<unsigned int>& indices, size_t targetTriangles, LodData& out, const SimplifyOptions& options) {
+	if (indices.size() % 3 != 0)
+		return Logger::error("MeshSimplifier", "simplify", "Index count is not a multiple of 3: " + std::to_string(indices.size()));
+
+	Context ctx;
+	if (!prepare(mesh, indices, options, ctx)) return false;
+
+	std::vector<unsigned int> result = indices;
+	const float maxErrorSq = options.maxError * options.maxError;
+	float resultError = 0.0f;
+	while (result.size() / 3 > targetTriangles) {
+		if (collapsePass(result, targetTriangles, maxErrorSq, ctx, resultError) == 0) break;
+	}
+
+	out.indices = std::move(result);
+	out.numIndices = static_cast<unsigned int>(out.indices.size());
+	out.numTriangles = out.numIndices / 3;
+	out.error = std::sqrt(resultError);
+	return true;
+}
+
+// One context serves the whole chain: quadrics keep accumulating from the source triangles, so each
+// level's error (and the maxError cutoff) is measured against the original surface rather than
+// against the level before it
+bool MeshSimplifier::buildLodChain(const MeshData& mesh, const std::vector<float>& ratios, std::vector<LodData>& out, const SimplifyOptions& options) {
+	out.clear();
+	for (const float ratio : ratios)
+		if (ratio <= 0.0f || ratio > 1.0f)
+			return Logger::error("MeshSimplifier", "buildLodChain", "LOD ratio must be in (0, 1]: " + std::to_string(ratio));
+	if (mesh.indices.size() % 3 != 0)
+		return Logger::error("MeshSimplifier", "buildLodChain", "Index count is not a multiple of 3: " + std::to_string(mesh.indices.size()));
+
+	Context ctx;
+	if (!prepare(mesh, mesh.indices, options, ctx)) return false;
+
+	std::vector<unsigned int> current = mesh.indices;
+	const size_t sourceTriangles = current.size() / 3;
+	const float maxErrorSq = options.maxError * options.maxError;
+	float chainError = 0.0f;
+	out.reserve(ratios.size());
+	for (const float ratio : ratios) {
+		const size_t target = static_cast<size_t>(static_cast<double>(sourceTriangles) * ratio);
+		while (current.size() / 3 > target) {
+			if (collapsePass(current, target, maxErrorSq, ctx, chainError) == 0) break;
+		}
+
+		LodData& lod = out.emplace_back();
+		lod.indices = current;
+		lod.numIndices = static_cast<unsigned int>(lod.indices.size());
+		lod.numTriangles = lod.numIndices / 3;
+		lod.error = std::sqrt(chainError);
+	}
+	return true;
+}
+
+bool MeshSimplifier::prepare(const MeshData& mesh, const std::vector<unsigned int>& indices, const SimplifyOptions& options, Context& ctx) const {
+	const size_t vertexCount = mesh.vertices.size();
+	if (vertexCount == 0) return Logger::error("MeshSimplifier", "prepare", "Mesh has no vertices");
+	for (size_t i = 0; i < indices.size(); ++i)
+		if (indices[i] >= vertexCount)
+			return Logger::error("MeshSimplifier", "prepare", "Index out of bounds at " + std::to_string(i) + ": " + std::to_string(indices[i]));
+
+	ctx.mesh = &mesh;
+	ctx.normalWeight = mesh.hasNormals ? options.normalWeight : 0.0f;
+	ctx.texCoordWeight = mesh.hasTexCoords ? options.texCoordWeight : 0.0f;
+	ctx.colourWeight = mesh.hasColours ? options.colourWeight : 0.0f;
+
+	Math::Vec3<float> minPos{ FLT_MAX }, maxPos{ -FLT_MAX };
+	for (const Math::Vertex& v : mesh.vertices) {
+		minPos = { std::min(minPos.x, v.pos.x), std::min(minPos.y, v.pos.y), std::min(minPos.z, v.pos.z) };
+		maxPos = { std::max(maxPos.x, v.pos.x), std::max(maxPos.y, v.pos.y), std::max(maxPos.z, v.pos.z) };
+	}
+	const float extent = std::max({ maxPos.x - minPos.x, maxPos.y - minPos.y, maxPos.z - minPos.z });
+	const float scale = extent > 0.0f ? 1.0f / extent : 1.0f;
+
+	ctx.positions.resize(vertexCount);
+	Utils::parallelFor(vertexCount, SIMPLIFY_GRAIN, [&](size_t begin, size_t end) {
+		for (size_t v = begin; v < end; ++v)
+			ctx.positions[v] = Utils::scale(Utils::sub(mesh.vertices[v].pos, minPos), scale);
+	});
+
+	// Vertices sharing a position are copies of one canonical vertex split by an attribute seam
+	ctx.remap.resize(vertexCount);
+	std::unordered_map<PositionKey, unsigned int, PositionKeyHash> firstAt;
+	firstAt.reserve(vertexCount);
+	for (size_t v = 0; v < vertexCount; ++v) {
+		const Math::Vec3<float>& p = mesh.vertices[v].pos;
+		const auto [it, inserted] = firstAt.try_emplace(PositionKey{ floatBits(p.x), floatBits(p.y), floatBits(p.z) }, static_cast<unsigned int>(v));
+		ctx.remap[v] = it->second;
+	}
+
+	classifyVertices(indices, options, ctx);
+	computeQuadrics(indices, options, ctx);
+	return true;
+}
+
+void MeshSimplifier::classifyVertices(const std::vector<unsigned int>& indices, const SimplifyOptions& options, Context& ctx) const {
+	std::vector<HalfEdge> halfEdges;
+	halfEdges.reserve(indices.size());
+	for (size_t t = 0; t + 2 < indices.size(); t += 3) {
+		for (size_t k = 0; k < 3; ++k) {
+			const unsigned int from = indices[t + k], to = indices[t + (k + 1) % 3];
+			const unsigned int a = ctx.remap[from], b = ctx.remap[to];
+			if (a != b) halfEdges.push_back({ edgeKey(a, b), from, to });
+		}
+	}
+	std::sort(halfEdges.begin(), halfEdges.end(), [](const HalfEdge& x, const HalfEdge& y) { return x.key < y.key; });
+
+	ctx.directedEdges.resize(halfEdges.size());
+	for (size_t i = 0; i < halfEdges.size(); ++i) ctx.directedEdges[i] = halfEdges[i].key;
+
+	ctx.kind.assign(ctx.remap.size(), VertexKind::Manifold);
+	ctx.seamEdges.clear();
+	std::vector<unsigned int> seamCount(ctx.remap.size(), 0u);
+	for (size_t i = 0; i < ctx.directedEdges.size();) {
+		const uint64_t key = ctx.directedEdges[i];
+		size_t run = i + 1;
+		while (run < ctx.directedEdges.size() && ctx.directedEdges[run] == key) ++run;
+
+		const unsigned int a = static_cast<unsigned int>(key >> 32);
+		const unsigned int b = static_cast<unsigned int>(key & 0xFFFFFFFFu);
+		const auto reverse = std::equal_range(ctx.directedEdges.begin(), ctx.directedEdges.end(), edgeKey(b, a));
+		const size_t reverseCount = static_cast<size_t>(reverse.second - reverse.first);
+
+		if (run - i > 1 || reverseCount > 1) {
+			ctx.kind[a] = ctx.kind[b] = VertexKind::Locked;
+		}
+		else if (reverseCount == 0) {
+			const VertexKind borderKind = options.lockBorder ? VertexKind::Locked : VertexKind::Border;
+			if (ctx.kind[a] != VertexKind::Locked) ctx.kind[a] = borderKind;
+			if (ctx.kind[b] != VertexKind::Locked) ctx.kind[b] = borderKind;
+		}
+		else {
+			// Keys are visited in order, so seamEdges comes out sorted
+			const HalfEdge& reverseEdge = halfEdges[static_cast<size_t>(reverse.first - ctx.directedEdges.begin())];
+			if (halfEdges[i].from != reverseEdge.to || halfEdges[i].to != reverseEdge.from) {
+				ctx.seamEdges.push_back(key);
+				if (a < b) { ++seamCount[a]; ++seamCount[b]; }
+			}
+		}
+		i = run;
+	}
+
+	// A seam vertex must continue the seam on both sides with one copy per side; seam ends, corners
+	// where several charts meet and seams on borders stay put
+	std::vector<uint8_t> referenced(ctx.remap.size(), 0);
+	std::vector<unsigned int> copies(ctx.remap.size(), 0u);
+	for (unsigned int i : indices) {
+		if (referenced[i]) continue;
+		referenced[i] = 1;
+		++copies[ctx.remap[i]];
+	}
+	for (size_t v = 0; v < ctx.remap.size(); ++v) {
+		if (copies[v] <= 1 && seamCount[v] == 0) continue;
+		const bool continuesSeam = ctx.kind[v] == VertexKind::Manifold && copies[v] == 2 && seamCount[v] == 2;
+		ctx.kind[v] = continuesSeam ? VertexKind::Seam : VertexKind::Locked;
+	}
+}
+
+void MeshSimplifier::computeQuadrics(const std::vector<unsigned int>& indices, const SimplifyOptions& options, Context& ctx) const {
+	std::vector<unsigned int> offsets, triangles;
+	buildTriangleAdjacency(indices, ctx.remap, offsets, triangles);
+
+	ctx.quadrics.assign(ctx.remap.size(), Quadric{});
+	Utils::parallelFor(ctx.remap.size(), SIMPLIFY_GRAIN, [&](size_t begin, size_t end) {
+		for (size_t v = begin; v < end; ++v) {
+			Quadric& q = ctx.quadrics[v];
+			for (unsigned int i = offsets[v]; i < offsets[v + 1]; ++i) {
+				const size_t t = static_cast<size_t>(triangles[i]) * 3;
+				const Math::Vec3<float>& p0 = ctx.positions[indices[t + 0]];
+				const Math::Vec3<float>& p1 = ctx.positions[indices[t + 1]];
+				const Math::Vec3<float>& p2 = ctx.positions[indices[t + 2]];
+
+				const Math::Vec3<float> n = Utils::cross(Utils::sub(p1, p0), Utils::sub(p2, p0));
+				const float doubleArea = Utils::length(n);
+				if (doubleArea <= 0.0f) continue;
+				const Math::Vec3<float> unitNormal = Utils::scale(n, 1.0f / doubleArea);
+				q.add(planeQuadric(unitNormal, p0, doubleArea * 0.5));
+
+				// Open edges and attribute seams touching v get a plane perpendicular to the face so
+				// the outline keeps its shape
+				for (size_t k = 0; k < 3; ++k) {
+					const unsigned int a = indices[t + k], b = indices[t + (k + 1) % 3];
+					const unsigned int ca = ctx.remap[a], cb = ctx.remap[b];
+					if ((ca != v && cb != v) || ca == cb) continue;
+					const bool border = !options.lockBorder && ctx.isBorderEdge(ca, cb);
+					if (!border && !ctx.isSeamEdge(ca, cb)) continue;
+
+					const Math::Vec3<float> edge = Utils::sub(ctx.positions[b], ctx.positions[a]);
+					const Math::Vec3<float> edgeNormal = Utils::normalize(Utils::cross(edge, unitNormal));
+					q.add(planeQuadric(edgeNormal, ctx.positions[a], Utils::dot(edge, edge) * BORDER_WEIGHT));
+				}
+			}
+		}
+	});
+}
+
+size_t MeshSimplifier::collapsePass(std::vector<unsigned int>& indices, size_t targetTriangles, float maxErrorSq, Context& ctx, float& resultError) const {
+	const size_t triangleCount = indices.size() / 3;
+	if (triangleCount <= targetTriangles) return 0;
+
+	std::vector<unsigned int> offsets, triangles;
+	buildTriangleAdjacency(indices, ctx.remap, offsets, triangles);
+
+	// A seam vertex may only follow an edge whose two triangles hold different copies of it; the
+	// copy on the far side then moves onto the far side's copy of `to`
+	const auto candidate = [&](size_t t, unsigned int from, unsigned int to) {
+		Collapse collapse{ from, to, FLT_MAX, NO_VERTEX, NO_VERTEX, false };
+		const unsigned int source = ctx.remap[from], target = ctx.remap[to];
+		if (source == target || ctx.kind[source] == VertexKind::Locked) return collapse;
+		if (ctx.kind[source] != VertexKind::Seam) {
+			collapse.cost = ctx.collapseCost(from, to);
+			collapse.valid = true;
+			return collapse;
+		}
+
+		size_t sides = 0;
+		for (unsigned int i = offsets[source]; i < offsets[source + 1]; ++i) {
+			const size_t other = triangles[i];
+			if (other == t) continue;
+			unsigned int pairFrom = NO_VERTEX, pairTo = NO_VERTEX;
+			for (size_t k = 0; k < 3; ++k) {
+				const unsigned int v = indices[other * 3 + k];
+				if (ctx.remap[v] == source) pairFrom = v;
+				else if (ctx.remap[v] == target) pairTo = v;
+			}
+			if (pairTo == NO_VERTEX) continue;
+			collapse.pairFrom = pairFrom;
+			collapse.pairTo = pairTo;
+			++sides;
+		}
+		if (sides == 1 && collapse.pairFrom != from) {
+			collapse.cost = ctx.collapseCost(from, to) + ctx.attributePenalty(collapse.pairFrom, collapse.pairTo);
+			collapse.valid = true;
+		}
+		return collapse;
+	};
+
+	std::vector<Collapse> candidates(triangleCount * 6);
+	Utils::parallelFor(triangleCount, SIMPLIFY_GRAIN, [&](size_t begin, size_t end) {
+		for (size_t t = begin; t < end; ++t) {
+			for (size_t k = 0; k < 3; ++k) {
+				const unsigned int a = indices[t * 3 + k], b = indices[t * 3 + (k + 1) % 3];
+				candidates[t * 6 + k * 2 + 0] = candidate(t, a, b);
+				candidates[t * 6 + k * 2 + 1] = candidate(t, b, a);
+			}
+		}
+	});
+
+	candidates.erase(std::remove_if(candidates.begin(), candidates.end(), [maxErrorSq](const Collapse& c) { return !c.valid || !(c.cost <= maxErrorSq); }), candidates.end());
+	std::sort(candidates.begin(), candidates.end(), [](const Collapse& a, const Collapse& b) {
+		if (a.cost != b.cost) return a.cost < b.cost;
+		if (a.from != b.from) return a.from < b.from;
+		return a.to < b.to;
+	});
+
+	std::vector<unsigned int> collapseRemap(ctx.remap.size());
+	for (size_t v = 0; v < collapseRemap.size(); ++v) collapseRemap[v] = static_cast<unsigned int>(v);
+	std::vector<uint8_t> touched(ctx.remap.size(), 0);
+
+	// Moving `from` onto `to` must not turn any surviving triangle around `from` upside down
+	const auto flips = [&](unsigned int from, unsigned int to) {
+		const unsigned int source = ctx.remap[from], target = ctx.remap[to];
+		for (unsigned int i = offsets[source]; i < offsets[source + 1]; ++i) {
+			const size_t t = static_cast<size_t>(triangles[i]) * 3;
+			unsigned int v[3], c[3];
+			for (size_t k = 0; k < 3; ++k) {
+				v[k] = collapseRemap[indices[t + k]];
+				c[k] = ctx.remap[v[k]];
+			}
+			if (c[0] == target || c[1] == target || c[2] == target) continue;
+			if (c[0] == c[1] || c[1] == c[2] || c[0] == c[2]) continue;
+
+			Math::Vec3<float> p[3] = { ctx.positions[v[0]], ctx.positions[v[1]], ctx.positions[v[2]] };
+			const Math::Vec3<float> before = Utils::cross(Utils::sub(p[1], p[0]), Utils::sub(p[2], p[0]));
+			for (size_t k = 0; k < 3; ++k)
+				if (c[k] == source) p[k] = ctx.positions[to];
+			const Math::Vec3<float> after = Utils::cross(Utils::sub(p[1], p[0]), Utils::sub(p[2], p[0]));
+
+			if (Utils::dot(before, after) <= FLIP_THRESHOLD * Utils::length(before) * Utils::length(after))
+				return true;
+		}
+		return false;
+	};
+
+	const size_t goal = (triangleCount - targetTriangles + 1) / 2;
+	size_t collapses = 0;
+	float passError = 0.0f;
+	for (const Collapse& collapse : candidates) {
+		if (collapses >= goal) break;
+
+		const unsigned int source = ctx.remap[collapse.from], target = ctx.remap[collapse.to];
+		if (touched[source] || touched[target]) continue;
+		if (flips(collapse.from, collapse.to)) continue;
+
+		collapseRemap[collapse.from] = collapse.to;
+		if (collapse.pairFrom != NO_VERTEX) collapseRemap[collapse.pairFrom] = collapse.pairTo;
+		touched[source] = touched[target] = 1;
+		ctx.quadrics[target].add(ctx.quadrics[source]);
+		passError = std::max(passError, collapse.cost);
+		++collapses;
+	}
+	if (collapses == 0) return 0;
+
+	size_t write = 0;
+	for (size_t t = 0; t < triangleCount; ++t) {
+		const unsigned int i0 = collapseRemap[indices[t * 3 + 0]];
+		const unsigned int i1 = collapseRemap[indices[t * 3 + 1]];
+		const unsigned int i2 = collapseRemap[indices[t * 3 + 2]];
+		const unsigned int c0 = ctx.remap[i0], c1 = ctx.remap[i1], c2 = ctx.remap[i2];
+		if (c0 == c1 || c1 == c2 || c0 == c2) continue;
+
+		indices[write++] = i0;
+		indices[write++] = i1;
+		indices[write++] = i2;
+	}
+	indices.resize(write);
+
+	resultError = std::max(resultError, passError);
+	return collapses;
+}
+
+}
@@ -0,0 +1,207 @@
+#include "starlet-serializer/processor/mesh/meshlet_builder.hpp"
+#include "starlet-serializer/processor/mesh/vertex_adjacency.hpp"
+#include "starlet-serializer/data/mesh_data.hpp"
+#include "starlet-serializer/data/meshlet_data.hpp"
+
+#include "starlet-serializer/utils/parallel.hpp"
+#include "starlet-serializer/utils/vec_ops.hpp"
+
+#include "starlet-logger/logger.hpp"
+
+#include "starlet-math/vertex.hpp"
+
+#include <algorithm>
+#include <cfloat>
+#include <climits>
+#include <cmath>
+
+namespace Starlet::Serializer {
+
+namespace {
+	constexpr size_t  BOUNDS_GRAIN = 256;
+	constexpr uint8_t NOT_IN_MESHLET = 0xFF;
+	constexpr float   MIN_CONE_DOT = 0.1f; // Below this the normals spread too wide for a useful cone
+}
+
+bool MeshletBuilder::build(const MeshData& mesh, MeshletData& out, unsigned int maxVertices, unsigned int maxTriangles) {
+	out.meshlets.clear();
+	out.vertices.clear();
+	out.triangles.clear();
+
+	if (maxVertices < 3 || maxVertices > 255)
+		return Logger::error("MeshletBuilder", "build", "Max vertices must be in [3, 255]: " + std::to_string(maxVertices));
+	if (maxTriangles < 1)
+		return Logger::error("MeshletBuilder", "build", "Max triangles must be at least 1");
+	if (mesh.indices.size() < 3 || mesh.indices.size() % 3 != 0)
+		return Logger::error("MeshletBuilder", "build", "Mesh has no triangle list");
+
+	VertexAdjacency adjacency;
+	if (!buildVertexAdjacency(mesh, adjacency)) return false;
+
+	out.maxVertices = maxVertices;
+	out.maxTriangles = maxTriangles;
+	partition(mesh, adjacency, out);
+	computeBounds(mesh, out);
+	return true;
+}
+
+bool MeshletBuilder::refit(const MeshData& mesh, MeshletData& meshlets) const {
+	for (size_t m = 0; m < meshlets.meshlets.size(); ++m) {
+		const Meshlet& meshlet = meshlets.meshlets[m];
+		bool valid = static_cast<size_t>(meshlet.vertexOffset) + meshlet.vertexCount <= meshlets.vertices.size()
+			&& (static_cast<size_t>(meshlet.triangleOffset) + meshlet.triangleCount) * 3 <= meshlets.triangles.size();
+		for (unsigned int i = 0; valid && i < meshlet.vertexCount; ++i)
+			valid = meshlets.vertices[meshlet.vertexOffset + i] < mesh.vertices.size();
+		for (unsigned int i = 0; valid && i < meshlet.triangleCount * 3; ++i)
+			valid = meshlets.triangles[static_cast<size_t>(meshlet.triangleOffset) * 3 + i] < meshlet.vertexCount;
+		if (!valid) return Logger::error("MeshletBuilder", "refit", "Meshlet " + std::to_string(m) + " is out of bounds");
+	}
+	computeBounds(mesh, meshlets);
+	return true;
+}
+
+void MeshletBuilder::partition(const MeshData& mesh, const VertexAdjacency& adjacency, MeshletData& out) const {
+	const size_t triangleCount = mesh.indices.size() / 3;
+	std::vector<uint8_t> emitted(triangleCount, 0);
+	std::vector<unsigned int> liveTriangles(mesh.vertices.size());
+	for (size_t v = 0; v < liveTriangles.size(); ++v)
+		liveTriangles[v] = adjacency.count(static_cast<unsigned int>(v));
+	std::vector<uint8_t> localIndex(mesh.vertices.size(), NOT_IN_MESHLET);
+
+	out.vertices.reserve(triangleCount);
+	out.triangles.reserve(triangleCount * 3);
+
+	Meshlet current;
+	const auto newVertexCount = [&](size_t t) {
+		const unsigned int a = mesh.indices[t * 3], b = mesh.indices[t * 3 + 1], c = mesh.indices[t * 3 + 2];
+		unsigned int count = localIndex[a] == NOT_IN_MESHLET;
+		count += b != a && localIndex[b] == NOT_IN_MESHLET;
+		count += c != a && c != b && localIndex[c] == NOT_IN_MESHLET;
+		return count;
+	};
+	const auto flush = [&]() {
+		if (current.triangleCount == 0) return;
+		for (unsigned int i = 0; i < current.vertexCount; ++i)
+			localIndex[out.vertices[current.vertexOffset + i]] = NOT_IN_MESHLET;
+		out.meshlets.push_back(current);
+
+		current = Meshlet{};
+		current.vertexOffset = static_cast<unsigned int>(out.vertices.size());
+		current.triangleOffset = static_cast<unsigned int>(out.triangles.size() / 3);
+	};
+	const auto append = [&](size_t t) {
+		for (size_t k = 0; k < 3; ++k) {
+			const unsigned int v = mesh.indices[t * 3 + k];
+			if (localIndex[v] == NOT_IN_MESHLET) {
+				localIndex[v] = static_cast<uint8_t>(current.vertexCount++);
+				out.vertices.push_back(v);
+			}
+			out.triangles.push_back(localIndex[v]);
+			--liveTriangles[v];
+		}
+		emitted[t] = 1;
+		++current.triangleCount;
+	};
+
+	// Grow through shared vertices, preferring triangles that add the fewest new vertices and then
+	// those whose vertices have the fewest triangles left. Without a neighbour that fits, fall back
+	// to the next triangle in index order.
+	size_t cursor = 0;
+	for (size_t remaining = triangleCount; remaining > 0; --remaining) {
+		if (current.triangleCount == out.maxTriangles) flush();
+
+		size_t best = SIZE_MAX;
+		unsigned int bestNew = UINT_MAX, bestLive = UINT_MAX;
+		for (unsigned int i = 0; i < current.vertexCount && bestNew > 0; ++i) {
+			const unsigned int v = out.vertices[current.vertexOffset + i];
+			if (liveTriangles[v] == 0) continue;
+
+			for (unsigned int j = adjacency.offsets[v]; j < adjacency.offsets[v + 1]; ++j) {
+				const size_t t = adjacency.corners[j] / 3;
+				if (emitted[t]) continue;
+
+				const unsigned int added = newVertexCount(t);
+				if (current.vertexCount + added > out.maxVertices) continue;
+
+				const unsigned int live = liveTriangles[mesh.indices[t * 3]] + liveTriangles[mesh.indices[t * 3 + 1]] + liveTriangles[mesh.indices[t * 3 + 2]];
+				if (added < bestNew || (added == bestNew && live < bestLive)) {
+					best = t;
+					bestNew = added;
+					bestLive = live;
+				}
+			}
+		}
+
+		if (best == SIZE_MAX) {
+			while (emitted[cursor]) ++cursor;
+			best = cursor;
+			if (current.vertexCount + newVertexCount(best) > out.maxVertices) flush();
+		}
+		append(best);
+	}
+	flush();
+}
+
+void MeshletBuilder::computeBounds(const MeshData& mesh, MeshletData& out) const {
+	Utils::parallelFor(out.meshlets.size(), BOUNDS_GRAIN, [&](size_t begin, size_t end) {
+		for (size_t m = begin; m < end; ++m)
+			computeMeshletBounds(mesh, out, out.meshlets[m]);
+	});
+}
+
+void MeshletBuilder::computeMeshletBounds(const MeshData& mesh, const MeshletData& data, Meshlet& meshlet) const {
+	const auto position = [&](unsigned int local) -> const Math::Vec3<float>& {
+		return mesh.vertices[data.vertices[meshlet.vertexOffset + local]].pos;
+	};
+
+	Math::Vec3<float> minPos{ FLT_MAX }, maxPos{ -FLT_MAX };
+	for (unsigned int i = 0; i < meshlet.vertexCount; ++i) {
+		const Math::Vec3<float>& p = position(i);
+		minPos = { std::min(minPos.x, p.x), std::min(minPos.y, p.y), std::min(minPos.z, p.z) };
+		maxPos = { std::max(maxPos.x, p.x), std::max(maxPos.y, p.y), std::max(maxPos.z, p.z) };
+	}
+	meshlet.center = Utils::scale(Utils::add(minPos, maxPos), 0.5f);
+
+	float radiusSq = 0.0f;
+	for (unsigned int i = 0; i < meshlet.vertexCount; ++i) {
+		const Math::Vec3<float> d = Utils::sub(position(i), meshlet.center);
+		radiusSq = std::max(radiusSq, Utils::dot(d, d));
+	}
+	meshlet.radius = std::sqrt(radiusSq);
+
+	const uint8_t* local = data.triangles.data() + static_cast<size_t>(meshlet.triangleOffset) * 3;
+	std::vector<Math::Vec3<float>> normals;
+	normals.reserve(meshlet.triangleCount);
+	Math::Vec3<float> axis{ 0.0f };
+	for (unsigned int t = 0; t < meshlet.triangleCount; ++t) {
+		const Math::Vec3<float>& p0 = position(local[t * 3 + 0]);
+		const Math::Vec3<float>& p1 = position(local[t * 3 + 1]);
+		const Math::Vec3<float>& p2 = position(local[t * 3 + 2]);
+		const Math::Vec3<float> n = Utils::normalize(Utils::cross(Utils::sub(p1, p0), Utils::sub(p2, p0)));
+		normals.push_back(n);
+		axis = Utils::add(axis, n);
+	}
+	meshlet.coneAxis = Utils::normalize(axis);
+	meshlet.coneApex = meshlet.center;
+	meshlet.coneCutoff = 1.0f;
+
+	float minDot = 1.0f;
+	for (const Math::Vec3<float>& n : normals)
+		if (Utils::dot(n, n) > 0.0f) minDot = std::min(minDot, Utils::dot(n, meshlet.coneAxis));
+	if (minDot <= MIN_CONE_DOT || Utils::dot(meshlet.coneAxis, meshlet.coneAxis) == 0.0f) return;
+
+	// Slide the apex back along the axis until it lies behind every triangle plane
+	float maxT = 0.0f;
+	for (unsigned int t = 0; t < meshlet.triangleCount; ++t) {
+		const Math::Vec3<float>& n = normals[t];
+		const float dn = Utils::dot(meshlet.coneAxis, n);
+		if (dn <= 0.0f) continue;
+		const float dc = Utils::dot(Utils::sub(meshlet.center, position(local[t * 3])), n);
+		maxT = std::max(maxT, dc / dn);
+	}
+
+	meshlet.coneApex = Utils::sub(meshlet.center, Utils::scale(meshlet.coneAxis, maxT));
+	meshlet.coneCutoff = std::sqrt(1.0f - minDot * minDot);
+}
+
+}
@@ -0,0 +1,166 @@
+#include "starlet-serializer/processor/mesh/normal_generator.hpp"
+#include "starlet-serializer/processor/mesh/vertex_adjacency.hpp"
+#include "starlet-serializer/data/mesh_data.hpp"
+
+#include "starlet-serializer/utils/parallel.hpp"
+#include "starlet-serializer/utils/vec_ops.hpp"
+
+#include "starlet-logger/logger.hpp"
+
+#include "starlet-math/vertex.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Starlet::Serializer {
+
+namespace {
+	constexpr size_t NORMAL_GRAIN = 16 * 1024;
+	constexpr float  PI = 3.14159265358979f;
+	constexpr float  SAME_NORMAL_DOT = 0.9999f;
+
+	float cornerAngle(const Math::Vec3<float>& a, const Math::Vec3<float>& b) {
+		const float d = Utils::dot(Utils::normalize(a), Utils::normalize(b));
+		return std::acos(std::clamp(d, -1.0f, 1.0f));
+	}
+}
+
+bool NormalGenerator::generate(MeshData& mesh, NormalWeighting weighting, float creaseAngle) {
+	if (mesh.indices.size() < 3 || mesh.vertices.empty())
+		return Logger::error("NormalGenerator", "generate", "Mesh has no triangles");
+
+	VertexAdjacency adjacency;
+	if (!buildVertexAdjacency(mesh, adjacency)) return false;
+
+	std::vector<Math::Vec3<float>> faceNormals;
+	std::vector<float> cornerWeights;
+	computeFaceNormals(mesh, weighting, faceNormals, cornerWeights);
+
+	if (creaseAngle >= 180.0f) {
+		gatherVertexNormals(mesh, adjacency, faceNormals, cornerWeights);
+	}
+	else {
+		const float cosCrease = std::cos(std::max(creaseAngle, 0.0f) * PI / 180.0f);
+		std::vector<Math::Vec3<float>> cornerNormals;
+		gatherCornerNormals(adjacency, cosCrease, faceNormals, cornerWeights, cornerNormals);
+		splitCreasedVertices(mesh, adjacency, cornerNormals);
+	}
+
+	mesh.numVertices = static_cast<unsigned int>(mesh.vertices.size());
+	mesh.hasNormals = true;
+	return true;
+}
+
+void NormalGenerator::computeFaceNormals(const MeshData& mesh, NormalWeighting weighting,
+	std::vector<Math::Vec3<float>>& faceNormals, std::vector<float>& cornerWeights) const {
+	const size_t triangleCount = mesh.indices.size() / 3;
+	faceNormals.resize(triangleCount);
+	cornerWeights.resize(triangleCount * 3);
+
+	Utils::parallelFor(triangleCount, NORMAL_GRAIN, [&](size_t begin, size_t end) {
+		for (size_t t = begin; t < end; ++t) {
+			const Math::Vec3<float>& p0 = mesh.vertices[mesh.indices[t * 3 + 0]].pos;
+			const Math::Vec3<float>& p1 = mesh.vertices[mesh.indices[t * 3 + 1]].pos;
+			const Math::Vec3<float>& p2 = mesh.vertices[mesh.indices[t * 3 + 2]].pos;
+
+			const Math::Vec3<float> e01 = Utils::sub(p1, p0);
+			const Math::Vec3<float> e12 = Utils::sub(p2, p1);
+			const Math::Vec3<float> e20 = Utils::sub(p0, p2);
+
+			const Math::Vec3<float> n = Utils::cross(e01, Utils::scale(e20, -1.0f));
+			const float doubleArea = Utils::length(n);
+			faceNormals[t] = doubleArea > 0.0f ? Utils::scale(n, 1.0f / doubleArea) : Math::Vec3<float>{ 0.0f, 0.0f, 0.0f };
+
+			if (weighting == NormalWeighting::Area) {
+				cornerWeights[t * 3 + 0] = cornerWeights[t * 3 + 1] = cornerWeights[t * 3 + 2] = doubleArea;
+			}
+			else {
+				cornerWeights[t * 3 + 0] = cornerAngle(e01, Utils::scale(e20, -1.0f));
+				cornerWeights[t * 3 + 1] = cornerAngle(e12, Utils::scale(e01, -1.0f));
+				cornerWeights[t * 3 + 2] = cornerAngle(e20, Utils::scale(e12, -1.0f));
+			}
+		}
+	});
+}
+
+void NormalGenerator::gatherVertexNormals(MeshData& mesh, const VertexAdjacency& adjacency,
+	const std::vector<Math::Vec3<float>>& faceNormals, const std::vector<float>& cornerWeights) const {
+	Utils::parallelFor(mesh.vertices.size(), NORMAL_GRAIN, [&](size_t begin, size_t end) {
+		for (size_t v = begin; v < end; ++v) {
+			Math::Vec3<float> sum{ 0.0f, 0.0f, 0.0f };
+			for (unsigned int i = adjacency.offsets[v]; i < adjacency.offsets[v + 1]; ++i) {
+				const unsigned int corner = adjacency.corners[i];
+				sum = Utils::add(sum, Utils::scale(faceNormals[corner / 3], cornerWeights[corner]));
+			}
+			mesh.vertices[v].norm = Utils::normalize(sum);
+		}
+	});
+}
+
+void NormalGenerator::gatherCornerNormals(const VertexAdjacency& adjacency, float cosCrease,
+	const std::vector<Math::Vec3<float>>& faceNormals, const std::vector<float>& cornerWeights,
+	std::vector<Math::Vec3<float>>& cornerNormals) const {
+	cornerNormals.resize(adjacency.corners.size());
+
+	Utils::parallelFor(adjacency.offsets.size() - 1, NORMAL_GRAIN, [&](size_t begin, size_t end) {
+		for (size_t v = begin; v < end; ++v) {
+			const unsigned int first = adjacency.offsets[v];
+			const unsigned int last = adjacency.offsets[v + 1];
+
+			for (unsigned int i = first; i < last; ++i) {
+				const unsigned int corner = adjacency.corners[i];
+				const Math::Vec3<float>& faceNormal = faceNormals[corner / 3];
+
+				Math::Vec3<float> sum{ 0.0f, 0.0f, 0.0f };
+				for (unsigned int j = first; j < last; ++j) {
+					const unsigned int other = adjacency.corners[j];
+					const Math::Vec3<float>& otherNormal = faceNormals[other / 3];
+					if (other == corner || Utils::dot(faceNormal, otherNormal) >= cosCrease)
+						sum = Utils::add(sum, Utils::scale(otherNormal, cornerWeights[other]));
+				}
+				cornerNormals[corner] = Utils::normalize(sum);
+			}
+		}
+	});
+}
+
+void NormalGenerator::splitCreasedVertices(MeshData& mesh, const VertexAdjacency& adjacency, const std::vector<Math::Vec3<float>>& cornerNormals) const {
+	const size_t vertexCount = mesh.vertices.size();
+
+	// Corners of a vertex whose normals agree form one smoothing group, and each group gets its own vertex
+	std::vector<unsigned int> slotGroups(adjacency.corners.size(), 0u);
+	Utils::parallelFor(vertexCount, NORMAL_GRAIN, [&](size_t begin, size_t end) {
+		for (size_t v = begin; v < end; ++v) {
+			const unsigned int first = adjacency.offsets[v];
+			const unsigned int last = adjacency.offsets[v + 1];
+			unsigned int groups = 0;
+
+			for (unsigned int i = first; i < last; ++i) {
+				const Math::Vec3<float>& n = cornerNormals[adjacency.corners[i]];
+				unsigned int group = groups;
+				for (unsigned int j = first; j < i; ++j) {
+					if (Utils::dot(n, cornerNormals[adjacency.corners[j]]) >= SAME_NORMAL_DOT) {
+						group = slotGroups[j];
+						break;
+					}
+				}
+				if (group == groups) ++groups;
+				slotGroups[i] = group;
+			}
+		}
+	});
+
+	std::vector<unsigned int> copyOffsets;
+	splitVertexGroups(mesh, adjacency, slotGroups, copyOffsets);
+
+	Utils::parallelFor(vertexCount, NORMAL_GRAIN, [&](size_t begin, size_t end) {
+		for (size_t v = begin; v < end; ++v) {
+			for (unsigned int i = adjacency.offsets[v]; i < adjacency.offsets[v + 1]; ++i) {
+				const unsigned int corner = adjacency.corners[i];
+				mesh.vertices[mesh.indices[corner]].norm = cornerNormals[corner];
+			}
+		}
+	});
+}
+
+}
@@ -0,0 +1,324 @@
+#include "starlet-serializer/processor/mesh/point_cloud_processor.hpp"
+#include "starlet-serializer/processor/mesh/bounds_calculator.hpp"
+#include "starlet-serializer/data/mesh_data.hpp"
+
+#include "starlet-serializer/utils/parallel.hpp"
+#include "starlet-serializer/utils/radix_sort.hpp"
+#include "starlet-serializer/utils/vec_ops.hpp"
+
+#include "starlet-logger/logger.hpp"
+
+#include "starlet-math/vertex.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Starlet::Serializer {
+
+namespace {
+	constexpr size_t   POINT_GRAIN = 64 * 1024;
+	constexpr uint32_t DONE = 0xFFFFFFFFu;
+	constexpr unsigned int MSD_DIGIT_BITS = 8;
+	constexpr size_t   MSD_BUCKETS = size_t{ 1 } << MSD_DIGIT_BITS;
+	constexpr size_t   MSD_SMALL_RANGE = 32; // Ranges this short finish with an insertion sort
+
+	uint64_t spreadBits(uint64_t v) {
+		v &= 0x1FFFFF;
+		v = (v | v << 32) & 0x1F00000000FFFFull;
+		v = (v | v << 16) & 0x1F0000FF0000FFull;
+		v = (v | v << 8)  & 0x100F00F00F00F00Full;
+		v = (v | v << 4)  & 0x10C30C30C30C30C3ull;
+		v = (v | v << 2)  & 0x1249249249249249ull;
+		return v;
+	}
+
+	// Quantisation of positions to the 21-bit-per-axis grid over the cubed bounds of a cloud. Built
+	// from the bounds alone, so codes can be recomputed from any permutation of the points.
+	struct MortonGrid {
+		Math::Vec3<float> origin;
+		double scale, maxCell;
+
+		explicit MortonGrid(const MeshData& cloud) : origin(cloud.boundsMin) {
+			const Math::Vec3<float> extent = Utils::sub(cloud.boundsMax, cloud.boundsMin);
+			const float side = std::max({ extent.x, extent.y, extent.z });
+			const double cells = static_cast<double>(1u << PointCloudProcessor::MORTON_BITS);
+			scale = side > 0.0f ? cells / side : 0.0;
+			maxCell = cells - 1.0;
+		}
+
+		uint64_t code(const Math::Vec3<float>& p) const {
+			const uint64_t x = static_cast<uint64_t>(std::min(maxCell, (p.x - origin.x) * scale));
+			const uint64_t y = static_cast<uint64_t>(std::min(maxCell, (p.y - origin.y) * scale));
+			const uint64_t z = static_cast<uint64_t>(std::min(maxCell, (p.z - origin.z) * scale));
+			return spreadBits(x) | spreadBits(y) << 1 | spreadBits(z) << 2;
+		}
+	};
+
+	// In-place MSD radix sort (American flag sort) of the points on their Morton codes, recomputed
+	// from the positions whenever a digit is needed. Scratch is two counter arrays per recursion
+	// level; `order`, when given, is permuted alongside to track where each point came from.
+	class InPlaceMortonSort {
+	public:
+		InPlaceMortonSort(MeshData& cloud, const MortonGrid& grid, uint32_t* order)
+			: vertices(cloud.vertices.data()), tangents(cloud.tangents.size() == cloud.vertices.size() ? cloud.tangents.data() : nullptr), order(order), grid(grid) {}
+
+		void sort(size_t count) {
+			const unsigned int topShift = (3 * PointCloudProcessor::MORTON_BITS - 1) / MSD_DIGIT_BITS * MSD_DIGIT_BITS;
+			size_t bucketEnd[MSD_BUCKETS];
+			partition(0, count, topShift, bucketEnd);
+
+			// Top-level buckets are disjoint, so they finish on separate threads
+			Utils::parallelFor(MSD_BUCKETS, 1, [&](size_t first, size_t last) {
+				for (size_t b = first; b < last; ++b) {
+					const size_t begin = b == 0 ? 0 : bucketEnd[b - 1];
+					if (topShift > 0) sortRange(begin, bucketEnd[b], topShift - MSD_DIGIT_BITS);
+				}
+			});
+		}
+
+	private:
+		size_t digit(size_t i, unsigned int shift) const { return (grid.code(vertices[i].pos) >> shift) & (MSD_BUCKETS - 1); }
+
+		void swapPoints(size_t a, size_t b) {
+			std::swap(vertices[a], vertices[b]);
+			if (tangents) std::swap(tangents[a], tangents[b]);
+			if (order) std::swap(order[a], order[b]);
+		}
+
+		// Moves every point of [begin, end) into its bucket for the digit at `shift`
+		void partition(size_t begin, size_t end, unsigned int shift, size_t (&bucketEnd)[MSD_BUCKETS]) {
+			size_t next[MSD_BUCKETS] = {};
+			for (size_t i = begin; i < end; ++i) ++next[digit(i, shift)];
+			size_t offset = begin;
+			for (size_t b = 0; b < MSD_BUCKETS; ++b) {
+				const size_t n = next[b];
+				next[b] = offset;
+				offset += n;
+				bucketEnd[b] = offset;
+			}
+
+			for (size_t b = 0; b < MSD_BUCKETS; ++b) {
+				while (next[b] < bucketEnd[b]) {
+					const size_t d = digit(next[b], shift);
+					if (d == b) ++next[b];
+					else swapPoints(next[b], next[d]++);
+				}
+			}
+		}
+
+		void sortRange(size_t begin, size_t end, unsigned int shift) {
+			if (end - begin <= MSD_SMALL_RANGE) {
+				uint64_t keys[MSD_SMALL_RANGE];
+				for (size_t i = begin; i < end; ++i) keys[i - begin] = grid.code(vertices[i].pos);
+				for (size_t i = begin + 1; i < end; ++i) {
+					for (size_t j = i; j > begin && keys[j - begin] < keys[j - 1 - begin]; --j) {
+						std::swap(keys[j - begin], keys[j - 1 - begin]);
+						swapPoints(j, j - 1);
+					}
+				}
+				return;
+			}
+
+			size_t bucketEnd[MSD_BUCKETS];
+			partition(begin, end, shift, bucketEnd);
+			if (shift == 0) return;
+			for (size_t b = 0, first = begin; b < MSD_BUCKETS; first = bucketEnd[b++])
+				if (bucketEnd[b] - first > 1) sortRange(first, bucketEnd[b], shift - MSD_DIGIT_BITS);
+		}
+
+		Math::Vertex* vertices;
+		Math::Vec4<float>* tangents;
+		uint32_t* order;
+		const MortonGrid& grid;
+	};
+
+	// Running sums for one voxel; count doubles as the weight when building the next level
+	struct Accumulator {
+		double pos[3]{}, norm[3]{}, col[4]{};
+		uint64_t count{ 0 };
+
+		void add(const Math::Vertex& v, uint64_t weight) {
+			pos[0] += static_cast<double>(v.pos.x) * weight; pos[1] += static_cast<double>(v.pos.y) * weight; pos[2] += static_cast<double>(v.pos.z) * weight;
+			norm[0] += static_cast<double>(v.norm.x) * weight; norm[1] += static_cast<double>(v.norm.y) * weight; norm[2] += static_cast<double>(v.norm.z) * weight;
+			col[0] += static_cast<double>(v.col.x) * weight; col[1] += static_cast<double>(v.col.y) * weight;
+			col[2] += static_cast<double>(v.col.z) * weight; col[3] += static_cast<double>(v.col.w) * weight;
+			count += weight;
+		}
+
+		Math::Vertex average(bool hasNormals) const {
+			const double inv = 1.0 / static_cast<double>(count);
+			Math::Vertex v;
+			v.pos = { static_cast<float>(pos[0] * inv), static_cast<float>(pos[1] * inv), static_cast<float>(pos[2] * inv) };
+			v.col = { static_cast<float>(col[0] * inv), static_cast<float>(col[1] * inv), static_cast<float>(col[2] * inv), static_cast<float>(col[3] * inv) };
+			if (hasNormals) v.norm = Utils::normalize({ static_cast<float>(norm[0]), static_cast<float>(norm[1]), static_cast<float>(norm[2]) });
+			return v;
+		}
+	};
+
+	// One downsampling step: collapses runs of equal (codeAt(i) >> shift) in the input into single
+	// vertices. Chunks own the runs that start inside them; a count pass sizes the output first.
+	template <typename CodeAt>
+	void collapseRuns(const std::vector<Math::Vertex>& vertices, CodeAt&& codeAt, const std::vector<uint64_t>* weights,
+		unsigned int shift, bool hasNormals, std::vector<Math::Vertex>& outVertices, std::vector<uint64_t>& outCodes, std::vector<uint64_t>& outWeights) {
+		const size_t count = vertices.size();
+		const auto isRunStart = [&](size_t i) { return i == 0 || (codeAt(i) >> shift) != (codeAt(i - 1) >> shift); };
+
+		const size_t chunks = std::max<size_t>(1, Utils::chunkCount(count, POINT_GRAIN));
+		std::vector<size_t> offsets(chunks + 1, 0);
+		Utils::parallelForChunks(count, POINT_GRAIN, [&](size_t chunk, size_t begin, size_t end) {
+			size_t runs = 0;
+			for (size_t i = begin; i < end; ++i) runs += isRunStart(i);
+			offsets[chunk + 1] = runs;
+		});
+		for (size_t c = 1; c <= chunks; ++c) offsets[c] += offsets[c - 1];
+
+		outVertices.resize(offsets[chunks]);
+		outCodes.resize(offsets[chunks]);
+		outWeights.resize(offsets[chunks]);
+		Utils::parallelForChunks(count, POINT_GRAIN, [&](size_t chunk, size_t begin, size_t end) {
+			size_t target = offsets[chunk];
+			size_t i = begin;
+			while (i < end && !isRunStart(i)) ++i;
+			while (i < end) {
+				Accumulator sum;
+				const uint64_t code = codeAt(i);
+				size_t j = i;
+				for (; j < count && (codeAt(j) >> shift) == (code >> shift); ++j) sum.add(vertices[j], weights ? (*weights)[j] : 1);
+				outVertices[target] = sum.average(hasNormals);
+				outCodes[target] = code;
+				outWeights[target] = sum.count;
+				++target;
+				i = j;
+			}
+		});
+	}
+}
+
+size_t PointCloudProcessor::radixSortBytes(size_t count, bool indexed) {
+	// keys, order and the sort's second copy of both, then the inverse permutation for indices
+	return count * (2 * sizeof(uint64_t) + 2 * sizeof(uint32_t) + (indexed ? sizeof(uint32_t) : 0));
+}
+
+bool PointCloudProcessor::mortonSort(MeshData& cloud, std::vector<uint64_t>* codes, size_t memoryBudget) {
+	const size_t count = cloud.vertices.size();
+	if (count == 0) return Logger::error("PointCloudProcessor", "mortonSort", "Point cloud has no vertices");
+	if (count > DONE) return Logger::error("PointCloudProcessor", "mortonSort", "Too many points: " + std::to_string(count));
+
+	BoundsCalculator().compute(cloud);
+	const MortonGrid grid(cloud);
+	const bool indexed = !cloud.indices.empty();
+
+	if (memoryBudget != 0 && radixSortBytes(count, indexed) > memoryBudget) {
+		std::vector<uint32_t> order(indexed ? count : 0);
+		for (size_t i = 0; i < order.size(); ++i) order[i] = static_cast<uint32_t>(i);
+		InPlaceMortonSort(cloud, grid, indexed ? order.data() : nullptr).sort(count);
+
+		if (indexed) remapIndices(cloud, order);
+		if (codes) {
+			codes->resize(count);
+			Utils::parallelFor(count, POINT_GRAIN, [&](size_t begin, size_t end) {
+				for (size_t i = begin; i < end; ++i) (*codes)[i] = grid.code(cloud.vertices[i].pos);
+			});
+		}
+		return true;
+	}
+
+	std::vector<uint64_t> keys(count);
+	std::vector<uint32_t> order(count);
+	Utils::parallelFor(count, POINT_GRAIN, [&](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i) {
+			keys[i] = grid.code(cloud.vertices[i].pos);
+			order[i] = static_cast<uint32_t>(i);
+		}
+	});
+	Utils::radixSortPairs(keys, order, MORTON_BITS * 3);
+
+	if (indexed) remapIndices(cloud, order);
+
+	// Apply vertices[i] = old vertices[order[i]] by walking permutation cycles, marking visited slots
+	const bool hasTangents = cloud.tangents.size() == count;
+	for (size_t start = 0; start < count; ++start) {
+		if (order[start] == DONE) continue;
+		if (order[start] == start) {
+			order[start] = DONE;
+			continue;
+		}
+
+		const Math::Vertex vertex = cloud.vertices[start];
+		const Math::Vec4<float> tangent = hasTangents ? cloud.tangents[start] : Math::Vec4<float>{ 0.0f, 0.0f, 0.0f, 0.0f };
+		size_t slot = start;
+		while (true) {
+			const size_t source = order[slot];
+			order[slot] = DONE;
+			if (source == start) {
+				cloud.vertices[slot] = vertex;
+				if (hasTangents) cloud.tangents[slot] = tangent;
+				break;
+			}
+			cloud.vertices[slot] = cloud.vertices[source];
+			if (hasTangents) cloud.tangents[slot] = cloud.tangents[source];
+			slot = source;
+		}
+	}
+
+	if (codes) *codes = std::move(keys);
+	return true;
+}
+
+void PointCloudProcessor::remapIndices(MeshData& cloud, const std::vector<uint32_t>& order) {
+	const size_t count = order.size();
+	std::vector<uint32_t> newIndex(count);
+	Utils::parallelFor(count, POINT_GRAIN, [&](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i) newIndex[order[i]] = static_cast<uint32_t>(i);
+	});
+	Utils::parallelFor(cloud.indices.size(), POINT_GRAIN, [&](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i)
+			if (cloud.indices[i] < count) cloud.indices[i] = newIndex[cloud.indices[i]];
+	});
+}
+
+bool PointCloudProcessor::buildLevels(const MeshData& sorted, const std::vector<uint64_t>& codes, const PointCloudOptions& options, std::vector<MeshData>& levels) {
+	levels.clear();
+	if (sorted.vertices.empty() || (!codes.empty() && codes.size() != sorted.vertices.size()))
+		return Logger::error("PointCloudProcessor", "buildLevels", "Point cloud is empty or its Morton codes do not match");
+	if (options.finestGridBits == 0 || options.finestGridBits > MORTON_BITS)
+		return Logger::error("PointCloudProcessor", "buildLevels", "Finest grid bits must be in [1, " + std::to_string(MORTON_BITS) + "]");
+
+	const unsigned int levelCount = std::min(options.levelCount, options.finestGridBits);
+	levels.reserve(levelCount);
+	const MortonGrid grid(sorted);
+	std::vector<uint64_t> levelCodes, weights, nextCodes, nextWeights;
+
+	// Each level reads the one before it straight from `levels`; only its codes and weights are kept
+	// on the side
+	for (unsigned int level = 0; level < levelCount; ++level) {
+		const unsigned int shift = 3 * (MORTON_BITS - options.finestGridBits + level);
+		MeshData out;
+		if (level > 0)
+			collapseRuns(levels.back().vertices, [&](size_t i) { return levelCodes[i]; }, &weights, shift, sorted.hasNormals, out.vertices, nextCodes, nextWeights);
+		else if (!codes.empty())
+			collapseRuns(sorted.vertices, [&](size_t i) { return codes[i]; }, nullptr, shift, sorted.hasNormals, out.vertices, nextCodes, nextWeights);
+		else
+			collapseRuns(sorted.vertices, [&](size_t i) { return grid.code(sorted.vertices[i].pos); }, nullptr, shift, sorted.hasNormals, out.vertices, nextCodes, nextWeights);
+
+		levelCodes.swap(nextCodes);
+		weights.swap(nextWeights);
+
+		out.numVertices = static_cast<unsigned int>(out.vertices.size());
+		out.hasNormals = sorted.hasNormals;
+		out.hasColours = sorted.hasColours;
+		BoundsCalculator().compute(out);
+		levels.push_back(std::move(out));
+	}
+	return true;
+}
+
+bool PointCloudProcessor::process(MeshData& cloud, const PointCloudOptions& options, std::vector<MeshData>& levels) {
+	// Within a budget the codes are not kept; level 0 recomputes them from the sorted positions
+	std::vector<uint64_t> codes;
+	const bool keepCodes = options.memoryBudget == 0 || radixSortBytes(cloud.vertices.size(), !cloud.indices.empty()) <= options.memoryBudget;
+	if (!mortonSort(cloud, keepCodes ? &codes : nullptr, options.memoryBudget)) return false;
+	return buildLevels(cloud, codes, options, levels);
+}
+
+}
@@ -0,0 +1,174 @@
+#include "starlet-serializer/processor/mesh/tangent_generator.hpp"
+#include "starlet-serializer/processor/mesh/vertex_adjacency.hpp"
+#include "starlet-serializer/data/mesh_data.hpp"
+
+#include "starlet-serializer/utils/parallel.hpp"
+#include "starlet-serializer/utils/vec_ops.hpp"
+
+#include "starlet-logger/logger.hpp"
+
+#include "starlet-math/vertex.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Starlet::Serializer {
+
+namespace {
+	constexpr size_t TANGENT_GRAIN = 16 * 1024;
+	constexpr float  UV_AREA_EPSILON = 1e-12f;
+
+	float cornerAngle(const Math::Vec3<float>& a, const Math::Vec3<float>& b) {
+		const float d = Utils::dot(Utils::normalize(a), Utils::normalize(b));
+		return std::acos(std::clamp(d, -1.0f, 1.0f));
+	}
+
+	bool isZero(const Math::Vec3<float>& v) {
+		return v.x == 0.0f && v.y == 0.0f && v.z == 0.0f;
+	}
+
+	// Any unit vector perpendicular to n, used when the UVs give no usable direction
+	Math::Vec3<float> perpendicular(const Math::Vec3<float>& n) {
+		const Math::Vec3<float> axis = std::fabs(n.x) < 0.9f ? Math::Vec3<float>{ 1.0f, 0.0f, 0.0f } : Math::Vec3<float>{ 0.0f, 1.0f, 0.0f };
+		const Math::Vec3<float> t = Utils::normalize(Utils::sub(axis, Utils::scale(n, Utils::dot(n, axis))));
+		return isZero(t) ? axis : t;
+	}
+}
+
+bool TangentGenerator::generate(MeshData& mesh) {
+	if (mesh.indices.size() < 3 || mesh.vertices.empty())
+		return Logger::error("TangentGenerator", "generate", "Mesh has no triangles");
+	if (!mesh.hasTexCoords)
+		return Logger::error("TangentGenerator", "generate", "Mesh has no texture coordinates");
+	if (!mesh.hasNormals)
+		return Logger::error("TangentGenerator", "generate", "Mesh has no normals");
+
+	VertexAdjacency adjacency;
+	if (!buildVertexAdjacency(mesh, adjacency)) return false;
+
+	std::vector<Math::Vec3<float>> faceTangents, faceBitangents;
+	std::vector<float> cornerWeights;
+	computeFaceTangents(mesh, faceTangents, faceBitangents, cornerWeights);
+
+	std::vector<unsigned int> slotGroups;
+	std::vector<float> slotSigns;
+	assignHandedness(mesh, adjacency, faceTangents, faceBitangents, slotGroups, slotSigns);
+
+	const size_t vertexCount = mesh.vertices.size();
+	mesh.tangents.clear();
+
+	std::vector<unsigned int> copyOffsets;
+	splitVertexGroups(mesh, adjacency, slotGroups, copyOffsets);
+
+	mesh.tangents.assign(mesh.vertices.size(), Math::Vec4<float>{ 0.0f, 0.0f, 0.0f, 1.0f });
+	gatherTangents(mesh, adjacency, vertexCount, faceTangents, cornerWeights, slotGroups, slotSigns);
+
+	mesh.numVertices = static_cast<unsigned int>(mesh.vertices.size());
+	mesh.hasTangents = true;
+	return true;
+}
+
+void TangentGenerator::computeFaceTangents(const MeshData& mesh, std::vector<Math::Vec3<float>>& faceTangents,
+	std::vector<Math::Vec3<float>>& faceBitangents, std::vector<float>& cornerWeights) const {
+	const size_t triangleCount = mesh.indices.size() / 3;
+	faceTangents.resize(triangleCount);
+	faceBitangents.resize(triangleCount);
+	cornerWeights.resize(triangleCount * 3);
+
+	Utils::parallelFor(triangleCount, TANGENT_GRAIN, [&](size_t begin, size_t end) {
+		for (size_t t = begin; t < end; ++t) {
+			const Math::Vertex& v0 = mesh.vertices[mesh.indices[t * 3 + 0]];
+			const Math::Vertex& v1 = mesh.vertices[mesh.indices[t * 3 + 1]];
+			const Math::Vertex& v2 = mesh.vertices[mesh.indices[t * 3 + 2]];
+
+			const Math::Vec3<float> e1 = Utils::sub(v1.pos, v0.pos);
+			const Math::Vec3<float> e2 = Utils::sub(v2.pos, v0.pos);
+			const Math::Vec3<float> e12 = Utils::sub(v2.pos, v1.pos);
+
+			const float du1 = v1.texCoord.x - v0.texCoord.x, dv1 = v1.texCoord.y - v0.texCoord.y;
+			const float du2 = v2.texCoord.x - v0.texCoord.x, dv2 = v2.texCoord.y - v0.texCoord.y;
+			const float uvArea = du1 * dv2 - du2 * dv1;
+
+			if (std::fabs(uvArea) > UV_AREA_EPSILON) {
+				const float r = 1.0f / uvArea;
+				faceTangents[t] = Utils::normalize(Utils::scale(Utils::sub(Utils::scale(e1, dv2), Utils::scale(e2, dv1)), r));
+				faceBitangents[t] = Utils::normalize(Utils::scale(Utils::sub(Utils::scale(e2, du1), Utils::scale(e1, du2)), r));
+			}
+			else {
+				faceTangents[t] = faceBitangents[t] = Math::Vec3<float>{ 0.0f, 0.0f, 0.0f };
+			}
+
+			cornerWeights[t * 3 + 0] = cornerAngle(e1, e2);
+			cornerWeights[t * 3 + 1] = cornerAngle(e12, Utils::scale(e1, -1.0f));
+			cornerWeights[t * 3 + 2] = cornerAngle(Utils::scale(e2, -1.0f), Utils::scale(e12, -1.0f));
+		}
+	});
+}
+
+void TangentGenerator::assignHandedness(const MeshData& mesh, const VertexAdjacency& adjacency, const std::vector<Math::Vec3<float>>& faceTangents,
+	const std::vector<Math::Vec3<float>>& faceBitangents, std::vector<unsigned int>& slotGroups, std::vector<float>& slotSigns) const {
+	slotGroups.assign(adjacency.corners.size(), 0u);
+	slotSigns.assign(adjacency.corners.size(), 1.0f);
+
+	Utils::parallelFor(mesh.vertices.size(), TANGENT_GRAIN, [&](size_t begin, size_t end) {
+		for (size_t v = begin; v < end; ++v) {
+			const Math::Vec3<float>& n = mesh.vertices[v].norm;
+			const unsigned int first = adjacency.offsets[v];
+			const unsigned int last = adjacency.offsets[v + 1];
+
+			// Group 0 takes the handedness of the first corner with usable UVs, group 1 the opposite
+			float baseSign = 0.0f;
+			for (unsigned int i = first; i < last; ++i) {
+				const unsigned int face = adjacency.corners[i] / 3;
+				if (isZero(faceTangents[face])) continue;
+
+				const float sign = Utils::dot(Utils::cross(n, faceTangents[face]), faceBitangents[face]) < 0.0f ? -1.0f : 1.0f;
+				if (baseSign == 0.0f) baseSign = sign;
+				slotGroups[i] = sign == baseSign ? 0u : 1u;
+				slotSigns[i] = sign;
+			}
+
+			if (baseSign == 0.0f) continue;
+			for (unsigned int i = first; i < last; ++i)
+				if (isZero(faceTangents[adjacency.corners[i] / 3])) slotSigns[i] = baseSign;
+		}
+	});
+}
+
+void TangentGenerator::gatherTangents(MeshData& mesh, const VertexAdjacency& adjacency, size_t vertexCount, const std::vector<Math::Vec3<float>>& faceTangents,
+	const std::vector<float>& cornerWeights, const std::vector<unsigned int>& slotGroups, const std::vector<float>& slotSigns) const {
+	Utils::parallelFor(vertexCount, TANGENT_GRAIN, [&](size_t begin, size_t end) {
+		for (size_t v = begin; v < end; ++v) {
+			const Math::Vec3<float>& n = mesh.vertices[v].norm;
+			const unsigned int first = adjacency.offsets[v];
+			const unsigned int last = adjacency.offsets[v + 1];
+
+			for (unsigned int group = 0; group < 2; ++group) {
+				Math::Vec3<float> sum{ 0.0f, 0.0f, 0.0f };
+				unsigned int target = 0;
+				float sign = 1.0f;
+				bool used = false;
+
+				for (unsigned int i = first; i < last; ++i) {
+					if (slotGroups[i] != group) continue;
+
+					const unsigned int corner = adjacency.corners[i];
+					const Math::Vec3<float>& t = faceTangents[corner / 3];
+					const Math::Vec3<float> projected = Utils::sub(t, Utils::scale(n, Utils::dot(n, t)));
+					sum = Utils::add(sum, Utils::scale(projected, cornerWeights[corner]));
+
+					target = mesh.indices[corner];
+					sign = slotSigns[i];
+					used = true;
+				}
+				if (!used) continue;
+
+				Math::Vec3<float> tangent = Utils::normalize(sum);
+				if (isZero(tangent)) tangent = perpendicular(n);
+				mesh.tangents[target] = { tangent.x, tangent.y, tangent.z, sign };
+			}
+		}
+	});
+}
+
+}
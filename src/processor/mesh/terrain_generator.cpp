@@ -0,0 +1,266 @@
+#include "starlet-serializer/processor/mesh/terrain_generator.hpp"
+#include "starlet-serializer/data/terrain_data.hpp"
+#include "starlet-serializer/data/image_data.hpp"
+
+#include "starlet-serializer/utils/parallel.hpp"
+
+#include "starlet-logger/logger.hpp"
+
+#include "starlet-math/vertex.hpp"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <string>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define STARLET_TERRAIN_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace Starlet::Serializer {
+
+namespace {
+	constexpr unsigned int MAX_CHUNK_SIZE = 4096;
+
+	// Sample positions along a chunk axis of `count` vertices: every stride-th vertex and the last
+	std::vector<unsigned int> axisSamples(unsigned int count, unsigned int stride) {
+		std::vector<unsigned int> samples;
+		for (unsigned int i = 0; i < count - 1; i += stride) samples.push_back(i);
+		samples.push_back(count - 1);
+		return samples;
+	}
+
+	// Normals for one row of vertices from a height buffer with a one-sample border. `row` points at
+	// the border sample left of the first vertex; `above`/`below` at the same column one row up/down.
+	void rowNormals(const float* row, const float* above, const float* below, unsigned int count, float spacing, float* nx, float* ny, float* nz) {
+		const float up = 2.0f * spacing;
+		unsigned int c = 0;
+#ifdef STARLET_TERRAIN_SSE2
+		const __m128 y = _mm_set1_ps(up), yy = _mm_set1_ps(up * up), one = _mm_set1_ps(1.0f);
+		for (; c + 4 <= count; c += 4) {
+			const __m128 x = _mm_sub_ps(_mm_loadu_ps(row + c), _mm_loadu_ps(row + c + 2));
+			const __m128 z = _mm_sub_ps(_mm_loadu_ps(above + c + 1), _mm_loadu_ps(below + c + 1));
+			const __m128 lengthSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(z, z)), yy);
+			const __m128 inverse = _mm_div_ps(one, _mm_sqrt_ps(lengthSq));
+			_mm_storeu_ps(nx + c, _mm_mul_ps(x, inverse));
+			_mm_storeu_ps(ny + c, _mm_mul_ps(y, inverse));
+			_mm_storeu_ps(nz + c, _mm_mul_ps(z, inverse));
+		}
+#endif
+		for (; c < count; ++c) {
+			const float x = row[c] - row[c + 2];
+			const float z = above[c + 1] - below[c + 1];
+			const float inverse = 1.0f / std::sqrt(x * x + z * z + up * up);
+			nx[c] = x * inverse;
+			ny[c] = up * inverse;
+			nz[c] = z * inverse;
+		}
+	}
+
+	// Quad strip between an edge of the grid and its skirt copy, wound to face away from the chunk
+	void addSkirt(std::vector<unsigned int>& indices, const std::vector<unsigned int>& samples, unsigned int gridBase, unsigned int gridStep, unsigned int skirtBase, bool flip) {
+		for (size_t i = 0; i + 1 < samples.size(); ++i) {
+			const unsigned int a = gridBase + samples[i] * gridStep, b = gridBase + samples[i + 1] * gridStep;
+			const unsigned int as = skirtBase + samples[i], bs = skirtBase + samples[i + 1];
+			if (flip) indices.insert(indices.end(), { b, a, bs, a, as, bs });
+			else      indices.insert(indices.end(), { a, b, as, b, bs, as });
+		}
+	}
+
+	// Largest vertical distance between the full-resolution heights and the coarse triangles
+	float lodError(const std::vector<float>& heights, unsigned int cols, const std::vector<unsigned int>& sx, const std::vector<unsigned int>& sz) {
+		const auto h = [&](unsigned int r, unsigned int c) { return heights[static_cast<size_t>(r) * cols + c]; };
+		float error = 0.0f;
+		for (size_t a = 0; a + 1 < sz.size(); ++a) {
+			for (size_t b = 0; b + 1 < sx.size(); ++b) {
+				const unsigned int z0 = sz[a], z1 = sz[a + 1], x0 = sx[b], x1 = sx[b + 1];
+				const float h00 = h(z0, x0), h10 = h(z0, x1), h01 = h(z1, x0), h11 = h(z1, x1);
+				const float invU = 1.0f / static_cast<float>(x1 - x0), invV = 1.0f / static_cast<float>(z1 - z0);
+				for (unsigned int r = z0; r <= z1; ++r) {
+					const float v = static_cast<float>(r - z0) * invV;
+					for (unsigned int c = x0; c <= x1; ++c) {
+						const float u = static_cast<float>(c - x0) * invU;
+						// Same split as the index buffer: the diagonal runs from (x1, z0) to (x0, z1)
+						const float approx = u + v <= 1.0f
+							? h00 + u * (h10 - h00) + v * (h01 - h00)
+							: h11 + (1.0f - u) * (h01 - h11) + (1.0f - v) * (h10 - h11);
+						error = std::max(error, std::abs(h(r, c) - approx));
+					}
+				}
+			}
+		}
+		return error;
+	}
+}
+
+bool TerrainGenerator::validate(const ImageData& image, const TerrainOptions& options) const {
+	if (image.width < 2 || image.height < 2)
+		return Logger::error("TerrainGenerator", "generate", "Heightmap must be at least 2x2 pixels");
+	if (image.pixelSize == 0 || image.pixels.size() < static_cast<size_t>(image.width) * image.height * image.pixelSize)
+		return Logger::error("TerrainGenerator", "generate", "Heightmap has fewer pixels than its dimensions");
+	if (options.channel >= image.pixelSize)
+		return Logger::error("TerrainGenerator", "generate", "Channel " + std::to_string(options.channel) + " is out of range for " + std::to_string(image.pixelSize) + "-byte pixels");
+	if (!(options.horizontalScale > 0.0f))
+		return Logger::error("TerrainGenerator", "generate", "Horizontal scale must be positive");
+	if (options.chunkSize == 0 || options.chunkSize > MAX_CHUNK_SIZE)
+		return Logger::error("TerrainGenerator", "generate", "Chunk size must be in [1, " + std::to_string(MAX_CHUNK_SIZE) + "]");
+	if (options.lodCount == 0 || options.lodCount > 13 || (1u << (options.lodCount - 1)) > options.chunkSize)
+		return Logger::error("TerrainGenerator", "generate", "LOD count " + std::to_string(options.lodCount) + " is too high for chunk size " + std::to_string(options.chunkSize));
+	return true;
+}
+
+void TerrainGenerator::buildChunk(const ImageData& image, const TerrainOptions& options, unsigned int chunkX, unsigned int chunkZ, TerrainChunk& out) const {
+	const unsigned int width = static_cast<unsigned int>(image.width), height = static_cast<unsigned int>(image.height);
+	const unsigned int x0 = chunkX * options.chunkSize, z0 = chunkZ * options.chunkSize;
+	const unsigned int cols = std::min(options.chunkSize, width - 1 - x0) + 1;
+	const unsigned int rows = std::min(options.chunkSize, height - 1 - z0) + 1;
+	const float spacing = options.horizontalScale;
+	const float toHeight = options.heightScale / 255.0f;
+
+	// World heights with a one-sample border, clamped at the image edges. Z follows image rows from
+	// the top, so bottom-up (native layout) images are read from their last stored row.
+	const size_t pitch = static_cast<size_t>(cols) + 2;
+	std::vector<float> border(pitch * (rows + 2));
+	for (unsigned int r = 0; r < rows + 2; ++r) {
+		const unsigned int z = std::min(static_cast<unsigned int>(std::max(static_cast<int>(z0 + r) - 1, 0)), height - 1);
+		const size_t stored = image.bottomUp ? height - 1 - z : z;
+		const uint8_t* src = image.pixels.data() + stored * width * image.pixelSize + options.channel;
+		for (unsigned int c = 0; c < cols + 2; ++c) {
+			const unsigned int x = std::min(static_cast<unsigned int>(std::max(static_cast<int>(x0 + c) - 1, 0)), width - 1);
+			border[r * pitch + c] = static_cast<float>(src[static_cast<size_t>(x) * image.pixelSize]) * toHeight;
+		}
+	}
+
+	const unsigned int gridCount = cols * rows;
+	const bool skirts = options.skirtDepth > 0.0f;
+	const unsigned int skirtCount = skirts ? 2 * (cols + rows) : 0;
+	MeshData& mesh = out.mesh;
+	mesh.vertices.resize(gridCount + skirtCount);
+
+	std::vector<float> heights(gridCount);
+	std::vector<float> nx(cols), ny(cols), nz(cols);
+	const float invU = 1.0f / static_cast<float>(width - 1), invV = 1.0f / static_cast<float>(height - 1);
+	for (unsigned int r = 0; r < rows; ++r) {
+		const float* row = border.data() + (r + 1) * pitch;
+		rowNormals(row, row - pitch, row + pitch, cols, spacing, nx.data(), ny.data(), nz.data());
+		for (unsigned int c = 0; c < cols; ++c) {
+			const float h = row[c + 1];
+			heights[r * cols + c] = h;
+			Math::Vertex& v = mesh.vertices[r * cols + c];
+			v.pos = { static_cast<float>(x0 + c) * spacing, h, static_cast<float>(z0 + r) * spacing };
+			v.norm = { nx[c], ny[c], nz[c] };
+			v.col = { 1.0f, 1.0f, 1.0f, 1.0f };
+			v.texCoord = { static_cast<float>(x0 + c) * invU, static_cast<float>(z0 + r) * invV };
+		}
+	}
+
+	// Skirt copies of the top, bottom, left and right edges, in that order
+	const unsigned int top = gridCount, bottom = top + cols, left = bottom + cols, right = left + rows;
+	if (skirts) {
+		const auto drop = [&](unsigned int from, unsigned int to) {
+			mesh.vertices[to] = mesh.vertices[from];
+			mesh.vertices[to].pos.y -= options.skirtDepth;
+		};
+		for (unsigned int c = 0; c < cols; ++c) {
+			drop(c, top + c);
+			drop((rows - 1) * cols + c, bottom + c);
+		}
+		for (unsigned int r = 0; r < rows; ++r) {
+			drop(r * cols, left + r);
+			drop(r * cols + cols - 1, right + r);
+		}
+	}
+
+	// Bounds are known from the grid layout and the height range
+	const auto [lowest, highest] = std::minmax_element(heights.begin(), heights.end());
+	mesh.boundsMin = { static_cast<float>(x0) * spacing, *lowest - (skirts ? options.skirtDepth : 0.0f), static_cast<float>(z0) * spacing };
+	mesh.boundsMax = { static_cast<float>(x0 + cols - 1) * spacing, *highest, static_cast<float>(z0 + rows - 1) * spacing };
+	mesh.sphereCenter = {
+		(mesh.boundsMin.x + mesh.boundsMax.x) * 0.5f,
+		(mesh.boundsMin.y + mesh.boundsMax.y) * 0.5f,
+		(mesh.boundsMin.z + mesh.boundsMax.z) * 0.5f
+	};
+	float radiusSq = 0.0f;
+	for (const Math::Vertex& v : mesh.vertices) {
+		const float dx = v.pos.x - mesh.sphereCenter.x, dy = v.pos.y - mesh.sphereCenter.y, dz = v.pos.z - mesh.sphereCenter.z;
+		radiusSq = std::max(radiusSq, dx * dx + dy * dy + dz * dz);
+	}
+	mesh.sphereRadius = std::sqrt(radiusSq);
+	mesh.minY = mesh.boundsMin.y;
+	mesh.maxY = mesh.boundsMax.y;
+
+	const float dx = mesh.boundsMax.x - mesh.boundsMin.x, dy = *highest - *lowest, dz = mesh.boundsMax.z - mesh.boundsMin.z;
+	const float extent = std::sqrt(dx * dx + dy * dy + dz * dz);
+
+	out.lods.resize(options.lodCount);
+	for (unsigned int level = 0; level < options.lodCount; ++level) {
+		const std::vector<unsigned int> sx = axisSamples(cols, 1u << level), sz = axisSamples(rows, 1u << level);
+		LodData& lod = out.lods[level];
+		lod.indices.resize((sx.size() - 1) * (sz.size() - 1) * 6);
+		unsigned int* quad = lod.indices.data();
+		for (size_t a = 0; a + 1 < sz.size(); ++a) {
+			for (size_t b = 0; b + 1 < sx.size(); ++b, quad += 6) {
+				const unsigned int i00 = sz[a] * cols + sx[b], i10 = sz[a] * cols + sx[b + 1];
+				const unsigned int i01 = sz[a + 1] * cols + sx[b], i11 = sz[a + 1] * cols + sx[b + 1];
+				quad[0] = i00; quad[1] = i01; quad[2] = i10;
+				quad[3] = i10; quad[4] = i01; quad[5] = i11;
+			}
+		}
+		if (skirts) {
+			addSkirt(lod.indices, sx, 0, 1, top, false);
+			addSkirt(lod.indices, sx, (rows - 1) * cols, 1, bottom, true);
+			addSkirt(lod.indices, sz, 0, cols, left, true);
+			addSkirt(lod.indices, sz, cols - 1, cols, right, false);
+		}
+		lod.numIndices = static_cast<unsigned int>(lod.indices.size());
+		lod.numTriangles = lod.numIndices / 3;
+		lod.error = level == 0 || extent == 0.0f ? 0.0f : lodError(heights, cols, sx, sz) / extent;
+	}
+
+	mesh.indices = out.lods[0].indices;
+	mesh.numVertices = static_cast<unsigned int>(mesh.vertices.size());
+	mesh.numIndices = static_cast<unsigned int>(mesh.indices.size());
+	mesh.numTriangles = mesh.numIndices / 3;
+	mesh.hasNormals = mesh.hasTexCoords = true;
+	out.chunkX = chunkX;
+	out.chunkZ = chunkZ;
+}
+
+bool TerrainGenerator::generate(const ImageData& image, const TerrainOptions& options, TerrainData& out) const {
+	if (!validate(image, options)) return false;
+
+	out.chunksX = (static_cast<unsigned int>(image.width) - 2) / options.chunkSize + 1;
+	out.chunksZ = (static_cast<unsigned int>(image.height) - 2) / options.chunkSize + 1;
+	out.chunks.assign(static_cast<size_t>(out.chunksX) * out.chunksZ, TerrainChunk{});
+	Utils::parallelFor(out.chunks.size(), 1, [&](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i)
+			buildChunk(image, options, static_cast<unsigned int>(i % out.chunksX), static_cast<unsigned int>(i / out.chunksX), out.chunks[i]);
+	});
+	return true;
+}
+
+bool TerrainGenerator::generate(const ImageData& image, const TerrainOptions& options, const std::function<bool(TerrainChunk&)>& sink) const {
+	if (!validate(image, options)) return false;
+
+	const size_t chunksX = (static_cast<unsigned int>(image.width) - 2) / options.chunkSize + 1;
+	const size_t chunksZ = (static_cast<unsigned int>(image.height) - 2) / options.chunkSize + 1;
+	const size_t total = chunksX * chunksZ;
+
+	std::vector<TerrainChunk> batch;
+	for (size_t first = 0; first < total; first += batch.size()) {
+		// Chunks are rebuilt in place, so their buffers are reused from batch to batch
+		batch.resize(std::min(Utils::workerCount(), total - first));
+		Utils::parallelFor(batch.size(), 1, [&](size_t begin, size_t end) {
+			for (size_t i = begin; i < end; ++i)
+				buildChunk(image, options, static_cast<unsigned int>((first + i) % chunksX), static_cast<unsigned int>((first + i) / chunksX), batch[i]);
+		});
+		for (TerrainChunk& chunk : batch) {
+			if (!sink(chunk))
+				return Logger::error("TerrainGenerator", "generate", "Chunk sink stopped at chunk (" + std::to_string(chunk.chunkX) + ", " + std::to_string(chunk.chunkZ) + ")");
+		}
+	}
+	return true;
+}
+
+}
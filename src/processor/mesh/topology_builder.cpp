@@ -0,0 +1,94 @@
+#include "starlet-serializer/processor/mesh/topology_builder.hpp"
+#include "starlet-serializer/data/topology_data.hpp"
+#include "starlet-serializer/data/mesh_data.hpp"
+
+#include "starlet-serializer/utils/parallel.hpp"
+#include "starlet-serializer/utils/radix_sort.hpp"
+
+#include "starlet-logger/logger.hpp"
+
+#include <algorithm>
+
+namespace Starlet::Serializer {
+
+namespace {
+	constexpr size_t TOPOLOGY_GRAIN = 64 * 1024;
+
+	struct ChunkResult {
+		std::vector<uint32_t> boundary;
+		std::vector<MeshEdge> nonManifold;
+		size_t edges{ 0 }, flipped{ 0 };
+	};
+}
+
+bool TopologyBuilder::build(const MeshData& mesh, TopologyData& out) {
+	out = TopologyData{};
+	if (mesh.indices.size() < 3 || mesh.indices.size() % 3 != 0)
+		return Logger::error("TopologyBuilder", "build", "Mesh has no triangle list");
+
+	const std::vector<unsigned int>& indices = mesh.indices;
+	const size_t halfEdgeCount = indices.size();
+	const unsigned int vertexBits = Utils::bitWidth(mesh.vertices.empty() ? 0 : mesh.vertices.size() - 1);
+
+	std::vector<uint64_t> keys(halfEdgeCount);
+	std::vector<uint32_t> halfEdges(halfEdgeCount);
+	std::vector<size_t> badIndex(Utils::chunkCount(halfEdgeCount, TOPOLOGY_GRAIN), SIZE_MAX);
+	Utils::parallelForChunks(halfEdgeCount, TOPOLOGY_GRAIN, [&](size_t chunk, size_t begin, size_t end) {
+		for (size_t h = begin; h < end; ++h) {
+			const unsigned int a = indices[h], b = indices[TopologyData::next(static_cast<uint32_t>(h))];
+			if (a >= mesh.vertices.size() && badIndex[chunk] == SIZE_MAX) badIndex[chunk] = h;
+			keys[h] = (static_cast<uint64_t>(std::min(a, b)) << vertexBits) | std::max(a, b);
+			halfEdges[h] = static_cast<uint32_t>(h);
+		}
+	});
+	for (size_t bad : badIndex)
+		if (bad != SIZE_MAX)
+			return Logger::error("TopologyBuilder", "build", "Index out of bounds at " + std::to_string(bad) + ": " + std::to_string(indices[bad]));
+
+	Utils::radixSortPairs(keys, halfEdges, vertexBits * 2);
+
+	// Each chunk handles the runs that start inside it, reading past its end to finish the last one
+	out.twins.assign(halfEdgeCount, TopologyData::NO_TWIN);
+	std::vector<ChunkResult> results(std::max<size_t>(1, Utils::chunkCount(halfEdgeCount, TOPOLOGY_GRAIN)));
+	Utils::parallelForChunks(halfEdgeCount, TOPOLOGY_GRAIN, [&](size_t chunk, size_t begin, size_t end) {
+		ChunkResult& result = results[chunk];
+		size_t start = begin;
+		while (start > 0 && start < halfEdgeCount && keys[start] == keys[start - 1]) ++start;
+
+		while (start < end) {
+			size_t runEnd = start + 1;
+			while (runEnd < halfEdgeCount && keys[runEnd] == keys[start]) ++runEnd;
+
+			const uint32_t first = halfEdges[start];
+			const unsigned int v0 = indices[first], v1 = indices[TopologyData::next(first)];
+			const size_t run = runEnd - start;
+
+			if (v0 != v1) {
+				++result.edges;
+				if (run == 1) {
+					result.boundary.push_back(first);
+				}
+				else if (run == 2) {
+					const uint32_t second = halfEdges[start + 1];
+					out.twins[first] = second;
+					out.twins[second] = first;
+					if (indices[second] == v0) ++result.flipped;
+				}
+				else {
+					result.nonManifold.push_back({ std::min(v0, v1), std::max(v0, v1), static_cast<unsigned int>(run) });
+				}
+			}
+			start = runEnd;
+		}
+	});
+
+	for (ChunkResult& result : results) {
+		out.boundaryHalfEdges.insert(out.boundaryHalfEdges.end(), result.boundary.begin(), result.boundary.end());
+		out.nonManifoldEdges.insert(out.nonManifoldEdges.end(), result.nonManifold.begin(), result.nonManifold.end());
+		out.edgeCount += result.edges;
+		out.flippedEdges += result.flipped;
+	}
+	return true;
+}
+
+}
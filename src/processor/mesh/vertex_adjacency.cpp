@@ -0,0 +1,76 @@
+#include "starlet-serializer/processor/mesh/vertex_adjacency.hpp"
+#include "starlet-serializer/data/mesh_data.hpp"
+
+#include "starlet-serializer/utils/parallel.hpp"
+
+#include "starlet-logger/logger.hpp"
+
+#include <algorithm>
+
+namespace Starlet::Serializer {
+
+namespace {
+	constexpr size_t SPLIT_GRAIN = 16 * 1024;
+}
+
+bool buildVertexAdjacency(const MeshData& mesh, VertexAdjacency& out) {
+	const size_t vertexCount = mesh.vertices.size();
+	const size_t cornerCount = (mesh.indices.size() / 3) * 3;
+
+	out.offsets.assign(vertexCount + 1, 0u);
+	for (size_t c = 0; c < cornerCount; ++c) {
+		const unsigned int v = mesh.indices[c];
+		if (v >= vertexCount)
+			return Logger::error("VertexAdjacency", "buildVertexAdjacency", "Index out of bounds at corner " + std::to_string(c) + ": " + std::to_string(v));
+		++out.offsets[v + 1];
+	}
+
+	for (size_t v = 0; v < vertexCount; ++v)
+		out.offsets[v + 1] += out.offsets[v];
+
+	std::vector<unsigned int> cursor(out.offsets.begin(), out.offsets.end() - 1);
+	out.corners.resize(cornerCount);
+	for (size_t c = 0; c < cornerCount; ++c)
+		out.corners[cursor[mesh.indices[c]]++] = static_cast<unsigned int>(c);
+
+	return true;
+}
+
+void splitVertexGroups(MeshData& mesh, const VertexAdjacency& adjacency, const std::vector<unsigned int>& slotGroups, std::vector<unsigned int>& copyOffsets) {
+	const size_t vertexCount = adjacency.offsets.size() - 1;
+	copyOffsets.assign(vertexCount + 1, 0u);
+
+	Utils::parallelFor(vertexCount, SPLIT_GRAIN, [&](size_t begin, size_t end) {
+		for (size_t v = begin; v < end; ++v) {
+			unsigned int maxGroup = 0;
+			for (unsigned int i = adjacency.offsets[v]; i < adjacency.offsets[v + 1]; ++i)
+				maxGroup = std::max(maxGroup, slotGroups[i]);
+			copyOffsets[v + 1] = maxGroup;
+		}
+	});
+
+	for (size_t v = 0; v < vertexCount; ++v)
+		copyOffsets[v + 1] += copyOffsets[v];
+
+	if (copyOffsets[vertexCount] == 0) return;
+	const bool copyTangents = mesh.tangents.size() == vertexCount;
+	mesh.vertices.resize(vertexCount + copyOffsets[vertexCount]);
+	if (copyTangents) mesh.tangents.resize(mesh.vertices.size());
+
+	Utils::parallelFor(vertexCount, SPLIT_GRAIN, [&](size_t begin, size_t end) {
+		for (size_t v = begin; v < end; ++v) {
+			for (unsigned int i = adjacency.offsets[v]; i < adjacency.offsets[v + 1]; ++i) {
+				const unsigned int group = slotGroups[i];
+				if (group == 0) continue;
+
+				const unsigned int copy = static_cast<unsigned int>(vertexCount + copyOffsets[v] + group - 1);
+				mesh.vertices[copy] = mesh.vertices[v];
+				if (copyTangents) mesh.tangents[copy] = mesh.tangents[v];
+				mesh.indices[adjacency.corners[i]] = copy;
+			}
+		}
+	});
+	mesh.numVertices = static_cast<unsigned int>(mesh.vertices.size());
+}
+
+}
@@ -0,0 +1,249 @@
+#include "starlet-serializer/processor/mesh/vertex_welder.hpp"
+#include "starlet-serializer/data/mesh_data.hpp"
+
+#include "starlet-serializer/utils/parallel.hpp"
+
+#include "starlet-logger/logger.hpp"
+
+#include "starlet-math/vertex.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+
+namespace Starlet::Serializer {
+
+namespace {
+	constexpr size_t WELD_GRAIN = 64 * 1024;
+
+	struct Cell {
+		int64_t x, y, z;
+	};
+
+	Cell cellOf(const Math::Vec3<float>& p, double inverseSize) {
+		return {
+			static_cast<int64_t>(std::floor(p.x * inverseSize)),
+			static_cast<int64_t>(std::floor(p.y * inverseSize)),
+			static_cast<int64_t>(std::floor(p.z * inverseSize))
+		};
+	}
+
+	uint64_t hashCell(int64_t x, int64_t y, int64_t z) {
+		uint64_t h = static_cast<uint64_t>(x) * 0x9E3779B97F4A7C15ull;
+		h ^= static_cast<uint64_t>(y) * 0xC2B2AE3D27D4EB4Full;
+		h ^= static_cast<uint64_t>(z) * 0x165667B19E3779F9ull;
+		return h ^ (h >> 29);
+	}
+
+	bool near(float a, float b, float epsilon) { return std::fabs(a - b) <= epsilon; }
+
+	bool sameAttributes(const MeshData& mesh, size_t a, size_t b, float epsilon) {
+		const Math::Vertex& va = mesh.vertices[a];
+		const Math::Vertex& vb = mesh.vertices[b];
+		if (mesh.hasNormals && !(near(va.norm.x, vb.norm.x, epsilon) && near(va.norm.y, vb.norm.y, epsilon) && near(va.norm.z, vb.norm.z, epsilon)))
+			return false;
+		if (mesh.hasColours && !(near(va.col.x, vb.col.x, epsilon) && near(va.col.y, vb.col.y, epsilon) && near(va.col.z, vb.col.z, epsilon) && near(va.col.w, vb.col.w, epsilon)))
+			return false;
+		if (mesh.hasTexCoords && !(near(va.texCoord.x, vb.texCoord.x, epsilon) && near(va.texCoord.y, vb.texCoord.y, epsilon)))
+			return false;
+		if (mesh.hasTangents && mesh.tangents.size() == mesh.vertices.size()) {
+			const Math::Vec4<float>& ta = mesh.tangents[a];
+			const Math::Vec4<float>& tb = mesh.tangents[b];
+			if (!(near(ta.x, tb.x, epsilon) && near(ta.y, tb.y, epsilon) && near(ta.z, tb.z, epsilon)) || ta.w != tb.w)
+				return false;
+		}
+		return true;
+	}
+
+	// Concurrent union-find root lookup with path halving; a lost CAS only skips a shortcut
+	uint32_t findRoot(std::atomic<uint32_t>* parent, uint32_t v) {
+		while (true) {
+			uint32_t p = parent[v].load(std::memory_order_relaxed);
+			if (p == v) return v;
+			const uint32_t grandparent = parent[p].load(std::memory_order_relaxed);
+			if (grandparent != p) parent[v].compare_exchange_weak(p, grandparent, std::memory_order_relaxed);
+			v = grandparent;
+		}
+	}
+
+	// Links the higher root under the lower one, so every set ends up rooted at its lowest index
+	void unite(std::atomic<uint32_t>* parent, uint32_t a, uint32_t b) {
+		while (true) {
+			a = findRoot(parent, a);
+			b = findRoot(parent, b);
+			if (a == b) return;
+			if (a < b) std::swap(a, b);
+			uint32_t expected = a;
+			if (parent[a].compare_exchange_strong(expected, b, std::memory_order_relaxed)) return;
+		}
+	}
+}
+
+bool VertexWelder::weld(MeshData& mesh, const WeldOptions& options, std::vector<unsigned int>* remap) {
+	if (mesh.vertices.empty())
+		return Logger::error("VertexWelder", "weld", "Mesh has no vertices");
+	if (!(options.positionEpsilon > 0.0f) || options.attributeEpsilon < 0.0f)
+		return Logger::error("VertexWelder", "weld", "Weld epsilon must be positive");
+	for (size_t i = 0; i < mesh.indices.size(); ++i)
+		if (mesh.indices[i] >= mesh.vertices.size())
+			return Logger::error("VertexWelder", "weld", "Index out of bounds at " + std::to_string(i) + ": " + std::to_string(mesh.indices[i]));
+
+	std::vector<unsigned int> representatives;
+	findRepresentatives(mesh, options, representatives);
+
+	std::vector<unsigned int> localRemap;
+	std::vector<unsigned int>& newIndex = remap ? *remap : localRemap;
+	compact(mesh, representatives, newIndex);
+	remapIndices(mesh, newIndex, options.removeDegenerate);
+	return true;
+}
+
+void VertexWelder::findRepresentatives(const MeshData& mesh, const WeldOptions& options, std::vector<unsigned int>& representatives) const {
+	const size_t vertexCount = mesh.vertices.size();
+	// Cells are twice the epsilon wide, so every match lies in the 2x2x2 block of cells on the
+	// vertex's side of its own cell centre
+	const double inverseSize = 0.5 / options.positionEpsilon;
+	const float epsilonSq = options.positionEpsilon * options.positionEpsilon;
+
+	size_t tableSize = 1;
+	while (tableSize < vertexCount * 2) tableSize <<= 1;
+	const uint64_t mask = tableSize - 1;
+
+	// Bucket vertices by cell hash: count, prefix sum, scatter, then sort each bucket so the
+	// layout does not depend on thread timing
+	std::vector<uint32_t> buckets(vertexCount);
+	std::unique_ptr<std::atomic<uint32_t>[]> counts(new std::atomic<uint32_t>[tableSize + 1]);
+	Utils::parallelFor(tableSize + 1, WELD_GRAIN, [&](size_t begin, size_t end) {
+		for (size_t b = begin; b < end; ++b) counts[b].store(0, std::memory_order_relaxed);
+	});
+	Utils::parallelFor(vertexCount, WELD_GRAIN, [&](size_t begin, size_t end) {
+		for (size_t v = begin; v < end; ++v) {
+			const Cell c = cellOf(mesh.vertices[v].pos, inverseSize);
+			buckets[v] = static_cast<uint32_t>(hashCell(c.x, c.y, c.z) & mask);
+			counts[buckets[v] + 1].fetch_add(1, std::memory_order_relaxed);
+		}
+	});
+
+	std::vector<uint32_t> offsets(tableSize + 1, 0);
+	for (size_t b = 1; b <= tableSize; ++b) offsets[b] = offsets[b - 1] + counts[b].load(std::memory_order_relaxed);
+	Utils::parallelFor(tableSize, WELD_GRAIN, [&](size_t begin, size_t end) {
+		for (size_t b = begin; b < end; ++b) counts[b].store(offsets[b], std::memory_order_relaxed);
+	});
+
+	std::vector<uint32_t> entries(vertexCount);
+	Utils::parallelFor(vertexCount, WELD_GRAIN, [&](size_t begin, size_t end) {
+		for (size_t v = begin; v < end; ++v)
+			entries[counts[buckets[v]].fetch_add(1, std::memory_order_relaxed)] = static_cast<uint32_t>(v);
+	});
+	counts.reset();
+	buckets.clear();
+	buckets.shrink_to_fit();
+
+	Utils::parallelFor(tableSize, WELD_GRAIN, [&](size_t begin, size_t end) {
+		for (size_t b = begin; b < end; ++b)
+			if (offsets[b + 1] - offsets[b] > 1) std::sort(entries.begin() + offsets[b], entries.begin() + offsets[b + 1]);
+	});
+
+	// Every matching pair is united once, from its higher index, so groups are the connected
+	// components of the match graph: a and c weld when a matches b and b matches c, even if a and
+	// c are further apart than epsilon
+	std::unique_ptr<std::atomic<uint32_t>[]> parent(new std::atomic<uint32_t>[vertexCount]);
+	Utils::parallelFor(vertexCount, WELD_GRAIN, [&](size_t begin, size_t end) {
+		for (size_t v = begin; v < end; ++v) parent[v].store(static_cast<uint32_t>(v), std::memory_order_relaxed);
+	});
+	Utils::parallelFor(vertexCount, WELD_GRAIN, [&](size_t begin, size_t end) {
+		for (size_t v = begin; v < end; ++v) {
+			const Math::Vec3<float>& p = mesh.vertices[v].pos;
+			const Cell c = cellOf(p, inverseSize);
+			const int64_t sx = p.x * inverseSize - static_cast<double>(c.x) < 0.5 ? -1 : 1;
+			const int64_t sy = p.y * inverseSize - static_cast<double>(c.y) < 0.5 ? -1 : 1;
+			const int64_t sz = p.z * inverseSize - static_cast<double>(c.z) < 0.5 ? -1 : 1;
+
+			for (int64_t dz = 0; dz <= 1; ++dz) {
+				for (int64_t dy = 0; dy <= 1; ++dy) {
+					for (int64_t dx = 0; dx <= 1; ++dx) {
+						const uint64_t bucket = hashCell(c.x + dx * sx, c.y + dy * sy, c.z + dz * sz) & mask;
+						for (uint32_t e = offsets[bucket]; e < offsets[bucket + 1]; ++e) {
+							const uint32_t other = entries[e];
+							if (other >= v) break;
+
+							const Math::Vec3<float>& q = mesh.vertices[other].pos;
+							const float ex = q.x - p.x, ey = q.y - p.y, ez = q.z - p.z;
+							if (ex * ex + ey * ey + ez * ez > epsilonSq) continue;
+							if (!options.positionOnly && !sameAttributes(mesh, v, other, options.attributeEpsilon)) continue;
+							unite(parent.get(), static_cast<uint32_t>(v), other);
+						}
+					}
+				}
+			}
+		}
+	});
+
+	representatives.resize(vertexCount);
+	Utils::parallelFor(vertexCount, WELD_GRAIN, [&](size_t begin, size_t end) {
+		for (size_t v = begin; v < end; ++v) representatives[v] = findRoot(parent.get(), static_cast<uint32_t>(v));
+	});
+}
+
+void VertexWelder::compact(MeshData& mesh, const std::vector<unsigned int>& representatives, std::vector<unsigned int>& remap) const {
+	const size_t vertexCount = mesh.vertices.size();
+	const bool hasTangents = mesh.tangents.size() == vertexCount;
+
+	// Per-chunk survivor counts give each chunk its output offset
+	const size_t chunks = std::max<size_t>(1, Utils::chunkCount(vertexCount, WELD_GRAIN));
+	std::vector<size_t> chunkOffsets(chunks + 1, 0);
+	Utils::parallelForChunks(vertexCount, WELD_GRAIN, [&](size_t chunk, size_t begin, size_t end) {
+		size_t kept = 0;
+		for (size_t v = begin; v < end; ++v) kept += representatives[v] == v;
+		chunkOffsets[chunk + 1] = kept;
+	});
+	for (size_t c = 1; c <= chunks; ++c) chunkOffsets[c] += chunkOffsets[c - 1];
+	const size_t keptCount = chunkOffsets[chunks];
+
+	remap.resize(vertexCount);
+	std::vector<Math::Vertex> vertices(keptCount);
+	std::vector<Math::Vec4<float>> tangents(hasTangents ? keptCount : 0);
+	Utils::parallelForChunks(vertexCount, WELD_GRAIN, [&](size_t chunk, size_t begin, size_t end) {
+		size_t next = chunkOffsets[chunk];
+		for (size_t v = begin; v < end; ++v) {
+			if (representatives[v] != v) continue;
+			remap[v] = static_cast<unsigned int>(next);
+			vertices[next] = mesh.vertices[v];
+			if (hasTangents) tangents[next] = mesh.tangents[v];
+			++next;
+		}
+	});
+	Utils::parallelFor(vertexCount, WELD_GRAIN, [&](size_t begin, size_t end) {
+		for (size_t v = begin; v < end; ++v)
+			if (representatives[v] != v) remap[v] = remap[representatives[v]];
+	});
+
+	mesh.vertices = std::move(vertices);
+	if (hasTangents) mesh.tangents = std::move(tangents);
+	mesh.numVertices = static_cast<unsigned int>(mesh.vertices.size());
+}
+
+void VertexWelder::remapIndices(MeshData& mesh, const std::vector<unsigned int>& remap, bool removeDegenerate) const {
+	Utils::parallelFor(mesh.indices.size(), WELD_GRAIN, [&](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i) mesh.indices[i] = remap[mesh.indices[i]];
+	});
+
+	if (removeDegenerate && mesh.indices.size() % 3 == 0) {
+		size_t kept = 0;
+		for (size_t t = 0; t + 2 < mesh.indices.size(); t += 3) {
+			const unsigned int a = mesh.indices[t], b = mesh.indices[t + 1], c = mesh.indices[t + 2];
+			if (a == b || b == c || a == c) continue;
+			mesh.indices[kept++] = a;
+			mesh.indices[kept++] = b;
+			mesh.indices[kept++] = c;
+		}
+		mesh.indices.resize(kept);
+	}
+
+	mesh.numIndices = static_cast<unsigned int>(mesh.indices.size());
+	mesh.numTriangles = mesh.numIndices / 3;
+}
+
+}
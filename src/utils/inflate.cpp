@@ -0,0 +1,413 @@
+#include "starlet-serializer/utils/inflate.hpp"
+#include "starlet-serializer/utils/cpu_features.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#ifdef STARLET_X86
+#include <immintrin.h>
+#endif
+
+namespace Starlet::Serializer::Utils {
+
+namespace {
+	// Table entries: bits 0-4 hold the bits to consume, bits 8-12 the extra bits to read after the
+	// code (or a subtable's index bits), bits 16-31 the literal, base value or subtable offset
+	constexpr uint32_t ENTRY_INVALID  = 1u << 5;
+	constexpr uint32_t ENTRY_LITERAL  = 1u << 13;
+	constexpr uint32_t ENTRY_SUBTABLE = 1u << 14;
+	constexpr uint32_t ENTRY_END      = 1u << 15;
+
+	constexpr uint32_t MAX_CODE_BITS = 15;
+	constexpr uint32_t LITLEN_PRIMARY_BITS = 10;
+	constexpr uint32_t DIST_PRIMARY_BITS = 8;
+	constexpr uint32_t CODELEN_PRIMARY_BITS = 7;
+	// zlib's worst cases are 1334 and 402 entries for these primary sizes; builds check the bound anyway
+	constexpr size_t LITLEN_TABLE_SIZE = 2048;
+	constexpr size_t DIST_TABLE_SIZE = 1024;
+	constexpr size_t CODELEN_TABLE_SIZE = 1u << CODELEN_PRIMARY_BITS;
+
+	constexpr uint32_t LITLEN_CODES = 288, DIST_CODES = 32;
+	constexpr uint16_t LENGTH_BASE[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+	constexpr uint8_t  LENGTH_EXTRA[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+	constexpr uint16_t DIST_BASE[30] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+	constexpr uint8_t  DIST_EXTRA[30] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+	constexpr uint8_t  CODELEN_ORDER[19] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+	constexpr uint32_t ADLER_MOD = 65521;
+	constexpr size_t ADLER_NMAX = 5552; // Most bytes before the 32-bit sums can overflow
+
+	constexpr uint32_t makeEntry(uint32_t value, uint32_t extra, uint32_t flags) { return (value << 16) | (extra << 8) | flags; }
+
+	uint32_t litlenEntry(uint32_t symbol) {
+		if (symbol < 256)  return makeEntry(symbol, 0, ENTRY_LITERAL);
+		if (symbol == 256) return ENTRY_END;
+		if (symbol < 286)  return makeEntry(LENGTH_BASE[symbol - 257], LENGTH_EXTRA[symbol - 257], 0);
+		return ENTRY_INVALID;
+	}
+	uint32_t distEntry(uint32_t symbol) {
+		return symbol < 30 ? makeEntry(DIST_BASE[symbol], DIST_EXTRA[symbol], 0) : ENTRY_INVALID;
+	}
+	uint32_t codelenEntry(uint32_t symbol) {
+		return makeEntry(symbol, 0, 0);
+	}
+
+	uint32_t reverseBits(uint32_t code, uint32_t bits) {
+		uint32_t reversed = 0;
+		for (uint32_t i = 0; i < bits; ++i, code >>= 1) reversed = (reversed << 1) | (code & 1);
+		return reversed;
+	}
+
+	// Canonical Huffman decode table from code lengths, indexed by the next primaryBits input bits.
+	// Deflate stores codes MSB-first in an LSB-first stream, so slots are keyed by bit-reversed codes.
+	// Longer codes share a primary slot per prefix that points at a subtable appended after the
+	// primary table. Incomplete codes are accepted; their unused slots decode as invalid.
+	template<typename SymbolEntry>
+	bool buildTable(const uint8_t* lengths, uint32_t count, uint32_t primaryBits, SymbolEntry symbolEntry, uint32_t* table, size_t tableSize) {
+		uint32_t lengthCount[MAX_CODE_BITS + 1]{};
+		for (uint32_t i = 0; i < count; ++i) ++lengthCount[lengths[i]];
+		lengthCount[0] = 0;
+
+		int32_t left = 1;
+		for (uint32_t len = 1; len <= MAX_CODE_BITS; ++len) {
+			left = (left << 1) - static_cast<int32_t>(lengthCount[len]);
+			if (left < 0) return false; // Over-subscribed
+		}
+
+		uint32_t nextCode[MAX_CODE_BITS + 1]{};
+		for (uint32_t len = 1, code = 0; len <= MAX_CODE_BITS; ++len) {
+			code = (code + lengthCount[len - 1]) << 1;
+			nextCode[len] = code;
+		}
+
+		const size_t primarySize = size_t{ 1 } << primaryBits;
+		std::fill(table, table + primarySize, ENTRY_INVALID | 1u);
+		size_t used = primarySize;
+
+		// Canonical order (length, then symbol) is also lexicographic code order, so long codes
+		// sharing a prefix arrive together and the last of each group is its longest
+		uint32_t groupPrefix = UINT32_MAX;
+		uint32_t* subtable = nullptr;
+		uint32_t subBits = 0;
+		for (uint32_t len = 1; len <= MAX_CODE_BITS; ++len) {
+			for (uint32_t symbol = 0; symbol < count; ++symbol) {
+				if (lengths[symbol] != len) continue;
+				const uint32_t code = nextCode[len]++;
+				const uint32_t entry = symbolEntry(symbol);
+
+				if (len <= primaryBits) {
+					for (size_t i = reverseBits(code, len); i < primarySize; i += size_t{ 1 } << len)
+						table[i] = entry | len;
+					continue;
+				}
+
+				const uint32_t prefix = code >> (len - primaryBits);
+				if (prefix != groupPrefix) {
+					// The group's longest code sets the subtable size
+					// (longer lengths are untouched yet, so nextCode still holds their first code)
+					uint32_t maxLen = len;
+					for (uint32_t longer = len + 1; longer <= MAX_CODE_BITS; ++longer) {
+						const uint32_t first = nextCode[longer], last = first + lengthCount[longer];
+						const uint32_t low = prefix << (longer - primaryBits), high = (prefix + 1) << (longer - primaryBits);
+						if (first < high && last > low) maxLen = longer;
+					}
+					subBits = maxLen - primaryBits;
+					if (used + (size_t{ 1 } << subBits) > tableSize) return false;
+					subtable = table + used;
+					std::fill(subtable, subtable + (size_t{ 1 } << subBits), ENTRY_INVALID | 1u);
+					table[reverseBits(prefix, primaryBits)] = makeEntry(static_cast<uint32_t>(used), subBits, ENTRY_SUBTABLE) | primaryBits;
+					used += size_t{ 1 } << subBits;
+					groupPrefix = prefix;
+				}
+
+				const uint32_t suffixBits = len - primaryBits;
+				const uint32_t suffix = code & ((1u << suffixBits) - 1);
+				for (size_t i = reverseBits(suffix, suffixBits); i < (size_t{ 1 } << subBits); i += size_t{ 1 } << suffixBits)
+					subtable[i] = entry | suffixBits;
+			}
+		}
+		return true;
+	}
+
+	// 64-bit LSB-first bit buffer. Reads past the end of the input feed zero bytes and are counted,
+	// so a truncated stream is caught once it actually consumes them.
+	struct BitReader {
+		const uint8_t* p;
+		const uint8_t* end;
+		uint64_t bits{ 0 };
+		uint32_t count{ 0 };
+		uint32_t overrun{ 0 };
+
+		// Leaves at least 56 bits buffered. Bytes above `count` may already hold the next input byte,
+		// which later refills OR in again unchanged.
+		void refill() {
+			if (end - p >= 8) {
+				uint64_t word = 0;
+				for (int i = 7; i >= 0; --i) word = (word << 8) | p[i];
+				bits |= word << count;
+				p += (63 - count) >> 3;
+				count |= 56;
+				return;
+			}
+			while (count <= 56) {
+				if (p < end) bits |= static_cast<uint64_t>(*p++) << count;
+				else ++overrun;
+				count += 8;
+			}
+		}
+
+		uint32_t peek(uint32_t n) const { return static_cast<uint32_t>(bits) & ((1u << n) - 1); }
+		void consume(uint32_t n) { bits >>= n; count -= n; }
+		uint32_t read(uint32_t n) { const uint32_t v = peek(n); consume(n); return v; }
+		bool truncated() const { return overrun * 8 > count; }
+
+		// Drops bits up to the next byte boundary and hands whole unread bytes back to the input
+		bool alignToByte() {
+			consume(count & 7);
+			if (truncated()) return false;
+			p -= (count >> 3) - overrun;
+			bits = 0;
+			count = overrun = 0;
+			return true;
+		}
+	};
+
+	struct FixedTables {
+		uint32_t litlen[LITLEN_TABLE_SIZE];
+		uint32_t dist[DIST_TABLE_SIZE];
+
+		FixedTables() {
+			uint8_t lengths[LITLEN_CODES];
+			std::fill(lengths, lengths + 144, 8);
+			std::fill(lengths + 144, lengths + 256, 9);
+			std::fill(lengths + 256, lengths + 280, 7);
+			std::fill(lengths + 280, lengths + LITLEN_CODES, 8);
+			buildTable(lengths, LITLEN_CODES, LITLEN_PRIMARY_BITS, litlenEntry, litlen, LITLEN_TABLE_SIZE);
+			std::fill(lengths, lengths + DIST_CODES, 5);
+			buildTable(lengths, DIST_CODES, DIST_PRIMARY_BITS, distEntry, dist, DIST_TABLE_SIZE);
+		}
+	};
+
+	uint32_t lookup(const uint32_t* table, uint32_t primaryBits, BitReader& in) {
+		uint32_t entry = table[in.peek(primaryBits)];
+		if (entry & ENTRY_SUBTABLE) {
+			in.consume(primaryBits);
+			entry = table[(entry >> 16) + in.peek((entry >> 8) & 0x1F)];
+		}
+		in.consume(entry & 0x1F);
+		return entry;
+	}
+
+	bool readDynamicTables(BitReader& in, uint32_t* litlen, uint32_t* dist) {
+		in.refill();
+		const uint32_t litlenCount = in.read(5) + 257;
+		const uint32_t distCount = in.read(5) + 1;
+		const uint32_t codelenCount = in.read(4) + 4;
+		if (litlenCount > 286 || distCount > 30) return false;
+
+		uint8_t codelenLengths[19]{};
+		for (uint32_t i = 0; i < codelenCount; ++i) {
+			if (in.count < 3) in.refill();
+			codelenLengths[CODELEN_ORDER[i]] = static_cast<uint8_t>(in.read(3));
+		}
+		uint32_t codelenTable[CODELEN_TABLE_SIZE];
+		if (!buildTable(codelenLengths, 19, CODELEN_PRIMARY_BITS, codelenEntry, codelenTable, CODELEN_TABLE_SIZE))
+			return false;
+
+		// Literal/length and distance lengths form one sequence; repeats may cross between them
+		uint8_t lengths[286 + 30]{};
+		const uint32_t total = litlenCount + distCount;
+		for (uint32_t i = 0; i < total;) {
+			if (in.count < 16) in.refill();
+			if (in.truncated()) return false;
+			const uint32_t entry = lookup(codelenTable, CODELEN_PRIMARY_BITS, in);
+			if (entry & ENTRY_INVALID) return false;
+
+			const uint32_t symbol = entry >> 16;
+			if (symbol < 16) {
+				lengths[i++] = static_cast<uint8_t>(symbol);
+				continue;
+			}
+
+			uint8_t value = 0;
+			uint32_t repeat;
+			if (symbol == 16) {
+				if (i == 0) return false;
+				value = lengths[i - 1];
+				repeat = 3 + in.read(2);
+			}
+			else if (symbol == 17) repeat = 3 + in.read(3);
+			else                   repeat = 11 + in.read(7);
+			if (i + repeat > total) return false;
+			std::fill(lengths + i, lengths + i + repeat, value);
+			i += repeat;
+		}
+		if (lengths[256] == 0) return false; // End-of-block must be codable
+
+		return buildTable(lengths, litlenCount, LITLEN_PRIMARY_BITS, litlenEntry, litlen, LITLEN_TABLE_SIZE)
+			&& buildTable(lengths + litlenCount, distCount, DIST_PRIMARY_BITS, distEntry, dist, DIST_TABLE_SIZE);
+	}
+
+	bool inflateHuffmanBlock(BitReader& in, const uint32_t* litlen, const uint32_t* dist, uint8_t* dstStart, uint8_t*& out, uint8_t* outEnd) {
+		for (;;) {
+			// One refill covers the longest length/distance pair: 15 + 5 + 15 + 13 bits
+			if (in.count < 48) {
+				in.refill();
+				if (in.truncated()) return false;
+			}
+
+			const uint32_t entry = lookup(litlen, LITLEN_PRIMARY_BITS, in);
+			if (entry & ENTRY_LITERAL) {
+				if (out == outEnd) return false;
+				*out++ = static_cast<uint8_t>(entry >> 16);
+				continue;
+			}
+			if (entry & (ENTRY_END | ENTRY_INVALID)) return (entry & ENTRY_END) != 0;
+			const size_t length = (entry >> 16) + in.read((entry >> 8) & 0x1F);
+
+			const uint32_t distEntry = lookup(dist, DIST_PRIMARY_BITS, in);
+			if (distEntry & ENTRY_INVALID) return false;
+			const size_t distance = (distEntry >> 16) + in.read((distEntry >> 8) & 0x1F);
+
+			if (distance > static_cast<size_t>(out - dstStart) || length > static_cast<size_t>(outEnd - out)) return false;
+			const uint8_t* from = out - distance;
+			if (distance >= 8 && static_cast<size_t>(outEnd - out) >= length + 8) {
+				// Whole 8-byte chunks, overshooting into space later output overwrites; the source
+				// trails by at least a chunk, so overlapping matches still replicate correctly
+				uint8_t* const stop = out + length;
+				do {
+					std::memcpy(out, from, 8);
+					out += 8;
+					from += 8;
+				} while (out < stop);
+				out = stop;
+			}
+			else if (distance == 1) {
+				std::memset(out, *from, length);
+				out += length;
+			}
+			else {
+				for (size_t i = 0; i < length; ++i) out[i] = from[i];
+				out += length;
+			}
+		}
+	}
+
+	uint32_t adler32Scalar(const uint8_t* data, size_t size, uint32_t a, uint32_t b) {
+		while (size > 0) {
+			size_t n = std::min(size, ADLER_NMAX);
+			size -= n;
+			for (; n >= 8; n -= 8, data += 8) {
+				a += data[0]; b += a; a += data[1]; b += a; a += data[2]; b += a; a += data[3]; b += a;
+				a += data[4]; b += a; a += data[5]; b += a; a += data[6]; b += a; a += data[7]; b += a;
+			}
+			for (; n > 0; --n) { a += *data++; b += a; }
+			a %= ADLER_MOD;
+			b %= ADLER_MOD;
+		}
+		return (b << 16) | a;
+	}
+
+#ifdef STARLET_X86
+	STARLET_TARGET("ssse3")
+	uint32_t hsum32(__m128i v) {
+		v = _mm_add_epi32(v, _mm_shuffle_epi32(v, 0x4E));
+		v = _mm_add_epi32(v, _mm_shuffle_epi32(v, 0xB1));
+		return static_cast<uint32_t>(_mm_cvtsi128_si32(v));
+	}
+
+	// 32-byte blocks: SAD sums the bytes into a, weighted multiply-adds (32..1) accumulate b, and
+	// the running a of earlier blocks is added 32 times per block at the end of each chunk
+	STARLET_TARGET("ssse3")
+	uint32_t adler32Ssse3(const uint8_t* data, size_t size, uint32_t a, uint32_t b) {
+		constexpr size_t BLOCK = 32;
+		const __m128i tapsLow = _mm_setr_epi8(32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17);
+		const __m128i tapsHigh = _mm_setr_epi8(16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1);
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i ones = _mm_set1_epi16(1);
+
+		size_t blocks = size / BLOCK;
+		while (blocks > 0) {
+			size_t n = std::min(blocks, ADLER_NMAX / BLOCK);
+			blocks -= n;
+
+			__m128i previousA = _mm_set_epi32(0, 0, 0, static_cast<int>(a * n));
+			__m128i sumA = zero;
+			__m128i sumB = _mm_set_epi32(0, 0, 0, static_cast<int>(b));
+			do {
+				const __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+				const __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 16));
+				previousA = _mm_add_epi32(previousA, sumA);
+				sumA = _mm_add_epi32(sumA, _mm_add_epi32(_mm_sad_epu8(low, zero), _mm_sad_epu8(high, zero)));
+				sumB = _mm_add_epi32(sumB, _mm_madd_epi16(_mm_maddubs_epi16(low, tapsLow), ones));
+				sumB = _mm_add_epi32(sumB, _mm_madd_epi16(_mm_maddubs_epi16(high, tapsHigh), ones));
+				data += BLOCK;
+			} while (--n);
+
+			sumB = _mm_add_epi32(sumB, _mm_slli_epi32(previousA, 5));
+			a = (a + hsum32(sumA)) % ADLER_MOD;
+			b = hsum32(sumB) % ADLER_MOD;
+		}
+		return adler32Scalar(data, size % BLOCK, a, b);
+	}
+#endif
+}
+
+uint32_t adler32(const uint8_t* data, size_t size, uint32_t adler) {
+	const uint32_t a = adler & 0xFFFF, b = adler >> 16;
+#ifdef STARLET_X86
+	if (simdLevel() != SimdLevel::Scalar) return adler32Ssse3(data, size, a, b);
+#endif
+	return adler32Scalar(data, size, a, b);
+}
+
+bool inflateZlib(const uint8_t* src, size_t srcSize, uint8_t* dst, size_t dstSize) {
+	// CMF/FLG header: deflate with a window up to 32K, checksum multiple of 31, no preset dictionary
+	if (!src || !dst || srcSize < 6) return false;
+	const uint32_t cmf = src[0], flg = src[1];
+	if ((cmf & 0x0F) != 8 || (cmf >> 4) > 7 || ((cmf << 8) | flg) % 31 != 0 || (flg & 0x20) != 0) return false;
+
+	static const FixedTables fixed;
+	uint32_t litlen[LITLEN_TABLE_SIZE];
+	uint32_t dist[DIST_TABLE_SIZE];
+
+	BitReader in{ src + 2, src + srcSize };
+	uint8_t* out = dst;
+	uint8_t* const outEnd = dst + dstSize;
+
+	bool finalBlock = false;
+	while (!finalBlock) {
+		in.refill();
+		finalBlock = in.read(1) != 0;
+		const uint32_t type = in.read(2);
+		if (in.truncated()) return false;
+
+		if (type == 0) {
+			if (!in.alignToByte() || in.end - in.p < 4) return false;
+			const uint32_t length = in.p[0] | (in.p[1] << 8);
+			const uint32_t complement = in.p[2] | (in.p[3] << 8);
+			in.p += 4;
+			if ((length ^ 0xFFFF) != complement) return false;
+			if (static_cast<size_t>(in.end - in.p) < length || static_cast<size_t>(outEnd - out) < length) return false;
+			std::memcpy(out, in.p, length);
+			in.p += length;
+			out += length;
+		}
+		else if (type == 1) {
+			if (!inflateHuffmanBlock(in, fixed.litlen, fixed.dist, dst, out, outEnd)) return false;
+		}
+		else if (type == 2) {
+			if (!readDynamicTables(in, litlen, dist)) return false;
+			if (!inflateHuffmanBlock(in, litlen, dist, dst, out, outEnd)) return false;
+		}
+		else return false;
+	}
+
+	// Big-endian Adler-32 of the output follows on the next byte boundary
+	if (out != outEnd || !in.alignToByte() || in.end - in.p < 4) return false;
+	const uint32_t expected = (static_cast<uint32_t>(in.p[0]) << 24) | (static_cast<uint32_t>(in.p[1]) << 16)
+		| (static_cast<uint32_t>(in.p[2]) << 8) | in.p[3];
+	return expected == adler32(dst, dstSize);
+}
+
+}
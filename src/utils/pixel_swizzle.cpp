@@ -0,0 +1,225 @@
+#include "starlet-serializer/utils/pixel_swizzle.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#ifdef STARLET_X86
+#include <immintrin.h>
+#endif
+
+namespace Starlet::Serializer::Utils {
+
+namespace {
+	// Byte order of each 16-byte block; -1 writes zero. Swaps only touch whole pixels, so byte 15 of
+	// the 24-bit masks (the next pixel's first byte) passes through unchanged and is rewritten by the
+	// following store, which keeps in-place use safe.
+	alignas(16) constexpr int8_t SWAP24_MASK[16] = { 2, 1, 0, 5, 4, 3, 8, 7, 6, 11, 10, 9, 14, 13, 12, 15 };
+	alignas(16) constexpr int8_t SWAP32_MASK[16] = { 2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15 };
+	alignas(16) constexpr int8_t PACK_SWAP_MASK[16] = { 2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1 };
+	alignas(16) constexpr int8_t PACK_MASK[16] = { 0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1 };
+	alignas(16) constexpr int8_t EXPAND_SWAP_MASK[16] = { 2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1 };
+	alignas(16) constexpr int8_t EXPAND_MASK[16] = { 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1 };
+
+	// Scalar reference for every layout change, driven by the same masks the SIMD kernels use
+	template<size_t SrcSize, size_t DstSize>
+	void shuffleScalar(const uint8_t* src, uint8_t* dst, size_t pixels, const int8_t* mask) {
+		for (size_t i = 0; i < pixels; ++i) {
+			uint8_t in[4];
+			std::memcpy(in, src + i * SrcSize, SrcSize);
+			for (size_t c = 0; c < DstSize; ++c)
+				dst[i * DstSize + c] = mask[c] < 0 ? 0xFF : in[mask[c]];
+		}
+	}
+
+#ifdef STARLET_X86
+	// Each kernel returns how many pixels it converted; loops stop while full-width loads and
+	// stores are still inside both buffers
+	STARLET_TARGET("ssse3")
+	size_t shuffle24Ssse3(const uint8_t* src, uint8_t* dst, size_t pixels, const int8_t* maskBytes) {
+		const __m128i mask = _mm_load_si128(reinterpret_cast<const __m128i*>(maskBytes));
+		size_t i = 0;
+		for (; i + 6 <= pixels; i += 5) {
+			const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 3));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 3), _mm_shuffle_epi8(v, mask));
+		}
+		return i;
+	}
+	STARLET_TARGET("ssse3")
+	size_t shuffle32Ssse3(const uint8_t* src, uint8_t* dst, size_t pixels, const int8_t* maskBytes) {
+		const __m128i mask = _mm_load_si128(reinterpret_cast<const __m128i*>(maskBytes));
+		size_t i = 0;
+		for (; i + 4 <= pixels; i += 4) {
+			const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 4));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 4), _mm_shuffle_epi8(v, mask));
+		}
+		return i;
+	}
+	STARLET_TARGET("ssse3")
+	size_t pack32To24Ssse3(const uint8_t* src, uint8_t* dst, size_t pixels, const int8_t* maskBytes) {
+		const __m128i mask = _mm_load_si128(reinterpret_cast<const __m128i*>(maskBytes));
+		size_t i = 0;
+		for (; i + 6 <= pixels; i += 4) {
+			const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 4));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 3), _mm_shuffle_epi8(v, mask));
+		}
+		return i;
+	}
+	STARLET_TARGET("ssse3")
+	size_t expand24To32Ssse3(const uint8_t* src, uint8_t* dst, size_t pixels, const int8_t* maskBytes) {
+		const __m128i mask = _mm_load_si128(reinterpret_cast<const __m128i*>(maskBytes));
+		const __m128i alpha = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+		size_t i = 0;
+		for (; i + 6 <= pixels; i += 4) {
+			const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 3));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 4), _mm_or_si128(_mm_shuffle_epi8(v, mask), alpha));
+		}
+		return i;
+	}
+
+	// AVX2 shuffles stay within 128-bit lanes, so the 24-bit layouts feed each lane separately
+	STARLET_TARGET("avx2")
+	__m256i broadcastMask(const int8_t* maskBytes) {
+		return _mm256_broadcastsi128_si256(_mm_load_si128(reinterpret_cast<const __m128i*>(maskBytes)));
+	}
+	STARLET_TARGET("avx2")
+	__m256i loadLanes(const uint8_t* lo, const uint8_t* hi) {
+		const __m128i l = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lo));
+		const __m128i h = _mm_loadu_si128(reinterpret_cast<const __m128i*>(hi));
+		return _mm256_inserti128_si256(_mm256_castsi128_si256(l), h, 1);
+	}
+	STARLET_TARGET("avx2")
+	size_t shuffle24Avx2(const uint8_t* src, uint8_t* dst, size_t pixels, const int8_t* maskBytes) {
+		const __m256i mask = broadcastMask(maskBytes);
+		size_t i = 0;
+		for (; i + 11 <= pixels; i += 10) {
+			const __m256i v = _mm256_shuffle_epi8(loadLanes(src + i * 3, src + i * 3 + 15), mask);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 3), _mm256_castsi256_si128(v));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 3 + 15), _mm256_extracti128_si256(v, 1));
+		}
+		return i;
+	}
+	STARLET_TARGET("avx2")
+	size_t shuffle32Avx2(const uint8_t* src, uint8_t* dst, size_t pixels, const int8_t* maskBytes) {
+		const __m256i mask = broadcastMask(maskBytes);
+		size_t i = 0;
+		for (; i + 8 <= pixels; i += 8) {
+			const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i * 4));
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i * 4), _mm256_shuffle_epi8(v, mask));
+		}
+		return i;
+	}
+	STARLET_TARGET("avx2")
+	size_t pack32To24Avx2(const uint8_t* src, uint8_t* dst, size_t pixels, const int8_t* maskBytes) {
+		const __m256i mask = broadcastMask(maskBytes);
+		const __m256i pack = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7);
+		size_t i = 0;
+		for (; i + 11 <= pixels; i += 8) {
+			const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i * 4));
+			const __m256i packed = _mm256_permutevar8x32_epi32(_mm256_shuffle_epi8(v, mask), pack);
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i * 3), packed);
+		}
+		return i;
+	}
+	STARLET_TARGET("avx2")
+	size_t expand24To32Avx2(const uint8_t* src, uint8_t* dst, size_t pixels, const int8_t* maskBytes) {
+		const __m256i mask = broadcastMask(maskBytes);
+		const __m256i alpha = _mm256_set1_epi32(static_cast<int>(0xFF000000u));
+		size_t i = 0;
+		for (; i + 10 <= pixels; i += 8) {
+			const __m256i v = _mm256_shuffle_epi8(loadLanes(src + i * 3, src + i * 3 + 12), mask);
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i * 4), _mm256_or_si256(v, alpha));
+		}
+		return i;
+	}
+#endif
+
+	using Kernel = size_t(*)(const uint8_t*, uint8_t*, size_t, const int8_t*);
+
+	template<size_t SrcSize, size_t DstSize>
+	void run(const uint8_t* src, uint8_t* dst, size_t pixels, const int8_t* mask, SimdLevel level, Kernel ssse3, Kernel avx2) {
+		size_t done = 0;
+#ifdef STARLET_X86
+		switch (std::min(level, simdLevel())) {
+		case SimdLevel::Avx2:  done = avx2(src, dst, pixels, mask); break;
+		case SimdLevel::Ssse3: done = ssse3(src, dst, pixels, mask); break;
+		default: break;
+		}
+#else
+		(void)level; (void)ssse3; (void)avx2;
+#endif
+		shuffleScalar<SrcSize, DstSize>(src + done * SrcSize, dst + done * DstSize, pixels - done, mask);
+	}
+
+#ifdef STARLET_X86
+	#define STARLET_SWIZZLE_KERNELS(name) name##Ssse3, name##Avx2
+#else
+	#define STARLET_SWIZZLE_KERNELS(name) nullptr, nullptr
+#endif
+
+	bool isBgr(PixelFormat format) {
+		return format == PixelFormat::BGR8 || format == PixelFormat::BGRA8;
+	}
+
+	// Rec. 601 luma in 8.8 fixed point
+	void toLuma(const uint8_t* src, size_t srcSize, bool bgr, uint8_t* dst, size_t pixels) {
+		const uint32_t wr = bgr ? 29 : 77, wb = bgr ? 77 : 29;
+		for (size_t i = 0; i < pixels; ++i, src += srcSize)
+			dst[i] = static_cast<uint8_t>((wr * src[0] + 150u * src[1] + wb * src[2] + 128u) >> 8);
+	}
+	void fromLuma(const uint8_t* src, uint8_t* dst, size_t dstSize, size_t pixels) {
+		// Walk backwards so a grey row can expand in place
+		for (size_t i = pixels; i-- > 0;) {
+			uint8_t* d = dst + i * dstSize;
+			d[0] = d[1] = d[2] = src[i];
+			if (dstSize == 4) d[3] = 0xFF;
+		}
+	}
+}
+
+void swapRedBlue24(const uint8_t* src, uint8_t* dst, size_t pixels, SimdLevel level) {
+	run<3, 3>(src, dst, pixels, SWAP24_MASK, level, STARLET_SWIZZLE_KERNELS(shuffle24));
+}
+void swapRedBlue32(const uint8_t* src, uint8_t* dst, size_t pixels, SimdLevel level) {
+	run<4, 4>(src, dst, pixels, SWAP32_MASK, level, STARLET_SWIZZLE_KERNELS(shuffle32));
+}
+void bgraToRgb(const uint8_t* src, uint8_t* dst, size_t pixels, SimdLevel level) {
+	run<4, 3>(src, dst, pixels, PACK_SWAP_MASK, level, STARLET_SWIZZLE_KERNELS(pack32To24));
+}
+void rgbaToRgb(const uint8_t* src, uint8_t* dst, size_t pixels, SimdLevel level) {
+	run<4, 3>(src, dst, pixels, PACK_MASK, level, STARLET_SWIZZLE_KERNELS(pack32To24));
+}
+void bgrToRgba(const uint8_t* src, uint8_t* dst, size_t pixels, SimdLevel level) {
+	run<3, 4>(src, dst, pixels, EXPAND_SWAP_MASK, level, STARLET_SWIZZLE_KERNELS(expand24To32));
+}
+void rgbToRgba(const uint8_t* src, uint8_t* dst, size_t pixels, SimdLevel level) {
+	run<3, 4>(src, dst, pixels, EXPAND_MASK, level, STARLET_SWIZZLE_KERNELS(expand24To32));
+}
+
+#undef STARLET_SWIZZLE_KERNELS
+
+bool convertPixels(const uint8_t* src, PixelFormat srcFormat, uint8_t* dst, PixelFormat dstFormat, size_t pixels) {
+	const size_t srcSize = pixelFormatSize(srcFormat), dstSize = pixelFormatSize(dstFormat);
+	if (srcSize == 0 || dstSize == 0) return false;
+
+	if (srcFormat == dstFormat) {
+		if (src != dst) std::memmove(dst, src, pixels * srcSize);
+		return true;
+	}
+	if (srcSize == 1) {
+		fromLuma(src, dst, dstSize, pixels);
+		return true;
+	}
+	if (dstSize == 1) {
+		toLuma(src, srcSize, isBgr(srcFormat), dst, pixels);
+		return true;
+	}
+
+	const bool swap = isBgr(srcFormat) != isBgr(dstFormat);
+	if (srcSize == 3 && dstSize == 3)      swapRedBlue24(src, dst, pixels);
+	else if (srcSize == 4 && dstSize == 4) swapRedBlue32(src, dst, pixels);
+	else if (srcSize == 4)                 swap ? bgraToRgb(src, dst, pixels) : rgbaToRgb(src, dst, pixels);
+	else                                   swap ? bgrToRgba(src, dst, pixels) : rgbToRgba(src, dst, pixels);
+	return true;
+}
+
+}
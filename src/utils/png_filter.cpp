@@ -0,0 +1,188 @@
+#include "starlet-serializer/utils/png_filter.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+#ifdef STARLET_X86
+#include <immintrin.h>
+#endif
+
+namespace Starlet::Serializer::Utils {
+
+namespace {
+	// Scalar references; each starts at `start` so SIMD kernels can hand over their tail
+	void unfilterSub(uint8_t* row, size_t rowBytes, size_t bpp, size_t start) {
+		for (size_t i = std::max(start, bpp); i < rowBytes; ++i) row[i] = static_cast<uint8_t>(row[i] + row[i - bpp]);
+	}
+	void unfilterUp(uint8_t* row, const uint8_t* prev, size_t rowBytes, size_t start) {
+		for (size_t i = start; i < rowBytes; ++i) row[i] = static_cast<uint8_t>(row[i] + prev[i]);
+	}
+	void unfilterAverage(uint8_t* row, const uint8_t* prev, size_t rowBytes, size_t bpp) {
+		for (size_t i = 0; i < std::min(bpp, rowBytes); ++i) row[i] = static_cast<uint8_t>(row[i] + (prev[i] >> 1));
+		for (size_t i = bpp; i < rowBytes; ++i) row[i] = static_cast<uint8_t>(row[i] + ((row[i - bpp] + prev[i]) >> 1));
+	}
+	uint8_t paethPredictor(int a, int b, int c) {
+		const int pa = std::abs(b - c), pb = std::abs(a - c), pc = std::abs(a + b - 2 * c);
+		if (pa <= pb && pa <= pc) return static_cast<uint8_t>(a);
+		return static_cast<uint8_t>(pb <= pc ? b : c);
+	}
+	void unfilterPaeth(uint8_t* row, const uint8_t* prev, size_t rowBytes, size_t bpp) {
+		for (size_t i = 0; i < std::min(bpp, rowBytes); ++i) row[i] = static_cast<uint8_t>(row[i] + prev[i]);
+		for (size_t i = bpp; i < rowBytes; ++i) row[i] = static_cast<uint8_t>(row[i] + paethPredictor(row[i - bpp], prev[i], prev[i - bpp]));
+	}
+
+#ifdef STARLET_X86
+	// One pixel in the low lanes of a register; 3-byte pixels go through memcpy so the last pixel
+	// of a row never reads past it
+	template<size_t Bpp>
+	STARLET_TARGET("ssse3")
+	__m128i loadPixel(const uint8_t* p) {
+		uint32_t v = 0;
+		std::memcpy(&v, p, Bpp);
+		return _mm_cvtsi32_si128(static_cast<int>(v));
+	}
+	template<size_t Bpp>
+	STARLET_TARGET("ssse3")
+	void storePixel(uint8_t* p, __m128i v) {
+		const uint32_t bits = static_cast<uint32_t>(_mm_cvtsi128_si32(v));
+		std::memcpy(p, &bits, Bpp);
+	}
+
+	STARLET_TARGET("ssse3")
+	size_t unfilterUpSsse3(uint8_t* row, const uint8_t* prev, size_t rowBytes) {
+		size_t i = 0;
+		for (; i + 16 <= rowBytes; i += 16) {
+			const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i));
+			const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(prev + i));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(row + i), _mm_add_epi8(x, b));
+		}
+		return i;
+	}
+
+	// Sub is a running sum per channel: log-step prefix sums over a block of whole pixels, plus the
+	// last reconstructed pixel of the previous block broadcast across it
+	STARLET_TARGET("ssse3")
+	size_t unfilterSub4Ssse3(uint8_t* row, size_t rowBytes) {
+		__m128i carry = _mm_setzero_si128();
+		size_t i = 0;
+		for (; i + 16 <= rowBytes; i += 16) {
+			__m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i));
+			x = _mm_add_epi8(x, _mm_slli_si128(x, 4));
+			x = _mm_add_epi8(x, _mm_slli_si128(x, 8));
+			x = _mm_add_epi8(x, carry);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(row + i), x);
+			carry = _mm_shuffle_epi32(x, 0xFF);
+		}
+		return i;
+	}
+	// Five 3-byte pixels per block; byte 15 belongs to the next block and is written back unchanged
+	STARLET_TARGET("ssse3")
+	size_t unfilterSub3Ssse3(uint8_t* row, size_t rowBytes) {
+		const __m128i lastPixel = _mm_setr_epi8(12, 13, 14, 12, 13, 14, 12, 13, 14, 12, 13, 14, 12, 13, 14, -1);
+		const __m128i keepByte15 = _mm_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, -1);
+		__m128i carry = _mm_setzero_si128();
+		size_t i = 0;
+		for (; i + 16 <= rowBytes; i += 15) {
+			const __m128i original = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i));
+			__m128i x = _mm_add_epi8(original, _mm_slli_si128(original, 3));
+			x = _mm_add_epi8(x, _mm_slli_si128(x, 6));
+			x = _mm_add_epi8(x, _mm_slli_si128(x, 12));
+			x = _mm_add_epi8(x, carry);
+			carry = _mm_shuffle_epi8(x, lastPixel);
+			x = _mm_or_si128(_mm_andnot_si128(keepByte15, x), _mm_and_si128(keepByte15, original));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(row + i), x);
+		}
+		return i;
+	}
+
+	// Average and Paeth depend on the pixel just reconstructed, so these run a pixel at a time with
+	// every channel in one register; Paeth's three-way choice becomes compares and masks
+	template<size_t Bpp>
+	STARLET_TARGET("ssse3")
+	void unfilterAverageSsse3(uint8_t* row, const uint8_t* prev, size_t rowBytes) {
+		const __m128i lowBit = _mm_set1_epi8(1);
+		__m128i a = _mm_setzero_si128();
+		for (size_t i = 0; i + Bpp <= rowBytes; i += Bpp) {
+			const __m128i b = loadPixel<Bpp>(prev + i);
+			// avg_epu8 rounds up; the filter floors
+			const __m128i average = _mm_sub_epi8(_mm_avg_epu8(a, b), _mm_and_si128(_mm_xor_si128(a, b), lowBit));
+			a = _mm_add_epi8(loadPixel<Bpp>(row + i), average);
+			storePixel<Bpp>(row + i, a);
+		}
+	}
+
+	template<size_t Bpp>
+	STARLET_TARGET("ssse3")
+	void unfilterPaethSsse3(uint8_t* row, const uint8_t* prev, size_t rowBytes) {
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i lowByte = _mm_set1_epi16(0xFF);
+		__m128i a = zero, c = zero;
+		for (size_t i = 0; i + Bpp <= rowBytes; i += Bpp) {
+			const __m128i b = _mm_unpacklo_epi8(loadPixel<Bpp>(prev + i), zero);
+			const __m128i x = _mm_unpacklo_epi8(loadPixel<Bpp>(row + i), zero);
+
+			const __m128i pa = _mm_abs_epi16(_mm_sub_epi16(b, c));
+			const __m128i pb = _mm_abs_epi16(_mm_sub_epi16(a, c));
+			const __m128i pc = _mm_abs_epi16(_mm_sub_epi16(_mm_add_epi16(a, b), _mm_add_epi16(c, c)));
+			const __m128i smallest = _mm_min_epi16(pc, _mm_min_epi16(pa, pb));
+
+			const __m128i useA = _mm_cmpeq_epi16(smallest, pa);
+			const __m128i useB = _mm_andnot_si128(useA, _mm_cmpeq_epi16(smallest, pb));
+			const __m128i useC = _mm_andnot_si128(_mm_or_si128(useA, useB), _mm_cmpeq_epi16(zero, zero));
+			const __m128i predictor = _mm_or_si128(_mm_or_si128(_mm_and_si128(useA, a), _mm_and_si128(useB, b)), _mm_and_si128(useC, c));
+
+			a = _mm_and_si128(_mm_add_epi16(x, predictor), lowByte);
+			storePixel<Bpp>(row + i, _mm_packus_epi16(a, a));
+			c = b;
+		}
+	}
+
+	bool unfilterSsse3(PngFilter filter, uint8_t* row, const uint8_t* prev, size_t rowBytes, size_t bpp) {
+		if (filter == PngFilter::Up) {
+			unfilterUp(row, prev, rowBytes, unfilterUpSsse3(row, prev, rowBytes));
+			return true;
+		}
+		if (bpp != 3 && bpp != 4) return false;
+
+		switch (filter) {
+		case PngFilter::Sub:
+			unfilterSub(row, rowBytes, bpp, bpp == 4 ? unfilterSub4Ssse3(row, rowBytes) : unfilterSub3Ssse3(row, rowBytes));
+			return true;
+		case PngFilter::Average:
+			if (bpp == 4) unfilterAverageSsse3<4>(row, prev, rowBytes);
+			else          unfilterAverageSsse3<3>(row, prev, rowBytes);
+			return true;
+		case PngFilter::Paeth:
+			if (bpp == 4) unfilterPaethSsse3<4>(row, prev, rowBytes);
+			else          unfilterPaethSsse3<3>(row, prev, rowBytes);
+			return true;
+		default:
+			return false;
+		}
+	}
+#endif
+}
+
+bool unfilterRow(uint8_t filter, uint8_t* row, const uint8_t* prev, size_t rowBytes, size_t bpp, SimdLevel level) {
+	const PngFilter type = static_cast<PngFilter>(filter);
+	if (type == PngFilter::None) return true;
+	if (filter > static_cast<uint8_t>(PngFilter::Paeth)) return false;
+
+#ifdef STARLET_X86
+	if (std::min(level, simdLevel()) >= SimdLevel::Ssse3 && unfilterSsse3(type, row, prev, rowBytes, bpp))
+		return true;
+#else
+	(void)level;
+#endif
+
+	switch (type) {
+	case PngFilter::Sub:     unfilterSub(row, rowBytes, bpp, 0); break;
+	case PngFilter::Up:      unfilterUp(row, prev, rowBytes, 0); break;
+	case PngFilter::Average: unfilterAverage(row, prev, rowBytes, bpp); break;
+	default:                 unfilterPaeth(row, prev, rowBytes, bpp); break;
+	}
+	return true;
+}
+
+}
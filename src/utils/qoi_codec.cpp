@@ -0,0 +1,253 @@
+#include "starlet-serializer/utils/qoi_codec.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+
+namespace Starlet::Serializer::Utils {
+
+namespace {
+	constexpr uint8_t QOI_OP_INDEX = 0x00; // 00iiiiii
+	constexpr uint8_t QOI_OP_DIFF = 0x40;  // 01rrggbb, each a difference in -2..1
+	constexpr uint8_t QOI_OP_LUMA = 0x80;  // 10gggggg rrrrbbbb, green in -32..31, red/blue relative to it in -8..7
+	constexpr uint8_t QOI_OP_RUN = 0xC0;   // 11llllll, repeats the previous pixel 1..62 times
+	constexpr uint8_t QOI_OP_RGB = 0xFE;
+	constexpr uint8_t QOI_OP_RGBA = 0xFF;
+	constexpr uint32_t QOI_MAX_RUN = 62;
+
+	constexpr uint8_t QOI_END_MARKER[QOI_END_MARKER_SIZE] = { 0, 0, 0, 0, 0, 0, 0, 1 };
+
+	constexpr uint32_t pack(uint8_t r, uint8_t g, uint8_t b, uint8_t a) {
+		return static_cast<uint32_t>(r) | (static_cast<uint32_t>(g) << 8) | (static_cast<uint32_t>(b) << 16) | (static_cast<uint32_t>(a) << 24);
+	}
+
+	// QOI's (r*3 + g*5 + b*7 + a*11) % 64 on a packed pixel with one multiply: the channels are
+	// spread into 16-bit lanes so that the sum lands, carry-free, in bits 48..63 of the product
+	constexpr uint32_t hash(uint32_t pixel) {
+		const uint64_t v = pixel;
+		const uint64_t spread = ((v & 0xFF00FF00u) << 24) | (v & 0x00FF00FFu);
+		return static_cast<uint32_t>((spread * (11u | 5ull << 16 | 7ull << 32 | 3ull << 48)) >> 48) & 63u;
+	}
+
+	// Per-channel addition modulo 256 of two packed pixels
+	constexpr uint32_t addChannels(uint32_t a, uint32_t b) {
+		return ((a & 0x7F7F7F7Fu) + (b & 0x7F7F7F7Fu)) ^ ((a ^ b) & 0x80808080u);
+	}
+
+	constexpr uint32_t packDelta(int dr, int dg, int db) {
+		return pack(static_cast<uint8_t>(dr), static_cast<uint8_t>(dg), static_cast<uint8_t>(db), 0);
+	}
+
+	// Packed channel deltas for each DIFF op payload
+	constexpr auto DIFF_DELTAS = [] {
+		std::array<uint32_t, 64> deltas{};
+		for (int op = 0; op < 64; ++op) deltas[op] = packDelta(((op >> 4) & 3) - 2, ((op >> 2) & 3) - 2, (op & 3) - 2);
+		return deltas;
+	}();
+
+	void storePixel(uint8_t* dst, uint32_t pixel) {
+		if constexpr (std::endian::native == std::endian::little) std::memcpy(dst, &pixel, 4);
+		else {
+			dst[0] = static_cast<uint8_t>(pixel); dst[1] = static_cast<uint8_t>(pixel >> 8);
+			dst[2] = static_cast<uint8_t>(pixel >> 16); dst[3] = static_cast<uint8_t>(pixel >> 24);
+		}
+	}
+
+	// Three-channel pixels also take a 4-byte store while the next pixel's slot is still in range;
+	// its first byte is overwritten by that pixel
+	template <size_t Channels>
+	void storePixel(uint8_t* dst, const uint8_t* end, uint32_t pixel) {
+		if (Channels == 4 || end - dst >= 4) storePixel(dst, pixel);
+		else {
+			dst[0] = static_cast<uint8_t>(pixel); dst[1] = static_cast<uint8_t>(pixel >> 8); dst[2] = static_cast<uint8_t>(pixel >> 16);
+		}
+	}
+
+	void writeBe32(uint8_t* p, uint32_t value) {
+		p[0] = static_cast<uint8_t>(value >> 24);
+		p[1] = static_cast<uint8_t>(value >> 16);
+		p[2] = static_cast<uint8_t>(value >> 8);
+		p[3] = static_cast<uint8_t>(value);
+	}
+}
+
+QoiDecoder::QoiDecoder(const uint8_t* data, size_t size)
+	: p(data), limit(size >= QOI_END_MARKER_SIZE ? data + size - QOI_END_MARKER_SIZE : data) {}
+
+bool QoiDecoder::decode(uint8_t* dst, size_t pixels, uint8_t channels) {
+	return channels == 4 ? decodePixels<4>(dst, pixels) : decodePixels<3>(dst, pixels);
+}
+
+// All decoder state lives in locals for the loop: byte stores through dst may alias members, which
+// would otherwise be reloaded after every pixel. The pixel stays packed, so DIFF and LUMA ops are
+// one table lookup or a few shifts plus a lane-wise add. Every op stores the result at its hash slot,
+// as the reference decoder does: an index op can read an entry that is not at its own slot (an
+// unwritten slot holds the zero colour, which hashes to 0), and a leading run is the first sighting
+// of the implicit opening pixel.
+template <size_t Channels>
+bool QoiDecoder::decodePixels(uint8_t* dst, size_t pixels) {
+	uint8_t* const end = dst + pixels * Channels;
+	const uint8_t* src = p;
+	const uint8_t* const stop = limit;
+	uint32_t current = pixel;
+	uint32_t pending = run;
+	uint32_t table[64];
+	std::memcpy(table, index, sizeof(table));
+	bool complete = true;
+
+	while (dst < end) {
+		if (pending > 0) {
+			const size_t count = std::min<size_t>(pending, static_cast<size_t>(end - dst) / Channels);
+			for (size_t i = 0; i < count; ++i, dst += Channels) storePixel<Channels>(dst, end, current);
+			pending -= static_cast<uint32_t>(count);
+			continue;
+		}
+
+		if (src >= stop) {
+			complete = false;
+			break;
+		}
+
+		const uint8_t op = *src++;
+		if (static_cast<uint8_t>(op - QOI_OP_DIFF) < QOI_OP_RUN - QOI_OP_DIFF) {
+			// DIFF and LUMA share one path: both are a packed delta, picked without a branch since
+			// smooth images alternate between them unpredictably. The LUMA byte may be read
+			// speculatively; the end marker keeps that in bounds.
+			const bool luma = op >= QOI_OP_LUMA;
+			const int dg = (op & 0x3F) - 32;
+			const uint8_t next = *src;
+			const uint32_t lumaDelta = packDelta(dg - 8 + (next >> 4), dg, dg - 8 + (next & 0x0F));
+			current = addChannels(current, luma ? lumaDelta : DIFF_DELTAS[op & 0x3F]);
+			src += luma;
+			table[hash(current)] = current;
+		}
+		else if (op < QOI_OP_DIFF) {
+			current = table[op];
+			table[hash(current)] = current;
+		}
+		else if (op < QOI_OP_RGB) {
+			pending = (op & 0x3F) + 1u;
+			table[hash(current)] = current;
+			continue;
+		}
+		else {
+			if (op == QOI_OP_RGB) {
+				current = pack(src[0], src[1], src[2], static_cast<uint8_t>(current >> 24));
+				src += 3;
+			}
+			else {
+				current = pack(src[0], src[1], src[2], src[3]);
+				src += 4;
+			}
+			table[hash(current)] = current;
+		}
+
+		storePixel<Channels>(dst, end, current);
+		dst += Channels;
+	}
+
+	p = src;
+	pixel = current;
+	run = pending;
+	std::memcpy(index, table, sizeof(table));
+	return complete;
+}
+
+QoiEncoder::QoiEncoder(std::vector<uint8_t>& out, uint32_t width, uint32_t height, uint8_t channels, uint8_t colourspace)
+	: out(out), channels(channels) {
+	// Every pixel costs at most one tag byte plus its channels
+	const size_t start = out.size();
+	const size_t worstCase = QOI_HEADER_SIZE + static_cast<size_t>(width) * height * (channels + 1u) + QOI_END_MARKER_SIZE;
+	out.resize(start + worstCase);
+
+	uint8_t* header = out.data() + start;
+	header[0] = 'q'; header[1] = 'o'; header[2] = 'i'; header[3] = 'f';
+	writeBe32(header + 4, width);
+	writeBe32(header + 8, height);
+	header[12] = channels;
+	header[13] = colourspace;
+	cursor = header + QOI_HEADER_SIZE;
+}
+
+void QoiEncoder::encode(const uint8_t* src, size_t pixels) {
+	if (channels == 4) encodePixels<4>(src, pixels);
+	else encodePixels<3>(src, pixels);
+}
+
+// Op choice matches the reference encoder, so output is byte-identical to it
+template <size_t Channels>
+void QoiEncoder::encodePixels(const uint8_t* src, size_t pixels) {
+	uint8_t* o = cursor;
+	uint32_t previous = pixel;
+	uint8_t r = static_cast<uint8_t>(previous), g = static_cast<uint8_t>(previous >> 8), b = static_cast<uint8_t>(previous >> 16), a = static_cast<uint8_t>(previous >> 24);
+	uint32_t pending = run;
+	uint32_t table[64];
+	std::memcpy(table, index, sizeof(table));
+
+	for (const uint8_t* const end = src + pixels * Channels; src < end; src += Channels) {
+		const uint8_t nr = src[0], ng = src[1], nb = src[2];
+		uint8_t na = 255;
+		if constexpr (Channels == 4) na = src[3];
+		const uint32_t value = pack(nr, ng, nb, na);
+
+		if (value == previous) {
+			if (++pending == QOI_MAX_RUN) {
+				*o++ = static_cast<uint8_t>(QOI_OP_RUN | (pending - 1));
+				pending = 0;
+			}
+			continue;
+		}
+		if (pending > 0) {
+			*o++ = static_cast<uint8_t>(QOI_OP_RUN | (pending - 1));
+			pending = 0;
+		}
+
+		const uint32_t slot = hash(value);
+		if (table[slot] == value) {
+			*o++ = static_cast<uint8_t>(QOI_OP_INDEX | slot);
+		}
+		else {
+			table[slot] = value;
+			if (na == a) {
+				const int8_t vr = static_cast<int8_t>(nr - r), vg = static_cast<int8_t>(ng - g), vb = static_cast<int8_t>(nb - b);
+				const int8_t vgr = static_cast<int8_t>(vr - vg), vgb = static_cast<int8_t>(vb - vg);
+				if (vr > -3 && vr < 2 && vg > -3 && vg < 2 && vb > -3 && vb < 2) {
+					*o++ = static_cast<uint8_t>(QOI_OP_DIFF | (vr + 2) << 4 | (vg + 2) << 2 | (vb + 2));
+				}
+				else if (vgr > -9 && vgr < 8 && vg > -33 && vg < 32 && vgb > -9 && vgb < 8) {
+					*o++ = static_cast<uint8_t>(QOI_OP_LUMA | (vg + 32));
+					*o++ = static_cast<uint8_t>((vgr + 8) << 4 | (vgb + 8));
+				}
+				else {
+					o[0] = QOI_OP_RGB; o[1] = nr; o[2] = ng; o[3] = nb;
+					o += 4;
+				}
+			}
+			else {
+				o[0] = QOI_OP_RGBA; o[1] = nr; o[2] = ng; o[3] = nb; o[4] = na;
+				o += 5;
+			}
+		}
+
+		r = nr; g = ng; b = nb; a = na;
+		previous = value;
+	}
+
+	cursor = o;
+	pixel = previous;
+	run = pending;
+	std::memcpy(index, table, sizeof(table));
+}
+
+void QoiEncoder::finish() {
+	if (run > 0) {
+		*cursor++ = static_cast<uint8_t>(QOI_OP_RUN | (run - 1));
+		run = 0;
+	}
+	std::copy(QOI_END_MARKER, QOI_END_MARKER + QOI_END_MARKER_SIZE, cursor);
+	cursor += QOI_END_MARKER_SIZE;
+	out.resize(static_cast<size_t>(cursor - out.data()));
+}
+
+}
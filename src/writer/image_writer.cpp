@@ -0,0 +1,270 @@
+#include "starlet-serializer/writer/writer.hpp"
+#include "starlet-logger/logger.hpp"
+
+#include "starlet-serializer/utils/pixel_swizzle.hpp"
+#include "starlet-serializer/utils/qoi_codec.hpp"
+
+#include <cctype>
+#include <cstdint>
+#include <cstring>
+
+namespace Starlet::Serializer {
+
+namespace {
+	constexpr size_t BMP_FILE_HEADER_SIZE = 14;
+	constexpr size_t BMP_INFO_HEADER_SIZE = 40;
+	constexpr size_t BMP_V4_HEADER_SIZE = 108; // Carries the alpha mask other readers honour
+	constexpr size_t BMP_GREY_PALETTE_SIZE = 256 * 4;
+	constexpr uint32_t BMP_COMPRESSION_BITFIELDS = 3;
+	constexpr uint32_t BMP_COLOURSPACE_SRGB = 0x73524742; // 'sRGB'
+	constexpr uint32_t BMP_PIXELS_PER_METRE = 2835;     // 72 DPI
+
+	constexpr size_t TGA_HEADER_SIZE = 18;
+	constexpr uint8_t TGA_IMAGE_TYPE_TRUE_COLOUR = 2;
+	constexpr uint8_t TGA_IMAGE_TYPE_GREYSCALE = 3;
+	constexpr uint8_t TGA_IMAGE_TYPE_RLE_OFFSET = 8;
+	constexpr uint8_t TGA_ORIGIN_TOP_BIT = 0x20;
+	constexpr uint32_t TGA_MAX_DIMENSION = 65535;
+	constexpr uint32_t TGA_MAX_PACKET = 128;
+
+	void putLe16(unsigned char* p, uint32_t value) {
+		p[0] = static_cast<unsigned char>(value);
+		p[1] = static_cast<unsigned char>(value >> 8);
+	}
+	void putLe32(unsigned char* p, uint32_t value) {
+		putLe16(p, value);
+		putLe16(p + 2, value >> 16);
+	}
+
+	bool hasAlpha(PixelFormat format) {
+		return format == PixelFormat::RGBA8 || format == PixelFormat::BGRA8;
+	}
+
+	// BMP and TGA both store grey as single bytes and colour as BGR(A)
+	PixelFormat storedFormat(PixelFormat format) {
+		if (format == PixelFormat::R8) return PixelFormat::R8;
+		return hasAlpha(format) ? PixelFormat::BGRA8 : PixelFormat::BGR8;
+	}
+
+	ImageFormat formatFromExtension(const std::string& path) {
+		const size_t dotPos = path.find_last_of('.');
+		if (dotPos == std::string::npos) return ImageFormat::UNKNOWN;
+
+		std::string extension = path.substr(dotPos + 1);
+		for (char& c : extension) c = static_cast<char>(tolower(c));
+
+		if      (extension == "bmp") return ImageFormat::BMP;
+		else if (extension == "tga") return ImageFormat::TGA;
+		else if (extension == "qoi") return ImageFormat::QOI;
+		else                         return ImageFormat::UNKNOWN;
+	}
+
+	// Row y counted from the top of the image, whichever way the buffer is stored
+	const unsigned char* topDownRow(const ImageData& data, uint32_t y) {
+		const size_t rowSize = static_cast<size_t>(data.width) * pixelFormatSize(data.format);
+		const uint32_t height = static_cast<uint32_t>(data.height);
+		return data.pixels.data() + rowSize * (data.bottomUp ? height - 1 - y : y);
+	}
+
+	// Packets never cross rows. A repeat of 2 pixels already pays for its packet header once pixels
+	// are 3+ bytes; single-byte grey needs 3 to break even.
+	template <size_t PixelSize>
+	unsigned char* encodeRleRow(const unsigned char* row, uint32_t width, unsigned char* out) {
+		constexpr uint32_t MIN_RUN = PixelSize == 1 ? 3 : 2;
+		auto same = [row](uint32_t a, uint32_t b) { return std::memcmp(row + a * PixelSize, row + b * PixelSize, PixelSize) == 0; };
+		auto runLength = [&](uint32_t start) {
+			uint32_t length = 1;
+			while (start + length < width && length < TGA_MAX_PACKET && same(start, start + length)) ++length;
+			return length;
+		};
+
+		for (uint32_t x = 0; x < width;) {
+			const uint32_t run = runLength(x);
+			if (run >= MIN_RUN) {
+				*out++ = static_cast<unsigned char>(0x80 | (run - 1));
+				std::memcpy(out, row + x * PixelSize, PixelSize);
+				out += PixelSize;
+				x += run;
+				continue;
+			}
+
+			// Literal pixels up to the next run worth its own packet
+			const uint32_t start = x;
+			x += run;
+			while (x < width && x - start < TGA_MAX_PACKET) {
+				if (x + 1 < width && same(x, x + 1) && runLength(x) >= MIN_RUN) break;
+				++x;
+			}
+			const uint32_t count = x - start;
+			*out++ = static_cast<unsigned char>(count - 1);
+			std::memcpy(out, row + start * PixelSize, static_cast<size_t>(count) * PixelSize);
+			out += static_cast<size_t>(count) * PixelSize;
+		}
+		return out;
+	}
+}
+
+bool Writer::writeImage(const ImageData& data, const std::string& path, const ImageWriteOptions& options) {
+	ImageWriteOptions resolved = options;
+	if (resolved.format == ImageFormat::UNKNOWN) {
+		resolved.format = formatFromExtension(path);
+		if (resolved.format == ImageFormat::UNKNOWN)
+			return Logger::error("Writer", "writeImage", "Unsupported image format: " + path);
+	}
+
+	std::vector<unsigned char> buffer;
+	if (!encodeImage(data, buffer, resolved)) return false;
+	return writeBinaryFile(buffer, path);
+}
+
+bool Writer::encodeImage(const ImageData& data, std::vector<unsigned char>& out, const ImageWriteOptions& options) {
+	if (!validateImage(data)) return false;
+
+	out.clear();
+	switch (options.format) {
+	case ImageFormat::BMP: return encodeBmp(data, out);
+	case ImageFormat::TGA: return encodeTga(data, out, options.rle);
+	case ImageFormat::QOI: encodeQoi(data, out); return true;
+	default:
+		return Logger::error("Writer", "encodeImage", "Unsupported image output format");
+	}
+}
+
+bool Writer::validateImage(const ImageData& data) {
+	if (data.width <= 0 || data.height <= 0)
+		return Logger::error("Writer", "validateImage", "Invalid image dimensions: " + std::to_string(data.width) + "x" + std::to_string(data.height));
+	if (pixelFormatSize(data.format) == 0)
+		return Logger::error("Writer", "validateImage", "Unknown pixel format");
+
+	const size_t needed = static_cast<size_t>(data.width) * data.height * pixelFormatSize(data.format);
+	if (data.pixels.size() < needed)
+		return Logger::error("Writer", "validateImage", "Pixel buffer too small: " + std::to_string(data.pixels.size()) + " bytes, need " + std::to_string(needed) + " bytes");
+	return true;
+}
+
+// Bottom-up rows padded to 4 bytes; alpha goes in a V4 header with explicit BGRA masks, grey in an
+// 8-bit image with an identity palette
+bool Writer::encodeBmp(const ImageData& data, std::vector<unsigned char>& out) {
+	const uint32_t width = static_cast<uint32_t>(data.width), height = static_cast<uint32_t>(data.height);
+	const PixelFormat stored = storedFormat(data.format);
+	const uint32_t bpp = pixelFormatSize(stored) * 8u;
+	const size_t dibSize = bpp == 32 ? BMP_V4_HEADER_SIZE : BMP_INFO_HEADER_SIZE;
+	const size_t paletteSize = bpp == 8 ? BMP_GREY_PALETTE_SIZE : 0;
+	const size_t dataOffset = BMP_FILE_HEADER_SIZE + dibSize + paletteSize;
+	const size_t stride = ((static_cast<size_t>(width) * bpp + 31) / 32) * 4;
+	const size_t imageSize = stride * height;
+	if (dataOffset + imageSize > UINT32_MAX)
+		return Logger::error("Writer", "encodeBmp", "Image too large for BMP: " + std::to_string(width) + "x" + std::to_string(height));
+
+	out.resize(dataOffset + imageSize);
+	unsigned char* p = out.data();
+	p[0] = 'B'; p[1] = 'M';
+	putLe32(p + 2, static_cast<uint32_t>(out.size()));
+	putLe32(p + 10, static_cast<uint32_t>(dataOffset));
+
+	unsigned char* dib = p + BMP_FILE_HEADER_SIZE;
+	putLe32(dib, static_cast<uint32_t>(dibSize));
+	putLe32(dib + 4, width);
+	putLe32(dib + 8, height);
+	putLe16(dib + 12, 1);
+	putLe16(dib + 14, bpp);
+	putLe32(dib + 20, static_cast<uint32_t>(imageSize));
+	putLe32(dib + 24, BMP_PIXELS_PER_METRE);
+	putLe32(dib + 28, BMP_PIXELS_PER_METRE);
+	if (bpp == 32) {
+		putLe32(dib + 16, BMP_COMPRESSION_BITFIELDS);
+		putLe32(dib + 40, 0x00FF0000);
+		putLe32(dib + 44, 0x0000FF00);
+		putLe32(dib + 48, 0x000000FF);
+		putLe32(dib + 52, 0xFF000000);
+		putLe32(dib + 56, BMP_COLOURSPACE_SRGB);
+	}
+	else if (bpp == 8) {
+		putLe32(dib + 32, 256);
+		unsigned char* palette = dib + dibSize;
+		for (uint32_t i = 0; i < 256; ++i) putLe32(palette + i * 4, i * 0x010101u);
+	}
+
+	// Unpadded bottom-up buffers already have the file's row order and convert in one pass
+	unsigned char* pixels = p + dataOffset;
+	if (data.bottomUp && stride == static_cast<size_t>(width) * pixelFormatSize(stored)) {
+		Utils::convertPixels(data.pixels.data(), data.format, pixels, stored, static_cast<size_t>(width) * height);
+		return true;
+	}
+	for (uint32_t y = 0; y < height; ++y)
+		Utils::convertPixels(topDownRow(data, height - 1 - y), data.format, pixels + stride * y, stored, width);
+	return true;
+}
+
+// Rows keep the buffer's order, with the origin bit telling readers which way it runs
+bool Writer::encodeTga(const ImageData& data, std::vector<unsigned char>& out, bool rle) {
+	const uint32_t width = static_cast<uint32_t>(data.width), height = static_cast<uint32_t>(data.height);
+	if (width > TGA_MAX_DIMENSION || height > TGA_MAX_DIMENSION)
+		return Logger::error("Writer", "encodeTga", "Image too large for TGA: " + std::to_string(width) + "x" + std::to_string(height));
+
+	const PixelFormat stored = storedFormat(data.format);
+	const size_t pixelSize = pixelFormatSize(stored);
+	const size_t srcRowSize = static_cast<size_t>(width) * pixelFormatSize(data.format);
+	const size_t rowSize = static_cast<size_t>(width) * pixelSize;
+
+	// Raw rows are converted in place; RLE rows go through a scratch row, at worst one extra byte
+	// per packet
+	const size_t maxPackets = (width + TGA_MAX_PACKET - 1) / TGA_MAX_PACKET;
+	out.resize(TGA_HEADER_SIZE + (rle ? rowSize + maxPackets : rowSize) * height);
+
+	unsigned char* p = out.data();
+	const uint8_t imageType = stored == PixelFormat::R8 ? TGA_IMAGE_TYPE_GREYSCALE : TGA_IMAGE_TYPE_TRUE_COLOUR;
+	p[2] = static_cast<unsigned char>(rle ? imageType + TGA_IMAGE_TYPE_RLE_OFFSET : imageType);
+	putLe16(p + 12, width);
+	putLe16(p + 14, height);
+	p[16] = static_cast<unsigned char>(pixelSize * 8);
+	p[17] = static_cast<unsigned char>((pixelSize == 4 ? 8 : 0) | (data.bottomUp ? 0 : TGA_ORIGIN_TOP_BIT));
+
+	unsigned char* cursor = p + TGA_HEADER_SIZE;
+	if (!rle) {
+		Utils::convertPixels(data.pixels.data(), data.format, cursor, stored, static_cast<size_t>(width) * height);
+		return true;
+	}
+
+	std::vector<unsigned char> row(rowSize);
+	for (uint32_t y = 0; y < height; ++y) {
+		const unsigned char* src = data.pixels.data() + srcRowSize * y;
+		if (stored != data.format) {
+			Utils::convertPixels(src, data.format, row.data(), stored, width);
+			src = row.data();
+		}
+		switch (pixelSize) {
+		case 1:  cursor = encodeRleRow<1>(src, width, cursor); break;
+		case 3:  cursor = encodeRleRow<3>(src, width, cursor); break;
+		default: cursor = encodeRleRow<4>(src, width, cursor); break;
+		}
+	}
+	out.resize(static_cast<size_t>(cursor - out.data()));
+	return true;
+}
+
+// QOI is top-down RGB(A); matching buffers feed the encoder as a whole
+void Writer::encodeQoi(const ImageData& data, std::vector<unsigned char>& out) {
+	const uint32_t width = static_cast<uint32_t>(data.width), height = static_cast<uint32_t>(data.height);
+	const uint8_t channels = hasAlpha(data.format) ? 4 : 3;
+	const PixelFormat stored = channels == 4 ? PixelFormat::RGBA8 : PixelFormat::RGB8;
+
+	Utils::QoiEncoder encoder(out, width, height, channels);
+	if (data.format == stored && !data.bottomUp) {
+		encoder.encode(data.pixels.data(), static_cast<size_t>(width) * height);
+	}
+	else {
+		std::vector<unsigned char> row(static_cast<size_t>(width) * channels);
+		for (uint32_t y = 0; y < height; ++y) {
+			const unsigned char* src = topDownRow(data, y);
+			if (data.format != stored) {
+				Utils::convertPixels(src, data.format, row.data(), stored, width);
+				src = row.data();
+			}
+			encoder.encode(src, width);
+		}
+	}
+	encoder.finish();
+}
+
+}
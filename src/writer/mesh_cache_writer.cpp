@@ -0,0 +1,191 @@
+#include "starlet-serializer/writer/writer.hpp"
+#include "starlet-logger/logger.hpp"
+
+#include "starlet-serializer/data/mesh_cache_data.hpp"
+#include "starlet-serializer/processor/mesh/bvh_builder.hpp"
+#include "starlet-serializer/processor/mesh/collision_builder.hpp"
+#include "starlet-serializer/processor/mesh/mesh_codec.hpp"
+#include "starlet-serializer/processor/mesh/meshlet_builder.hpp"
+#include "starlet-serializer/utils/binary_io.hpp"
+
+#include <cstdio>
+
+namespace Starlet::Serializer {
+
+namespace {
+	size_t beginChunk(Utils::ByteWriter& out, const char (&id)[5]) {
+		out.tag(id);
+		const size_t sizeOffset = out.size();
+		out.u64(0);
+		return sizeOffset;
+	}
+	void endChunk(Utils::ByteWriter& out, size_t sizeOffset) {
+		out.patchU64(sizeOffset, out.size() - sizeOffset - sizeof(uint64_t));
+	}
+}
+
+bool Writer::writeMeshCache(const MeshCacheData& data, const std::string& path) {
+	if (data.mesh.vertices.size() != data.mesh.numVertices || data.mesh.indices.size() != data.mesh.numIndices)
+		return Logger::error("Writer", "writeMeshCache", "Mesh counts do not match its buffers");
+
+	// Room for an uncompressed mesh chunk, so the buffer rarely regrows while writing
+	std::vector<unsigned char> buffer;
+	buffer.reserve(64 + data.mesh.vertices.size() * 12 * sizeof(float) + data.mesh.indices.size() * sizeof(uint32_t));
+	Utils::ByteWriter out(buffer);
+	out.tag(MeshCacheFormat::MAGIC);
+	out.u32(MeshCacheFormat::VERSION);
+
+	if (!data.compressed) {
+		writeMeshChunk(out, data.mesh);
+		if (data.hasMeshlets) writeMeshletChunk(out, data.meshlets);
+		if (data.hasBvh) writeBvhChunk(out, data.bvh);
+		if (data.hasCollision) writeCollisionChunk(out, data.collision);
+		return writeBinaryFile(buffer, path);
+	}
+
+	MeshCodec codec;
+	std::vector<unsigned char> vertices;
+	codec.encodeVertices(data.mesh, vertices);
+	writeCompressedMeshChunk(out, vertices, data.mesh.indices);
+	if (!data.hasMeshlets && !data.hasBvh && !data.hasCollision) return writeBinaryFile(buffer, path);
+
+	// Derived chunks must describe the positions a reader decodes, not the ones given, or triangles
+	// can poke out of their bounds by up to half a quantization step
+	MeshData decoded;
+	if (!codec.decodeVertices(vertices.data(), vertices.size(), decoded)) return false;
+	decoded.indices = data.mesh.indices;
+	decoded.numIndices = data.mesh.numIndices;
+
+	if (data.hasMeshlets) {
+		MeshletData meshlets = data.meshlets;
+		if (!MeshletBuilder().refit(decoded, meshlets)) return false;
+		writeMeshletChunk(out, meshlets);
+	}
+	if (data.hasBvh) {
+		BvhData bvh = data.bvh;
+		if (!BvhBuilder().refit(decoded, bvh)) return false;
+		writeBvhChunk(out, bvh);
+	}
+	if (data.hasCollision) {
+		// The caller's proxies may come from another mesh (e.g. a simplified one), so they are kept and
+		// grown to cover the quantization error rather than rebuilt
+		CollisionData collision = data.collision;
+		CollisionBuilder().inflate(collision, codec.positionError(data.mesh));
+		writeCollisionChunk(out, collision);
+	}
+
+	return writeBinaryFile(buffer, path);
+}
+
+void Writer::writeMeshChunk(Utils::ByteWriter& out, const MeshData& mesh) {
+	const bool writeTangents = mesh.hasTangents && mesh.tangents.size() == mesh.vertices.size();
+	uint32_t flags = 0;
+	if (mesh.hasNormals)   flags |= MeshCacheFormat::MESH_HAS_NORMALS;
+	if (mesh.hasColours)   flags |= MeshCacheFormat::MESH_HAS_COLOURS;
+	if (mesh.hasTexCoords) flags |= MeshCacheFormat::MESH_HAS_TEXCOORDS;
+	if (writeTangents)     flags |= MeshCacheFormat::MESH_HAS_TANGENTS;
+
+	const size_t chunk = beginChunk(out, MeshCacheFormat::MESH_CHUNK);
+	out.u32(static_cast<uint32_t>(mesh.vertices.size()));
+	out.u32(static_cast<uint32_t>(mesh.indices.size()));
+	out.u32(flags);
+	out.f32(mesh.minY);
+	out.f32(mesh.maxY);
+
+	for (const Math::Vertex& v : mesh.vertices) {
+		out.f32(v.pos.x);  out.f32(v.pos.y);  out.f32(v.pos.z);
+		out.f32(v.norm.x); out.f32(v.norm.y); out.f32(v.norm.z);
+		out.f32(v.col.x);  out.f32(v.col.y);  out.f32(v.col.z); out.f32(v.col.w);
+		out.f32(v.texCoord.x); out.f32(v.texCoord.y);
+	}
+	for (unsigned int i : mesh.indices) out.u32(i);
+	if (writeTangents) {
+		for (const Math::Vec4<float>& t : mesh.tangents) {
+			out.f32(t.x); out.f32(t.y); out.f32(t.z); out.f32(t.w);
+		}
+	}
+	endChunk(out, chunk);
+}
+
+void Writer::writeCompressedMeshChunk(Utils::ByteWriter& out, const std::vector<unsigned char>& vertices, const std::vector<unsigned int>& meshIndices) {
+	std::vector<unsigned char> indices;
+	MeshCodec().encodeIndices(meshIndices, indices);
+
+	const size_t chunk = beginChunk(out, MeshCacheFormat::COMPRESSED_MESH_CHUNK);
+	out.u64(vertices.size());
+	out.bytes(vertices.data(), vertices.size());
+	out.bytes(indices.data(), indices.size());
+	endChunk(out, chunk);
+}
+
+void Writer::writeMeshletChunk(Utils::ByteWriter& out, const MeshletData& meshlets) {
+	const size_t chunk = beginChunk(out, MeshCacheFormat::MESHLET_CHUNK);
+	out.u32(static_cast<uint32_t>(meshlets.meshlets.size()));
+	out.u32(static_cast<uint32_t>(meshlets.vertices.size()));
+	out.u32(static_cast<uint32_t>(meshlets.triangles.size() / 3));
+	out.u32(meshlets.maxVertices);
+	out.u32(meshlets.maxTriangles);
+
+	for (const Meshlet& m : meshlets.meshlets) {
+		out.u32(m.vertexOffset);   out.u32(m.vertexCount);
+		out.u32(m.triangleOffset); out.u32(m.triangleCount);
+		out.f32(m.center.x);   out.f32(m.center.y);   out.f32(m.center.z); out.f32(m.radius);
+		out.f32(m.coneApex.x); out.f32(m.coneApex.y); out.f32(m.coneApex.z);
+		out.f32(m.coneAxis.x); out.f32(m.coneAxis.y); out.f32(m.coneAxis.z); out.f32(m.coneCutoff);
+	}
+	for (unsigned int v : meshlets.vertices) out.u32(v);
+	out.bytes(meshlets.triangles.data(), (meshlets.triangles.size() / 3) * 3);
+	endChunk(out, chunk);
+}
+
+void Writer::writeBvhChunk(Utils::ByteWriter& out, const BvhData& bvh) {
+	const size_t chunk = beginChunk(out, MeshCacheFormat::BVH_CHUNK);
+	out.u32(static_cast<uint32_t>(bvh.nodes.size()));
+	out.u32(static_cast<uint32_t>(bvh.triangles.size()));
+
+	for (const BvhNode& node : bvh.nodes) {
+		out.f32(node.boundsMin[0]); out.f32(node.boundsMin[1]); out.f32(node.boundsMin[2]);
+		out.u32(node.leftFirst);
+		out.f32(node.boundsMax[0]); out.f32(node.boundsMax[1]); out.f32(node.boundsMax[2]);
+		out.u32(node.count);
+	}
+	for (unsigned int t : bvh.triangles) out.u32(t);
+	endChunk(out, chunk);
+}
+
+void Writer::writeCollisionChunk(Utils::ByteWriter& out, const CollisionData& collision) {
+	const size_t chunk = beginChunk(out, MeshCacheFormat::COLLISION_CHUNK);
+	out.u32(static_cast<uint32_t>(collision.hull.vertices.size()));
+	out.u32(static_cast<uint32_t>(collision.hull.indices.size()));
+
+	for (size_t a = 0; a < KDopData::AXIS_COUNT; ++a) {
+		out.f32(collision.kdop.min[a]);
+		out.f32(collision.kdop.max[a]);
+	}
+
+	const ObbData& obb = collision.obb;
+	out.f32(obb.center.x); out.f32(obb.center.y); out.f32(obb.center.z);
+	for (const Math::Vec3<float>& axis : obb.axes) {
+		out.f32(axis.x); out.f32(axis.y); out.f32(axis.z);
+	}
+	out.f32(obb.halfExtents.x); out.f32(obb.halfExtents.y); out.f32(obb.halfExtents.z);
+
+	for (const Math::Vec3<float>& v : collision.hull.vertices) {
+		out.f32(v.x); out.f32(v.y); out.f32(v.z);
+	}
+	for (unsigned int i : collision.hull.indices) out.u32(i);
+	endChunk(out, chunk);
+}
+
+bool Writer::writeBinaryFile(const std::vector<unsigned char>& data, const std::string& path) {
+	FILE* file = fopen(path.c_str(), "wb");
+	if (!file) return Logger::error("Writer", "writeBinaryFile", "Failed to open file for saving: " + path);
+
+	const size_t written = fwrite(data.data(), 1, data.size(), file);
+	const bool closed = fclose(file) == 0;
+	if (written != data.size() || !closed)
+		return Logger::error("Writer", "writeBinaryFile", "Failed to write " + std::to_string(data.size()) + " bytes to " + path);
+	return true;
+}
+
+}
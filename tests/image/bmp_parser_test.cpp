@@ -265,11 +265,11 @@ TEST_F(BmpParserTest, InvalidColourPlanes) {
 }
 
 TEST_F(BmpParserTest, UnsupportedBitsPerPixel) {
-  std::string bmp = BmpBuilder(2, 2).setBpp(32).build();
+  std::string bmp = BmpBuilder(2, 2).setBpp(12).build();
   createTestFile("test_data/bad_bpp.bmp", bmp);
   testing::internal::CaptureStderr();
   expectInvalidParse("test_data/bad_bpp.bmp");
-  expectStderrContains({ "Only 24bpp supported: 32" });
+  expectStderrContains({ "Unsupported BMP bits per pixel: 12" });
 }
 
 TEST_F(BmpParserTest, CompressedBMP) {
@@ -277,7 +277,7 @@ TEST_F(BmpParserTest, CompressedBMP) {
   createTestFile("test_data/compressed.bmp", bmp);
   testing::internal::CaptureStderr();
   expectInvalidParse("test_data/compressed.bmp");
-  expectStderrContains({ "Compressed BMP not supported: 1" });
+  expectStderrContains({ "Unsupported BMP compression 1 for 24bpp" });
 }
 
 TEST_F(BmpParserTest, InsufficientPixelData) {
@@ -320,4 +320,300 @@ TEST_F(BmpParserTest, DataOffsetEqualsFileSize) {
   testing::internal::CaptureStderr();
   expectInvalidParse("test_data/offset_at_end.bmp");
   expectStderrContains({ "Invalid data offset: 54" });
-}
\ No newline at end of file
+}
+
+TEST_F(BmpParserTest, RgbaOutputAddsOpaqueAlpha) {
+  std::string bmp = BmpBuilder(3, 1).setPixel(0, 0, 10, 20, 30).setPixel(2, 0, 40, 50, 60).build();
+  createTestFile("test_data/rgba_out.bmp", bmp);
+
+  SSerializer::ImageParseOptions options;
+  options.format = SSerializer::PixelFormat::RGBA8;
+  ASSERT_TRUE(parser.parse("test_data/rgba_out.bmp", out, options));
+  EXPECT_EQ(out.pixelSize, 4);
+  EXPECT_EQ(out.byteSize, 12u);
+  EXPECT_EQ(out.pixels, (std::vector<uint8_t>{ 10, 20, 30, 255, 0, 0, 0, 255, 40, 50, 60, 255 }));
+}
+
+TEST_F(BmpParserTest, R8OutputTakesLuma) {
+  std::string bmp = BmpBuilder(2, 1).setPixel(0, 0, 255, 255, 255).setPixel(1, 0, 255, 0, 0).build();
+  createTestFile("test_data/r8_out.bmp", bmp);
+
+  SSerializer::ImageParseOptions options;
+  options.format = SSerializer::PixelFormat::R8;
+  ASSERT_TRUE(parser.parse("test_data/r8_out.bmp", out, options));
+  EXPECT_EQ(out.format, SSerializer::PixelFormat::R8);
+  EXPECT_EQ(out.pixels, (std::vector<uint8_t>{ 255, 77 }));
+}
+
+TEST_F(BmpParserTest, NativeLayoutKeepsBgrAndBottomUpRows) {
+  // Width 4 leaves no row padding
+  std::string bmp = BmpBuilder(4, 2).setPixel(0, 0, 10, 20, 30).setPixel(3, 1, 40, 50, 60).build();
+  createTestFile("test_data/native.bmp", bmp);
+
+  SSerializer::ImageParseOptions options;
+  options.nativeLayout = true;
+  ASSERT_TRUE(parser.parse("test_data/native.bmp", out, options));
+  EXPECT_EQ(out.format, SSerializer::PixelFormat::BGR8);
+  EXPECT_TRUE(out.bottomUp);
+  EXPECT_EQ(out.byteSize, 24u);
+  EXPECT_EQ(std::string(out.pixels.begin(), out.pixels.end()), bmp.substr(54, 24));
+}
+
+TEST_F(BmpParserTest, NativeLayoutStripsRowPadding) {
+  std::string bmp = BmpBuilder(1, 2).setPixel(0, 0, 10, 20, 30).setPixel(0, 1, 40, 50, 60).setTopDown().build();
+  createTestFile("test_data/native_padded.bmp", bmp);
+
+  SSerializer::ImageParseOptions options;
+  options.nativeLayout = true;
+  ASSERT_TRUE(parser.parse("test_data/native_padded.bmp", out, options));
+  EXPECT_FALSE(out.bottomUp);
+  EXPECT_EQ(out.pixels, (std::vector<uint8_t>{ 30, 20, 10, 60, 50, 40 }));
+}
+
+TEST_F(BmpParserTest, DefaultLayoutIsTopDown) {
+  std::string bmp = BmpBuilder(1, 2).setPixel(0, 0, 10, 20, 30).build();
+  createTestFile("test_data/default_layout.bmp", bmp);
+  ASSERT_TRUE(parser.parse("test_data/default_layout.bmp", out));
+  EXPECT_FALSE(out.bottomUp);
+  EXPECT_EQ(out.pixels[3], 10);
+}
+
+TEST_F(BmpParserTest, ProbeReadsHeaderOnly) {
+  std::string bmp = BmpBuilder(5, -3).build();
+  createTestFile("test_data/probe.bmp", bmp);
+
+  SSerializer::ImageInfo info;
+  ASSERT_TRUE(parser.probe("test_data/probe.bmp", info));
+  EXPECT_EQ(info.width, 5u);
+  EXPECT_EQ(info.height, 3u);
+  EXPECT_EQ(info.sourceFormat, SSerializer::PixelFormat::BGR8);
+  EXPECT_FALSE(info.sourceBottomUp);
+  EXPECT_EQ(info.format, SSerializer::PixelFormat::RGB8);
+  EXPECT_EQ(info.rowSize, 15u);
+  EXPECT_EQ(info.byteSize, 45u);
+}
+
+TEST_F(BmpParserTest, DecodeMatchesParse) {
+  BmpBuilder builder(3, 3);
+  for (uint32_t y = 0; y < 3; ++y)
+    for (uint32_t x = 0; x < 3; ++x)
+      builder.setPixel(x, y, static_cast<uint8_t>(x * 10), static_cast<uint8_t>(y * 10), static_cast<uint8_t>(x + y));
+  createTestFile("test_data/decode.bmp", builder.build());
+
+  ASSERT_TRUE(parser.parse("test_data/decode.bmp", out));
+  std::vector<uint8_t> staging(out.byteSize);
+  ASSERT_TRUE(parser.decode("test_data/decode.bmp", staging.data(), staging.size(), 9));
+  EXPECT_EQ(staging, out.pixels);
+}
+
+TEST_F(BmpParserTest, SignatureOverridesExtension) {
+  createTestFile("test_data/really_bmp.tga", BmpBuilder(2, 2).setPixel(0, 0, 10, 20, 30).build());
+  expectValidParse("test_data/really_bmp.tga", 2, 2);
+
+  SSerializer::ImageInfo info;
+  ASSERT_TRUE(parser.probe("test_data/really_bmp.tga", info));
+  EXPECT_EQ(info.fileFormat, SSerializer::ImageFormat::BMP);
+}
+
+namespace {
+  void putU32(std::string& data, size_t offset, uint32_t val) { *reinterpret_cast<uint32_t*>(&data[offset]) = val; }
+
+  // Raw BMP: file header, `dibSize`-byte DIB header, then `extra` (masks or palette) and the pixel bytes
+  std::string makeBmp(uint16_t bpp, uint32_t width, int32_t height, uint32_t compression, const std::string& extra,
+                      const std::string& pixels, uint32_t dibSize = 40, uint32_t coloursUsed = 0) {
+    std::string data(14 + dibSize, '\0');
+    data[0] = 'B'; data[1] = 'M';
+    putU32(data, 2, static_cast<uint32_t>(data.size() + extra.size() + pixels.size()));
+    putU32(data, 10, static_cast<uint32_t>(data.size() + extra.size()));
+    putU32(data, 14, dibSize);
+    putU32(data, 18, width);
+    putU32(data, 22, static_cast<uint32_t>(height));
+    data[26] = 1;
+    data[28] = static_cast<char>(bpp);
+    putU32(data, 30, compression);
+    putU32(data, 46, coloursUsed);
+    return data + extra + pixels;
+  }
+
+  std::string u32s(std::initializer_list<uint32_t> values) {
+    std::string out;
+    for (uint32_t v : values) out.append(reinterpret_cast<const char*>(&v), 4);
+    return out;
+  }
+
+  // Four-entry palette: red, green, blue, white (stored BGRX)
+  const std::string PALETTE4 = u32s({ 0x00FF0000, 0x0000FF00, 0x000000FF, 0x00FFFFFF });
+}
+
+TEST_F(BmpParserTest, ThirtyTwoBitRgbIsOpaque) {
+  // BI_RGB 32-bit is BGRX, whatever the fourth byte holds
+  const std::string pixels("\x01\x02\x03\x80" "\x04\x05\x06\x00", 8);
+  createTestFile("test_data/bgrx_rgb.bmp", makeBmp(32, 2, -1, 0, "", pixels));
+
+  SSerializer::ImageParseOptions options;
+  options.format = SSerializer::PixelFormat::RGBA8;
+  ASSERT_TRUE(parser.parse("test_data/bgrx_rgb.bmp", out, options));
+  EXPECT_EQ(out.pixels, (std::vector<uint8_t>{ 3, 2, 1, 0xFF, 6, 5, 4, 0xFF }));
+
+  SSerializer::ImageParseOptions native;
+  native.nativeLayout = true;
+  ASSERT_TRUE(parser.parse("test_data/bgrx_rgb.bmp", out, native));
+  EXPECT_EQ(out.format, SSerializer::PixelFormat::BGR8);
+  EXPECT_EQ(out.pixels, (std::vector<uint8_t>{ 1, 2, 3, 4, 5, 6 }));
+}
+
+TEST_F(BmpParserTest, ThirtyTwoBitAlphaBitfieldsKeepAlpha) {
+  const std::string pixels("\x01\x02\x03\x80" "\x04\x05\x06\xFF", 8);
+  const std::string masks = u32s({ 0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000 });
+  createTestFile("test_data/bgra.bmp", makeBmp(32, 2, -1, 6, masks, pixels));
+
+  SSerializer::ImageParseOptions options;
+  options.format = SSerializer::PixelFormat::RGBA8;
+  ASSERT_TRUE(parser.parse("test_data/bgra.bmp", out, options));
+  EXPECT_EQ(out.pixels, (std::vector<uint8_t>{ 3, 2, 1, 0x80, 6, 5, 4, 0xFF }));
+
+  SSerializer::ImageParseOptions native;
+  native.nativeLayout = true;
+  ASSERT_TRUE(parser.parse("test_data/bgra.bmp", out, native));
+  EXPECT_EQ(out.format, SSerializer::PixelFormat::BGRA8);
+  EXPECT_EQ(std::string(out.pixels.begin(), out.pixels.end()), pixels);
+}
+
+TEST_F(BmpParserTest, BitfieldsWithoutAlphaAreOpaque) {
+  // BGRX masks after a 40-byte header
+  const std::string masks = u32s({ 0x00FF0000, 0x0000FF00, 0x000000FF });
+  createTestFile("test_data/bgrx.bmp", makeBmp(32, 1, 1, 3, masks, std::string("\x10\x20\x30\x00", 4)));
+
+  SSerializer::ImageParseOptions options;
+  options.format = SSerializer::PixelFormat::RGBA8;
+  ASSERT_TRUE(parser.parse("test_data/bgrx.bmp", out, options));
+  EXPECT_EQ(out.pixels, (std::vector<uint8_t>{ 0x30, 0x20, 0x10, 0xFF }));
+
+  SSerializer::ImageInfo info;
+  ASSERT_TRUE(parser.probe("test_data/bgrx.bmp", info));
+  EXPECT_EQ(info.sourceFormat, SSerializer::PixelFormat::BGR8);
+}
+
+TEST_F(BmpParserTest, V5HeaderRgbaMasks) {
+  // RGBA byte order declared through the masks inside a 124-byte header
+  std::string bmp = makeBmp(32, 2, 1, 3, "", std::string("\x0A\x0B\x0C\x0D" "\x01\x02\x03\x04", 8), 124);
+  putU32(bmp, 54, 0x000000FF);
+  putU32(bmp, 58, 0x0000FF00);
+  putU32(bmp, 62, 0x00FF0000);
+  putU32(bmp, 66, 0xFF000000);
+  createTestFile("test_data/v5.bmp", bmp);
+
+  SSerializer::ImageParseOptions options;
+  options.format = SSerializer::PixelFormat::RGBA8;
+  ASSERT_TRUE(parser.parse("test_data/v5.bmp", out, options));
+  EXPECT_EQ(out.pixels, (std::vector<uint8_t>{ 0x0A, 0x0B, 0x0C, 0x0D, 1, 2, 3, 4 }));
+}
+
+TEST_F(BmpParserTest, SixteenBitMasks) {
+  // 565 bitfields: full red, full green, full blue (rows padded to 4 bytes)
+  const std::string masks = u32s({ 0xF800, 0x07E0, 0x001F });
+  createTestFile("test_data/565.bmp", makeBmp(16, 3, 1, 3, masks, std::string("\x00\xF8\xE0\x07\x1F\x00\x00\x00", 8)));
+  ASSERT_TRUE(parser.parse("test_data/565.bmp", out));
+  EXPECT_EQ(out.pixels, (std::vector<uint8_t>{ 255, 0, 0, 0, 255, 0, 0, 0, 255 }));
+
+  // BI_RGB 16-bit is 555
+  createTestFile("test_data/555.bmp", makeBmp(16, 1, 1, 0, "", std::string("\xE0\x03\x00\x00", 4)));
+  ASSERT_TRUE(parser.parse("test_data/555.bmp", out));
+  EXPECT_EQ(out.pixels, (std::vector<uint8_t>{ 0, 255, 0 }));
+}
+
+TEST_F(BmpParserTest, PalettizedDepths) {
+  const std::vector<uint8_t> red{ 255, 0, 0 }, green{ 0, 255, 0 }, blue{ 0, 0, 255 }, white{ 255, 255, 255 };
+  auto pixel = [&](size_t i) { return std::vector<uint8_t>(out.pixels.begin() + i * 3, out.pixels.begin() + i * 3 + 3); };
+
+  createTestFile("test_data/pal8.bmp", makeBmp(8, 3, -1, 0, PALETTE4, std::string("\x03\x01\x02\x00", 4), 40, 4));
+  ASSERT_TRUE(parser.parse("test_data/pal8.bmp", out));
+  EXPECT_EQ(pixel(0), white); EXPECT_EQ(pixel(1), green); EXPECT_EQ(pixel(2), blue);
+
+  // Odd width leaves a half-used byte
+  createTestFile("test_data/pal4.bmp", makeBmp(4, 3, -1, 0, PALETTE4, std::string("\x12\x30\x00\x00", 4), 40, 4));
+  ASSERT_TRUE(parser.parse("test_data/pal4.bmp", out));
+  EXPECT_EQ(pixel(0), green); EXPECT_EQ(pixel(1), blue); EXPECT_EQ(pixel(2), white);
+
+  // Ten 1-bit pixels span two bytes
+  createTestFile("test_data/pal1.bmp", makeBmp(1, 10, -1, 0, PALETTE4, std::string("\xA0\x40\x00\x00", 4), 40, 2));
+  ASSERT_TRUE(parser.parse("test_data/pal1.bmp", out));
+  for (size_t i = 0; i < 10; ++i)
+    EXPECT_EQ(pixel(i), (i == 0 || i == 2 || i == 9) ? green : red) << i;
+}
+
+TEST_F(BmpParserTest, PaletteToRgbaAndR8) {
+  createTestFile("test_data/pal8_rgba.bmp", makeBmp(8, 2, 1, 0, PALETTE4, std::string("\x02\x03\x00\x00", 4), 40, 4));
+
+  SSerializer::ImageParseOptions options;
+  options.format = SSerializer::PixelFormat::RGBA8;
+  ASSERT_TRUE(parser.parse("test_data/pal8_rgba.bmp", out, options));
+  EXPECT_EQ(out.pixels, (std::vector<uint8_t>{ 0, 0, 255, 255, 255, 255, 255, 255 }));
+
+  options.format = SSerializer::PixelFormat::R8;
+  ASSERT_TRUE(parser.parse("test_data/pal8_rgba.bmp", out, options));
+  EXPECT_EQ(out.pixels, (std::vector<uint8_t>{ 29, 255 }));
+}
+
+TEST_F(BmpParserTest, Rle8RunsAbsoluteAndDelta) {
+  // 4x3, bottom row first: run of 4 x index 1; absolute [2,3,0] + end of line; delta (2,0) then run of 2 x 3
+  std::string rle;
+  rle += std::string("\x04\x01", 2) + std::string("\x00\x00", 2);
+  rle += std::string("\x00\x03\x02\x03\x00\x00", 6) + std::string("\x00\x00", 2);
+  rle += std::string("\x00\x02\x02\x00", 4) + std::string("\x02\x03", 2);
+  rle += std::string("\x00\x01", 2);
+  createTestFile("test_data/rle8.bmp", makeBmp(8, 4, 3, 1, PALETTE4, rle, 40, 4));
+
+  ASSERT_TRUE(parser.parse("test_data/rle8.bmp", out));
+  const std::vector<uint8_t> R{ 255, 0, 0 }, G{ 0, 255, 0 }, B{ 0, 0, 255 }, W{ 255, 255, 255 };
+  std::vector<uint8_t> expected;
+  for (const auto* px : { &R, &R, &W, &W,  &B, &W, &R, &R,  &G, &G, &G, &G }) expected.insert(expected.end(), px->begin(), px->end());
+  EXPECT_EQ(out.pixels, expected);
+}
+
+TEST_F(BmpParserTest, Rle4AlternatesNibbles) {
+  // 6x1: run of 3 alternating 1/2, then absolute [3, 0, 1]
+  std::string rle = std::string("\x03\x12", 2) + std::string("\x00\x03\x30\x10", 4) + std::string("\x00\x01", 2);
+  createTestFile("test_data/rle4.bmp", makeBmp(4, 6, 1, 2, PALETTE4, rle, 40, 4));
+
+  ASSERT_TRUE(parser.parse("test_data/rle4.bmp", out));
+  EXPECT_EQ(out.pixels, (std::vector<uint8_t>{ 0, 255, 0,  0, 0, 255,  0, 255, 0,  255, 255, 255,  255, 0, 0,  0, 255, 0 }));
+}
+
+TEST_F(BmpParserTest, TruncatedRleFails) {
+  createTestFile("test_data/rle_truncated.bmp", makeBmp(8, 8, 1, 1, PALETTE4, std::string("\x00\x08\x01\x02", 4), 40, 4));
+  testing::internal::CaptureStderr();
+  expectInvalidParse("test_data/rle_truncated.bmp");
+  expectStderrContains({ "Truncated RLE data at row 0" });
+}
+
+TEST_F(BmpParserTest, TopDownRleFails) {
+  createTestFile("test_data/rle_top_down.bmp", makeBmp(8, 2, -1, 1, PALETTE4, std::string("\x02\x01\x00\x01", 4), 40, 4));
+  testing::internal::CaptureStderr();
+  expectInvalidParse("test_data/rle_top_down.bmp");
+  expectStderrContains({ "Top-down RLE BMP is invalid" });
+}
+
+TEST_F(BmpParserTest, MissingMasksFail) {
+  createTestFile("test_data/no_masks.bmp", makeBmp(32, 1, 1, 3, "", std::string(4, '\0')));
+  testing::internal::CaptureStderr();
+  expectInvalidParse("test_data/no_masks.bmp");
+  expectStderrContains({ "File too small for colour masks" });
+
+  createTestFile("test_data/zero_masks.bmp", makeBmp(32, 1, 1, 3, u32s({ 0, 0, 0 }), std::string(4, '\0')));
+  testing::internal::CaptureStderr();
+  expectInvalidParse("test_data/zero_masks.bmp");
+  expectStderrContains({ "BMP colour masks are all zero" });
+}
+
+TEST_F(BmpParserTest, NonContiguousMasksFail) {
+  createTestFile("test_data/split_mask.bmp", makeBmp(32, 1, 1, 3, u32s({ 0x00FF0000, 0x0000FF00, 0x80000001 }), std::string("\xFF\xFF\xFF\xFF", 4)));
+  testing::internal::CaptureStderr();
+  expectInvalidParse("test_data/split_mask.bmp");
+  expectStderrContains({ "BMP colour mask 2 is not contiguous" });
+
+  createTestFile("test_data/split_mask16.bmp", makeBmp(16, 1, 1, 3, u32s({ 0xF800, 0x07E0, 0x8001 }), std::string("\xFF\xFF\x00\x00", 4)));
+  testing::internal::CaptureStderr();
+  expectInvalidParse("test_data/split_mask16.bmp");
+  expectStderrContains({ "BMP colour mask 2 is not contiguous" });
+}
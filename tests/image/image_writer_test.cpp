@@ -0,0 +1,161 @@
+#include "../test_helpers.hpp"
+
+#include "starlet-serializer/writer/writer.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace {
+  // Flat spans, repeats of two and noise, so RLE sees runs, short repeats and literals
+  SSerializer::ImageData makeImage(uint32_t width, uint32_t height, SSerializer::PixelFormat format, bool bottomUp) {
+    SSerializer::ImageData image;
+    image.width = static_cast<int32_t>(width);
+    image.height = static_cast<int32_t>(height);
+    image.format = format;
+    image.bottomUp = bottomUp;
+    image.pixelSize = SSerializer::pixelFormatSize(format);
+    image.byteSize = static_cast<size_t>(width) * height * image.pixelSize;
+    image.pixels.resize(image.byteSize);
+
+    uint32_t seed = 7;
+    for (size_t i = 0; i < image.byteSize; ++i) {
+      seed = seed * 1103515245u + 12345u;
+      const size_t pixel = i / image.pixelSize;
+      const size_t x = pixel % width;
+      image.pixels[i] = x < 4 ? static_cast<uint8_t>(40 * (pixel / width)) : x < 8 ? static_cast<uint8_t>(x / 2 * 30 + i % image.pixelSize) : static_cast<uint8_t>(seed >> 16);
+    }
+    return image;
+  }
+
+  std::vector<uint8_t> topDown(const SSerializer::ImageData& image) {
+    if (!image.bottomUp) return image.pixels;
+    const size_t rowSize = static_cast<size_t>(image.width) * image.pixelSize;
+    std::vector<uint8_t> rows;
+    for (size_t y = static_cast<size_t>(image.height); y-- > 0;)
+      rows.insert(rows.end(), image.pixels.begin() + y * rowSize, image.pixels.begin() + (y + 1) * rowSize);
+    return rows;
+  }
+
+  uint32_t readLe(const std::vector<uint8_t>& data, size_t offset, size_t bytes) {
+    uint32_t value = 0;
+    for (size_t i = 0; i < bytes; ++i) value |= static_cast<uint32_t>(data[offset + i]) << (i * 8);
+    return value;
+  }
+}
+
+class ImageWriterTest : public ImageParserTest {
+protected:
+  SSerializer::Writer writer;
+  std::vector<uint8_t> encoded;
+
+  SSerializer::ImageWriteOptions container(SSerializer::ImageFormat format, bool rle = false) {
+    SSerializer::ImageWriteOptions options;
+    options.format = format;
+    options.rle = rle;
+    return options;
+  }
+};
+
+TEST_F(ImageWriterTest, RoundTripsEveryFormatAndLayout) {
+  const struct { const char* path; bool rle; } files[] = {
+    { "test_data/written.bmp", false }, { "test_data/written.tga", false }, { "test_data/written_rle.tga", true }, { "test_data/written.qoi", false }
+  };
+  const SSerializer::PixelFormat formats[] = {
+    SSerializer::PixelFormat::R8, SSerializer::PixelFormat::RGB8, SSerializer::PixelFormat::RGBA8,
+    SSerializer::PixelFormat::BGR8, SSerializer::PixelFormat::BGRA8
+  };
+
+  for (const auto& file : files) {
+    for (SSerializer::PixelFormat format : formats) {
+      for (bool bottomUp : { false, true }) {
+        const SSerializer::ImageData image = makeImage(13, 5, format, bottomUp);
+        SSerializer::ImageWriteOptions options;
+        options.rle = file.rle;
+        ASSERT_TRUE(writer.writeImage(image, file.path, options)) << file.path;
+
+        SSerializer::ImageParseOptions parseOptions;
+        parseOptions.format = format;
+        ASSERT_TRUE(parser.parse(file.path, out, parseOptions)) << file.path;
+        EXPECT_EQ(out.width, 13);
+        EXPECT_EQ(out.height, 5);
+        EXPECT_EQ(out.pixels, topDown(image)) << file.path << " format " << int(format) << " bottomUp " << bottomUp;
+      }
+    }
+  }
+}
+
+TEST_F(ImageWriterTest, BmpHeaders) {
+  ASSERT_TRUE(writer.encodeImage(makeImage(5, 2, SSerializer::PixelFormat::RGB8, false), encoded, container(SSerializer::ImageFormat::BMP)));
+  ASSERT_EQ(encoded.size(), 14u + 40u + 16u * 2);
+  EXPECT_EQ(readLe(encoded, 2, 4), encoded.size());
+  EXPECT_EQ(readLe(encoded, 10, 4), 54u);
+  EXPECT_EQ(readLe(encoded, 28, 2), 24u);
+  EXPECT_EQ(readLe(encoded, 30, 4), 0u);
+  EXPECT_EQ(encoded[54 + 15], 0);
+
+  ASSERT_TRUE(writer.encodeImage(makeImage(5, 2, SSerializer::PixelFormat::RGBA8, false), encoded, container(SSerializer::ImageFormat::BMP)));
+  EXPECT_EQ(readLe(encoded, 14, 4), 108u);
+  EXPECT_EQ(readLe(encoded, 28, 2), 32u);
+  EXPECT_EQ(readLe(encoded, 30, 4), 3u);
+  EXPECT_EQ(readLe(encoded, 66, 4), 0xFF000000u);
+
+  ASSERT_TRUE(writer.encodeImage(makeImage(5, 2, SSerializer::PixelFormat::R8, false), encoded, container(SSerializer::ImageFormat::BMP)));
+  EXPECT_EQ(readLe(encoded, 10, 4), 14u + 40u + 1024u);
+  EXPECT_EQ(readLe(encoded, 28, 2), 8u);
+  EXPECT_EQ(readLe(encoded, 54 + 200 * 4, 4), 200u * 0x010101u);
+}
+
+TEST_F(ImageWriterTest, TgaRlePackets) {
+  // Run of three, two literals, a repeat of two and a final literal
+  SSerializer::ImageData image = makeImage(8, 1, SSerializer::PixelFormat::RGB8, false);
+  const uint8_t colours[8] = { 1, 1, 1, 2, 3, 4, 4, 5 };
+  for (size_t i = 0; i < 24; ++i) image.pixels[i] = static_cast<uint8_t>(colours[i / 3] * 10 + i % 3);
+
+  ASSERT_TRUE(writer.encodeImage(image, encoded, container(SSerializer::ImageFormat::TGA, true)));
+  EXPECT_EQ(encoded[2], 10);
+  EXPECT_EQ(encoded[16], 24);
+  EXPECT_EQ(encoded[17], 0x20);
+  const std::vector<uint8_t> packets = {
+    0x82, 12, 11, 10,
+    0x01, 22, 21, 20, 32, 31, 30,
+    0x81, 42, 41, 40,
+    0x00, 52, 51, 50
+  };
+  EXPECT_EQ(std::vector<uint8_t>(encoded.begin() + 18, encoded.end()), packets);
+
+  // 300 identical grey pixels split into packets of at most 128
+  SSerializer::ImageData grey = makeImage(300, 1, SSerializer::PixelFormat::R8, true);
+  std::fill(grey.pixels.begin(), grey.pixels.end(), 9);
+  ASSERT_TRUE(writer.encodeImage(grey, encoded, container(SSerializer::ImageFormat::TGA, true)));
+  EXPECT_EQ(encoded[2], 11);
+  EXPECT_EQ(encoded[17], 0x00);
+  EXPECT_EQ(std::vector<uint8_t>(encoded.begin() + 18, encoded.end()), (std::vector<uint8_t>{ 0xFF, 9, 0xFF, 9, 0xAB, 9 }));
+}
+
+TEST_F(ImageWriterTest, InvalidImages) {
+  const SSerializer::ImageData image = makeImage(4, 4, SSerializer::PixelFormat::RGB8, false);
+
+  testing::internal::CaptureStderr();
+  EXPECT_FALSE(writer.writeImage(image, "test_data/written.png"));
+  expectStderrContains({ "Unsupported image format: test_data/written.png" });
+
+  testing::internal::CaptureStderr();
+  EXPECT_FALSE(writer.encodeImage(image, encoded, {}));
+  expectStderrContains({ "Unsupported image output format" });
+
+  SSerializer::ImageData truncated = image;
+  truncated.pixels.resize(10);
+  testing::internal::CaptureStderr();
+  EXPECT_FALSE(writer.writeImage(truncated, "test_data/truncated.bmp"));
+  expectStderrContains({ "Pixel buffer too small: 10 bytes, need 48 bytes" });
+
+  SSerializer::ImageData empty;
+  testing::internal::CaptureStderr();
+  EXPECT_FALSE(writer.writeImage(empty, "test_data/empty.qoi"));
+  expectStderrContains({ "Invalid image dimensions: 0x0" });
+
+  testing::internal::CaptureStderr();
+  EXPECT_FALSE(writer.writeImage(makeImage(70000, 1, SSerializer::PixelFormat::R8, false), "test_data/wide.tga"));
+  expectStderrContains({ "Image too large for TGA: 70000x1" });
+}
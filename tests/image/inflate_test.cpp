@@ -0,0 +1,206 @@
+#include "../test_helpers.hpp"
+
+#include "starlet-serializer/utils/inflate.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace {
+  // Text the zlib streams below were compressed from
+  std::string sampleText() {
+    std::string text;
+    for (int i = 0; i < 60; ++i)
+      text += std::to_string(i % 13) + " the quick brown fox " + std::to_string(i * 7 % 100) + " jumps over the lazy dog\n";
+    return text;
+  }
+
+  // zlib level 9 with Z_FIXED: one fixed-Huffman block
+  const std::vector<uint8_t> FIXED_STREAM = {
+    0x78, 0x01, 0x33, 0x50, 0x28, 0xC9, 0x48, 0x55, 0x28, 0x2C, 0xCD, 0x4C, 0xCE, 0x56, 0x48, 0x2A,
+    0xCA, 0x2F, 0xCF, 0x53, 0x48, 0xCB, 0xAF, 0x50, 0x30, 0x50, 0xC8, 0x2A, 0xCD, 0x2D, 0x28, 0x56,
+    0xC8, 0x2F, 0x4B, 0x2D, 0x02, 0x2B, 0xC8, 0x49, 0xAC, 0xAA, 0x54, 0x48, 0xC9, 0x4F, 0xE7, 0x32,
+    0xC4, 0xAA, 0xDE, 0x1C, 0xA7, 0x7A, 0x23, 0xAC, 0xEA, 0x0D, 0x4D, 0x70, 0x6A, 0x30, 0xC6, 0xAA,
+    0xC1, 0xC8, 0x10, 0xA7, 0x06, 0x13, 0xEC, 0x1A, 0x2C, 0x70, 0x6A, 0x30, 0xC5, 0xAA, 0xC1, 0xD8,
+    0x14, 0xA7, 0x06, 0x33, 0xAC, 0x1A, 0x4C, 0x8C, 0x70, 0x6A, 0x30, 0xC7, 0xAE, 0xC1, 0x12, 0xA7,
+    0x06, 0x0B, 0xAC, 0x1A, 0x4C, 0xCD, 0x70, 0x6A, 0xB0, 0xC4, 0xAA, 0xC1, 0xCC, 0x18, 0x77, 0xBC,
+    0x19, 0x60, 0x8F, 0x38, 0x3C, 0x31, 0x8D, 0x23, 0xAA, 0x71, 0xC7, 0xB5, 0x21, 0xF6, 0xC8, 0xB6,
+    0xC0, 0x1D, 0xD9, 0xD8, 0x1D, 0x65, 0x69, 0x48, 0x62, 0xF2, 0xB3, 0xB4, 0x20, 0x31, 0xFD, 0x99,
+    0x92, 0x98, 0xFC, 0x0C, 0x8D, 0x48, 0x4C, 0x7E, 0x86, 0x96, 0x24, 0x26, 0x3F, 0x23, 0x33, 0x12,
+    0x93, 0x9F, 0xB1, 0x31, 0xA9, 0xC9, 0xCF, 0x80, 0xC4, 0xE4, 0x67, 0x62, 0x4E, 0x62, 0xF2, 0x33,
+    0x35, 0x21, 0x35, 0xF9, 0x99, 0x19, 0x92, 0x9A, 0xFC, 0xCC, 0x2C, 0x48, 0x4D, 0x7E, 0xE6, 0xA6,
+    0x24, 0x26, 0x3F, 0x0B, 0x23, 0x12, 0x93, 0x9F, 0x85, 0x25, 0x89, 0xC9, 0xCF, 0xD2, 0x8C, 0xC4,
+    0xF4, 0x67, 0x4C, 0x6A, 0xF2, 0x33, 0x20, 0x31, 0xF9, 0x19, 0x9A, 0x93, 0x98, 0xFC, 0x8C, 0x4C,
+    0x48, 0x4C, 0x7E, 0xC6, 0x86, 0x24, 0x26, 0x3F, 0x63, 0x0B, 0x12, 0x93, 0x9F, 0x89, 0x29, 0xA9,
+    0xC9, 0xCF, 0xD4, 0x88, 0xD4, 0xE4, 0x67, 0x6A, 0x49, 0x6A, 0xF2, 0x33, 0x33, 0x23, 0x31, 0xF9,
+    0x99, 0x1B, 0x93, 0x9A, 0xFC, 0x0C, 0x48, 0x4C, 0x7E, 0x16, 0xE6, 0x24, 0x26, 0x3F, 0x4B, 0x13,
+    0x52, 0xD3, 0x1F, 0x89, 0xC9, 0xCF, 0x82, 0xC4, 0xD4, 0x67, 0x68, 0x4A, 0x62, 0xEA, 0x33, 0x32,
+    0x22, 0x31, 0xF5, 0x19, 0x59, 0x92, 0x98, 0xFA, 0x8C, 0xCD, 0x48, 0x4D, 0x7D, 0x26, 0xC6, 0x24,
+    0xA7, 0x3E, 0x03, 0x52, 0x53, 0x9F, 0xA9, 0x39, 0x89, 0xA9, 0xCF, 0xCC, 0x84, 0xD4, 0xA6, 0x9F,
+    0x21, 0x89, 0xA9, 0xCF, 0xDC, 0x82, 0xC4, 0xD4, 0x67, 0x61, 0x4A, 0x62, 0xEA, 0xB3, 0x34, 0x22,
+    0x31, 0xF9, 0x59, 0x5A, 0x92, 0x98, 0xFE, 0xCC, 0x48, 0x4C, 0x7E, 0x86, 0xB8, 0xA3, 0x1A, 0x00,
+    0x24, 0x0B, 0xF5, 0x8E,  };
+
+  // zlib level 9: one dynamic-Huffman block
+  const std::vector<uint8_t> DYNAMIC_STREAM = {
+    0x78, 0xDA, 0x95, 0xD6, 0x49, 0x4E, 0x44, 0x31, 0x0C, 0x45, 0xD1, 0x39, 0xAB, 0xC8, 0x12, 0xBE,
+    0x9D, 0xD8, 0x89, 0x97, 0x43, 0x53, 0xF4, 0xF0, 0xA1, 0xA0, 0xE8, 0x56, 0x8F, 0xC4, 0xD8, 0x46,
+    0xBA, 0x73, 0x5F, 0x29, 0xD2, 0x3B, 0x83, 0x6C, 0xED, 0xFD, 0xF6, 0xD0, 0x5E, 0x4F, 0x77, 0x97,
+    0x0F, 0xED, 0xE2, 0xB8, 0x7F, 0x3E, 0xB7, 0xEB, 0xFD, 0xAB, 0x6D, 0xED, 0xFE, 0xF4, 0xF4, 0xF2,
+    0xD6, 0xF6, 0x8F, 0xC3, 0xF1, 0xEF, 0xE0, 0xF1, 0xFC, 0xE7, 0xBB, 0x5D, 0xED, 0x37, 0x67, 0x92,
+    0xDE, 0xCF, 0xF2, 0x5E, 0xD3, 0x7B, 0x19, 0x65, 0xD0, 0xD3, 0x40, 0xA5, 0x0C, 0x46, 0x1E, 0xAC,
+    0x32, 0xB0, 0x34, 0xE8, 0x56, 0x06, 0x9E, 0x06, 0x43, 0xCB, 0x60, 0xE6, 0x41, 0x94, 0xC1, 0x4A,
+    0x03, 0xF3, 0x32, 0x88, 0x34, 0xF0, 0x5E, 0xEF, 0xB6, 0xE5, 0xC3, 0xFD, 0xB3, 0x74, 0x31, 0x75,
+    0xBD, 0xB5, 0xE4, 0x63, 0xAF, 0x7A, 0xEC, 0xFC, 0x51, 0x21, 0x90, 0x5F, 0x2C, 0xE8, 0xCF, 0x20,
+    0x3F, 0x51, 0xC8, 0x4F, 0x02, 0xF2, 0x53, 0x87, 0xFC, 0x7A, 0xA7, 0xFC, 0x36, 0xC8, 0x6F, 0x4C,
+    0xC8, 0xCF, 0x06, 0xE5, 0xE7, 0x42, 0xF9, 0xF9, 0xA2, 0xFC, 0xA6, 0x41, 0x7E, 0x4B, 0x21, 0xBF,
+    0x15, 0x90, 0x5F, 0x38, 0xF4, 0xD7, 0x29, 0xBF, 0x0D, 0xF2, 0x93, 0x09, 0xF9, 0xE9, 0x80, 0xFC,
+    0xBA, 0x40, 0x7E, 0x7D, 0x41, 0x7E, 0xC3, 0x28, 0x3F, 0x53, 0xCA, 0xCF, 0x82, 0xF2, 0x73, 0x87,
+    0xFC, 0x66, 0xA7, 0xFC, 0x36, 0xC8, 0x6F, 0x4D, 0xC8, 0x2F, 0x06, 0xF5, 0x07, 0xF9, 0x2D, 0xA8,
+    0x4F, 0x0C, 0xEA, 0x53, 0x85, 0xFA, 0x34, 0xA0, 0xBE, 0xEE, 0x54, 0xDF, 0xE8, 0x58, 0xDF, 0x46,
+    0xF5, 0xD9, 0x84, 0xFA, 0x7C, 0xD0, 0xAF, 0x9F, 0x40, 0x7D, 0x73, 0x41, 0x7D, 0xCB, 0xA0, 0xBE,
+    0x50, 0xC8, 0x2F, 0x02, 0xFA, 0x73, 0xC8, 0x4F, 0xEA, 0xA9, 0x7F, 0x01, 0x24, 0x0B, 0xF5, 0x8E,  };
+
+  // Hand-built dynamic block giving 'A'..'O' code lengths 1..15, so the long codes live in subtables
+  const std::string LONG_CODE_TEXT = "ONMLKJIHGFEDCBAABCDEFGHIJKLMNOOOOAA";
+  const std::vector<uint8_t> LONG_CODE_STREAM = {
+    0x78, 0x01, 0x05, 0xE0, 0x21, 0xB5, 0x6D, 0xDB, 0xB6, 0x6D, 0xDB, 0x6A, 0x8B, 0x29, 0x97, 0xDA,
+    0xFA, 0x98, 0x6B, 0x9F, 0xFB, 0xBE, 0x7F, 0x37, 0x3F, 0xFE, 0xFF, 0xFE, 0xBF, 0xFF, 0xF7, 0x7F,
+    0xFF, 0xFB, 0xEF, 0xDF, 0xDF, 0xEF, 0x7B, 0xB7, 0x68, 0xF7, 0xBE, 0xDF, 0xDF, 0xBF, 0xFF, 0xFE,
+    0xF7, 0x7F, 0xFF, 0xEF, 0xFF, 0xFB, 0xFF, 0xFD, 0xFF, 0xFE, 0x7F, 0xFF, 0x3F, 0xFE, 0xFF, 0xB1,
+    0x92, 0x09, 0xE0,
+  };
+
+  // 1000 x 'a' then 5 x "xyz": distance-1 and short-distance overlapping matches
+  const std::vector<uint8_t> RUN_STREAM = {
+    0x78, 0xDA, 0x4B, 0x4C, 0x1C, 0x05, 0xA3, 0x60, 0x14, 0x0C, 0x77, 0x50, 0x51, 0x59, 0x85, 0x8C,
+    0x00, 0x67, 0x86, 0x82, 0x0F,
+  };
+
+  std::vector<uint8_t> inflate(const std::vector<uint8_t>& stream, size_t size, bool& ok) {
+    std::vector<uint8_t> out(size);
+    ok = SSerializer::Utils::inflateZlib(stream.data(), stream.size(), out.data(), out.size());
+    return out;
+  }
+
+  // Uncompressed zlib stream split into stored blocks of at most blockSize bytes
+  std::vector<uint8_t> storedStream(const std::vector<uint8_t>& data, size_t blockSize) {
+    std::vector<uint8_t> stream{ 0x78, 0x01 };
+    size_t offset = 0;
+    do {
+      const size_t length = std::min(blockSize, data.size() - offset);
+      const bool last = offset + length == data.size();
+      stream.push_back(last ? 1 : 0);
+      stream.push_back(static_cast<uint8_t>(length));
+      stream.push_back(static_cast<uint8_t>(length >> 8));
+      stream.push_back(static_cast<uint8_t>(~length));
+      stream.push_back(static_cast<uint8_t>(~length >> 8));
+      stream.insert(stream.end(), data.begin() + offset, data.begin() + offset + length);
+      offset += length;
+    } while (offset < data.size());
+
+    const uint32_t adler = SSerializer::Utils::adler32(data.data(), data.size());
+    for (int shift = 24; shift >= 0; shift -= 8) stream.push_back(static_cast<uint8_t>(adler >> shift));
+    return stream;
+  }
+
+  uint32_t referenceAdler32(const std::vector<uint8_t>& data) {
+    uint32_t a = 1, b = 0;
+    for (uint8_t byte : data) {
+      a = (a + byte) % 65521;
+      b = (b + a) % 65521;
+    }
+    return (b << 16) | a;
+  }
+}
+
+TEST(InflateTest, FixedHuffmanBlock) {
+  const std::string text = sampleText();
+  bool ok = false;
+  const std::vector<uint8_t> out = inflate(FIXED_STREAM, text.size(), ok);
+  ASSERT_TRUE(ok);
+  EXPECT_EQ(std::string(out.begin(), out.end()), text);
+}
+
+TEST(InflateTest, DynamicHuffmanBlock) {
+  const std::string text = sampleText();
+  bool ok = false;
+  const std::vector<uint8_t> out = inflate(DYNAMIC_STREAM, text.size(), ok);
+  ASSERT_TRUE(ok);
+  EXPECT_EQ(std::string(out.begin(), out.end()), text);
+}
+
+TEST(InflateTest, LongCodesUseSubtables) {
+  bool ok = false;
+  const std::vector<uint8_t> out = inflate(LONG_CODE_STREAM, LONG_CODE_TEXT.size(), ok);
+  ASSERT_TRUE(ok);
+  EXPECT_EQ(std::string(out.begin(), out.end()), LONG_CODE_TEXT);
+}
+
+TEST(InflateTest, OverlappingMatches) {
+  std::string expected(1000, 'a');
+  for (int i = 0; i < 5; ++i) expected += "xyz";
+  bool ok = false;
+  const std::vector<uint8_t> out = inflate(RUN_STREAM, expected.size(), ok);
+  ASSERT_TRUE(ok);
+  EXPECT_EQ(std::string(out.begin(), out.end()), expected);
+}
+
+TEST(InflateTest, StoredBlocks) {
+  std::vector<uint8_t> data(150000);
+  for (size_t i = 0; i < data.size(); ++i) data[i] = static_cast<uint8_t>(i * 31 + (i >> 9));
+
+  for (size_t blockSize : { size_t{ 65535 }, size_t{ 1000 }, size_t{ 7 } }) {
+    bool ok = false;
+    EXPECT_EQ(inflate(storedStream(data, blockSize), data.size(), ok), data);
+    EXPECT_TRUE(ok) << "block size " << blockSize;
+  }
+}
+
+TEST(InflateTest, RejectsWrongOutputSize) {
+  const size_t size = sampleText().size();
+  bool ok = true;
+  inflate(DYNAMIC_STREAM, size - 1, ok);
+  EXPECT_FALSE(ok);
+  inflate(DYNAMIC_STREAM, size + 1, ok);
+  EXPECT_FALSE(ok);
+}
+
+TEST(InflateTest, RejectsCorruptStreams) {
+  const size_t size = sampleText().size();
+  bool ok = true;
+
+  std::vector<uint8_t> badHeader = DYNAMIC_STREAM;
+  badHeader[1] ^= 1;
+  inflate(badHeader, size, ok);
+  EXPECT_FALSE(ok);
+
+  std::vector<uint8_t> badChecksum = DYNAMIC_STREAM;
+  badChecksum.back() ^= 1;
+  inflate(badChecksum, size, ok);
+  EXPECT_FALSE(ok);
+
+  std::vector<uint8_t> truncated(DYNAMIC_STREAM.begin(), DYNAMIC_STREAM.end() - 40);
+  inflate(truncated, size, ok);
+  EXPECT_FALSE(ok);
+
+  std::vector<uint8_t> reservedType{ 0x78, 0x01, 0x07, 0, 0, 0, 0 };
+  inflate(reservedType, 0, ok);
+  EXPECT_FALSE(ok);
+}
+
+TEST(InflateTest, Adler32MatchesReference) {
+  const std::string wiki = "Wikipedia";
+  EXPECT_EQ(SSerializer::Utils::adler32(reinterpret_cast<const uint8_t*>(wiki.data()), wiki.size()), 0x11E60398u);
+
+  // Sizes around the 32-byte SIMD blocks and the 5552-byte modulo interval, all bytes 0xFF
+  for (size_t size : { size_t{ 0 }, size_t{ 31 }, size_t{ 32 }, size_t{ 33 }, size_t{ 5551 }, size_t{ 5552 }, size_t{ 5600 }, size_t{ 100000 } }) {
+    const std::vector<uint8_t> data(size, 0xFF);
+    EXPECT_EQ(SSerializer::Utils::adler32(data.data(), data.size()), referenceAdler32(data)) << size;
+  }
+
+  std::vector<uint8_t> data(20000);
+  for (size_t i = 0; i < data.size(); ++i) data[i] = static_cast<uint8_t>(i * 131);
+  const uint32_t first = SSerializer::Utils::adler32(data.data(), 7777);
+  EXPECT_EQ(SSerializer::Utils::adler32(data.data() + 7777, data.size() - 7777, first), referenceAdler32(data));
+}
@@ -0,0 +1,147 @@
+#include "../test_helpers.hpp"
+
+#include "starlet-serializer/utils/pixel_swizzle.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace {
+  using Starlet::Serializer::Utils::SimdLevel;
+  const SimdLevel LEVELS[] = { SimdLevel::Scalar, SimdLevel::Ssse3, SimdLevel::Avx2 };
+
+  std::vector<uint8_t> makePixels(size_t bytes) {
+    std::vector<uint8_t> data(bytes);
+    for (size_t i = 0; i < bytes; ++i) data[i] = static_cast<uint8_t>(i * 7 + 3);
+    return data;
+  }
+
+  // Sizes around every kernel's block width and tail, plus one large run
+  std::vector<size_t> testSizes() {
+    std::vector<size_t> sizes;
+    for (size_t n = 0; n <= 70; ++n) sizes.push_back(n);
+    sizes.push_back(4099);
+    return sizes;
+  }
+}
+
+TEST(PixelSwizzleTest, SwapRedBlue24MatchesReference) {
+  for (size_t n : testSizes()) {
+    const std::vector<uint8_t> src = makePixels(n * 3);
+    for (SimdLevel level : LEVELS) {
+      std::vector<uint8_t> dst(n * 3, 0);
+      SSerializer::Utils::swapRedBlue24(src.data(), dst.data(), n, level);
+      for (size_t i = 0; i < n; ++i) {
+        ASSERT_EQ(dst[i * 3], src[i * 3 + 2]) << "pixels " << n << " at " << i;
+        ASSERT_EQ(dst[i * 3 + 1], src[i * 3 + 1]) << "pixels " << n << " at " << i;
+        ASSERT_EQ(dst[i * 3 + 2], src[i * 3]) << "pixels " << n << " at " << i;
+      }
+    }
+  }
+}
+
+TEST(PixelSwizzleTest, SwapRedBlue32MatchesReference) {
+  for (size_t n : testSizes()) {
+    const std::vector<uint8_t> src = makePixels(n * 4);
+    for (SimdLevel level : LEVELS) {
+      std::vector<uint8_t> dst(n * 4, 0);
+      SSerializer::Utils::swapRedBlue32(src.data(), dst.data(), n, level);
+      for (size_t i = 0; i < n; ++i) {
+        ASSERT_EQ(dst[i * 4], src[i * 4 + 2]) << "pixels " << n << " at " << i;
+        ASSERT_EQ(dst[i * 4 + 1], src[i * 4 + 1]) << "pixels " << n << " at " << i;
+        ASSERT_EQ(dst[i * 4 + 2], src[i * 4]) << "pixels " << n << " at " << i;
+        ASSERT_EQ(dst[i * 4 + 3], src[i * 4 + 3]) << "pixels " << n << " at " << i;
+      }
+    }
+  }
+}
+
+TEST(PixelSwizzleTest, BgraToRgbMatchesReferenceWithoutOverrun) {
+  for (size_t n : testSizes()) {
+    const std::vector<uint8_t> src = makePixels(n * 4);
+    for (SimdLevel level : LEVELS) {
+      // Guard bytes after the output catch stores past the last pixel
+      std::vector<uint8_t> dst(n * 3 + 32, 0xCD);
+      SSerializer::Utils::bgraToRgb(src.data(), dst.data(), n, level);
+      for (size_t i = 0; i < n; ++i) {
+        ASSERT_EQ(dst[i * 3], src[i * 4 + 2]) << "pixels " << n << " at " << i;
+        ASSERT_EQ(dst[i * 3 + 1], src[i * 4 + 1]) << "pixels " << n << " at " << i;
+        ASSERT_EQ(dst[i * 3 + 2], src[i * 4]) << "pixels " << n << " at " << i;
+      }
+      for (size_t i = n * 3; i < dst.size(); ++i) ASSERT_EQ(dst[i], 0xCD) << "pixels " << n;
+    }
+  }
+}
+
+TEST(PixelSwizzleTest, InPlaceConversionsMatchCopies) {
+  for (size_t n : testSizes()) {
+    for (SimdLevel level : LEVELS) {
+      const std::vector<uint8_t> rgb = makePixels(n * 3), rgba = makePixels(n * 4);
+      std::vector<uint8_t> expected24(n * 3), expected32(n * 4), expectedPacked(n * 3);
+      SSerializer::Utils::swapRedBlue24(rgb.data(), expected24.data(), n, SimdLevel::Scalar);
+      SSerializer::Utils::swapRedBlue32(rgba.data(), expected32.data(), n, SimdLevel::Scalar);
+      SSerializer::Utils::bgraToRgb(rgba.data(), expectedPacked.data(), n, SimdLevel::Scalar);
+
+      std::vector<uint8_t> buffer = rgb;
+      SSerializer::Utils::swapRedBlue24(buffer.data(), buffer.data(), n, level);
+      ASSERT_EQ(buffer, expected24) << "pixels " << n;
+
+      buffer = rgba;
+      SSerializer::Utils::swapRedBlue32(buffer.data(), buffer.data(), n, level);
+      ASSERT_EQ(buffer, expected32) << "pixels " << n;
+
+      buffer = rgba;
+      SSerializer::Utils::bgraToRgb(buffer.data(), buffer.data(), n, level);
+      buffer.resize(n * 3);
+      ASSERT_EQ(buffer, expectedPacked) << "pixels " << n;
+    }
+  }
+}
+
+TEST(PixelSwizzleTest, ExpansionsAndPackingMatchReference) {
+  for (size_t n : testSizes()) {
+    const std::vector<uint8_t> src3 = makePixels(n * 3), src4 = makePixels(n * 4);
+    for (SimdLevel level : LEVELS) {
+      std::vector<uint8_t> swapped(n * 4 + 32, 0xCD), kept(n * 4 + 32, 0xCD), packed(n * 3 + 32, 0xCD);
+      SSerializer::Utils::bgrToRgba(src3.data(), swapped.data(), n, level);
+      SSerializer::Utils::rgbToRgba(src3.data(), kept.data(), n, level);
+      SSerializer::Utils::rgbaToRgb(src4.data(), packed.data(), n, level);
+      for (size_t i = 0; i < n; ++i) {
+        for (size_t c = 0; c < 3; ++c) {
+          ASSERT_EQ(swapped[i * 4 + c], src3[i * 3 + 2 - c]) << "pixels " << n << " at " << i;
+          ASSERT_EQ(kept[i * 4 + c], src3[i * 3 + c]) << "pixels " << n << " at " << i;
+          ASSERT_EQ(packed[i * 3 + c], src4[i * 4 + c]) << "pixels " << n << " at " << i;
+        }
+        ASSERT_EQ(swapped[i * 4 + 3], 255);
+        ASSERT_EQ(kept[i * 4 + 3], 255);
+      }
+      for (size_t i = n * 4; i < swapped.size(); ++i) ASSERT_EQ(swapped[i], 0xCD) << "pixels " << n;
+      for (size_t i = n * 3; i < packed.size(); ++i) ASSERT_EQ(packed[i], 0xCD) << "pixels " << n;
+    }
+  }
+}
+
+TEST(PixelSwizzleTest, ConvertPixelsCoversEveryFormatPair) {
+  using SSerializer::PixelFormat;
+  const PixelFormat formats[] = { PixelFormat::R8, PixelFormat::RGB8, PixelFormat::RGBA8, PixelFormat::BGR8, PixelFormat::BGRA8 };
+  // One pixel, R=200 G=100 B=50 A=25, in each layout
+  const std::vector<uint8_t> samples[] = { { 124 }, { 200, 100, 50 }, { 200, 100, 50, 25 }, { 50, 100, 200 }, { 50, 100, 200, 25 } };
+
+  for (size_t s = 0; s < 5; ++s) {
+    for (size_t d = 0; d < 5; ++d) {
+      std::vector<uint8_t> out(4, 0);
+      ASSERT_TRUE(SSerializer::Utils::convertPixels(samples[s].data(), formats[s], out.data(), formats[d], 1));
+      out.resize(SSerializer::pixelFormatSize(formats[d]));
+
+      std::vector<uint8_t> expected = samples[d];
+      if (formats[s] == PixelFormat::R8 && formats[d] != PixelFormat::R8) {
+        expected.assign(expected.size(), 124);
+        if (expected.size() == 4) expected[3] = 255;
+      }
+      else if (expected.size() == 4 && samples[s].size() == 3) expected[3] = 255;
+      EXPECT_EQ(out, expected) << "from " << s << " to " << d;
+    }
+  }
+
+  uint8_t dummy = 0;
+  EXPECT_FALSE(SSerializer::Utils::convertPixels(&dummy, PixelFormat::Unknown, &dummy, PixelFormat::RGB8, 1));
+}
@@ -0,0 +1,351 @@
+#include "../test_helpers.hpp"
+
+#include "starlet-serializer/utils/inflate.hpp"
+#include "starlet-serializer/utils/png_filter.hpp"
+
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace {
+  using Starlet::Serializer::Utils::SimdLevel;
+  const SimdLevel LEVELS[] = { SimdLevel::Scalar, SimdLevel::Ssse3, SimdLevel::Avx2 };
+
+  void appendBe32(std::string& out, uint32_t value) {
+    for (int shift = 24; shift >= 0; shift -= 8) out += static_cast<char>(value >> shift);
+  }
+
+  uint32_t crc32(const std::string& data) {
+    uint32_t crc = 0xFFFFFFFF;
+    for (unsigned char byte : data) {
+      crc ^= byte;
+      for (int k = 0; k < 8; ++k) crc = (crc >> 1) ^ (0xEDB88320 & (0u - (crc & 1)));
+    }
+    return ~crc;
+  }
+
+  std::string chunk(const std::string& type, const std::string& data) {
+    std::string out;
+    appendBe32(out, static_cast<uint32_t>(data.size()));
+    appendBe32(out, crc32(type + data));
+    out.insert(4, type + data);
+    return out;
+  }
+
+  // zlib stream of stored blocks, so tests control the filtered bytes exactly
+  std::string storedZlib(const std::string& data) {
+    std::string out("\x78\x01", 2);
+    size_t offset = 0;
+    do {
+      const size_t length = std::min<size_t>(65535, data.size() - offset);
+      out += static_cast<char>(offset + length == data.size() ? 1 : 0);
+      out += static_cast<char>(length);
+      out += static_cast<char>(length >> 8);
+      out += static_cast<char>(~length);
+      out += static_cast<char>(~length >> 8);
+      out += data.substr(offset, length);
+      offset += length;
+    } while (offset < data.size());
+    appendBe32(out, SSerializer::Utils::adler32(reinterpret_cast<const uint8_t*>(data.data()), data.size()));
+    return out;
+  }
+
+  std::string ihdr(uint32_t width, uint32_t height, uint8_t depth, uint8_t colourType, uint8_t interlace = 0) {
+    std::string data;
+    appendBe32(data, width);
+    appendBe32(data, height);
+    data += static_cast<char>(depth);
+    data += static_cast<char>(colourType);
+    data += std::string(2, '\0');
+    data += static_cast<char>(interlace);
+    return chunk("IHDR", data);
+  }
+
+  // zlibData is split into `parts` IDAT chunks; extra chunks go before the first
+  std::string makePng(const std::string& header, const std::string& zlibData, const std::string& extra = "", size_t parts = 1) {
+    std::string png = std::string("\x89PNG\r\n\x1A\n", 8) + header + extra;
+    const size_t part = (zlibData.size() + parts - 1) / parts;
+    for (size_t offset = 0; offset < zlibData.size(); offset += part) png += chunk("IDAT", zlibData.substr(offset, part));
+    return png + chunk("IEND", "");
+  }
+
+  uint8_t paeth(int a, int b, int c) {
+    const int pa = std::abs(b - c), pb = std::abs(a - c), pc = std::abs(a + b - 2 * c);
+    return static_cast<uint8_t>(pa <= pb && pa <= pc ? a : pb <= pc ? b : c);
+  }
+
+  // Forward filter of raw rows, cycling the filter type per row
+  std::string filterRows(const std::string& raw, size_t rowBytes, size_t bpp, int firstFilter = 0) {
+    std::string out;
+    const std::string zero(rowBytes, '\0');
+    for (size_t y = 0; y * rowBytes < raw.size(); ++y) {
+      const uint8_t* row = reinterpret_cast<const uint8_t*>(raw.data() + y * rowBytes);
+      const uint8_t* prev = reinterpret_cast<const uint8_t*>(y == 0 ? zero.data() : raw.data() + (y - 1) * rowBytes);
+      const int filter = static_cast<int>((firstFilter + y) % 5);
+      out += static_cast<char>(filter);
+      for (size_t i = 0; i < rowBytes; ++i) {
+        const int a = i >= bpp ? row[i - bpp] : 0, b = prev[i], c = i >= bpp ? prev[i - bpp] : 0;
+        const int predictor = filter == 1 ? a : filter == 2 ? b : filter == 3 ? (a + b) / 2 : filter == 4 ? paeth(a, b, c) : 0;
+        out += static_cast<char>(row[i] - predictor);
+      }
+    }
+    return out;
+  }
+
+  std::string makeRaw(size_t bytes, uint32_t seed = 1) {
+    std::string raw(bytes, '\0');
+    for (size_t i = 0; i < bytes; ++i) {
+      seed = seed * 1103515245u + 12345u;
+      // Smooth ramps with some noise, so every predictor sees varied neighbours
+      raw[i] = static_cast<char>((i / 3) * 5 + ((seed >> 16) & 0x1F));
+    }
+    return raw;
+  }
+
+  std::vector<uint8_t> bytesOf(const std::string& s) { return std::vector<uint8_t>(s.begin(), s.end()); }
+
+  // 8x8 RGB, pixel (x, y) = (32x, 32y, 16(x + y)), filter None, compressed by zlib level 9
+  const std::vector<uint8_t> GRADIENT_IDAT = {
+    0x78, 0xDA, 0x0D, 0xC8, 0xD1, 0x00, 0x04, 0x31, 0x10, 0x03, 0xD0, 0x20, 0x2C, 0xC2, 0x20, 0x2C,
+    0x42, 0x10, 0x8A, 0x10, 0x84, 0x22, 0x04, 0xA1, 0x08, 0x41, 0x58, 0x84, 0x41, 0x38, 0x84, 0x41,
+    0xB9, 0xBE, 0xCF, 0x07, 0x00, 0x85, 0x87, 0x28, 0xE1, 0x35, 0x18, 0xAC, 0x86, 0x06, 0xFB, 0xF6,
+    0x53, 0x55, 0xAC, 0x57, 0x45, 0xD7, 0x4A, 0xA9, 0x6B, 0x4F, 0x19, 0xE0, 0xED, 0x97, 0xA4, 0xB8,
+    0x4C, 0x85, 0xBB, 0xE9, 0xE1, 0x01, 0xF4, 0x96, 0x6E, 0x2F, 0x49, 0xD6, 0x8E, 0xDC, 0x3A, 0xA3,
+    0x00, 0x66, 0x79, 0xD1, 0xB7, 0xB7, 0xED, 0xF8, 0xB4, 0x33, 0xFE, 0x80, 0xAC, 0x8A, 0x98, 0xAD,
+    0xDC, 0x3E, 0x49, 0x3A, 0xDF, 0xA4, 0x81, 0x56, 0xF5, 0x66, 0x5B, 0x7D, 0xDC, 0xB7, 0xBF, 0xEE,
+    0x9E, 0xFE, 0x01, 0xB3, 0x6B, 0xCC, 0x39, 0x9A, 0x78, 0xBE, 0xCC, 0xED, 0xDF, 0xCC, 0xFC, 0x01,
+    0xEE, 0x3F, 0x54, 0x01,
+  };
+}
+
+class PngParserTest : public ImageParserTest {
+protected:
+  SSerializer::ImageParseOptions withFormat(SSerializer::PixelFormat format) {
+    SSerializer::ImageParseOptions options;
+    options.format = format;
+    return options;
+  }
+};
+
+TEST_F(PngParserTest, CompressedRgb) {
+  createTestFile("test_data/gradient.png", makePng(ihdr(8, 8, 8, 2), std::string(GRADIENT_IDAT.begin(), GRADIENT_IDAT.end())));
+  expectValidParse("test_data/gradient.png", 8, 8);
+  for (uint32_t y = 0; y < 8; ++y) {
+    for (uint32_t x = 0; x < 8; ++x) {
+      const uint8_t* px = out.pixels.data() + (y * 8 + x) * 3;
+      ASSERT_EQ(px[0], x * 32);
+      ASSERT_EQ(px[1], y * 32);
+      ASSERT_EQ(px[2], (x + y) * 16);
+    }
+  }
+}
+
+TEST_F(PngParserTest, AllFilterTypesRgbAndRgba) {
+  for (uint8_t channels : { 3, 4 }) {
+    const uint32_t width = 37, height = 11;
+    const std::string raw = makeRaw(width * height * channels);
+    const std::string filtered = filterRows(raw, width * channels, channels);
+    createTestFile("test_data/filters.png", makePng(ihdr(width, height, 8, channels == 3 ? 2 : 6), storedZlib(filtered)));
+
+    ASSERT_TRUE(parser.parse("test_data/filters.png", out, withFormat(channels == 3 ? SSerializer::PixelFormat::RGB8 : SSerializer::PixelFormat::RGBA8)));
+    EXPECT_EQ(out.pixels, bytesOf(raw)) << "channels " << int(channels);
+  }
+}
+
+TEST_F(PngParserTest, UnfilterKernelsMatchScalar) {
+  for (size_t bpp : { 1, 2, 3, 4, 6, 8 }) {
+    for (size_t pixels : { 1, 5, 6, 16, 33, 100 }) {
+      const size_t rowBytes = pixels * bpp;
+      const std::string prevRow = makeRaw(rowBytes, 7), filteredRow = makeRaw(rowBytes, 11);
+      for (uint8_t filter = 1; filter <= 4; ++filter) {
+        std::vector<uint8_t> expected = bytesOf(filteredRow);
+        ASSERT_TRUE(SSerializer::Utils::unfilterRow(filter, expected.data(), reinterpret_cast<const uint8_t*>(prevRow.data()), rowBytes, bpp, SimdLevel::Scalar));
+        for (SimdLevel level : LEVELS) {
+          std::vector<uint8_t> row = bytesOf(filteredRow);
+          ASSERT_TRUE(SSerializer::Utils::unfilterRow(filter, row.data(), reinterpret_cast<const uint8_t*>(prevRow.data()), rowBytes, bpp, level));
+          ASSERT_EQ(row, expected) << "bpp " << bpp << " pixels " << pixels << " filter " << int(filter);
+        }
+      }
+    }
+  }
+
+  uint8_t row[4]{}, prev[4]{};
+  EXPECT_FALSE(SSerializer::Utils::unfilterRow(5, row, prev, 4, 1));
+}
+
+TEST_F(PngParserTest, SubByteGreyScalesToFullRange) {
+  // 1, 2 and 4-bit grey rows of five pixels, each holding the maximum then counting down
+  const struct { uint8_t depth; std::string row; std::vector<uint8_t> expected; } cases[] = {
+    { 1, std::string("\x00\xA8", 2), { 255, 0, 255, 0, 255 } },
+    { 2, std::string("\x00\xE4\x00", 3), { 255, 170, 85, 0, 0 } },
+    { 4, std::string("\x00\xFE\xDC\x00", 4), { 255, 238, 221, 204, 0 } },
+  };
+  for (const auto& c : cases) {
+    createTestFile("test_data/grey.png", makePng(ihdr(5, 1, c.depth, 0), storedZlib(c.row)));
+    ASSERT_TRUE(parser.parse("test_data/grey.png", out, withFormat(SSerializer::PixelFormat::R8)));
+    EXPECT_EQ(out.pixels, c.expected) << "depth " << int(c.depth);
+  }
+}
+
+TEST_F(PngParserTest, SixteenBitKeepsHighByte) {
+  // Truncated, not rounded: 0x9ABC reads as 0x9A and 0x80FF as 0x80
+  createTestFile("test_data/rgb16.png", makePng(ihdr(2, 1, 16, 2), storedZlib(std::string("\x00" "\x12\x34\x56\x78\x9A\xBC" "\xFF\x00\x80\x01\x00\xFF", 13))));
+  ASSERT_TRUE(parser.parse("test_data/rgb16.png", out));
+  EXPECT_EQ(out.pixels, (std::vector<uint8_t>{ 0x12, 0x56, 0x9A, 0xFF, 0x80, 0x00 }));
+
+  createTestFile("test_data/ga16.png", makePng(ihdr(1, 1, 16, 4), storedZlib(std::string("\x00" "\x40\x01\x7F\x02", 5))));
+  ASSERT_TRUE(parser.parse("test_data/ga16.png", out, withFormat(SSerializer::PixelFormat::RGBA8)));
+  EXPECT_EQ(out.pixels, (std::vector<uint8_t>{ 0x40, 0x40, 0x40, 0x7F }));
+}
+
+TEST_F(PngParserTest, ColourKeyBecomesAlpha) {
+  // 8-bit grey keyed on 0x20
+  createTestFile("test_data/grey_key.png", makePng(ihdr(3, 1, 8, 0), storedZlib(std::string("\x00\x10\x20\x30", 4)), chunk("tRNS", std::string("\x00\x20", 2))));
+  ASSERT_TRUE(parser.parse("test_data/grey_key.png", out, withFormat(SSerializer::PixelFormat::RGBA8)));
+  EXPECT_EQ(out.pixels, (std::vector<uint8_t>{ 0x10, 0x10, 0x10, 255,  0x20, 0x20, 0x20, 0,  0x30, 0x30, 0x30, 255 }));
+
+  // Without alpha in the output the key has nothing to write to
+  ASSERT_TRUE(parser.parse("test_data/grey_key.png", out, withFormat(SSerializer::PixelFormat::R8)));
+  EXPECT_EQ(out.pixels, (std::vector<uint8_t>{ 0x10, 0x20, 0x30 }));
+
+  // 2-bit grey keyed on 1, compared before scaling to 8 bits
+  createTestFile("test_data/grey2_key.png", makePng(ihdr(4, 1, 2, 0), storedZlib(std::string("\x00\x1B", 2)), chunk("tRNS", std::string("\x00\x01", 2))));
+  ASSERT_TRUE(parser.parse("test_data/grey2_key.png", out, withFormat(SSerializer::PixelFormat::BGRA8)));
+  EXPECT_EQ(out.pixels, (std::vector<uint8_t>{ 0, 0, 0, 255,  85, 85, 85, 0,  170, 170, 170, 255,  255, 255, 255, 255 }));
+}
+
+TEST_F(PngParserTest, ColourKeyDefaultsToRgba) {
+  // An ancillary chunk past the probe's first read puts tRNS beyond the fixed header
+  const std::string extra = chunk("tEXt", "Comment" + std::string(1, '\0') + std::string(200, 'x')) + chunk("tRNS", std::string("\x00\x20", 2));
+  createTestFile("test_data/grey_key_text.png", makePng(ihdr(3, 1, 8, 0), storedZlib(std::string("\x00\x10\x20\x30", 4)), extra));
+
+  SSerializer::ImageInfo info;
+  ASSERT_TRUE(parser.probe("test_data/grey_key_text.png", info));
+  EXPECT_EQ(info.sourceFormat, SSerializer::PixelFormat::RGBA8);
+  EXPECT_EQ(info.format, SSerializer::PixelFormat::RGBA8);
+
+  ASSERT_TRUE(parser.parse("test_data/grey_key_text.png", out));
+  EXPECT_EQ(out.format, SSerializer::PixelFormat::RGBA8);
+  EXPECT_EQ(out.pixels, (std::vector<uint8_t>{ 0x10, 0x10, 0x10, 255,  0x20, 0x20, 0x20, 0,  0x30, 0x30, 0x30, 255 }));
+
+  // Unkeyed grey still defaults to RGB8
+  createTestFile("test_data/grey_plain.png", makePng(ihdr(1, 1, 8, 0), storedZlib(std::string("\x00\x10", 2))));
+  ASSERT_TRUE(parser.probe("test_data/grey_plain.png", info));
+  EXPECT_EQ(info.format, SSerializer::PixelFormat::RGB8);
+}
+
+TEST_F(PngParserTest, SixteenBitColourKeyComparesFullSamples) {
+  // Both pixels truncate to the same 8-bit colour; only the exact 16-bit match is transparent
+  const std::string row("\x00" "\x12\x34\x56\x78\x9A\xBC" "\x12\x35\x56\x78\x9A\xBC", 13);
+  createTestFile("test_data/rgb16_key.png", makePng(ihdr(2, 1, 16, 2), storedZlib(row), chunk("tRNS", std::string("\x12\x34\x56\x78\x9A\xBC", 6))));
+  ASSERT_TRUE(parser.parse("test_data/rgb16_key.png", out, withFormat(SSerializer::PixelFormat::RGBA8)));
+  EXPECT_EQ(out.pixels, (std::vector<uint8_t>{ 0x12, 0x56, 0x9A, 0,  0x12, 0x56, 0x9A, 255 }));
+}
+
+TEST_F(PngParserTest, GreyAlphaExpandsToRgba) {
+  createTestFile("test_data/ga8.png", makePng(ihdr(2, 1, 8, 4), storedZlib(std::string("\x00" "\x10\x20\x30\x40", 5))));
+  SSerializer::ImageParseOptions native;
+  native.nativeLayout = true;
+  ASSERT_TRUE(parser.parse("test_data/ga8.png", out, native));
+  EXPECT_EQ(out.format, SSerializer::PixelFormat::RGBA8);
+  EXPECT_EQ(out.pixels, (std::vector<uint8_t>{ 0x10, 0x10, 0x10, 0x20, 0x30, 0x30, 0x30, 0x40 }));
+}
+
+TEST_F(PngParserTest, PaletteWithTransparency) {
+  const std::string palette("\xFF\x00\x00" "\x00\xFF\x00" "\x00\x00\xFF", 9);
+  const std::string extra = chunk("PLTE", palette) + chunk("tRNS", std::string("\x80\x00", 2));
+
+  // 4-bit indices 0, 1, 2, 1, 0 (odd width leaves half a byte)
+  createTestFile("test_data/pal4.png", makePng(ihdr(5, 1, 4, 3), storedZlib(std::string("\x00\x01\x21\x00", 4)), extra));
+  ASSERT_TRUE(parser.parse("test_data/pal4.png", out, withFormat(SSerializer::PixelFormat::RGBA8)));
+  EXPECT_EQ(out.pixels, (std::vector<uint8_t>{ 255, 0, 0, 0x80,  0, 255, 0, 0,  0, 0, 255, 255,  0, 255, 0, 0,  255, 0, 0, 0x80 }));
+
+  createTestFile("test_data/pal8.png", makePng(ihdr(2, 1, 8, 3), storedZlib(std::string("\x00\x02\x00", 3)), chunk("PLTE", palette)));
+  ASSERT_TRUE(parser.parse("test_data/pal8.png", out, withFormat(SSerializer::PixelFormat::RGB8)));
+  EXPECT_EQ(out.pixels, (std::vector<uint8_t>{ 0, 0, 255, 255, 0, 0 }));
+}
+
+TEST_F(PngParserTest, Adam7MatchesProgressive) {
+  for (uint32_t size : { 1u, 3u, 9u, 13u }) {
+    const uint32_t width = size, height = size + 2;
+    const std::string raw = makeRaw(width * height * 3, size);
+
+    // Gather each Adam7 pass as its own filtered sub-image
+    const uint32_t adam7[7][4] = { { 0, 0, 8, 8 }, { 4, 0, 8, 8 }, { 0, 4, 4, 8 }, { 2, 0, 4, 4 }, { 0, 2, 2, 4 }, { 1, 0, 2, 2 }, { 0, 1, 1, 2 } };
+    std::string interlaced;
+    for (const auto& pass : adam7) {
+      std::string sub;
+      uint32_t passWidth = 0;
+      for (uint32_t y = pass[1]; y < height; y += pass[3]) {
+        passWidth = 0;
+        for (uint32_t x = pass[0]; x < width; x += pass[2], ++passWidth) sub += raw.substr((y * width + x) * 3, 3);
+      }
+      if (passWidth > 0 && !sub.empty()) interlaced += filterRows(sub, passWidth * 3, 3, 4);
+    }
+
+    createTestFile("test_data/adam7.png", makePng(ihdr(width, height, 8, 2, 1), storedZlib(interlaced)));
+    ASSERT_TRUE(parser.parse("test_data/adam7.png", out));
+    EXPECT_EQ(out.pixels, bytesOf(raw)) << "size " << size;
+  }
+}
+
+TEST_F(PngParserTest, SplitIdatAndRowPitch) {
+  const std::string raw = makeRaw(6 * 4 * 4);
+  createTestFile("test_data/split.png", makePng(ihdr(6, 4, 8, 6), storedZlib(filterRows(raw, 24, 4)), "", 5));
+
+  SSerializer::ImageInfo info;
+  ASSERT_TRUE(parser.probe("test_data/split.png", info));
+  EXPECT_EQ(info.fileFormat, SSerializer::ImageFormat::PNG);
+  EXPECT_EQ(info.sourceFormat, SSerializer::PixelFormat::RGBA8);
+  EXPECT_EQ(info.width, 6u);
+  EXPECT_EQ(info.height, 4u);
+
+  const SSerializer::ImageParseOptions options = withFormat(SSerializer::PixelFormat::RGBA8);
+  std::vector<uint8_t> staging(32 * 3 + 24, 0xEE);
+  ASSERT_TRUE(parser.decode("test_data/split.png", staging.data(), staging.size(), 32, options));
+  for (size_t y = 0; y < 4; ++y)
+    EXPECT_EQ(std::vector<uint8_t>(staging.begin() + y * 32, staging.begin() + y * 32 + 24), bytesOf(raw.substr(y * 24, 24))) << y;
+  EXPECT_EQ(staging[24], 0xEE);
+}
+
+TEST_F(PngParserTest, InvalidHeaders) {
+  createTestFile("test_data/bad_depth.png", makePng(ihdr(2, 2, 4, 2), storedZlib(std::string(4, '\0'))));
+  testing::internal::CaptureStderr();
+  expectInvalidParse("test_data/bad_depth.png");
+  expectStderrContains({ "Unsupported PNG bit depth 4 for colour type 2" });
+
+  createTestFile("test_data/bad_type.png", makePng(ihdr(2, 2, 8, 5), storedZlib(std::string(4, '\0'))));
+  testing::internal::CaptureStderr();
+  expectInvalidParse("test_data/bad_type.png");
+  expectStderrContains({ "Unsupported PNG colour type: 5" });
+
+  std::string noIhdr = makePng(ihdr(2, 2, 8, 2), storedZlib(std::string(4, '\0')));
+  noIhdr[12] = 'X';
+  createTestFile("test_data/no_ihdr.png", noIhdr);
+  testing::internal::CaptureStderr();
+  expectInvalidParse("test_data/no_ihdr.png");
+  expectStderrContains({ "Missing IHDR chunk" });
+}
+
+TEST_F(PngParserTest, InvalidImageData) {
+  createTestFile("test_data/bad_filter.png", makePng(ihdr(1, 1, 8, 0), storedZlib(std::string("\x07\x00", 2))));
+  testing::internal::CaptureStderr();
+  expectInvalidParse("test_data/bad_filter.png");
+  expectStderrContains({ "Unknown filter type 7 in row 0" });
+
+  createTestFile("test_data/short_data.png", makePng(ihdr(4, 4, 8, 0), storedZlib(std::string(10, '\0'))));
+  testing::internal::CaptureStderr();
+  expectInvalidParse("test_data/short_data.png");
+  expectStderrContains({ "Corrupt or truncated image data" });
+
+  createTestFile("test_data/no_idat.png", std::string("\x89PNG\r\n\x1A\n", 8) + ihdr(1, 1, 8, 0) + chunk("IEND", ""));
+  testing::internal::CaptureStderr();
+  expectInvalidParse("test_data/no_idat.png");
+  expectStderrContains({ "No IDAT chunk" });
+
+  createTestFile("test_data/no_plte.png", makePng(ihdr(1, 1, 8, 3), storedZlib(std::string(2, '\0'))));
+  testing::internal::CaptureStderr();
+  expectInvalidParse("test_data/no_plte.png");
+  expectStderrContains({ "Palette image has no PLTE chunk" });
+}
@@ -0,0 +1,170 @@
+#include "../test_helpers.hpp"
+
+#include "starlet-serializer/utils/pixel_swizzle.hpp"
+#include "starlet-serializer/utils/qoi_codec.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace {
+  std::string qoiHeader(uint32_t width, uint32_t height, uint8_t channels, uint8_t colourspace = 0) {
+    std::string out = "qoif";
+    for (uint32_t value : { width, height })
+      for (int shift = 24; shift >= 0; shift -= 8) out += static_cast<char>(value >> shift);
+    out += static_cast<char>(channels);
+    out += static_cast<char>(colourspace);
+    return out;
+  }
+
+  const std::string END_MARKER("\0\0\0\0\0\0\0\x01", 8);
+
+  std::string encode(const std::vector<uint8_t>& pixels, uint32_t width, uint32_t height, uint8_t channels) {
+    std::vector<uint8_t> out;
+    SSerializer::Utils::QoiEncoder encoder(out, width, height, channels);
+    encoder.encode(pixels.data(), static_cast<size_t>(width) * height);
+    encoder.finish();
+    return std::string(out.begin(), out.end());
+  }
+
+  // Flat patches, gentle ramps, noise and alpha steps, so every op shows up
+  std::vector<uint8_t> makePixels(uint32_t width, uint32_t height, uint8_t channels, uint32_t seed = 1) {
+    std::vector<uint8_t> pixels(static_cast<size_t>(width) * height * channels);
+    for (uint32_t y = 0; y < height; ++y) {
+      for (uint32_t x = 0; x < width; ++x) {
+        seed = seed * 1103515245u + 12345u;
+        uint8_t* px = pixels.data() + (static_cast<size_t>(y) * width + x) * channels;
+        const uint32_t region = (x / 16 + y / 4) % 4;
+        const uint8_t noise = static_cast<uint8_t>(seed >> 16);
+        px[0] = region == 0 ? 200 : region == 1 ? static_cast<uint8_t>(x) : region == 2 ? noise : static_cast<uint8_t>(x * 3 + (noise & 7));
+        px[1] = region == 0 ? 100 : static_cast<uint8_t>(y * 2 + (region == 2 ? noise >> 1 : 0));
+        px[2] = region == 0 ? 50 : static_cast<uint8_t>(x + y);
+        if (channels == 4) px[3] = region == 3 ? static_cast<uint8_t>(x & 0xF0) : 255;
+      }
+    }
+    return pixels;
+  }
+}
+
+class QoiParserTest : public ImageParserTest {
+protected:
+  SSerializer::ImageParseOptions withFormat(SSerializer::PixelFormat format) {
+    SSerializer::ImageParseOptions options;
+    options.format = format;
+    return options;
+  }
+};
+
+TEST_F(QoiParserTest, EveryOpMatchesReferenceBytes) {
+  // RGB, DIFF (+1, 0, -1), LUMA (dg +10, dr-dg -3, db-dg +2), RUN 2, RGBA, INDEX 21
+  const std::string chunks("\xFE\x10\x20\x30" "\x79" "\xAA\x5A" "\xC1" "\xFF\x01\x02\x03\x80" "\x15", 14);
+  const std::vector<uint8_t> expected = {
+    16, 32, 48, 255,  17, 32, 47, 255,  24, 42, 59, 255,  24, 42, 59, 255,  24, 42, 59, 255,  1, 2, 3, 128,  16, 32, 48, 255
+  };
+
+  createTestFile("test_data/ops.qoi", qoiHeader(7, 1, 4) + chunks + END_MARKER);
+  ASSERT_TRUE(parser.parse("test_data/ops.qoi", out, withFormat(SSerializer::PixelFormat::RGBA8)));
+  EXPECT_EQ(out.pixels, expected);
+
+  EXPECT_EQ(encode(expected, 7, 1, 4), qoiHeader(7, 1, 4) + chunks + END_MARKER);
+}
+
+TEST_F(QoiParserTest, LeadingRunEntersIndex) {
+  // Three copies of the opening pixel, then INDEX 53, the slot it hashes to
+  createTestFile("test_data/leading_run.qoi", qoiHeader(4, 1, 4) + std::string("\xC2\x35", 2) + END_MARKER);
+  ASSERT_TRUE(parser.parse("test_data/leading_run.qoi", out, withFormat(SSerializer::PixelFormat::RGBA8)));
+  EXPECT_EQ(out.pixels, (std::vector<uint8_t>{ 0, 0, 0, 255, 0, 0, 0, 255, 0, 0, 0, 255, 0, 0, 0, 255 }));
+}
+
+TEST_F(QoiParserTest, IndexOpStoresAtItsHashSlot) {
+  // RGBA (1, 0, 0, 23) hashes to 0. INDEX 5 reads the unwritten zero colour, which moves to slot 0,
+  // so the final INDEX 0 reads zero too
+  createTestFile("test_data/index_store.qoi", qoiHeader(3, 1, 4) + std::string("\xFF\x01\x00\x00\x17" "\x05" "\x00", 7) + END_MARKER);
+  ASSERT_TRUE(parser.parse("test_data/index_store.qoi", out, withFormat(SSerializer::PixelFormat::RGBA8)));
+  EXPECT_EQ(out.pixels, (std::vector<uint8_t>{ 1, 0, 0, 23, 0, 0, 0, 0, 0, 0, 0, 0 }));
+}
+
+TEST_F(QoiParserTest, RoundTripsInEveryFormat) {
+  const SSerializer::PixelFormat formats[] = {
+    SSerializer::PixelFormat::RGB8, SSerializer::PixelFormat::RGBA8, SSerializer::PixelFormat::BGR8,
+    SSerializer::PixelFormat::BGRA8, SSerializer::PixelFormat::R8
+  };
+  for (uint8_t channels : { 3, 4 }) {
+    for (uint32_t width : { 1u, 5u, 64u, 131u }) {
+      const uint32_t height = 9;
+      const std::vector<uint8_t> pixels = makePixels(width, height, channels);
+      createTestFile("test_data/round_trip.qoi", encode(pixels, width, height, channels));
+
+      const SSerializer::PixelFormat source = channels == 4 ? SSerializer::PixelFormat::RGBA8 : SSerializer::PixelFormat::RGB8;
+      for (SSerializer::PixelFormat format : formats) {
+        std::vector<uint8_t> expected(static_cast<size_t>(width) * height * SSerializer::pixelFormatSize(format));
+        SSerializer::Utils::convertPixels(pixels.data(), source, expected.data(), format, static_cast<size_t>(width) * height);
+        ASSERT_TRUE(parser.parse("test_data/round_trip.qoi", out, withFormat(format)));
+        ASSERT_EQ(out.pixels, expected) << "channels " << int(channels) << " width " << width << " format " << int(format);
+      }
+    }
+  }
+}
+
+TEST_F(QoiParserTest, LongRunsSpanRows) {
+  // One RGB op, then 300 repeats as runs of up to 62 that cross the 7-pixel row boundaries
+  const std::vector<uint8_t> pixels(7 * 43 * 3, 0x5A);
+  const std::string file = encode(pixels, 7, 43, 3);
+  EXPECT_LT(file.size(), 14u + 8u + 10u);
+  createTestFile("test_data/runs.qoi", file);
+
+  ASSERT_TRUE(parser.parse("test_data/runs.qoi", out));
+  EXPECT_EQ(out.pixels, pixels);
+}
+
+TEST_F(QoiParserTest, ProbeAndDecodeWithRowPitch) {
+  const std::vector<uint8_t> pixels = makePixels(6, 4, 4);
+  createTestFile("test_data/pitch.qoi", encode(pixels, 6, 4, 4));
+
+  SSerializer::ImageInfo info;
+  ASSERT_TRUE(parser.probe("test_data/pitch.qoi", info));
+  EXPECT_EQ(info.fileFormat, SSerializer::ImageFormat::QOI);
+  EXPECT_EQ(info.sourceFormat, SSerializer::PixelFormat::RGBA8);
+  EXPECT_EQ(info.width, 6u);
+  EXPECT_EQ(info.height, 4u);
+
+  const SSerializer::ImageParseOptions options = withFormat(SSerializer::PixelFormat::RGBA8);
+  std::vector<uint8_t> staging(32 * 3 + 24, 0xEE);
+  ASSERT_TRUE(parser.decode("test_data/pitch.qoi", staging.data(), staging.size(), 32, options));
+  for (size_t y = 0; y < 4; ++y)
+    EXPECT_EQ(std::vector<uint8_t>(staging.begin() + y * 32, staging.begin() + y * 32 + 24), std::vector<uint8_t>(pixels.begin() + y * 24, pixels.begin() + y * 24 + 24)) << y;
+  EXPECT_EQ(staging[24], 0xEE);
+}
+
+TEST_F(QoiParserTest, InvalidFiles) {
+  createTestFile("test_data/bad_channels.qoi", qoiHeader(1, 1, 2) + "\xC0" + END_MARKER);
+  testing::internal::CaptureStderr();
+  expectInvalidParse("test_data/bad_channels.qoi");
+  expectStderrContains({ "Unsupported QOI channel count: 2" });
+
+  createTestFile("test_data/bad_colourspace.qoi", qoiHeader(1, 1, 3, 2) + "\xC0" + END_MARKER);
+  testing::internal::CaptureStderr();
+  expectInvalidParse("test_data/bad_colourspace.qoi");
+  expectStderrContains({ "Unsupported QOI colourspace: 2" });
+
+  createTestFile("test_data/zero_width.qoi", qoiHeader(0, 1, 3) + END_MARKER);
+  testing::internal::CaptureStderr();
+  expectInvalidParse("test_data/zero_width.qoi");
+  expectStderrContains({ "Invalid width: 0" });
+
+  createTestFile("test_data/short.qoi", qoiHeader(1, 1, 3));
+  testing::internal::CaptureStderr();
+  expectInvalidParse("test_data/short.qoi");
+  expectStderrContains({ "File too small" });
+
+  createTestFile("test_data/truncated.qoi", qoiHeader(4, 4, 3) + "\xC3" + END_MARKER);
+  testing::internal::CaptureStderr();
+  expectInvalidParse("test_data/truncated.qoi");
+  expectStderrContains({ "Truncated image data" });
+
+  // A run reaching into the end marker is cut off there
+  createTestFile("test_data/truncated_rows.qoi", qoiHeader(4, 4, 3) + "\xFE\x01\x02\x03\xC3" + END_MARKER);
+  testing::internal::CaptureStderr();
+  EXPECT_FALSE(parser.parse("test_data/truncated_rows.qoi", out, withFormat(SSerializer::PixelFormat::BGR8)));
+  expectStderrContains({ "Truncated image data at row 1" });
+}
@@ -106,13 +106,13 @@ TEST_F(TgaParserTest, Tga32Bit) {
     .build();
 
   createTestFile("test_data/tga32.tga", tga);
-  expectValidParse("test_data/tga32.tga", 2, 2);
+  expectValidParse("test_data/tga32.tga", 2, 2, 4);
 
-  EXPECT_EQ(out.pixelSize, 3);
-  EXPECT_EQ(out.byteSize, 12);
+  EXPECT_EQ(out.format, SSerializer::PixelFormat::RGBA8);
   EXPECT_EQ(out.pixels[0], 255);
   EXPECT_EQ(out.pixels[1], 0);
   EXPECT_EQ(out.pixels[2], 0);
+  EXPECT_EQ(out.pixels[3], 255);
 }
 
 TEST_F(TgaParserTest, WithIdField) {
@@ -192,7 +192,7 @@ TEST_F(TgaParserTest, UnsupportedImageType) {
     .setPixel(0, 1, 255, 0, 0)
     .setPixel(1, 1, 255, 255, 255)
     .build();
-  tga[2] = 1; // RLE compressed
+  tga[2] = 32; // Huffman/delta compressed
   createTestFile("test_data/bad_type.tga", tga);
 
   testing::internal::CaptureStderr();
@@ -208,7 +208,7 @@ TEST_F(TgaParserTest, WithColorMap) {
     .setPixel(0, 1, 255, 0, 0)
     .setPixel(1, 1, 255, 255, 255)
     .build();
-  tga[1] = 1; // Has colour map
+  tga[1] = 2; // Not a defined colour map type
   createTestFile("test_data/with_colourmap.tga", tga);
 
   testing::internal::CaptureStderr();
@@ -224,7 +224,7 @@ TEST_F(TgaParserTest, UnsupportedBitsPerPixel) {
     .setPixel(0, 1, 255, 0, 0)
     .setPixel(1, 1, 255, 255, 255)
     .build();
-  tga[16] = 16;
+  tga[16] = 12;
   createTestFile("test_data/bad_bpp.tga", tga);
 
   testing::internal::CaptureStderr();
@@ -287,4 +287,329 @@ TEST_F(TgaParserTest, FileNotFound) {
   expectInvalidParse("test_data/nonexistent.tga");
   const std::string output = testing::internal::GetCapturedStderr();
   EXPECT_NE(output.find("Failed to open file: test_data/nonexistent.tga"), std::string::npos);
-}
\ No newline at end of file
+}
+
+TEST_F(TgaParserTest, Tga32BitKeepsAlphaAsRgba) {
+  std::string tga = TgaBuilder(2, 1, 32)
+    .setPixel(0, 0, 10, 20, 30, 40)
+    .setPixel(1, 0, 50, 60, 70, 80)
+    .setTopDown()
+    .build();
+  createTestFile("test_data/tga32_rgba.tga", tga);
+
+  SSerializer::ImageParseOptions options;
+  options.format = SSerializer::PixelFormat::RGBA8;
+  ASSERT_TRUE(parser.parse("test_data/tga32_rgba.tga", out, options));
+  EXPECT_EQ(out.format, SSerializer::PixelFormat::RGBA8);
+  EXPECT_EQ(out.pixelSize, 4);
+  EXPECT_EQ(out.byteSize, 8u);
+  EXPECT_EQ(out.pixels, (std::vector<uint8_t>{ 10, 20, 30, 40, 50, 60, 70, 80 }));
+}
+
+TEST_F(TgaParserTest, Tga32BitAsBgraKeepsFileOrder) {
+  std::string tga = TgaBuilder(1, 1, 32).setPixel(0, 0, 10, 20, 30, 40).build();
+  createTestFile("test_data/tga32_bgra.tga", tga);
+
+  SSerializer::ImageParseOptions options;
+  options.format = SSerializer::PixelFormat::BGRA8;
+  ASSERT_TRUE(parser.parse("test_data/tga32_bgra.tga", out, options));
+  EXPECT_EQ(out.pixels, (std::vector<uint8_t>{ 30, 20, 10, 40 }));
+}
+
+TEST_F(TgaParserTest, Tga24BitAsRgbaAddsOpaqueAlpha) {
+  std::string tga = TgaBuilder(1, 1).setPixel(0, 0, 10, 20, 30).build();
+  createTestFile("test_data/tga24_rgba.tga", tga);
+
+  SSerializer::ImageParseOptions options;
+  options.format = SSerializer::PixelFormat::RGBA8;
+  ASSERT_TRUE(parser.parse("test_data/tga24_rgba.tga", out, options));
+  EXPECT_EQ(out.pixels, (std::vector<uint8_t>{ 10, 20, 30, 255 }));
+}
+
+TEST_F(TgaParserTest, DefaultFormatFollowsSourceAlpha) {
+  std::string tga = TgaBuilder(1, 1, 32).setPixel(0, 0, 10, 20, 30, 40).build();
+  createTestFile("test_data/tga32_default.tga", tga);
+  ASSERT_TRUE(parser.parse("test_data/tga32_default.tga", out));
+  EXPECT_EQ(out.format, SSerializer::PixelFormat::RGBA8);
+  EXPECT_EQ(out.pixels, (std::vector<uint8_t>{ 10, 20, 30, 40 }));
+
+  createTestFile("test_data/tga24_default.tga", TgaBuilder(1, 1).setPixel(0, 0, 10, 20, 30).build());
+  ASSERT_TRUE(parser.parse("test_data/tga24_default.tga", out));
+  EXPECT_EQ(out.format, SSerializer::PixelFormat::RGB8);
+  EXPECT_EQ(out.pixels, (std::vector<uint8_t>{ 10, 20, 30 }));
+}
+
+TEST_F(TgaParserTest, UnknownOutputFormatFails) {
+  createTestFile("test_data/tga_unknown_format.tga", TgaBuilder(1, 1).build());
+  SSerializer::ImageParseOptions options;
+  options.format = static_cast<SSerializer::PixelFormat>(0xFF);
+  testing::internal::CaptureStderr();
+  EXPECT_FALSE(parser.parse("test_data/tga_unknown_format.tga", out, options));
+  expectStderrContains({ "Unsupported output pixel format" });
+}
+
+TEST_F(TgaParserTest, NativeLayoutKeepsBgraAndBottomUpRows) {
+  std::string tga = TgaBuilder(1, 2, 32)
+    .setPixel(0, 0, 10, 20, 30, 40)
+    .setPixel(0, 1, 50, 60, 70, 80)
+    .build();
+  createTestFile("test_data/native.tga", tga);
+
+  SSerializer::ImageParseOptions options;
+  options.nativeLayout = true;
+  options.format = SSerializer::PixelFormat::R8; // Ignored in native mode
+  ASSERT_TRUE(parser.parse("test_data/native.tga", out, options));
+  EXPECT_EQ(out.format, SSerializer::PixelFormat::BGRA8);
+  EXPECT_TRUE(out.bottomUp);
+  EXPECT_EQ(out.pixels, (std::vector<uint8_t>{ 30, 20, 10, 40, 70, 60, 50, 80 }));
+}
+
+TEST_F(TgaParserTest, NativeLayoutTopDown24Bit) {
+  std::string tga = TgaBuilder(2, 1).setPixel(0, 0, 10, 20, 30).setPixel(1, 0, 40, 50, 60).setTopDown().build();
+  createTestFile("test_data/native_topdown.tga", tga);
+
+  SSerializer::ImageParseOptions options;
+  options.nativeLayout = true;
+  ASSERT_TRUE(parser.parse("test_data/native_topdown.tga", out, options));
+  EXPECT_EQ(out.format, SSerializer::PixelFormat::BGR8);
+  EXPECT_FALSE(out.bottomUp);
+  EXPECT_EQ(out.pixels, (std::vector<uint8_t>{ 30, 20, 10, 60, 50, 40 }));
+}
+
+TEST_F(TgaParserTest, ProbeReportsLayoutAndSize) {
+  std::string tga = TgaBuilder(3, 2, 32).build();
+  createTestFile("test_data/probe.tga", tga);
+
+  SSerializer::ImageInfo info;
+  SSerializer::ImageParseOptions options;
+  options.format = SSerializer::PixelFormat::RGBA8;
+  ASSERT_TRUE(parser.probe("test_data/probe.tga", info, options));
+  EXPECT_EQ(info.width, 3u);
+  EXPECT_EQ(info.height, 2u);
+  EXPECT_EQ(info.sourceFormat, SSerializer::PixelFormat::BGRA8);
+  EXPECT_TRUE(info.sourceBottomUp);
+  EXPECT_EQ(info.format, SSerializer::PixelFormat::RGBA8);
+  EXPECT_FALSE(info.bottomUp);
+  EXPECT_EQ(info.rowSize, 12u);
+  EXPECT_EQ(info.byteSize, 24u);
+}
+
+TEST_F(TgaParserTest, ProbeRejectsTruncatedFile) {
+  std::string tga = TgaBuilder(4, 4).build();
+  tga.resize(30);
+  createTestFile("test_data/probe_truncated.tga", tga);
+
+  SSerializer::ImageInfo info;
+  testing::internal::CaptureStderr();
+  EXPECT_FALSE(parser.probe("test_data/probe_truncated.tga", info));
+  expectStderrContains({ "File too small for declared dimensions" });
+}
+
+TEST_F(TgaParserTest, DecodeWritesRowsAtCallerPitch) {
+  std::string tga = TgaBuilder(2, 2, 32)
+    .setPixel(0, 0, 1, 2, 3, 4).setPixel(1, 0, 5, 6, 7, 8)
+    .setPixel(0, 1, 9, 10, 11, 12).setPixel(1, 1, 13, 14, 15, 16)
+    .setTopDown()
+    .build();
+  createTestFile("test_data/decode_pitch.tga", tga);
+
+  SSerializer::ImageParseOptions options;
+  options.format = SSerializer::PixelFormat::RGBA8;
+  std::vector<uint8_t> staging(12 + 8, 0xAA); // 12-byte pitch, last row tight
+  ASSERT_TRUE(parser.decode("test_data/decode_pitch.tga", staging.data(), staging.size(), 12, options));
+  EXPECT_EQ(staging, (std::vector<uint8_t>{ 1, 2, 3, 4, 5, 6, 7, 8, 0xAA, 0xAA, 0xAA, 0xAA, 9, 10, 11, 12, 13, 14, 15, 16 }));
+}
+
+TEST_F(TgaParserTest, DecodeNativeLayoutCopiesPixelBlock) {
+  std::string tga = TgaBuilder(2, 1).setPixel(0, 0, 1, 2, 3).setPixel(1, 0, 4, 5, 6).build();
+  createTestFile("test_data/decode_native.tga", tga);
+
+  SSerializer::ImageParseOptions options;
+  options.nativeLayout = true;
+  std::vector<uint8_t> staging(6, 0);
+  ASSERT_TRUE(parser.decode("test_data/decode_native.tga", staging.data(), staging.size(), 6, options));
+  EXPECT_EQ(staging, (std::vector<uint8_t>{ 3, 2, 1, 6, 5, 4 }));
+}
+
+TEST_F(TgaParserTest, DecodeRejectsSmallPitchAndBuffer) {
+  createTestFile("test_data/decode_small.tga", TgaBuilder(2, 2).build());
+  std::vector<uint8_t> staging(12, 0);
+
+  testing::internal::CaptureStderr();
+  EXPECT_FALSE(parser.decode("test_data/decode_small.tga", staging.data(), staging.size(), 5));
+  expectStderrContains({ "Row pitch too small: 5 bytes, need 6 bytes" });
+
+  testing::internal::CaptureStderr();
+  EXPECT_FALSE(parser.decode("test_data/decode_small.tga", staging.data(), staging.size(), 8));
+  expectStderrContains({ "Destination buffer too small: 12 bytes, need 14 bytes" });
+
+  testing::internal::CaptureStderr();
+  EXPECT_FALSE(parser.decode("test_data/decode_small.tga", nullptr, 0, 6));
+  expectStderrContains({ "Null destination buffer" });
+}
+
+TEST_F(TgaParserTest, HeaderDetectedWithoutExtension) {
+  createTestFile("test_data/tga_no_extension", TgaBuilder(2, 2, 32).build());
+  expectValidParse("test_data/tga_no_extension", 2, 2, 4);
+
+  SSerializer::ImageInfo info;
+  ASSERT_TRUE(parser.probe("test_data/tga_no_extension", info));
+  EXPECT_EQ(info.fileFormat, SSerializer::ImageFormat::TGA);
+  EXPECT_EQ(info.sourceFormat, SSerializer::PixelFormat::BGRA8);
+}
+
+namespace {
+  // Raw TGA with an optional colour map and arbitrary (possibly RLE) pixel bytes
+  std::string makeTga(uint8_t imageType, uint8_t bpp, uint16_t width, uint16_t height, const std::string& pixels,
+                      uint8_t mapEntrySize = 0, const std::string& colourMap = "", uint16_t mapFirst = 0, uint8_t descriptor = 0x20) {
+    std::string data(18, '\0');
+    const uint16_t mapLength = mapEntrySize ? static_cast<uint16_t>(colourMap.size() / ((mapEntrySize + 7) / 8)) : 0;
+    data[1] = mapEntrySize ? 1 : 0;
+    data[2] = static_cast<char>(imageType);
+    *reinterpret_cast<uint16_t*>(&data[3]) = mapFirst;
+    *reinterpret_cast<uint16_t*>(&data[5]) = mapLength;
+    data[7] = static_cast<char>(mapEntrySize);
+    *reinterpret_cast<uint16_t*>(&data[12]) = width;
+    *reinterpret_cast<uint16_t*>(&data[14]) = height;
+    data[16] = static_cast<char>(bpp);
+    data[17] = static_cast<char>(descriptor);
+    return data + colourMap + pixels;
+  }
+
+  // Greedy RLE over the whole pixel stream, letting packets run across rows
+  std::string encodeRle(const std::string& raw, size_t pixelSize) {
+    std::string out;
+    const size_t count = raw.size() / pixelSize;
+    auto same = [&](size_t a, size_t b) { return raw.compare(a * pixelSize, pixelSize, raw, b * pixelSize, pixelSize) == 0; };
+    for (size_t i = 0; i < count;) {
+      size_t run = 1;
+      while (i + run < count && run < 128 && same(i, i + run)) ++run;
+      if (run > 1) {
+        out += static_cast<char>(0x80 | (run - 1));
+        out += raw.substr(i * pixelSize, pixelSize);
+        i += run;
+        continue;
+      }
+      size_t literal = 1;
+      while (i + literal < count && literal < 128 && !(i + literal + 1 < count && same(i + literal, i + literal + 1))) ++literal;
+      out += static_cast<char>(literal - 1);
+      out += raw.substr(i * pixelSize, literal * pixelSize);
+      i += literal;
+    }
+    return out;
+  }
+
+  // Pixel bytes mixing long runs with noise
+  std::string makeRaw(size_t pixels, size_t pixelSize) {
+    std::string raw(pixels * pixelSize, '\0');
+    for (size_t i = 0; i < pixels; ++i)
+      for (size_t c = 0; c < pixelSize; ++c)
+        raw[i * pixelSize + c] = static_cast<char>(((i / 37) % 3 == 0) ? (i * 13 + c * 7) : (i / 37) * 11 + c);
+    return raw;
+  }
+}
+
+TEST_F(TgaParserTest, RleTrueColourMatchesUncompressed) {
+  for (uint8_t bpp : { 24, 32 }) {
+    const size_t pixelSize = bpp / 8;
+    const std::string raw = makeRaw(61 * 17, pixelSize);
+    createTestFile("test_data/raw.tga", makeTga(2, bpp, 61, 17, raw, 0, "", 0, 0));
+    createTestFile("test_data/rle.tga", makeTga(10, bpp, 61, 17, encodeRle(raw, pixelSize), 0, "", 0, 0));
+
+    for (SSerializer::PixelFormat format : { SSerializer::PixelFormat::RGB8, SSerializer::PixelFormat::RGBA8, SSerializer::PixelFormat::BGRA8 }) {
+      SSerializer::ImageParseOptions options;
+      options.format = format;
+      SSerializer::ImageData expected;
+      ASSERT_TRUE(parser.parse("test_data/raw.tga", expected, options));
+      ASSERT_TRUE(parser.parse("test_data/rle.tga", out, options));
+      EXPECT_EQ(out.pixels, expected.pixels) << "bpp " << int(bpp);
+    }
+
+    SSerializer::ImageParseOptions native;
+    native.nativeLayout = true;
+    ASSERT_TRUE(parser.parse("test_data/rle.tga", out, native));
+    EXPECT_TRUE(out.bottomUp);
+    EXPECT_EQ(std::string(out.pixels.begin(), out.pixels.end()), raw);
+  }
+}
+
+TEST_F(TgaParserTest, RleLongRunsFillWholeRows) {
+  // One 128-pixel run spanning two 100-pixel rows, then a second run
+  std::string body;
+  body += static_cast<char>(0xFF); body += std::string("\x01\x02\x03\x04", 4);
+  body += static_cast<char>(0x80 | 71); body += std::string("\x05\x06\x07\x08", 4);
+  createTestFile("test_data/rle_runs.tga", makeTga(10, 32, 100, 2, body));
+
+  SSerializer::ImageParseOptions options;
+  options.format = SSerializer::PixelFormat::RGBA8;
+  ASSERT_TRUE(parser.parse("test_data/rle_runs.tga", out, options));
+  for (size_t i = 0; i < 200; ++i) {
+    const uint8_t* px = out.pixels.data() + i * 4;
+    if (i < 128) EXPECT_EQ(std::vector<uint8_t>(px, px + 4), (std::vector<uint8_t>{ 3, 2, 1, 4 })) << i;
+    else         EXPECT_EQ(std::vector<uint8_t>(px, px + 4), (std::vector<uint8_t>{ 7, 6, 5, 8 })) << i;
+  }
+}
+
+TEST_F(TgaParserTest, RleGreyscale) {
+  const std::string raw = makeRaw(9 * 7, 1);
+  createTestFile("test_data/rle_grey.tga", makeTga(11, 8, 9, 7, encodeRle(raw, 1)));
+
+  SSerializer::ImageParseOptions options;
+  options.format = SSerializer::PixelFormat::R8;
+  ASSERT_TRUE(parser.parse("test_data/rle_grey.tga", out, options));
+  EXPECT_EQ(std::string(out.pixels.begin(), out.pixels.end()), raw);
+
+  ASSERT_TRUE(parser.parse("test_data/rle_grey.tga", out));
+  EXPECT_EQ(out.pixels[3], static_cast<uint8_t>(raw[1]));
+  EXPECT_EQ(out.pixels[4], static_cast<uint8_t>(raw[1]));
+  EXPECT_EQ(out.pixels[5], static_cast<uint8_t>(raw[1]));
+}
+
+TEST_F(TgaParserTest, ColourMappedUncompressedAndRle) {
+  // Map entries 10..12 as 24-bit BGR
+  const std::string map("\x01\x02\x03" "\x04\x05\x06" "\x07\x08\x09", 9);
+  const std::string indices("\x0A\x0B\x0C\x0C\x0C\x0A", 6);
+  const std::vector<uint8_t> expected{ 3, 2, 1, 6, 5, 4, 9, 8, 7, 9, 8, 7, 9, 8, 7, 3, 2, 1 };
+
+  createTestFile("test_data/mapped.tga", makeTga(1, 8, 3, 2, indices, 24, map, 10));
+  ASSERT_TRUE(parser.parse("test_data/mapped.tga", out));
+  EXPECT_EQ(out.pixels, expected);
+
+  createTestFile("test_data/mapped_rle.tga", makeTga(9, 8, 3, 2, encodeRle(indices, 1), 24, map, 10));
+  ASSERT_TRUE(parser.parse("test_data/mapped_rle.tga", out));
+  EXPECT_EQ(out.pixels, expected);
+}
+
+TEST_F(TgaParserTest, ColourMapWithAlphaEntries) {
+  const std::string map("\x01\x02\x03\x80" "\x04\x05\x06\x40", 8);
+  createTestFile("test_data/mapped32.tga", makeTga(1, 8, 2, 1, std::string("\x01\x00", 2), 32, map));
+
+  SSerializer::ImageParseOptions options;
+  options.format = SSerializer::PixelFormat::RGBA8;
+  ASSERT_TRUE(parser.parse("test_data/mapped32.tga", out, options));
+  EXPECT_EQ(out.pixels, (std::vector<uint8_t>{ 6, 5, 4, 0x40, 3, 2, 1, 0x80 }));
+}
+
+TEST_F(TgaParserTest, TrueColour16Bit) {
+  // 0x7C00 is full red, 0x03E0 full green, 0x001F full blue
+  createTestFile("test_data/tga16.tga", makeTga(2, 16, 3, 1, std::string("\x00\x7C\xE0\x03\x1F\x00", 6)));
+  ASSERT_TRUE(parser.parse("test_data/tga16.tga", out));
+  EXPECT_EQ(out.pixels, (std::vector<uint8_t>{ 255, 0, 0, 0, 255, 0, 0, 0, 255 }));
+}
+
+TEST_F(TgaParserTest, TruncatedRleFails) {
+  std::string body;
+  body += static_cast<char>(0x83); body += std::string("\x01\x02\x03", 3);
+  createTestFile("test_data/rle_truncated.tga", makeTga(10, 24, 4, 2, body));
+
+  testing::internal::CaptureStderr();
+  expectInvalidParse("test_data/rle_truncated.tga");
+  expectStderrContains({ "RLE data ends early at row 1" });
+}
+
+TEST_F(TgaParserTest, ColourMappedWithoutMapFails) {
+  createTestFile("test_data/mapped_no_map.tga", makeTga(1, 8, 2, 1, std::string(2, '\0')));
+  testing::internal::CaptureStderr();
+  expectInvalidParse("test_data/mapped_no_map.tga");
+  expectStderrContains({ "Colour-mapped TGA has no colour map" });
+}
@@ -65,4 +65,26 @@ TEST_F(ImageParserTest, DetectFormatEmptyExtension) {
   testing::internal::CaptureStderr();
   expectInvalidParse("test_data/image.");
   expectStderrContains({ "Unsupported image format: test_data/image." });
-}
\ No newline at end of file
+}
+
+// Signature detection
+TEST_F(ImageParserTest, DetectFormatFromSignatures) {
+  std::string png("\x89PNG\r\n\x1A\n", 8);
+  png.resize(40, '\0');
+  createTestFile("test_data/signature_png", png);
+  EXPECT_EQ(parser.detectFormat("test_data/signature_png"), SSerializer::ImageFormat::PNG);
+
+  std::string qoi = "qoif";
+  qoi.resize(20, '\0');
+  createTestFile("test_data/signature_qoi.bmp", qoi);
+  EXPECT_EQ(parser.detectFormat("test_data/signature_qoi.bmp"), SSerializer::ImageFormat::QOI);
+}
+
+TEST_F(ImageParserTest, DetectFormatShortSignatureFallsBackToExtension) {
+  createTestFile("test_data/short_signature.tga", "BM");
+  EXPECT_EQ(parser.detectFormat("test_data/short_signature.tga"), SSerializer::ImageFormat::TGA);
+}
+
+TEST_F(ImageParserTest, DetectFormatMissingFileUsesExtension) {
+  EXPECT_EQ(parser.detectFormat("test_data/missing_file.bmp"), SSerializer::ImageFormat::BMP);
+}
@@ -0,0 +1,291 @@
+#include "../test_helpers.hpp"
+
+#include "starlet-serializer/parser/mesh/mesh_cache_parser.hpp"
+#include "starlet-serializer/data/mesh_cache_data.hpp"
+#include "starlet-serializer/processor/mesh/meshlet_builder.hpp"
+#include "starlet-serializer/processor/mesh/bvh_builder.hpp"
+#include "starlet-serializer/processor/mesh/collision_builder.hpp"
+#include "starlet-serializer/writer/writer.hpp"
+#include "starlet-serializer/utils/vec_ops.hpp"
+
+#include <array>
+#include <cmath>
+#include <filesystem>
+
+class MeshCacheTest : public ::testing::Test {
+protected:
+  SSerializer::Writer writer;
+  SSerializer::MeshCacheParser parser;
+  SSerializer::MeshCacheData out;
+};
+
+TEST_F(MeshCacheTest, RoundTripMesh) {
+  SSerializer::MeshCacheData data;
+  data.mesh = makeGridMesh(3);
+  data.mesh.vertices[4].norm = { 0.0f, 0.0f, 1.0f };
+  data.mesh.vertices[5].texCoord = { 0.25f, 0.75f };
+  data.mesh.hasNormals = data.mesh.hasTexCoords = true;
+  data.mesh.tangents.assign(data.mesh.vertices.size(), Starlet::Math::Vec4<float>{ 1.0f, 0.0f, 0.0f, -1.0f });
+  data.mesh.hasTangents = true;
+  data.mesh.maxY = 1.0f;
+
+  ASSERT_TRUE(writer.writeMeshCache(data, "test_data/grid.smesh"));
+  ASSERT_TRUE(parser.parse("test_data/grid.smesh", out));
+  EXPECT_EQ(out.mesh.numVertices, data.mesh.numVertices);
+  EXPECT_EQ(out.mesh.numTriangles, data.mesh.numTriangles);
+  EXPECT_EQ(out.mesh.indices, data.mesh.indices);
+  EXPECT_TRUE(out.mesh.hasNormals);
+  EXPECT_TRUE(out.mesh.hasTexCoords);
+  EXPECT_FALSE(out.mesh.hasColours);
+  EXPECT_TRUE(out.mesh.hasTangents);
+  EXPECT_FLOAT_EQ(out.mesh.vertices[4].norm.z, 1.0f);
+  EXPECT_FLOAT_EQ(out.mesh.vertices[5].texCoord.y, 0.75f);
+  EXPECT_FLOAT_EQ(out.mesh.tangents[2].w, -1.0f);
+  EXPECT_FLOAT_EQ(out.mesh.maxY, 1.0f);
+  EXPECT_FALSE(out.hasMeshlets);
+}
+
+TEST_F(MeshCacheTest, RoundTripMeshlets) {
+  SSerializer::MeshCacheData data;
+  data.mesh = makeGridMesh(12);
+  SSerializer::MeshletBuilder builder;
+  ASSERT_TRUE(builder.build(data.mesh, data.meshlets, 32, 32));
+  data.hasMeshlets = true;
+
+  ASSERT_TRUE(writer.writeMeshCache(data, "test_data/meshlets.smesh"));
+  ASSERT_TRUE(parser.parse("test_data/meshlets.smesh", out));
+  ASSERT_TRUE(out.hasMeshlets);
+  ASSERT_EQ(out.meshlets.meshlets.size(), data.meshlets.meshlets.size());
+  EXPECT_EQ(out.meshlets.vertices, data.meshlets.vertices);
+  EXPECT_EQ(out.meshlets.triangles, data.meshlets.triangles);
+  EXPECT_EQ(out.meshlets.maxVertices, 32u);
+  EXPECT_EQ(out.meshlets.meshlets[1].triangleOffset, data.meshlets.meshlets[1].triangleOffset);
+  EXPECT_FLOAT_EQ(out.meshlets.meshlets[1].radius, data.meshlets.meshlets[1].radius);
+  EXPECT_FLOAT_EQ(out.meshlets.meshlets[1].coneCutoff, data.meshlets.meshlets[1].coneCutoff);
+}
+
+TEST_F(MeshCacheTest, RoundTripCompressedMesh) {
+  SSerializer::MeshCacheData data;
+  data.mesh = makeGridMesh(16, 2.0f);
+  data.mesh.vertices[7].texCoord = { 0.5f, 0.125f };
+  data.mesh.hasTexCoords = true;
+  data.compressed = true;
+
+  ASSERT_TRUE(writer.writeMeshCache(data, "test_data/compressed.smesh"));
+  SSerializer::MeshCacheData uncompressed;
+  uncompressed.mesh = data.mesh;
+  ASSERT_TRUE(writer.writeMeshCache(uncompressed, "test_data/uncompressed.smesh"));
+  EXPECT_LT(std::filesystem::file_size("test_data/compressed.smesh"), std::filesystem::file_size("test_data/uncompressed.smesh") / 4);
+
+  ASSERT_TRUE(parser.parse("test_data/compressed.smesh", out));
+  EXPECT_TRUE(out.compressed);
+  EXPECT_EQ(out.mesh.indices, data.mesh.indices);
+  EXPECT_EQ(out.mesh.numTriangles, data.mesh.numTriangles);
+  EXPECT_TRUE(out.mesh.hasTexCoords);
+  EXPECT_NEAR(out.mesh.vertices[7].texCoord.y, 0.125f, 1e-4f);
+  EXPECT_NEAR(out.mesh.vertices[9].pos.x, data.mesh.vertices[9].pos.x, 1e-4f);
+  EXPECT_FLOAT_EQ(out.mesh.boundsMax.z, 2.0f);
+}
+
+TEST_F(MeshCacheTest, CompressedDerivedChunksBoundDecodedMesh) {
+  // Irregular positions so quantization moves nearly every vertex
+  SSerializer::MeshCacheData data;
+  data.mesh = makeGridMesh(16);
+  for (size_t i = 0; i < data.mesh.vertices.size(); ++i) {
+    Starlet::Math::Vec3<float>& p = data.mesh.vertices[i].pos;
+    p.x += 0.01f * std::sin(float(i) * 1.7f);
+    p.y += 0.01f * std::cos(float(i) * 2.3f);
+    p.z = 0.3f * std::sin(p.x * 5.0f) * std::cos(p.y * 3.0f);
+  }
+  ASSERT_TRUE(SSerializer::BvhBuilder().build(data.mesh, data.bvh, 1));
+  ASSERT_TRUE(SSerializer::MeshletBuilder().build(data.mesh, data.meshlets, 16, 8));
+  ASSERT_TRUE(SSerializer::CollisionBuilder().build(data.mesh, data.collision));
+  data.compressed = data.hasBvh = data.hasMeshlets = data.hasCollision = true;
+
+  ASSERT_TRUE(writer.writeMeshCache(data, "test_data/compressed_derived.smesh"));
+  ASSERT_TRUE(parser.parse("test_data/compressed_derived.smesh", out));
+  ASSERT_EQ(out.bvh.triangles, data.bvh.triangles);
+
+  const auto position = [&](unsigned int v) {
+    const Starlet::Math::Vec3<float>& p = out.mesh.vertices[v].pos;
+    return std::array<float, 3>{ p.x, p.y, p.z };
+  };
+  for (const SSerializer::BvhNode& node : out.bvh.nodes) {
+    if (!node.isLeaf()) continue;
+    for (uint32_t i = node.leftFirst; i < node.leftFirst + node.count; ++i)
+      for (size_t k = 0; k < 3; ++k) {
+        const std::array<float, 3> p = position(out.mesh.indices[out.bvh.triangles[i] * 3 + k]);
+        for (int a = 0; a < 3; ++a) {
+          EXPECT_GE(p[a], node.boundsMin[a]);
+          EXPECT_LE(p[a], node.boundsMax[a]);
+        }
+      }
+  }
+
+  for (const SSerializer::Meshlet& m : out.meshlets.meshlets)
+    for (unsigned int i = 0; i < m.vertexCount; ++i) {
+      const std::array<float, 3> p = position(out.meshlets.vertices[m.vertexOffset + i]);
+      const float dx = p[0] - m.center.x, dy = p[1] - m.center.y, dz = p[2] - m.center.z;
+      EXPECT_LE(std::sqrt(dx * dx + dy * dy + dz * dz), m.radius * (1.0f + 1e-6f));
+    }
+
+  // The first three 26-DOP slabs are the axis-aligned bounds
+  for (unsigned int v = 0; v < out.mesh.numVertices; ++v) {
+    const std::array<float, 3> p = position(v);
+    for (int a = 0; a < 3; ++a) {
+      EXPECT_GE(p[a], out.collision.kdop.min[a]);
+      EXPECT_LE(p[a], out.collision.kdop.max[a]);
+    }
+  }
+
+  // The hull keeps its topology and every decoded vertex stays inside each face plane
+  ASSERT_EQ(out.collision.hull.indices, data.collision.hull.indices);
+  const std::vector<Starlet::Math::Vec3<float>>& hull = out.collision.hull.vertices;
+  for (size_t t = 0; t < out.collision.hull.indices.size(); t += 3) {
+    const Starlet::Math::Vec3<float>& a = hull[out.collision.hull.indices[t]];
+    const Starlet::Math::Vec3<float> n = SSerializer::Utils::normalize(SSerializer::Utils::cross(
+      SSerializer::Utils::sub(hull[out.collision.hull.indices[t + 1]], a), SSerializer::Utils::sub(hull[out.collision.hull.indices[t + 2]], a)));
+    for (const Starlet::Math::Vertex& v : out.mesh.vertices)
+      EXPECT_LE(SSerializer::Utils::dot(n, SSerializer::Utils::sub(v.pos, a)), 1e-6f);
+  }
+}
+
+TEST_F(MeshCacheTest, CompressedKeepsCallerCollisionProxies) {
+  // A flat mesh has no quickhull of its own; the caller's box proxy must still be written
+  SSerializer::MeshCacheData data;
+  data.mesh = makeGridMesh(8);
+  std::vector<Starlet::Math::Vec3<float>> box;
+  for (int c = 0; c < 8; ++c) box.push_back({ float(c & 1), float((c >> 1) & 1), float((c >> 2) & 1) * 0.5f - 0.25f });
+  SSerializer::CollisionBuilder builder;
+  ASSERT_TRUE(builder.buildHull(box, data.collision.hull, 8));
+  builder.buildKDop(box, data.collision.kdop);
+  builder.buildObb(box, data.collision.obb);
+  data.compressed = data.hasCollision = true;
+
+  ASSERT_TRUE(writer.writeMeshCache(data, "test_data/compressed_proxies.smesh"));
+  ASSERT_TRUE(parser.parse("test_data/compressed_proxies.smesh", out));
+  ASSERT_TRUE(out.hasCollision);
+  ASSERT_EQ(out.collision.hull.vertices.size(), 8u);
+  EXPECT_EQ(out.collision.hull.indices, data.collision.hull.indices);
+  // Grown by no more than a fraction of a quantization step
+  EXPECT_NEAR(out.collision.kdop.max[2], 0.25f, 1e-4f);
+  EXPECT_GE(out.collision.kdop.max[2], 0.25f);
+  EXPECT_NEAR(out.collision.obb.halfExtents.z, data.collision.obb.halfExtents.z, 1e-4f);
+}
+
+TEST_F(MeshCacheTest, RoundTripBvh) {
+  SSerializer::MeshCacheData data;
+  data.mesh = makeGridMesh(12);
+  SSerializer::BvhBuilder builder;
+  ASSERT_TRUE(builder.build(data.mesh, data.bvh));
+  data.hasBvh = true;
+
+  ASSERT_TRUE(writer.writeMeshCache(data, "test_data/bvh.smesh"));
+  ASSERT_TRUE(parser.parse("test_data/bvh.smesh", out));
+  ASSERT_TRUE(out.hasBvh);
+  ASSERT_EQ(out.bvh.nodes.size(), data.bvh.nodes.size());
+  EXPECT_EQ(out.bvh.triangles, data.bvh.triangles);
+  EXPECT_EQ(out.bvh.nodes[0].leftFirst, data.bvh.nodes[0].leftFirst);
+  EXPECT_FLOAT_EQ(out.bvh.nodes.back().boundsMax[1], data.bvh.nodes.back().boundsMax[1]);
+
+  SSerializer::RayHit hit;
+  EXPECT_TRUE(SSerializer::BvhQuery().raycast(out.mesh, out.bvh, { 0.3f, 0.7f, 1.0f }, { 0.0f, 0.0f, -1.0f }, hit));
+}
+
+TEST_F(MeshCacheTest, RoundTripCollision) {
+  SSerializer::MeshCacheData data;
+  data.mesh = makeGridMesh(4);
+  for (Starlet::Math::Vertex& v : data.mesh.vertices) v.pos.z = v.pos.x * v.pos.y;
+  SSerializer::CollisionBuilder builder;
+  ASSERT_TRUE(builder.build(data.mesh, data.collision));
+  data.hasCollision = true;
+
+  ASSERT_TRUE(writer.writeMeshCache(data, "test_data/collision.smesh"));
+  ASSERT_TRUE(parser.parse("test_data/collision.smesh", out));
+  ASSERT_TRUE(out.hasCollision);
+  EXPECT_FALSE(out.hasBvh);
+  EXPECT_EQ(out.collision.hull.indices, data.collision.hull.indices);
+  ASSERT_EQ(out.collision.hull.vertices.size(), data.collision.hull.vertices.size());
+  EXPECT_FLOAT_EQ(out.collision.hull.vertices[2].y, data.collision.hull.vertices[2].y);
+  EXPECT_FLOAT_EQ(out.collision.kdop.max[5], data.collision.kdop.max[5]);
+  EXPECT_FLOAT_EQ(out.collision.obb.axes[1].x, data.collision.obb.axes[1].x);
+  EXPECT_FLOAT_EQ(out.collision.obb.halfExtents.z, data.collision.obb.halfExtents.z);
+}
+
+TEST_F(MeshCacheTest, MeshParserLoadsCache) {
+  SSerializer::MeshCacheData data;
+  data.mesh = makeGridMesh(2);
+  ASSERT_TRUE(writer.writeMeshCache(data, "test_data/model.smesh"));
+
+  SSerializer::MeshParser meshParser;
+  SSerializer::MeshData mesh;
+  ASSERT_TRUE(meshParser.parse("test_data/model.smesh", mesh));
+  EXPECT_EQ(mesh.numVertices, 9u);
+  EXPECT_EQ(mesh.numTriangles, 8u);
+}
+
+TEST_F(MeshCacheTest, BadSignatureFails) {
+  createTestFile("test_data/bad.smesh", "NOPE\x01\x00\x00\x00");
+  testing::internal::CaptureStderr();
+  EXPECT_FALSE(parser.parse("test_data/bad.smesh", out));
+  expectStderrContains({ "Bad signature" });
+}
+
+TEST_F(MeshCacheTest, TruncatedChunkFails) {
+  SSerializer::MeshCacheData data;
+  data.mesh = makeGridMesh(2);
+  ASSERT_TRUE(writer.writeMeshCache(data, "test_data/truncated.smesh"));
+
+  std::vector<unsigned char> bytes;
+  ASSERT_TRUE(parser.loadBinaryFile(bytes, "test_data/truncated.smesh"));
+  bytes.resize(bytes.size() - 20);
+  createBinaryFile("test_data/truncated.smesh", bytes);
+
+  testing::internal::CaptureStderr();
+  EXPECT_FALSE(parser.parse("test_data/truncated.smesh", out));
+  expectStderrContains({ "Truncated chunk" });
+}
+
+TEST_F(MeshCacheTest, MeshletVertexOutOfRangeFails) {
+  SSerializer::MeshCacheData data;
+  data.mesh = makeGridMesh(4);
+  SSerializer::MeshletBuilder builder;
+  ASSERT_TRUE(builder.build(data.mesh, data.meshlets, 32, 32));
+  data.hasMeshlets = true;
+  data.meshlets.vertices.back() = data.mesh.numVertices;
+  ASSERT_TRUE(writer.writeMeshCache(data, "test_data/bad_meshlet_vertex.smesh"));
+
+  testing::internal::CaptureStderr();
+  EXPECT_FALSE(parser.parse("test_data/bad_meshlet_vertex.smesh", out));
+  expectStderrContains({ "Meshlet vertex out of bounds" });
+}
+
+TEST_F(MeshCacheTest, MeshletLocalIndexOutOfRangeFails) {
+  SSerializer::MeshCacheData data;
+  data.mesh = makeGridMesh(4);
+  SSerializer::MeshletBuilder builder;
+  ASSERT_TRUE(builder.build(data.mesh, data.meshlets, 32, 32));
+  data.hasMeshlets = true;
+  data.meshlets.triangles[0] = static_cast<uint8_t>(data.meshlets.meshlets[0].vertexCount);
+  ASSERT_TRUE(writer.writeMeshCache(data, "test_data/bad_meshlet_local.smesh"));
+
+  testing::internal::CaptureStderr();
+  EXPECT_FALSE(parser.parse("test_data/bad_meshlet_local.smesh", out));
+  expectStderrContains({ "local index out of bounds" });
+}
+
+TEST_F(MeshCacheTest, UnknownChunksAreSkipped) {
+  SSerializer::MeshCacheData data;
+  data.mesh = makeGridMesh(1);
+  ASSERT_TRUE(writer.writeMeshCache(data, "test_data/extra.smesh"));
+
+  std::vector<unsigned char> bytes;
+  ASSERT_TRUE(parser.loadBinaryFile(bytes, "test_data/extra.smesh"));
+  bytes.pop_back();
+  const unsigned char extra[] = { 'X', 'T', 'R', 'A', 2, 0, 0, 0, 0, 0, 0, 0, 0xAB, 0xCD };
+  bytes.insert(bytes.end(), std::begin(extra), std::end(extra));
+  createBinaryFile("test_data/extra.smesh", bytes);
+
+  EXPECT_TRUE(parser.parse("test_data/extra.smesh", out));
+  EXPECT_EQ(out.mesh.numTriangles, 2u);
+}
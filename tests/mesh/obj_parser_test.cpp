@@ -81,6 +81,16 @@ TEST_F(ObjParserTest, SingleTriangle) {
   EXPECT_EQ(out.indices[1], 1);
   EXPECT_EQ(out.indices[2], 2);
 }
+
+TEST_F(ObjParserTest, ReusedOutputDropsStaleTangents) {
+  out.tangents.assign(8, { 1.0f, 0.0f, 0.0f, 1.0f });
+  out.hasTangents = true;
+  createTestFile("test_data/triangle_reused.obj", "v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 3\n");
+  expectValidParse("test_data/triangle_reused.obj", 3, 1);
+  EXPECT_FALSE(out.hasTangents);
+  EXPECT_TRUE(out.tangents.empty());
+}
+
 TEST_F(ObjParserTest, QuadTriangulation) {
   createTestFile("test_data/quad.obj", "v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\nf 1 2 3 4\n");
   expectValidParse("test_data/quad.obj", 4, 2);
@@ -1,5 +1,8 @@
 #include "test_helpers.hpp"
 
+#include "starlet-serializer/writer/writer.hpp"
+#include "starlet-serializer/data/mesh_cache_data.hpp"
+
 // PLY format detection
 TEST_F(MeshParserTest, DetectFormatPlyLowercase) {
   createTestFile("test_data/model.ply", "ply");
@@ -60,4 +63,20 @@ TEST_F(MeshParserTest, DetectFormatEmptyExtension) {
   testing::internal::CaptureStderr();
   expectInvalidParse("test_data/model.");
   expectStderrContains({ "Unsupported mesh format: test_data/model." });
-}
\ No newline at end of file
+}
+
+// Signature detection
+TEST_F(MeshParserTest, DetectFormatPlySignatureOverridesExtension) {
+  createTestFile("test_data/really_ply.obj",
+    "ply\nformat ascii 1.0\nelement vertex 3\nproperty float x\nproperty float y\nproperty float z\n"
+    "element face 1\nproperty list uchar int vertex_indices\nend_header\n0 0 0\n1 0 0\n0 1 0\n3 0 1 2\n");
+  expectValidParse("test_data/really_ply.obj", 3, 1);
+}
+
+TEST_F(MeshParserTest, DetectFormatMeshCacheWithoutExtension) {
+  SSerializer::MeshCacheData cache;
+  cache.mesh = makeTriangleMesh({ {0,0,0}, {1,0,0}, {0,1,0} }, { 0,1,2 });
+  SSerializer::Writer writer;
+  ASSERT_TRUE(writer.writeMeshCache(cache, "test_data/cache_no_extension"));
+  expectValidParse("test_data/cache_no_extension", 3, 1);
+}
@@ -658,4 +658,18 @@ TEST_F(ParserTest, TrimEOLMixedLineEndings) {
   const unsigned char data[] = "text\r\n,\n";
   const unsigned char* result = parser.trimEOL(data, data + 8);
   EXPECT_EQ(result - data, 4);
-}
\ No newline at end of file
+}
+
+TEST_F(ParserTest, LoadBinaryFilePrefixReadsLeadingBytes) {
+  createTestFile("test_data/prefix.bin", "0123456789");
+  std::vector<unsigned char> data;
+  size_t fileSize = 0;
+
+  ASSERT_TRUE(parser.loadBinaryFilePrefix(data, "test_data/prefix.bin", 4, fileSize));
+  EXPECT_EQ(fileSize, 10u);
+  EXPECT_EQ(std::string(data.begin(), data.end() - 1), "0123");
+  EXPECT_EQ(data.back(), '\0');
+
+  ASSERT_TRUE(parser.loadBinaryFilePrefix(data, "test_data/prefix.bin", 64, fileSize));
+  EXPECT_EQ(data.size(), 11u);
+}
@@ -0,0 +1,79 @@
+#include "../test_helpers.hpp"
+
+#include "starlet-serializer/processor/mesh/bounds_calculator.hpp"
+
+#include <cmath>
+#include <random>
+
+class BoundsCalculatorTest : public ::testing::Test {
+protected:
+  SSerializer::BoundsCalculator calculator;
+};
+
+TEST_F(BoundsCalculatorTest, MatchesScalarReference) {
+  std::mt19937 rng(11);
+  std::uniform_real_distribution<float> dist(-50.0f, 50.0f);
+
+  // Odd sizes exercise the scalar tails of the vector loops
+  for (unsigned int count : { 1u, 2u, 3u, 7u, 1001u, 200003u }) {
+    SSerializer::MeshData mesh;
+    mesh.vertices.resize(count);
+    for (Starlet::Math::Vertex& v : mesh.vertices) {
+      v.pos = { dist(rng), dist(rng) * 0.5f, dist(rng) + 10.0f };
+      v.norm = { 1e9f, -1e9f, 1e9f }; // Must not leak into the position lanes
+    }
+    calculator.compute(mesh);
+
+    float min[3] = { 1e30f, 1e30f, 1e30f }, max[3] = { -1e30f, -1e30f, -1e30f };
+    for (const Starlet::Math::Vertex& v : mesh.vertices) {
+      const float p[3] = { v.pos.x, v.pos.y, v.pos.z };
+      for (int a = 0; a < 3; ++a) {
+        min[a] = std::min(min[a], p[a]);
+        max[a] = std::max(max[a], p[a]);
+      }
+    }
+    EXPECT_FLOAT_EQ(mesh.boundsMin.x, min[0]); EXPECT_FLOAT_EQ(mesh.boundsMax.x, max[0]);
+    EXPECT_FLOAT_EQ(mesh.boundsMin.y, min[1]); EXPECT_FLOAT_EQ(mesh.boundsMax.y, max[1]);
+    EXPECT_FLOAT_EQ(mesh.boundsMin.z, min[2]); EXPECT_FLOAT_EQ(mesh.boundsMax.z, max[2]);
+    EXPECT_FLOAT_EQ(mesh.minY, min[1]);
+    EXPECT_FLOAT_EQ(mesh.maxY, max[1]);
+
+    float radius = 0.0f;
+    for (const Starlet::Math::Vertex& v : mesh.vertices) {
+      const float dx = v.pos.x - mesh.sphereCenter.x, dy = v.pos.y - mesh.sphereCenter.y, dz = v.pos.z - mesh.sphereCenter.z;
+      radius = std::max(radius, std::sqrt(dx * dx + dy * dy + dz * dz));
+    }
+    EXPECT_NEAR(mesh.sphereRadius, radius, 1e-4f);
+  }
+}
+
+TEST_F(BoundsCalculatorTest, EmptyMeshHasZeroBounds) {
+  SSerializer::MeshData mesh;
+  mesh.sphereRadius = 3.0f;
+  calculator.compute(mesh);
+  EXPECT_FLOAT_EQ(mesh.sphereRadius, 0.0f);
+  EXPECT_FLOAT_EQ(mesh.boundsMax.x, 0.0f);
+}
+
+TEST_F(MeshParserTest, ObjParseFillsBounds) {
+  createTestFile("test_data/bounds.obj", "v -1 2 0\nv 3 -4 1\nv 0 0 5\nf 1 2 3\n");
+  ASSERT_TRUE(parser.parse("test_data/bounds.obj", out));
+  EXPECT_FLOAT_EQ(out.boundsMin.x, -1.0f); EXPECT_FLOAT_EQ(out.boundsMax.x, 3.0f);
+  EXPECT_FLOAT_EQ(out.boundsMin.y, -4.0f); EXPECT_FLOAT_EQ(out.boundsMax.y, 2.0f);
+  EXPECT_FLOAT_EQ(out.boundsMin.z, 0.0f);  EXPECT_FLOAT_EQ(out.boundsMax.z, 5.0f);
+  EXPECT_FLOAT_EQ(out.minY, -4.0f);
+  EXPECT_FLOAT_EQ(out.sphereCenter.y, -1.0f);
+  EXPECT_GT(out.sphereRadius, 0.0f);
+}
+
+TEST_F(MeshParserTest, PlyParseFillsBounds) {
+  createTestFile("test_data/bounds.ply",
+    "ply\nformat ascii 1.0\nelement vertex 3\nproperty float x\nproperty float y\nproperty float z\n"
+    "element face 1\nproperty list uchar int vertex_indices\nend_header\n"
+    "0 0 0\n2 0 -2\n0 4 0\n3 0 1 2\n");
+  ASSERT_TRUE(parser.parse("test_data/bounds.ply", out));
+  EXPECT_FLOAT_EQ(out.boundsMax.x, 2.0f);
+  EXPECT_FLOAT_EQ(out.boundsMin.z, -2.0f);
+  EXPECT_FLOAT_EQ(out.maxY, 4.0f);
+  EXPECT_NEAR(out.sphereRadius, std::sqrt(1.0f + 4.0f + 1.0f), 1e-5f);
+}
@@ -0,0 +1,192 @@
+#include "../test_helpers.hpp"
+
+#include "starlet-serializer/processor/mesh/bvh_builder.hpp"
+#include "starlet-serializer/data/bvh_data.hpp"
+
+#include <cmath>
+#include <numeric>
+#include <random>
+
+class BvhBuilderTest : public ::testing::Test {
+protected:
+  static SSerializer::MeshData makeDome(unsigned int size) {
+    SSerializer::MeshData mesh = makeGridMesh(size);
+    for (Starlet::Math::Vertex& v : mesh.vertices)
+      v.pos.z = 0.5f * std::sin(3.14159265f * v.pos.x) * std::sin(3.14159265f * v.pos.y);
+    return mesh;
+  }
+
+  // Single leaf over every triangle: the queries reduce to brute force
+  static SSerializer::BvhData makeFlat(const SSerializer::MeshData& mesh) {
+    SSerializer::BvhData flat;
+    flat.triangles.resize(mesh.indices.size() / 3);
+    std::iota(flat.triangles.begin(), flat.triangles.end(), 0u);
+    SSerializer::BvhNode root;
+    for (int i = 0; i < 3; ++i) {
+      root.boundsMin[i] = -1e30f;
+      root.boundsMax[i] = 1e30f;
+    }
+    root.count = static_cast<uint32_t>(flat.triangles.size());
+    flat.nodes.push_back(root);
+    return flat;
+  }
+
+  void expectValidTree(const SSerializer::MeshData& mesh, unsigned int maxLeafSize) {
+    std::vector<unsigned int> seen(mesh.indices.size() / 3, 0);
+    for (const SSerializer::BvhNode& node : out.nodes) {
+      if (!node.isLeaf()) {
+        for (unsigned int c = 0; c < 2; ++c) {
+          const SSerializer::BvhNode& child = out.nodes[node.leftFirst + c];
+          for (int i = 0; i < 3; ++i) {
+            EXPECT_GE(child.boundsMin[i], node.boundsMin[i]);
+            EXPECT_LE(child.boundsMax[i], node.boundsMax[i]);
+          }
+        }
+        continue;
+      }
+      EXPECT_LE(node.count, std::max(maxLeafSize, 16u));
+      for (uint32_t i = node.leftFirst; i < node.leftFirst + node.count; ++i) {
+        const unsigned int t = out.triangles[i];
+        ++seen[t];
+        for (unsigned int k = 0; k < 3; ++k) {
+          const Starlet::Math::Vec3<float>& p = mesh.vertices[mesh.indices[t * 3 + k]].pos;
+          EXPECT_GE(p.x, node.boundsMin[0]); EXPECT_LE(p.x, node.boundsMax[0]);
+          EXPECT_GE(p.y, node.boundsMin[1]); EXPECT_LE(p.y, node.boundsMax[1]);
+          EXPECT_GE(p.z, node.boundsMin[2]); EXPECT_LE(p.z, node.boundsMax[2]);
+        }
+      }
+    }
+    for (unsigned int count : seen) EXPECT_EQ(count, 1u);
+  }
+
+  SSerializer::BvhBuilder builder;
+  SSerializer::BvhQuery query;
+  SSerializer::BvhData out;
+};
+
+TEST_F(BvhBuilderTest, GridTreeIsValid) {
+  const SSerializer::MeshData mesh = makeDome(32);
+  ASSERT_TRUE(builder.build(mesh, out));
+  EXPECT_GT(out.nodes.size(), 1u);
+  EXPECT_EQ(out.triangles.size(), mesh.numTriangles);
+  expectValidTree(mesh, SSerializer::BvhBuilder::DEFAULT_MAX_LEAF_SIZE);
+}
+
+TEST_F(BvhBuilderTest, SingleTriangleIsLeafRoot) {
+  const SSerializer::MeshData mesh = makeTriangleMesh({ { 0, 0, 0 }, { 1, 0, 0 }, { 0, 1, 0 } }, { 0, 1, 2 });
+  ASSERT_TRUE(builder.build(mesh, out));
+  ASSERT_EQ(out.nodes.size(), 1u);
+  EXPECT_TRUE(out.nodes[0].isLeaf());
+  EXPECT_FLOAT_EQ(out.nodes[0].boundsMax[0], 1.0f);
+}
+
+TEST_F(BvhBuilderTest, CoincidentTrianglesStillSplit) {
+  std::vector<unsigned int> indices;
+  for (unsigned int i = 0; i < 100; ++i) indices.insert(indices.end(), { 0, 1, 2 });
+  const SSerializer::MeshData mesh = makeTriangleMesh({ { 0, 0, 0 }, { 1, 0, 0 }, { 0, 1, 0 } }, indices);
+  ASSERT_TRUE(builder.build(mesh, out, 2));
+  expectValidTree(mesh, 2);
+}
+
+TEST_F(BvhBuilderTest, RaycastMatchesBruteForce) {
+  const SSerializer::MeshData mesh = makeDome(24);
+  ASSERT_TRUE(builder.build(mesh, out));
+  const SSerializer::BvhData flat = makeFlat(mesh);
+
+  std::mt19937 rng(7);
+  std::uniform_real_distribution<float> dist(-0.2f, 1.2f);
+  for (int i = 0; i < 200; ++i) {
+    const Starlet::Math::Vec3<float> origin{ dist(rng), dist(rng), 2.0f };
+    const Starlet::Math::Vec3<float> direction{ dist(rng) - 0.5f, dist(rng) - 0.5f, -1.0f };
+
+    SSerializer::RayHit expected, actual;
+    const bool expectedHit = query.raycast(mesh, flat, origin, direction, expected);
+    ASSERT_EQ(query.raycast(mesh, out, origin, direction, actual), expectedHit);
+    if (expectedHit) {
+      EXPECT_NEAR(actual.distance, expected.distance, 1e-5f);
+    }
+  }
+}
+
+TEST_F(BvhBuilderTest, RaycastReportsBarycentrics) {
+  const SSerializer::MeshData mesh = makeTriangleMesh({ { 0, 0, 0 }, { 1, 0, 0 }, { 0, 1, 0 } }, { 0, 1, 2 });
+  ASSERT_TRUE(builder.build(mesh, out));
+
+  SSerializer::RayHit hit;
+  ASSERT_TRUE(query.raycast(mesh, out, { 0.25f, 0.5f, 1.0f }, { 0.0f, 0.0f, -1.0f }, hit));
+  EXPECT_NEAR(hit.distance, 1.0f, 1e-6f);
+  EXPECT_NEAR(hit.u, 0.25f, 1e-6f);
+  EXPECT_NEAR(hit.v, 0.5f, 1e-6f);
+  EXPECT_FALSE(query.raycast(mesh, out, { 0.25f, 0.5f, 1.0f }, { 0.0f, 0.0f, -1.0f }, hit, 0.5f));
+  EXPECT_FALSE(query.raycast(mesh, out, { 0.9f, 0.9f, 1.0f }, { 0.0f, 0.0f, -1.0f }, hit));
+}
+
+TEST_F(BvhBuilderTest, OverlapMatchesBruteForce) {
+  const SSerializer::MeshData mesh = makeDome(24);
+  ASSERT_TRUE(builder.build(mesh, out));
+  const SSerializer::BvhData flat = makeFlat(mesh);
+
+  std::vector<unsigned int> expected, actual;
+  query.overlapAabb(mesh, flat, { 0.3f, 0.2f, 0.4f }, { 0.6f, 0.45f, 1.0f }, expected);
+  query.overlapAabb(mesh, out, { 0.3f, 0.2f, 0.4f }, { 0.6f, 0.45f, 1.0f }, actual);
+  std::sort(expected.begin(), expected.end());
+  std::sort(actual.begin(), actual.end());
+  EXPECT_FALSE(expected.empty());
+  EXPECT_EQ(actual, expected);
+}
+
+TEST_F(BvhBuilderTest, OverlapUsesExactTriangleTest) {
+  // The box touches the triangle's bounds but lies beyond its hypotenuse
+  const SSerializer::MeshData mesh = makeTriangleMesh({ { 0, 0, 0 }, { 1, 0, 0 }, { 0, 1, 0 } }, { 0, 1, 2 });
+  ASSERT_TRUE(builder.build(mesh, out));
+
+  std::vector<unsigned int> triangles;
+  query.overlapAabb(mesh, out, { 0.8f, 0.8f, -1.0f }, { 1.0f, 1.0f, 1.0f }, triangles);
+  EXPECT_TRUE(triangles.empty());
+  query.overlapAabb(mesh, out, { 0.1f, 0.1f, -1.0f }, { 0.2f, 0.2f, 1.0f }, triangles);
+  EXPECT_EQ(triangles.size(), 1u);
+}
+
+TEST_F(BvhBuilderTest, DeepTreeVisitsEveryNode) {
+  // A degenerate chain far deeper than the fixed traversal stack: every interior node has the next
+  // interior node on the left and a one-triangle leaf on the right, so each level leaves a node
+  // pending on the stack
+  const SSerializer::MeshData mesh = makeGridMesh(8);
+  const SSerializer::BvhData flat = makeFlat(mesh);
+  const uint32_t triangleCount = static_cast<uint32_t>(flat.triangles.size());
+  SSerializer::BvhData deep;
+  deep.triangles = flat.triangles;
+  deep.nodes.push_back(flat.nodes[0]);
+  for (uint32_t t = 0; t + 1 < triangleCount; ++t) {
+    const size_t parent = deep.nodes.size() == 1 ? 0 : deep.nodes.size() - 2;
+    deep.nodes[parent].leftFirst = static_cast<uint32_t>(deep.nodes.size());
+    deep.nodes[parent].count = 0;
+    SSerializer::BvhNode leaf = flat.nodes[0];
+    leaf.leftFirst = t;
+    leaf.count = 1;
+    SSerializer::BvhNode rest = flat.nodes[0];
+    rest.leftFirst = t + 1;
+    rest.count = 1;
+    deep.nodes.push_back(rest);
+    deep.nodes.push_back(leaf);
+  }
+
+  std::vector<unsigned int> triangles;
+  query.overlapAabb(mesh, deep, { -1.0f, -1.0f, -1.0f }, { 2.0f, 2.0f, 1.0f }, triangles);
+  EXPECT_EQ(triangles.size(), triangleCount);
+
+  for (float x = 0.03f; x < 1.0f; x += 0.125f) {
+    SSerializer::RayHit expected, actual;
+    ASSERT_TRUE(query.raycast(mesh, flat, { x, 0.93f, 1.0f }, { 0.0f, 0.0f, -1.0f }, expected));
+    ASSERT_TRUE(query.raycast(mesh, deep, { x, 0.93f, 1.0f }, { 0.0f, 0.0f, -1.0f }, actual));
+    EXPECT_EQ(actual.triangle, expected.triangle);
+  }
+}
+
+TEST_F(BvhBuilderTest, RejectsInvalidMesh) {
+  testing::internal::CaptureStderr();
+  EXPECT_FALSE(builder.build(SSerializer::MeshData{}, out));
+  const SSerializer::MeshData mesh = makeTriangleMesh({ { 0, 0, 0 }, { 1, 0, 0 }, { 0, 1, 0 } }, { 0, 1, 5 });
+  EXPECT_FALSE(builder.build(mesh, out));
+  expectStderrContains({ "Mesh has no triangle list", "Index out of bounds" });
+}
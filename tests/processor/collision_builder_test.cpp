@@ -0,0 +1,151 @@
+#include "../test_helpers.hpp"
+
+#include "starlet-serializer/processor/mesh/collision_builder.hpp"
+#include "starlet-serializer/data/collision_data.hpp"
+#include "starlet-serializer/utils/vec_ops.hpp"
+
+#include <cmath>
+#include <map>
+#include <random>
+
+using Vec3f = Starlet::Math::Vec3<float>;
+
+class CollisionBuilderTest : public ::testing::Test {
+protected:
+  static std::vector<Vec3f> spherePoints(size_t count) {
+    std::mt19937 rng(9);
+    std::normal_distribution<float> dist(0.0f, 1.0f);
+    std::vector<Vec3f> points;
+    for (size_t i = 0; i < count; ++i)
+      points.push_back(SSerializer::Utils::normalize({ dist(rng), dist(rng), dist(rng) }));
+    return points;
+  }
+
+  // Closed, consistently wound, convex, and containing every input point
+  void expectValidHull(const SSerializer::ConvexHullData& hull, const std::vector<Vec3f>& points, bool containsAll) {
+    ASSERT_EQ(hull.indices.size() % 3, 0u);
+    std::map<std::pair<unsigned int, unsigned int>, int> edges;
+    for (size_t t = 0; t < hull.indices.size(); t += 3)
+      for (size_t k = 0; k < 3; ++k) ++edges[{ hull.indices[t + k], hull.indices[t + (k + 1) % 3] }];
+    for (const auto& [edge, count] : edges) {
+      EXPECT_EQ(count, 1);
+      EXPECT_EQ(edges.count({ edge.second, edge.first }), 1u);
+    }
+    EXPECT_EQ(hull.vertices.size() - edges.size() / 2 + hull.indices.size() / 3, 2u);
+
+    for (size_t t = 0; t < hull.indices.size(); t += 3) {
+      const Vec3f& a = hull.vertices[hull.indices[t]];
+      const Vec3f n = SSerializer::Utils::normalize(SSerializer::Utils::cross(
+        SSerializer::Utils::sub(hull.vertices[hull.indices[t + 1]], a), SSerializer::Utils::sub(hull.vertices[hull.indices[t + 2]], a)));
+      for (const Vec3f& v : hull.vertices) EXPECT_LE(SSerializer::Utils::dot(n, SSerializer::Utils::sub(v, a)), 1e-4f);
+      if (!containsAll) continue;
+      for (const Vec3f& p : points) EXPECT_LE(SSerializer::Utils::dot(n, SSerializer::Utils::sub(p, a)), 1e-4f);
+    }
+  }
+
+  SSerializer::CollisionBuilder builder;
+  SSerializer::CollisionData out;
+};
+
+TEST_F(CollisionBuilderTest, CubeHullHasEightCorners) {
+  std::mt19937 rng(1);
+  std::uniform_real_distribution<float> dist(0.0f, 1.0f);
+  std::vector<Vec3f> points;
+  for (int i = 0; i < 500; ++i) points.push_back({ dist(rng), dist(rng), dist(rng) });
+  for (int c = 0; c < 8; ++c) points.push_back({ float(c & 1), float((c >> 1) & 1), float((c >> 2) & 1) });
+
+  ASSERT_TRUE(builder.buildHull(points, out.hull, 64));
+  EXPECT_EQ(out.hull.vertices.size(), 8u);
+  EXPECT_EQ(out.hull.indices.size(), 36u);
+  expectValidHull(out.hull, points, true);
+}
+
+TEST_F(CollisionBuilderTest, SphereHullContainsAllPoints) {
+  const std::vector<Vec3f> points = spherePoints(300);
+  ASSERT_TRUE(builder.buildHull(points, out.hull, 1000));
+  EXPECT_EQ(out.hull.vertices.size(), 300u);
+  expectValidHull(out.hull, points, true);
+}
+
+TEST_F(CollisionBuilderTest, VertexLimitIsRespected) {
+  const std::vector<Vec3f> points = spherePoints(5000);
+  ASSERT_TRUE(builder.buildHull(points, out.hull, 32));
+  EXPECT_EQ(out.hull.vertices.size(), 32u);
+  expectValidHull(out.hull, points, false);
+}
+
+TEST_F(CollisionBuilderTest, KDopOfUnitCube) {
+  SSerializer::MeshData mesh = makeGridMesh(4, 0.0f);
+  for (const Starlet::Math::Vertex& v : makeGridMesh(4, 1.0f).vertices) mesh.vertices.push_back(v);
+  ASSERT_TRUE(builder.build(mesh, out));
+
+  EXPECT_FLOAT_EQ(out.kdop.min[0], 0.0f);
+  EXPECT_FLOAT_EQ(out.kdop.max[0], 1.0f);
+  EXPECT_FLOAT_EQ(out.kdop.max[2], 1.0f);
+  EXPECT_NEAR(out.kdop.max[3], std::sqrt(3.0f), 1e-5f);
+  EXPECT_NEAR(out.kdop.min[8], -std::sqrt(0.5f), 1e-5f);
+  EXPECT_EQ(out.hull.vertices.size(), 8u);
+}
+
+TEST_F(CollisionBuilderTest, ObbFitsRotatedBox) {
+  // Box of half extents 4 x 1 x 0.5 rotated 30 degrees about z
+  const float c = std::cos(0.5235988f), s = std::sin(0.5235988f);
+  std::mt19937 rng(2);
+  std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+  std::vector<Vec3f> points;
+  for (int i = 0; i < 4000; ++i) {
+    float x = 4.0f * dist(rng), y = dist(rng), z = 0.5f * dist(rng);
+    const int face = i % 3;
+    if (face == 0) x = x > 0 ? 4.0f : -4.0f;
+    if (face == 1) y = y > 0 ? 1.0f : -1.0f;
+    if (face == 2) z = z > 0 ? 0.5f : -0.5f;
+    points.push_back({ c * x - s * y + 10.0f, s * x + c * y, z });
+  }
+
+  builder.buildObb(points, out.obb);
+  float extents[3] = { out.obb.halfExtents.x, out.obb.halfExtents.y, out.obb.halfExtents.z };
+  std::sort(extents, extents + 3);
+  EXPECT_NEAR(extents[0], 0.5f, 0.05f);
+  EXPECT_NEAR(extents[1], 1.0f, 0.05f);
+  EXPECT_NEAR(extents[2], 4.0f, 0.05f);
+  EXPECT_NEAR(out.obb.center.x, 10.0f, 0.05f);
+  EXPECT_NEAR(SSerializer::Utils::dot(SSerializer::Utils::cross(out.obb.axes[0], out.obb.axes[1]), out.obb.axes[2]), 1.0f, 1e-5f);
+}
+
+TEST_F(CollisionBuilderTest, RejectsDegenerateInput) {
+  testing::internal::CaptureStderr();
+  EXPECT_FALSE(builder.build(makeGridMesh(3), out));
+  EXPECT_FALSE(builder.buildHull(spherePoints(10), out.hull, 3));
+  EXPECT_FALSE(builder.build(SSerializer::MeshData{}, out));
+  expectStderrContains({ "Points are coplanar", "Max hull vertices must be at least 4", "Mesh has no vertices" });
+}
+
+TEST_F(CollisionBuilderTest, InflateCoversMovedPoints) {
+  const std::vector<Vec3f> points = spherePoints(400);
+  ASSERT_TRUE(builder.buildHull(points, out.hull, 24));
+  builder.buildKDop(points, out.kdop);
+  builder.buildObb(points, out.obb);
+  const size_t hullVertices = out.hull.vertices.size();
+
+  // Corners of the margin box around every hull vertex
+  const Vec3f margin{ 0.01f, 0.02f, 0.005f };
+  std::vector<Vec3f> moved;
+  for (const Vec3f& v : out.hull.vertices)
+    for (int c = 0; c < 8; ++c)
+      moved.push_back({ v.x + (c & 1 ? margin.x : -margin.x), v.y + (c & 2 ? margin.y : -margin.y), v.z + (c & 4 ? margin.z : -margin.z) });
+
+  builder.inflate(out, margin);
+  EXPECT_EQ(out.hull.vertices.size(), hullVertices);
+  expectValidHull(out.hull, moved, true);
+  for (const Vec3f& p : moved) {
+    for (size_t a = 0; a < SSerializer::KDopData::AXIS_COUNT; ++a) {
+      const float d = SSerializer::Utils::dot(p, SSerializer::KDopData::axis(a));
+      EXPECT_GE(d, out.kdop.min[a] - 1e-6f);
+      EXPECT_LE(d, out.kdop.max[a] + 1e-6f);
+    }
+    const Vec3f local = SSerializer::Utils::sub(p, out.obb.center);
+    EXPECT_LE(std::fabs(SSerializer::Utils::dot(local, out.obb.axes[0])), out.obb.halfExtents.x + 1e-5f);
+    EXPECT_LE(std::fabs(SSerializer::Utils::dot(local, out.obb.axes[1])), out.obb.halfExtents.y + 1e-5f);
+    EXPECT_LE(std::fabs(SSerializer::Utils::dot(local, out.obb.axes[2])), out.obb.halfExtents.z + 1e-5f);
+  }
+}
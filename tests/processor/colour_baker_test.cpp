@@ -0,0 +1,124 @@
+#include "../test_helpers.hpp"
+
+#include "starlet-serializer/processor/mesh/colour_baker.hpp"
+#include "starlet-serializer/data/model_data.hpp"
+#include "starlet-serializer/parser/mesh_parser.hpp"
+
+class ColourBakerTest : public ::testing::Test {
+protected:
+  SSerializer::ColourBaker baker;
+
+  SSerializer::ModelData makeModel(SSerializer::ColourMode mode, const std::string& name = "model") {
+    SSerializer::ModelData model;
+    model.name = name;
+    model.mode = mode;
+    model.colour.colour = { 0.2f, 0.4f, 0.6f, 0.5f };
+    return model;
+  }
+
+  // Column of vertices from y = 0 to y = 10; odd counts exercise the scalar tail
+  SSerializer::MeshData makeColumn(unsigned int count) {
+    SSerializer::MeshData mesh;
+    mesh.vertices.resize(count);
+    for (unsigned int i = 0; i < count; ++i)
+      mesh.vertices[i].pos = { 0.0f, 10.0f * static_cast<float>(i) / static_cast<float>(count - 1), 0.0f };
+    mesh.numVertices = count;
+    mesh.minY = 0.0f;
+    mesh.maxY = 10.0f;
+    return mesh;
+  }
+};
+
+TEST_F(ColourBakerTest, SolidUsesModelColour) {
+  SSerializer::MeshData mesh = makeColumn(7);
+  ASSERT_TRUE(baker.bake(makeModel(SSerializer::ColourMode::Solid), mesh));
+  EXPECT_TRUE(mesh.hasColours);
+  for (const Starlet::Math::Vertex& v : mesh.vertices) {
+    EXPECT_FLOAT_EQ(v.col.y, 0.4f);
+    EXPECT_FLOAT_EQ(v.col.w, 0.5f);
+  }
+}
+
+TEST_F(ColourBakerTest, RandomIsSeededByName) {
+  SSerializer::MeshData a = makeColumn(101), b = makeColumn(101), c = makeColumn(101);
+  ASSERT_TRUE(baker.bake(makeModel(SSerializer::ColourMode::Random, "rock"), a));
+  ASSERT_TRUE(baker.bake(makeModel(SSerializer::ColourMode::Random, "rock"), b));
+  ASSERT_TRUE(baker.bake(makeModel(SSerializer::ColourMode::Random, "tree"), c));
+
+  size_t differences = 0, distinct = 0;
+  for (size_t i = 0; i < a.vertices.size(); ++i) {
+    EXPECT_FLOAT_EQ(a.vertices[i].col.x, b.vertices[i].col.x);
+    EXPECT_FLOAT_EQ(a.vertices[i].col.z, b.vertices[i].col.z);
+    EXPECT_FLOAT_EQ(a.vertices[i].col.w, 0.5f);
+    EXPECT_GE(a.vertices[i].col.x, 0.0f);
+    EXPECT_LE(a.vertices[i].col.x, 1.0f);
+    if (a.vertices[i].col.x != c.vertices[i].col.x) ++differences;
+    if (i > 0 && a.vertices[i].col.y != a.vertices[i - 1].col.y) ++distinct;
+  }
+  EXPECT_GT(differences, 90u);
+  EXPECT_GT(distinct, 90u);
+}
+
+TEST_F(ColourBakerTest, GradientRunsRedToViolet) {
+  SSerializer::MeshData mesh = makeColumn(13);
+  ASSERT_TRUE(baker.bake(makeModel(SSerializer::ColourMode::VerticalGradient), mesh));
+
+  const Starlet::Math::Vec4<float>& bottom = mesh.vertices.front().col;
+  EXPECT_FLOAT_EQ(bottom.x, 1.0f);
+  EXPECT_FLOAT_EQ(bottom.y, 0.0f);
+  EXPECT_FLOAT_EQ(bottom.z, 0.0f);
+  EXPECT_FLOAT_EQ(bottom.w, 0.5f);
+
+  // Hue 5/6 is magenta-violet
+  const Starlet::Math::Vec4<float>& top = mesh.vertices.back().col;
+  EXPECT_NEAR(top.x, 1.0f, 1e-5f);
+  EXPECT_NEAR(top.y, 0.0f, 1e-5f);
+  EXPECT_NEAR(top.z, 1.0f, 1e-5f);
+
+  // Halfway is hue 5/12: between green and cyan
+  const Starlet::Math::Vec4<float>& middle = mesh.vertices[6].col;
+  EXPECT_NEAR(middle.x, 0.0f, 1e-5f);
+  EXPECT_NEAR(middle.y, 1.0f, 1e-5f);
+  EXPECT_NEAR(middle.z, 0.5f, 1e-5f);
+
+  // The SIMD body and the scalar tail agree
+  for (size_t i : { 3u, 8u, 11u }) {
+    SSerializer::MeshData single = makeColumn(13);
+    single.vertices = { mesh.vertices[i] };
+    ASSERT_TRUE(baker.bake(makeModel(SSerializer::ColourMode::VerticalGradient), single));
+    EXPECT_FLOAT_EQ(single.vertices[0].col.x, mesh.vertices[i].col.x);
+    EXPECT_FLOAT_EQ(single.vertices[0].col.y, mesh.vertices[i].col.y);
+    EXPECT_FLOAT_EQ(single.vertices[0].col.z, mesh.vertices[i].col.z);
+  }
+}
+
+TEST_F(ColourBakerTest, VertexColourKeepsFileColours) {
+  SSerializer::MeshData mesh = makeColumn(5);
+  mesh.vertices[2].col = { 0.9f, 0.8f, 0.7f, 1.0f };
+  mesh.hasColours = true;
+  ASSERT_TRUE(baker.bake(makeModel(SSerializer::ColourMode::VertexColour), mesh));
+  EXPECT_FLOAT_EQ(mesh.vertices[2].col.x, 0.9f);
+
+  SSerializer::MeshData plain = makeColumn(5);
+  ASSERT_TRUE(baker.bake(makeModel(SSerializer::ColourMode::VertexColour), plain));
+  EXPECT_TRUE(plain.hasColours);
+  EXPECT_FLOAT_EQ(plain.vertices[2].col.x, 0.2f);
+}
+
+TEST_F(ColourBakerTest, EmptyMeshFails) {
+  SSerializer::MeshData mesh;
+  EXPECT_FALSE(baker.bake(makeModel(SSerializer::ColourMode::Solid), mesh));
+}
+
+TEST_F(MeshParserTest, ParseBakesModelColours) {
+  createTestFile("test_data/colour_bake.obj", "v 0 0 0\nv 1 0 0\nv 0 2 0\nf 1 2 3\n");
+  SSerializer::ModelData model;
+  model.name = "tri";
+  model.mode = SSerializer::ColourMode::VerticalGradient;
+  SSerializer::MeshParseOptions options;
+  options.colourModel = &model;
+  ASSERT_TRUE(parser.parse("test_data/colour_bake.obj", out, options));
+  EXPECT_TRUE(out.hasColours);
+  EXPECT_FLOAT_EQ(out.vertices[0].col.x, 1.0f);
+  EXPECT_NEAR(out.vertices[2].col.z, 1.0f, 1e-5f);
+}
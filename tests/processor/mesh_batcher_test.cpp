@@ -0,0 +1,88 @@
+#include "../test_helpers.hpp"
+
+#include "starlet-serializer/processor/mesh/mesh_batcher.hpp"
+#include "starlet-serializer/processor/mesh/bounds_calculator.hpp"
+#include "starlet-serializer/data/mesh_batch_data.hpp"
+
+class MeshBatcherTest : public ::testing::Test {
+protected:
+  void expectMatchesSources(const std::vector<SSerializer::MeshData>& meshes, bool rebased) {
+    ASSERT_EQ(out.entries.size(), meshes.size());
+    for (size_t m = 0; m < meshes.size(); ++m) {
+      const SSerializer::MeshBatchEntry& entry = out.entries[m];
+      ASSERT_EQ(entry.indexCount, meshes[m].indices.size());
+      ASSERT_EQ(entry.vertexCount, meshes[m].vertices.size());
+      EXPECT_EQ(entry.baseInstance, m);
+      EXPECT_EQ(entry.baseVertex, rebased ? 0 : static_cast<int32_t>(entry.firstVertex));
+      for (size_t i = 0; i < entry.indexCount; ++i) {
+        const unsigned int stored = out.indices[entry.firstIndex + i];
+        // What an indexed draw of the entry fetches
+        const unsigned int vertex = stored + entry.baseVertex;
+        EXPECT_FLOAT_EQ(out.vertices[vertex].pos.x, meshes[m].vertices[meshes[m].indices[i]].pos.x);
+        EXPECT_FLOAT_EQ(out.vertices[vertex].pos.y, meshes[m].vertices[meshes[m].indices[i]].pos.y);
+      }
+    }
+  }
+
+  SSerializer::MeshBatcher batcher;
+  SSerializer::MeshBatchData out;
+};
+
+TEST_F(MeshBatcherTest, PacksMeshesWithOffsets) {
+  std::vector<SSerializer::MeshData> meshes;
+  for (unsigned int size : { 2u, 5u, 1u, 9u }) {
+    meshes.push_back(makeGridMesh(size, static_cast<float>(size)));
+    SSerializer::BoundsCalculator().compute(meshes.back());
+  }
+
+  ASSERT_TRUE(batcher.build(meshes, out));
+  EXPECT_EQ(out.vertices.size(), 9u + 36u + 4u + 100u);
+  EXPECT_EQ(out.entries[1].baseVertex, 9);
+  EXPECT_EQ(out.entries[1].firstVertex, 9u);
+  EXPECT_EQ(out.entries[2].firstIndex, (4u + 25u) * 6u);
+  EXPECT_EQ(out.entries[3].instanceCount, 1u);
+  EXPECT_FLOAT_EQ(out.entries[3].boundsMin.z, 9.0f);
+  EXPECT_FALSE(out.rebasedIndices);
+  EXPECT_FALSE(out.hasTangents);
+  expectMatchesSources(meshes, false);
+}
+
+TEST_F(MeshBatcherTest, RebasedIndicesAddBaseVertex) {
+  std::vector<SSerializer::MeshData> meshes = { makeGridMesh(3), SSerializer::MeshData{}, makeGridMesh(4) };
+  ASSERT_TRUE(batcher.build(meshes, out, true));
+  EXPECT_TRUE(out.rebasedIndices);
+  EXPECT_EQ(out.entries[1].indexCount, 0u);
+  EXPECT_EQ(out.entries[2].firstVertex, 16u);
+  EXPECT_EQ(out.indices[out.entries[2].firstIndex], 16u);
+  expectMatchesSources(meshes, true);
+}
+
+TEST_F(MeshBatcherTest, LargeBatchMatchesSources) {
+  std::vector<SSerializer::MeshData> meshes;
+  for (unsigned int i = 0; i < 40; ++i) meshes.push_back(makeGridMesh(20 + i * 7));
+  ASSERT_TRUE(batcher.build(meshes, out));
+  expectMatchesSources(meshes, false);
+}
+
+TEST_F(MeshBatcherTest, FillsMissingTangents) {
+  std::vector<SSerializer::MeshData> meshes = { makeGridMesh(1), makeGridMesh(1) };
+  meshes[1].tangents.assign(4, Starlet::Math::Vec4<float>{ 1.0f, 0.0f, 0.0f, -1.0f });
+  meshes[1].hasTangents = true;
+
+  ASSERT_TRUE(batcher.build(meshes, out));
+  ASSERT_TRUE(out.hasTangents);
+  ASSERT_EQ(out.tangents.size(), 8u);
+  EXPECT_FLOAT_EQ(out.tangents[0].w, 1.0f);
+  EXPECT_FLOAT_EQ(out.tangents[0].x, 0.0f);
+  EXPECT_FLOAT_EQ(out.tangents[5].x, 1.0f);
+  EXPECT_FLOAT_EQ(out.tangents[5].w, -1.0f);
+}
+
+TEST_F(MeshBatcherTest, RejectsBadInput) {
+  testing::internal::CaptureStderr();
+  EXPECT_FALSE(batcher.build(std::vector<SSerializer::MeshData>{}, out));
+  std::vector<SSerializer::MeshData> meshes = { makeGridMesh(1), makeTriangleMesh({ { 0, 0, 0 }, { 1, 0, 0 }, { 0, 1, 0 } }, { 0, 1, 3 }) };
+  EXPECT_FALSE(batcher.build(meshes, out));
+  EXPECT_TRUE(out.vertices.empty());
+  expectStderrContains({ "No meshes to batch", "Index out of bounds in mesh 1 at 2: 3" });
+}
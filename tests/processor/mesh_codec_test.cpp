@@ -0,0 +1,183 @@
+#include "../test_helpers.hpp"
+
+#include "starlet-serializer/processor/mesh/mesh_codec.hpp"
+
+#include <cmath>
+#include <random>
+
+class MeshCodecTest : public ::testing::Test {
+protected:
+  SSerializer::MeshCodec codec;
+};
+
+TEST_F(MeshCodecTest, IndicesRoundTripExactly) {
+  std::mt19937 rng(5);
+  // Sizes around the four-value groups and the 16-byte SIMD window, plus large jumps in both directions
+  for (size_t count : { 0u, 1u, 3u, 4u, 5u, 17u, 1000u, 100003u }) {
+    std::vector<unsigned int> indices(count);
+    for (size_t i = 0; i < count; ++i)
+      indices[i] = i % 7 == 0 ? rng() : static_cast<unsigned int>(i / 2 + rng() % 8);
+
+    std::vector<unsigned char> encoded;
+    codec.encodeIndices(indices, encoded);
+    std::vector<unsigned int> decoded;
+    ASSERT_TRUE(codec.decodeIndices(encoded.data(), encoded.size(), decoded));
+    EXPECT_EQ(decoded, indices) << count;
+  }
+}
+
+TEST_F(MeshCodecTest, ScalarIndexDecodeMatchesSimd) {
+  std::mt19937 rng(6);
+  std::vector<unsigned int> indices(4099);
+  for (size_t i = 0; i < indices.size(); ++i) indices[i] = i % 5 == 0 ? rng() : static_cast<unsigned int>(i + rng() % 300);
+
+  std::vector<unsigned char> encoded;
+  codec.encodeIndices(indices, encoded);
+  std::vector<unsigned int> scalar, simd;
+  ASSERT_TRUE(codec.decodeIndices(encoded.data(), encoded.size(), scalar, Starlet::Serializer::Utils::SimdLevel::Scalar));
+  ASSERT_TRUE(codec.decodeIndices(encoded.data(), encoded.size(), simd));
+  EXPECT_EQ(scalar, indices);
+  EXPECT_EQ(simd, scalar);
+}
+
+TEST_F(MeshCodecTest, CoherentIndicesCompress) {
+  SSerializer::MeshData mesh = makeGridMesh(64);
+  std::vector<unsigned char> encoded;
+  codec.encodeIndices(mesh.indices, encoded);
+  EXPECT_LT(encoded.size(), mesh.indices.size() * sizeof(unsigned int) / 3);
+}
+
+TEST_F(MeshCodecTest, TruncatedIndicesFail) {
+  std::vector<unsigned int> indices = { 0, 70000, 1, 2, 3, 4000000 };
+  std::vector<unsigned char> encoded;
+  codec.encodeIndices(indices, encoded);
+
+  std::vector<unsigned int> decoded;
+  EXPECT_FALSE(codec.decodeIndices(encoded.data(), encoded.size() - 1, decoded));
+  EXPECT_FALSE(codec.decodeIndices(encoded.data(), 3, decoded));
+}
+
+TEST_F(MeshCodecTest, VerticesRoundTripWithinQuantization) {
+  std::mt19937 rng(9);
+  std::uniform_real_distribution<float> dist(-20.0f, 20.0f);
+
+  for (unsigned int count : { 1u, 15u, 16u, 33u, 5000u }) {
+    SSerializer::MeshData mesh;
+    mesh.vertices.resize(count);
+    mesh.tangents.resize(count);
+    for (unsigned int i = 0; i < count; ++i) {
+      Starlet::Math::Vertex& v = mesh.vertices[i];
+      v.pos = { dist(rng), static_cast<float>(i) * 0.01f, 3.0f };
+      v.norm = { 0.0f, 1.0f, 0.0f };
+      v.col = { dist(rng) / 40.0f + 0.5f, 0.25f, 1.0f, 1.0f };
+      v.texCoord = { static_cast<float>(i % 8) / 8.0f, dist(rng) };
+      mesh.tangents[i] = { 1.0f, 0.0f, 0.0f, i % 2 ? 1.0f : -1.0f };
+    }
+    mesh.numVertices = count;
+    mesh.hasNormals = mesh.hasColours = mesh.hasTexCoords = mesh.hasTangents = true;
+
+    std::vector<unsigned char> encoded;
+    codec.encodeVertices(mesh, encoded);
+    SSerializer::MeshData out;
+    ASSERT_TRUE(codec.decodeVertices(encoded.data(), encoded.size(), out));
+    ASSERT_EQ(out.vertices.size(), count);
+    ASSERT_EQ(out.tangents.size(), count);
+    EXPECT_EQ(out.numVertices, count);
+    EXPECT_TRUE(out.hasNormals && out.hasColours && out.hasTexCoords && out.hasTangents);
+
+    // 16-bit steps over a 40-unit range are ~6e-4
+    for (unsigned int i = 0; i < count; ++i) {
+      const Starlet::Math::Vertex& a = mesh.vertices[i];
+      const Starlet::Math::Vertex& b = out.vertices[i];
+      EXPECT_NEAR(b.pos.x, a.pos.x, 1e-3f);
+      EXPECT_NEAR(b.pos.y, a.pos.y, 1e-3f);
+      EXPECT_FLOAT_EQ(b.pos.z, 3.0f);
+      EXPECT_FLOAT_EQ(b.norm.y, 1.0f);
+      EXPECT_NEAR(b.col.x, a.col.x, 1e-4f);
+      EXPECT_NEAR(b.texCoord.x, a.texCoord.x, 1e-4f);
+      EXPECT_NEAR(b.texCoord.y, a.texCoord.y, 1e-3f);
+      EXPECT_FLOAT_EQ(out.tangents[i].w, mesh.tangents[i].w);
+    }
+  }
+}
+
+TEST_F(MeshCodecTest, MissingStreamsAreNotStored) {
+  SSerializer::MeshData mesh = makeGridMesh(8);
+  std::vector<unsigned char> encoded;
+  codec.encodeVertices(mesh, encoded);
+
+  SSerializer::MeshData out;
+  ASSERT_TRUE(codec.decodeVertices(encoded.data(), encoded.size(), out));
+  EXPECT_FALSE(out.hasNormals);
+  EXPECT_FALSE(out.hasTangents);
+  EXPECT_TRUE(out.tangents.empty());
+  EXPECT_LT(encoded.size(), mesh.vertices.size() * 3 * sizeof(float));
+}
+
+TEST_F(MeshCodecTest, UncolouredMeshDecodesOpaqueWhite) {
+  SSerializer::MeshData mesh = makeGridMesh(8);
+  for (Starlet::Math::Vertex& v : mesh.vertices) v.col = { 1.0f, 1.0f, 1.0f, 1.0f };
+  mesh.hasColours = false;
+  std::vector<unsigned char> encoded;
+  codec.encodeVertices(mesh, encoded);
+
+  SSerializer::MeshData out;
+  ASSERT_TRUE(codec.decodeVertices(encoded.data(), encoded.size(), out));
+  EXPECT_FALSE(out.hasColours);
+  ASSERT_EQ(out.vertices.size(), mesh.vertices.size());
+  for (const Starlet::Math::Vertex& v : out.vertices)
+    EXPECT_EQ(v.col, (Starlet::Math::Vec4<float>{ 1.0f, 1.0f, 1.0f, 1.0f }));
+}
+
+TEST_F(MeshCodecTest, ScalarVertexDecodeMatchesSimd) {
+  std::mt19937 rng(10);
+  std::uniform_real_distribution<float> dist(-50.0f, 50.0f);
+
+  // Spans several blocks, with a partial last group, and mixes zero, low and full byte groups
+  const unsigned int count = 9000;
+  SSerializer::MeshData mesh;
+  mesh.vertices.resize(count);
+  for (unsigned int i = 0; i < count; ++i) {
+    Starlet::Math::Vertex& v = mesh.vertices[i];
+    v.pos = { dist(rng), static_cast<float>(i) * 0.001f, i < 4000 ? 0.0f : 1.0f };
+    v.texCoord = { static_cast<float>(i % 8) / 8.0f, 0.5f };
+  }
+  mesh.numVertices = count;
+  mesh.hasTexCoords = true;
+
+  std::vector<unsigned char> encoded;
+  codec.encodeVertices(mesh, encoded);
+  SSerializer::MeshData scalar, simd;
+  ASSERT_TRUE(codec.decodeVertices(encoded.data(), encoded.size(), scalar, Starlet::Serializer::Utils::SimdLevel::Scalar));
+  ASSERT_TRUE(codec.decodeVertices(encoded.data(), encoded.size(), simd));
+  ASSERT_EQ(scalar.vertices.size(), count);
+  ASSERT_EQ(simd.vertices.size(), count);
+  for (unsigned int i = 0; i < count; ++i) {
+    EXPECT_EQ(scalar.vertices[i].pos, simd.vertices[i].pos) << i;
+    EXPECT_EQ(scalar.vertices[i].texCoord, simd.vertices[i].texCoord) << i;
+    EXPECT_NEAR(scalar.vertices[i].pos.x, mesh.vertices[i].pos.x, 2e-3f) << i;
+  }
+}
+
+TEST_F(MeshCodecTest, CorruptVertexStreamFails) {
+  SSerializer::MeshData mesh = makeGridMesh(8);
+  std::vector<unsigned char> encoded;
+  codec.encodeVertices(mesh, encoded);
+
+  SSerializer::MeshData out;
+  EXPECT_FALSE(codec.decodeVertices(encoded.data(), encoded.size() - 1, out));
+  encoded[4] = 0xFF; // Unknown stream flags
+  EXPECT_FALSE(codec.decodeVertices(encoded.data(), encoded.size(), out));
+}
+
+TEST_F(MeshCodecTest, OversizedVertexCountFailsWithoutAllocating) {
+  SSerializer::MeshData mesh = makeGridMesh(8);
+  std::vector<unsigned char> encoded;
+  codec.encodeVertices(mesh, encoded);
+
+  // A few hundred bytes claiming four billion vertices
+  encoded[0] = encoded[1] = encoded[2] = encoded[3] = 0xFF;
+  SSerializer::MeshData out;
+  EXPECT_FALSE(codec.decodeVertices(encoded.data(), encoded.size(), out));
+  EXPECT_TRUE(out.vertices.empty());
+}
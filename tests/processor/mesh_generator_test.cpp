@@ -0,0 +1,174 @@
+#include "../test_helpers.hpp"
+
+#include "starlet-serializer/processor/mesh/mesh_generator.hpp"
+#include "starlet-serializer/processor/mesh/bounds_calculator.hpp"
+#include "starlet-serializer/processor/mesh/topology_builder.hpp"
+#include "starlet-serializer/data/topology_data.hpp"
+
+#include <algorithm>
+
+class MeshGeneratorTest : public ::testing::Test {
+protected:
+  SSerializer::MeshGenerator generator;
+
+  // Every triangle's geometric normal must agree with its vertex normals
+  void expectOutwardWinding(const SSerializer::MeshData& mesh) {
+    for (size_t t = 0; t < mesh.indices.size(); t += 3) {
+      const Starlet::Math::Vertex& a = mesh.vertices[mesh.indices[t]];
+      const Starlet::Math::Vertex& b = mesh.vertices[mesh.indices[t + 1]];
+      const Starlet::Math::Vertex& c = mesh.vertices[mesh.indices[t + 2]];
+      const float e1[3] = { b.pos.x - a.pos.x, b.pos.y - a.pos.y, b.pos.z - a.pos.z };
+      const float e2[3] = { c.pos.x - a.pos.x, c.pos.y - a.pos.y, c.pos.z - a.pos.z };
+      const float n[3] = { e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0] };
+      EXPECT_GT(n[0] * a.norm.x + n[1] * a.norm.y + n[2] * a.norm.z, 0.0f) << "triangle " << t / 3;
+    }
+  }
+
+  SSerializer::GridData makeGrid(SSerializer::GridType type, unsigned int count, float spacing) {
+    SSerializer::GridData grid;
+    grid.name = "grid";
+    grid.type = type;
+    grid.count = count;
+    grid.spacing = spacing;
+    return grid;
+  }
+};
+
+TEST_F(MeshGeneratorTest, UnitMeshesAreSharedAndWellFormed) {
+  const SSerializer::MeshData& triangle = SSerializer::MeshGenerator::unitMesh(SSerializer::PrimitiveType::Triangle);
+  const SSerializer::MeshData& square = SSerializer::MeshGenerator::unitMesh(SSerializer::PrimitiveType::Square);
+  const SSerializer::MeshData& cube = SSerializer::MeshGenerator::unitMesh(SSerializer::PrimitiveType::Cube);
+  EXPECT_EQ(&cube, &SSerializer::MeshGenerator::unitMesh(SSerializer::PrimitiveType::Cube));
+
+  EXPECT_EQ(triangle.numTriangles, 1u);
+  EXPECT_EQ(square.numTriangles, 2u);
+  EXPECT_EQ(cube.numVertices, 24u);
+  EXPECT_EQ(cube.numTriangles, 12u);
+  for (const SSerializer::MeshData* mesh : { &triangle, &square, &cube }) {
+    EXPECT_TRUE(mesh->hasNormals);
+    EXPECT_TRUE(mesh->hasTexCoords);
+    EXPECT_FLOAT_EQ(mesh->boundsMin.x, -0.5f);
+    EXPECT_FLOAT_EQ(mesh->boundsMax.y, 0.5f);
+    expectOutwardWinding(*mesh);
+  }
+  EXPECT_FLOAT_EQ(square.boundsMax.z, 0.0f);
+  EXPECT_FLOAT_EQ(cube.boundsMin.z, -0.5f);
+}
+
+TEST_F(MeshGeneratorTest, CubeGridMergesElements) {
+  SSerializer::GridData grid = makeGrid(SSerializer::GridType::Cube, 5, 2.0f);
+  grid.transform.size = { 0.5f, 1.0f, 1.5f };
+
+  SSerializer::MeshData mesh;
+  ASSERT_TRUE(generator.generateGrid(grid, mesh));
+  EXPECT_EQ(mesh.numVertices, 125u * 24u);
+  EXPECT_EQ(mesh.numTriangles, 125u * 12u);
+  EXPECT_FLOAT_EQ(mesh.boundsMin.x, -0.25f);
+  EXPECT_FLOAT_EQ(mesh.boundsMax.x, 8.25f);
+  EXPECT_FLOAT_EQ(mesh.boundsMax.y, 8.5f);
+  EXPECT_FLOAT_EQ(mesh.boundsMin.z, -0.75f);
+  expectOutwardWinding(mesh);
+
+  SSerializer::MeshData reference = mesh;
+  SSerializer::BoundsCalculator().compute(reference);
+  EXPECT_FLOAT_EQ(mesh.sphereRadius, reference.sphereRadius);
+  EXPECT_FLOAT_EQ(mesh.sphereCenter.y, reference.sphereCenter.y);
+  EXPECT_FLOAT_EQ(mesh.maxY, reference.maxY);
+
+  // Element 7 is (2, 1, 0): its vertices are the unit cube scaled and moved there
+  const SSerializer::MeshData& cube = SSerializer::MeshGenerator::unitMesh(SSerializer::PrimitiveType::Cube);
+  for (size_t v = 0; v < 24; ++v) {
+    const Starlet::Math::Vertex& out = mesh.vertices[7 * 24 + v];
+    EXPECT_FLOAT_EQ(out.pos.x, cube.vertices[v].pos.x * 0.5f + 4.0f);
+    EXPECT_FLOAT_EQ(out.pos.y, cube.vertices[v].pos.y + 2.0f);
+    EXPECT_FLOAT_EQ(out.pos.z, cube.vertices[v].pos.z * 1.5f);
+    EXPECT_FLOAT_EQ(out.norm.x, cube.vertices[v].norm.x);
+    EXPECT_FLOAT_EQ(out.texCoord.y, cube.vertices[v].texCoord.y);
+  }
+
+  // Separate closed cubes: no open or shared edges across elements
+  SSerializer::TopologyData topology;
+  ASSERT_TRUE(SSerializer::TopologyBuilder().build(mesh, topology));
+  EXPECT_TRUE(topology.nonManifoldEdges.empty());
+  EXPECT_EQ(topology.boundaryHalfEdges.size(), 125u * 24u);
+}
+
+TEST_F(MeshGeneratorTest, SquareGridIsPlanar) {
+  SSerializer::MeshData mesh;
+  ASSERT_TRUE(generator.generateGrid(makeGrid(SSerializer::GridType::Square, 300, 1.0f), mesh));
+  EXPECT_EQ(mesh.numVertices, 300u * 300u * 4u);
+  EXPECT_FLOAT_EQ(mesh.boundsMax.x, 299.5f);
+  EXPECT_FLOAT_EQ(mesh.boundsMax.z, 0.0f);
+  EXPECT_FLOAT_EQ(mesh.boundsMin.z, 0.0f);
+  EXPECT_EQ(mesh.indices.back(), mesh.numVertices - 1);
+}
+
+TEST_F(MeshGeneratorTest, OffsetsMatchMergedLayout) {
+  const SSerializer::GridData grid = makeGrid(SSerializer::GridType::Cube, 7, 3.0f);
+  std::vector<Starlet::Math::Vec3<float>> offsets;
+  ASSERT_TRUE(generator.generateGridOffsets(grid, offsets));
+  ASSERT_EQ(offsets.size(), 343u);
+  EXPECT_FLOAT_EQ(offsets[1].x, 3.0f);
+  EXPECT_FLOAT_EQ(offsets[7].y, 3.0f);
+  EXPECT_FLOAT_EQ(offsets[342].x, 18.0f);
+  EXPECT_FLOAT_EQ(offsets[342].z, 18.0f);
+
+  SSerializer::MeshData mesh;
+  ASSERT_TRUE(generator.generateGrid(grid, mesh));
+  const Starlet::Math::Vertex& first = SSerializer::MeshGenerator::unitMesh(SSerializer::PrimitiveType::Cube).vertices[0];
+  for (size_t e = 0; e < offsets.size(); ++e)
+    EXPECT_FLOAT_EQ(mesh.vertices[e * 24].pos.y, first.pos.y + offsets[e].y);
+}
+
+TEST_F(MeshGeneratorTest, RejectsInvalidGrids) {
+  SSerializer::MeshData mesh;
+  std::vector<Starlet::Math::Vec3<float>> offsets;
+  EXPECT_FALSE(generator.generateGrid(makeGrid(SSerializer::GridType::Cube, 0, 1.0f), mesh));
+  EXPECT_FALSE(generator.generateGrid(makeGrid(SSerializer::GridType::Model, 4, 1.0f), mesh));
+  EXPECT_TRUE(generator.generateGridOffsets(makeGrid(SSerializer::GridType::Model, 4, 1.0f), offsets));
+  EXPECT_EQ(offsets.size(), 64u);
+
+  // 24 vertices per cube overflow 32-bit indices well before the offsets would
+  EXPECT_FALSE(generator.generateGrid(makeGrid(SSerializer::GridType::Cube, 600, 1.0f), mesh));
+}
+
+TEST_F(MeshGeneratorTest, OversizedGridsFailWithoutAllocating) {
+  std::vector<Starlet::Math::Vec3<float>> offsets;
+  testing::internal::CaptureStderr();
+  // 2^21 cubes per axis would ask for ~10^19 offsets in one buffer
+  EXPECT_FALSE(generator.generateGridOffsets(makeGrid(SSerializer::GridType::Cube, 1u << 21, 1.0f), offsets));
+  EXPECT_FALSE(generator.generateGridOffsets(makeGrid(SSerializer::GridType::Model, 4096, 1.0f), offsets));
+  EXPECT_FALSE(generator.generateGridOffsets(makeGrid(SSerializer::GridType::Square, 0xFFFFFFFFu, 1.0f), offsets));
+  EXPECT_FALSE(generator.generateGridOffsets(makeGrid(SSerializer::GridType::Cube, 1000, 1.0f), 0, size_t(1) << 29, offsets));
+  expectStderrContains({ "request element ranges instead: grid" });
+  EXPECT_TRUE(offsets.empty());
+}
+
+TEST_F(MeshGeneratorTest, OffsetRangesReachLargeGrids) {
+  const SSerializer::GridData grid = makeGrid(SSerializer::GridType::Cube, 1000, 2.0f);
+  EXPECT_EQ(SSerializer::MeshGenerator::gridElementCount(grid), 1000000000u);
+
+  // A range crossing row and slice boundaries, and the very last elements
+  std::vector<Starlet::Math::Vec3<float>> offsets;
+  for (uint64_t first : { uint64_t(999990), uint64_t(999999990) }) {
+    ASSERT_TRUE(generator.generateGridOffsets(grid, first, 10, offsets));
+    ASSERT_EQ(offsets.size(), 10u);
+    for (uint64_t e = first; e < first + 10; ++e) {
+      const Starlet::Math::Vec3<float>& o = offsets[e - first];
+      EXPECT_FLOAT_EQ(o.x, static_cast<float>(e % 1000) * 2.0f);
+      EXPECT_FLOAT_EQ(o.y, static_cast<float>((e / 1000) % 1000) * 2.0f);
+      EXPECT_FLOAT_EQ(o.z, static_cast<float>(e / 1000000) * 2.0f);
+    }
+  }
+
+  // Ranges match the whole-grid offsets of a smaller grid
+  const SSerializer::GridData small = makeGrid(SSerializer::GridType::Square, 37, 1.5f);
+  std::vector<Starlet::Math::Vec3<float>> whole, part;
+  ASSERT_TRUE(generator.generateGridOffsets(small, whole));
+  ASSERT_TRUE(generator.generateGridOffsets(small, 100, 500, part));
+  EXPECT_TRUE(std::equal(part.begin(), part.end(), whole.begin() + 100));
+
+  testing::internal::CaptureStderr();
+  EXPECT_FALSE(generator.generateGridOffsets(grid, 999999995, 10, offsets));
+  expectStderrContains({ "outside the grid" });
+}
@@ -0,0 +1,196 @@
+#include "../test_helpers.hpp"
+
+#include "starlet-serializer/processor/mesh/mesh_simplifier.hpp"
+#include "starlet-serializer/data/lod_data.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+  // Grid bulged into a dome, so every collapse has a real geometric cost
+  SSerializer::MeshData makeCurvedGrid(unsigned int size) {
+    SSerializer::MeshData mesh = makeGridMesh(size);
+    for (Starlet::Math::Vertex& v : mesh.vertices)
+      v.pos.z = 0.5f * std::sin(v.pos.x * 3.14159265f) * std::sin(v.pos.y * 3.14159265f);
+    return mesh;
+  }
+
+  // Root mean square vertical distance from the source vertices of a heightfield to `indices`
+  float rmsHeightDeviation(const SSerializer::MeshData& mesh, const std::vector<unsigned int>& indices) {
+    double sum = 0.0;
+    for (const Starlet::Math::Vertex& v : mesh.vertices) {
+      for (size_t t = 0; t < indices.size(); t += 3) {
+        const Starlet::Math::Vec3<float>& a = mesh.vertices[indices[t]].pos;
+        const Starlet::Math::Vec3<float>& b = mesh.vertices[indices[t + 1]].pos;
+        const Starlet::Math::Vec3<float>& c = mesh.vertices[indices[t + 2]].pos;
+        const double area = (b.y - c.y) * (a.x - c.x) + (c.x - b.x) * (a.y - c.y);
+        if (std::fabs(area) < 1e-12) continue;
+        const double wa = ((b.y - c.y) * (v.pos.x - c.x) + (c.x - b.x) * (v.pos.y - c.y)) / area;
+        const double wb = ((c.y - a.y) * (v.pos.x - c.x) + (a.x - c.x) * (v.pos.y - c.y)) / area;
+        const double wc = 1.0 - wa - wb;
+        if (wa < -1e-6 || wb < -1e-6 || wc < -1e-6) continue;
+        const double dz = wa * a.z + wb * b.z + wc * c.z - v.pos.z;
+        sum += dz * dz;
+        break;
+      }
+    }
+    return static_cast<float>(std::sqrt(sum / mesh.vertices.size()));
+  }
+
+  bool usesVertex(const std::vector<unsigned int>& indices, unsigned int vertex) {
+    return std::find(indices.begin(), indices.end(), vertex) != indices.end();
+  }
+}
+
+class MeshSimplifierTest : public ::testing::Test {
+protected:
+  SSerializer::MeshSimplifier simplifier;
+  SSerializer::LodData lod;
+};
+
+TEST_F(MeshSimplifierTest, FlatGridCollapsesInteriorAndKeepsBorder) {
+  const SSerializer::MeshData mesh = makeGridMesh(10);
+  ASSERT_TRUE(simplifier.simplify(mesh, mesh.indices, 0, lod));
+  EXPECT_LT(lod.numTriangles, 60u);
+  EXPECT_EQ(lod.indices.size(), lod.numIndices);
+  EXPECT_NEAR(lod.error, 0.0f, 1e-3f);
+
+  // Corners and edge midpoints stay referenced
+  EXPECT_TRUE(usesVertex(lod.indices, 0));
+  EXPECT_TRUE(usesVertex(lod.indices, 5));
+  EXPECT_TRUE(usesVertex(lod.indices, 120));
+}
+
+TEST_F(MeshSimplifierTest, UnboundedErrorStillKeepsLockedBorder) {
+  const SSerializer::MeshData mesh = makeCurvedGrid(10);
+  SSerializer::SimplifyOptions options;
+  options.maxError = INFINITY;
+  ASSERT_TRUE(simplifier.simplify(mesh, mesh.indices, 0, lod, options));
+  EXPECT_GT(lod.numTriangles, 0u);
+  for (unsigned int y = 0; y <= 10; ++y) {
+    for (unsigned int x = 0; x <= 10; ++x) {
+      if (x == 0 || y == 0 || x == 10 || y == 10) {
+        EXPECT_TRUE(usesVertex(lod.indices, y * 11 + x)) << x << ", " << y;
+      }
+    }
+  }
+}
+
+TEST_F(MeshSimplifierTest, UnlockedBorderSimplifiesFurther) {
+  const SSerializer::MeshData mesh = makeGridMesh(10);
+  SSerializer::SimplifyOptions options;
+  options.lockBorder = false;
+  ASSERT_TRUE(simplifier.simplify(mesh, mesh.indices, 2, lod, options));
+  EXPECT_LE(lod.numTriangles, 8u);
+  EXPECT_GT(lod.numTriangles, 0u);
+}
+
+TEST_F(MeshSimplifierTest, ErrorLimitStopsCollapses) {
+  const SSerializer::MeshData mesh = makeCurvedGrid(16);
+  SSerializer::SimplifyOptions options;
+  options.maxError = 1e-6f;
+  ASSERT_TRUE(simplifier.simplify(mesh, mesh.indices, 0, lod, options));
+  EXPECT_GT(lod.numTriangles, mesh.numTriangles / 2);
+
+  options.maxError = 0.5f;
+  ASSERT_TRUE(simplifier.simplify(mesh, mesh.indices, 0, lod, options));
+  EXPECT_LT(lod.numTriangles, mesh.numTriangles / 4);
+  EXPECT_GT(lod.error, 0.0f);
+}
+
+TEST_F(MeshSimplifierTest, LodChainSharesVertexBuffer) {
+  const SSerializer::MeshData mesh = makeCurvedGrid(32);
+  std::vector<SSerializer::LodData> chain;
+  SSerializer::SimplifyOptions options;
+  options.maxError = 1.0f;
+  ASSERT_TRUE(simplifier.buildLodChain(mesh, { 0.5f, 0.25f, 0.1f }, chain, options));
+  ASSERT_EQ(chain.size(), 3u);
+
+  unsigned int previousTriangles = mesh.numTriangles;
+  float previousError = 0.0f;
+  for (const SSerializer::LodData& level : chain) {
+    EXPECT_LT(level.numTriangles, previousTriangles);
+    EXPECT_GE(level.error, previousError);
+    for (unsigned int i : level.indices) EXPECT_LT(i, mesh.numVertices);
+    previousTriangles = level.numTriangles;
+    previousError = level.error;
+  }
+  EXPECT_LE(chain[0].numTriangles, mesh.numTriangles / 2);
+}
+
+TEST_F(MeshSimplifierTest, LodChainErrorIsMeasuredAgainstSource) {
+  const SSerializer::MeshData mesh = makeCurvedGrid(32);
+  SSerializer::SimplifyOptions options;
+  options.maxError = 0.02f;
+  std::vector<float> ratios;
+  for (float ratio = 0.95f; ratio > 0.01f; ratio *= 0.95f) ratios.push_back(ratio);
+  std::vector<SSerializer::LodData> chain;
+  ASSERT_TRUE(simplifier.buildLodChain(mesh, ratios, chain, options));
+
+  // Many small steps must not drift further from the source than the error limit allows
+  const float deviation = rmsHeightDeviation(mesh, chain.back().indices);
+  EXPECT_LE(chain.back().error, options.maxError);
+  EXPECT_LE(deviation, chain.back().error);
+}
+
+TEST_F(MeshSimplifierTest, SeamVerticesCollapseAlongSeam) {
+  // Flat grid cut down its middle column into two UV charts: the right chart gets its own copies
+  // of the seam vertices and u shifted by 1
+  const unsigned int size = 8, side = size + 1, seamX = size / 2;
+  SSerializer::MeshData mesh = makeGridMesh(size);
+  mesh.hasTexCoords = true;
+  for (Starlet::Math::Vertex& v : mesh.vertices) v.texCoord = { v.pos.x, v.pos.y };
+  std::vector<unsigned int> rightCopy(side);
+  for (unsigned int y = 0; y < side; ++y) {
+    Starlet::Math::Vertex copy = mesh.vertices[y * side + seamX];
+    copy.texCoord.x += 1.0f;
+    rightCopy[y] = static_cast<unsigned int>(mesh.vertices.size());
+    mesh.vertices.push_back(copy);
+  }
+  for (Starlet::Math::Vertex& v : mesh.vertices)
+    if (v.pos.x > 0.5f) v.texCoord.x += 1.0f;
+  for (size_t t = 0; t < mesh.indices.size(); t += 3) {
+    const bool right = mesh.vertices[mesh.indices[t]].pos.x + mesh.vertices[mesh.indices[t + 1]].pos.x + mesh.vertices[mesh.indices[t + 2]].pos.x > 1.5f;
+    for (size_t k = 0; k < 3 && right; ++k)
+      if (mesh.indices[t + k] % side == seamX && mesh.indices[t + k] < side * side) mesh.indices[t + k] = rightCopy[mesh.indices[t + k] / side];
+  }
+  mesh.numVertices = static_cast<unsigned int>(mesh.vertices.size());
+
+  SSerializer::SimplifyOptions options;
+  options.maxError = 0.05f;
+  ASSERT_TRUE(simplifier.simplify(mesh, mesh.indices, 0, lod, options));
+
+  // No triangle straddles the charts, and both sides of the seam keep the same vertices
+  std::vector<float> leftSeam, rightSeam;
+  for (size_t t = 0; t < lod.indices.size(); t += 3) {
+    unsigned int rightCorners = 0;
+    for (size_t k = 0; k < 3; ++k) {
+      const Starlet::Math::Vertex& v = mesh.vertices[lod.indices[t + k]];
+      if (v.texCoord.x >= 1.0f) ++rightCorners;
+      if (v.pos.x == 0.5f) (v.texCoord.x >= 1.0f ? rightSeam : leftSeam).push_back(v.pos.y);
+    }
+    EXPECT_TRUE(rightCorners == 0 || rightCorners == 3);
+  }
+  for (std::vector<float>* seam : { &leftSeam, &rightSeam }) {
+    std::sort(seam->begin(), seam->end());
+    seam->erase(std::unique(seam->begin(), seam->end()), seam->end());
+  }
+  EXPECT_EQ(leftSeam, rightSeam);
+  EXPECT_LT(leftSeam.size(), side);
+  EXPECT_GE(leftSeam.size(), 2u);
+}
+
+TEST_F(MeshSimplifierTest, InvalidRatioFails) {
+  const SSerializer::MeshData mesh = makeGridMesh(2);
+  std::vector<SSerializer::LodData> chain;
+  testing::internal::CaptureStderr();
+  EXPECT_FALSE(simplifier.buildLodChain(mesh, { 1.5f }, chain));
+  expectStderrContains({ "LOD ratio must be in (0, 1]" });
+}
+
+TEST_F(MeshSimplifierTest, OutOfRangeIndexFails) {
+  const SSerializer::MeshData mesh = makeGridMesh(2);
+  testing::internal::CaptureStderr();
+  EXPECT_FALSE(simplifier.simplify(mesh, { 0, 1, 99 }, 0, lod));
+  expectStderrContains({ "Index out of bounds" });
+}
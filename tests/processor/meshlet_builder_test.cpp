@@ -0,0 +1,91 @@
+#include "../test_helpers.hpp"
+
+#include "starlet-serializer/processor/mesh/meshlet_builder.hpp"
+#include "starlet-serializer/data/meshlet_data.hpp"
+
+#include <cmath>
+#include <set>
+
+class MeshletBuilderTest : public ::testing::Test {
+protected:
+  void expectCoversMesh(const SSerializer::MeshData& mesh) {
+    size_t triangles = 0;
+    std::multiset<std::array<unsigned int, 3>> expected, actual;
+    for (size_t t = 0; t < mesh.indices.size(); t += 3)
+      expected.insert({ mesh.indices[t], mesh.indices[t + 1], mesh.indices[t + 2] });
+
+    for (const SSerializer::Meshlet& m : out.meshlets) {
+      EXPECT_LE(m.vertexCount, out.maxVertices);
+      EXPECT_LE(m.triangleCount, out.maxTriangles);
+      for (unsigned int t = 0; t < m.triangleCount; ++t) {
+        std::array<unsigned int, 3> tri{};
+        for (unsigned int k = 0; k < 3; ++k) {
+          const uint8_t local = out.triangles[(m.triangleOffset + t) * 3 + k];
+          EXPECT_LT(local, m.vertexCount);
+          tri[k] = out.vertices[m.vertexOffset + local];
+        }
+        actual.insert(tri);
+        ++triangles;
+      }
+    }
+    EXPECT_EQ(triangles, mesh.indices.size() / 3);
+    EXPECT_EQ(actual, expected);
+  }
+
+  SSerializer::MeshletBuilder builder;
+  SSerializer::MeshletData out;
+};
+
+TEST_F(MeshletBuilderTest, GridSplitsWithinLimits) {
+  const SSerializer::MeshData mesh = makeGridMesh(32);
+  ASSERT_TRUE(builder.build(mesh, out));
+  EXPECT_GE(out.meshlets.size(), mesh.numTriangles / SSerializer::MeshletBuilder::DEFAULT_MAX_TRIANGLES);
+  expectCoversMesh(mesh);
+}
+
+TEST_F(MeshletBuilderTest, SmallLimits) {
+  const SSerializer::MeshData mesh = makeGridMesh(8);
+  ASSERT_TRUE(builder.build(mesh, out, 8, 6));
+  expectCoversMesh(mesh);
+}
+
+TEST_F(MeshletBuilderTest, BoundingSphereContainsVertices) {
+  const SSerializer::MeshData mesh = makeGridMesh(16);
+  ASSERT_TRUE(builder.build(mesh, out, 16, 16));
+  for (const SSerializer::Meshlet& m : out.meshlets) {
+    for (unsigned int i = 0; i < m.vertexCount; ++i) {
+      const Starlet::Math::Vec3<float>& p = mesh.vertices[out.vertices[m.vertexOffset + i]].pos;
+      const float dx = p.x - m.center.x, dy = p.y - m.center.y, dz = p.z - m.center.z;
+      EXPECT_LE(std::sqrt(dx * dx + dy * dy + dz * dz), m.radius + 1e-5f);
+    }
+  }
+}
+
+TEST_F(MeshletBuilderTest, FlatMeshletHasTightCone) {
+  const SSerializer::MeshData mesh = makeGridMesh(4);
+  ASSERT_TRUE(builder.build(mesh, out));
+  ASSERT_EQ(out.meshlets.size(), 1u);
+  const SSerializer::Meshlet& m = out.meshlets[0];
+  EXPECT_NEAR(m.coneAxis.z, 1.0f, 1e-5f);
+  EXPECT_NEAR(m.coneCutoff, 0.0f, 1e-3f);
+
+  // Seen from below the plane every triangle faces away
+  const float eye[3] = { 0.5f, 0.5f, -10.0f };
+  const float dx = m.coneApex.x - eye[0], dy = m.coneApex.y - eye[1], dz = m.coneApex.z - eye[2];
+  const float len = std::sqrt(dx * dx + dy * dy + dz * dz);
+  EXPECT_GE((dx * m.coneAxis.x + dy * m.coneAxis.y + dz * m.coneAxis.z) / len, m.coneCutoff);
+}
+
+TEST_F(MeshletBuilderTest, InvalidLimitsFail) {
+  const SSerializer::MeshData mesh = makeGridMesh(2);
+  testing::internal::CaptureStderr();
+  EXPECT_FALSE(builder.build(mesh, out, 256, 124));
+  expectStderrContains({ "Max vertices must be in [3, 255]" });
+}
+
+TEST_F(MeshletBuilderTest, EmptyMeshFails) {
+  SSerializer::MeshData mesh;
+  testing::internal::CaptureStderr();
+  EXPECT_FALSE(builder.build(mesh, out));
+  expectStderrContains({ "Mesh has no triangle list" });
+}
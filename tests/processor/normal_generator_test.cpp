@@ -0,0 +1,105 @@
+#include "../test_helpers.hpp"
+
+#include "starlet-serializer/processor/mesh/normal_generator.hpp"
+
+#include <cmath>
+
+namespace {
+  // Unit cube with 8 shared corners, wound counter-clockwise when seen from outside
+  SSerializer::MeshData makeCube() {
+    return makeTriangleMesh(
+      { {0,0,0}, {1,0,0}, {1,1,0}, {0,1,0}, {0,0,1}, {1,0,1}, {1,1,1}, {0,1,1} },
+      { 0,2,1, 0,3,2,  4,5,6, 4,6,7,  0,1,5, 0,5,4,  2,3,7, 2,7,6,  0,4,7, 0,7,3,  1,2,6, 1,6,5 });
+  }
+}
+
+class NormalGeneratorTest : public ::testing::Test {
+protected:
+  SSerializer::NormalGenerator generator;
+};
+
+TEST_F(NormalGeneratorTest, FlatQuadFacesPositiveZ) {
+  SSerializer::MeshData mesh = makeTriangleMesh({ {0,0,0}, {1,0,0}, {1,1,0}, {0,1,0} }, { 0,1,2, 0,2,3 });
+  ASSERT_TRUE(generator.generate(mesh));
+  EXPECT_TRUE(mesh.hasNormals);
+  for (const Starlet::Math::Vertex& v : mesh.vertices) {
+    EXPECT_NEAR(v.norm.x, 0.0f, 1e-6f);
+    EXPECT_NEAR(v.norm.y, 0.0f, 1e-6f);
+    EXPECT_NEAR(v.norm.z, 1.0f, 1e-6f);
+  }
+}
+
+TEST_F(NormalGeneratorTest, SmoothCubeCornersPointOutward) {
+  SSerializer::MeshData mesh = makeCube();
+  ASSERT_TRUE(generator.generate(mesh, SSerializer::NormalWeighting::Angle));
+  EXPECT_EQ(mesh.numVertices, 8u);
+
+  const float expected = 1.0f / std::sqrt(3.0f);
+  EXPECT_NEAR(mesh.vertices[6].norm.x, expected, 1e-5f);
+  EXPECT_NEAR(mesh.vertices[6].norm.y, expected, 1e-5f);
+  EXPECT_NEAR(mesh.vertices[6].norm.z, expected, 1e-5f);
+  EXPECT_NEAR(mesh.vertices[0].norm.x, -expected, 1e-5f);
+}
+
+TEST_F(NormalGeneratorTest, AreaWeightingFavoursLargerFaces) {
+  // Two faces share the edge 0-1: a large one in the XY plane and a small one in the XZ plane
+  SSerializer::MeshData mesh = makeTriangleMesh({ {0,0,0}, {1,0,0}, {0,10,0}, {0,0,-0.1f} }, { 0,1,2, 0,3,1 });
+  ASSERT_TRUE(generator.generate(mesh, SSerializer::NormalWeighting::Area));
+  EXPECT_GT(mesh.vertices[0].norm.z, 0.99f);
+}
+
+TEST_F(NormalGeneratorTest, CreaseAngleSplitsHardEdges) {
+  SSerializer::MeshData mesh = makeCube();
+  ASSERT_TRUE(generator.generate(mesh, SSerializer::NormalWeighting::Angle, 30.0f));
+  EXPECT_EQ(mesh.numVertices, 24u);
+  EXPECT_EQ(mesh.vertices.size(), 24u);
+  EXPECT_EQ(mesh.indices.size(), 36u);
+
+  for (size_t t = 0; t < mesh.indices.size() / 3; ++t) {
+    const Starlet::Math::Vec3<float>& n0 = mesh.vertices[mesh.indices[t * 3]].norm;
+    for (size_t k = 1; k < 3; ++k) {
+      const Starlet::Math::Vec3<float>& n = mesh.vertices[mesh.indices[t * 3 + k]].norm;
+      EXPECT_FLOAT_EQ(n.x, n0.x);
+      EXPECT_FLOAT_EQ(n.y, n0.y);
+      EXPECT_FLOAT_EQ(n.z, n0.z);
+    }
+  }
+}
+
+TEST_F(NormalGeneratorTest, CreaseAngleKeepsSmoothSurfacesShared) {
+  SSerializer::MeshData mesh = makeTriangleMesh({ {0,0,0}, {1,0,0}, {1,1,0}, {0,1,0} }, { 0,1,2, 0,2,3 });
+  ASSERT_TRUE(generator.generate(mesh, SSerializer::NormalWeighting::Angle, 30.0f));
+  EXPECT_EQ(mesh.numVertices, 4u);
+}
+
+TEST_F(NormalGeneratorTest, EmptyMeshFails) {
+  SSerializer::MeshData mesh;
+  testing::internal::CaptureStderr();
+  EXPECT_FALSE(generator.generate(mesh));
+  expectStderrContains({ "Mesh has no triangles" });
+}
+
+TEST_F(NormalGeneratorTest, OutOfRangeIndexFails) {
+  SSerializer::MeshData mesh = makeTriangleMesh({ {0,0,0}, {1,0,0}, {0,1,0} }, { 0,1,5 });
+  testing::internal::CaptureStderr();
+  EXPECT_FALSE(generator.generate(mesh));
+  expectStderrContains({ "Index out of bounds" });
+}
+
+TEST_F(MeshParserTest, ParseGeneratesNormalsWhenMissing) {
+  createTestFile("test_data/no_normals.obj", "v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 3\n");
+  SSerializer::MeshParseOptions options;
+  options.generateNormals = true;
+  ASSERT_TRUE(parser.parse("test_data/no_normals.obj", out, options));
+  EXPECT_TRUE(out.hasNormals);
+  EXPECT_NEAR(out.vertices[0].norm.z, 1.0f, 1e-6f);
+}
+
+TEST_F(MeshParserTest, ParseKeepsSourceNormals) {
+  createTestFile("test_data/with_normals.obj", "v 0 0 0\nv 1 0 0\nv 0 1 0\nvn 1 0 0\nf 1//1 2//1 3//1\n");
+  SSerializer::MeshParseOptions options;
+  options.generateNormals = true;
+  ASSERT_TRUE(parser.parse("test_data/with_normals.obj", out, options));
+  EXPECT_FLOAT_EQ(out.vertices[0].norm.x, 1.0f);
+  EXPECT_FLOAT_EQ(out.vertices[0].norm.z, 0.0f);
+}
@@ -0,0 +1,162 @@
+#include "../test_helpers.hpp"
+
+#include "starlet-serializer/processor/mesh/point_cloud_processor.hpp"
+
+#include <algorithm>
+#include <random>
+
+class PointCloudProcessorTest : public ::testing::Test {
+protected:
+  // n^3 lattice points over [0, 1], shuffled, with colour red = x so attributes can be tracked
+  static SSerializer::MeshData makeLattice(unsigned int n) {
+    SSerializer::MeshData cloud;
+    for (unsigned int z = 0; z < n; ++z)
+      for (unsigned int y = 0; y < n; ++y)
+        for (unsigned int x = 0; x < n; ++x) {
+          Starlet::Math::Vertex v;
+          v.pos = { float(x) / (n - 1), float(y) / (n - 1), float(z) / (n - 1) };
+          v.col = { v.pos.x, 0.0f, 0.0f, 1.0f };
+          cloud.vertices.push_back(v);
+        }
+    std::shuffle(cloud.vertices.begin(), cloud.vertices.end(), std::mt19937(4));
+    cloud.numVertices = static_cast<unsigned int>(cloud.vertices.size());
+    cloud.hasColours = true;
+    return cloud;
+  }
+
+  SSerializer::PointCloudProcessor processor;
+  std::vector<uint64_t> codes;
+  std::vector<SSerializer::MeshData> levels;
+};
+
+TEST_F(PointCloudProcessorTest, MortonSortOrdersPoints) {
+  SSerializer::MeshData cloud = makeLattice(8);
+  ASSERT_TRUE(processor.mortonSort(cloud, &codes));
+  ASSERT_EQ(codes.size(), 512u);
+  EXPECT_TRUE(std::is_sorted(codes.begin(), codes.end()));
+  EXPECT_EQ(codes.front(), 0u);
+
+  // First octant (all coordinates below 0.5) comes first
+  for (size_t i = 0; i < 64; ++i) {
+    EXPECT_LT(cloud.vertices[i].pos.x, 0.5f);
+    EXPECT_LT(cloud.vertices[i].pos.y, 0.5f);
+    EXPECT_LT(cloud.vertices[i].pos.z, 0.5f);
+  }
+  for (const Starlet::Math::Vertex& v : cloud.vertices) EXPECT_FLOAT_EQ(v.col.x, v.pos.x);
+}
+
+TEST_F(PointCloudProcessorTest, MortonSortRemapsIndices) {
+  SSerializer::MeshData cloud = makeLattice(4);
+  std::vector<Starlet::Math::Vec3<float>> expected;
+  for (unsigned int i = 0; i < 30; ++i) {
+    cloud.indices.push_back(i * 2);
+    expected.push_back(cloud.vertices[i * 2].pos);
+  }
+  ASSERT_TRUE(processor.mortonSort(cloud));
+  for (size_t i = 0; i < expected.size(); ++i) {
+    EXPECT_FLOAT_EQ(cloud.vertices[cloud.indices[i]].pos.x, expected[i].x);
+    EXPECT_FLOAT_EQ(cloud.vertices[cloud.indices[i]].pos.z, expected[i].z);
+  }
+}
+
+TEST_F(PointCloudProcessorTest, BudgetedSortMatchesRadixSort) {
+  SSerializer::MeshData reference = makeLattice(24);
+  SSerializer::MeshData cloud = reference;
+  ASSERT_TRUE(processor.mortonSort(reference, &codes));
+
+  // A one-byte budget forces the in-place sort
+  std::vector<uint64_t> budgetCodes;
+  ASSERT_TRUE(processor.mortonSort(cloud, &budgetCodes, 1));
+  EXPECT_EQ(budgetCodes, codes);
+  for (size_t i = 0; i < cloud.vertices.size(); ++i) {
+    EXPECT_EQ(cloud.vertices[i].pos.x, reference.vertices[i].pos.x);
+    EXPECT_EQ(cloud.vertices[i].pos.y, reference.vertices[i].pos.y);
+    EXPECT_EQ(cloud.vertices[i].pos.z, reference.vertices[i].pos.z);
+    EXPECT_EQ(cloud.vertices[i].col.x, cloud.vertices[i].pos.x);
+  }
+}
+
+TEST_F(PointCloudProcessorTest, BudgetedSortRemapsIndices) {
+  SSerializer::MeshData cloud = makeLattice(10);
+  std::vector<Starlet::Math::Vec3<float>> expected;
+  for (unsigned int i = 0; i < 300; ++i) {
+    cloud.indices.push_back(i * 3);
+    expected.push_back(cloud.vertices[i * 3].pos);
+  }
+  ASSERT_TRUE(processor.mortonSort(cloud, nullptr, 1));
+  for (size_t i = 0; i < expected.size(); ++i) {
+    EXPECT_EQ(cloud.vertices[cloud.indices[i]].pos.x, expected[i].x);
+    EXPECT_EQ(cloud.vertices[cloud.indices[i]].pos.y, expected[i].y);
+    EXPECT_EQ(cloud.vertices[cloud.indices[i]].pos.z, expected[i].z);
+  }
+}
+
+TEST_F(PointCloudProcessorTest, BudgetedLevelsMatchUnbudgeted) {
+  SSerializer::MeshData cloud = makeLattice(20);
+  SSerializer::MeshData budgetCloud = cloud;
+  SSerializer::PointCloudOptions options;
+  options.finestGridBits = 4;
+  options.levelCount = 3;
+  ASSERT_TRUE(processor.process(cloud, options, levels));
+
+  std::vector<SSerializer::MeshData> budgetLevels;
+  options.memoryBudget = 1;
+  ASSERT_TRUE(processor.process(budgetCloud, options, budgetLevels));
+  ASSERT_EQ(budgetLevels.size(), levels.size());
+  for (size_t l = 0; l < levels.size(); ++l) {
+    ASSERT_EQ(budgetLevels[l].numVertices, levels[l].numVertices);
+    for (size_t i = 0; i < levels[l].vertices.size(); ++i) {
+      EXPECT_NEAR(budgetLevels[l].vertices[i].pos.x, levels[l].vertices[i].pos.x, 1e-6f);
+      EXPECT_NEAR(budgetLevels[l].vertices[i].pos.y, levels[l].vertices[i].pos.y, 1e-6f);
+      EXPECT_NEAR(budgetLevels[l].vertices[i].pos.z, levels[l].vertices[i].pos.z, 1e-6f);
+    }
+  }
+}
+
+TEST_F(PointCloudProcessorTest, LevelsAverageVoxels) {
+  SSerializer::MeshData cloud = makeLattice(16);
+  SSerializer::PointCloudOptions options;
+  options.finestGridBits = 2;
+  options.levelCount = 3;
+  ASSERT_TRUE(processor.process(cloud, options, levels));
+
+  // 4^3 voxels of 4^3 points, then 2^3, then 1 (levelCount is capped at finestGridBits)
+  ASSERT_EQ(levels.size(), 2u);
+  EXPECT_EQ(levels[0].numVertices, 64u);
+  EXPECT_EQ(levels[1].numVertices, 8u);
+  EXPECT_TRUE(levels[0].hasColours);
+
+  const Starlet::Math::Vertex& first = levels[0].vertices[0];
+  EXPECT_NEAR(first.pos.x, 1.5f / 15.0f, 1e-5f);
+  EXPECT_NEAR(first.col.x, first.pos.x, 1e-5f);
+  EXPECT_NEAR(levels[1].vertices[7].pos.y, 11.5f / 15.0f, 1e-5f);
+}
+
+TEST_F(PointCloudProcessorTest, CoarseLevelsWeightByPointCount) {
+  // Voxel (0,0,0) of a 2-voxel grid holds two fine voxels with 1 and 3 points
+  SSerializer::MeshData cloud;
+  for (const auto& p : std::vector<std::array<float, 3>>{ { 0, 0, 0 }, { 0.3f, 0, 0 }, { 0.3f, 0, 0 }, { 0.3f, 0, 0 }, { 1, 1, 1 } }) {
+    Starlet::Math::Vertex v;
+    v.pos = { p[0], p[1], p[2] };
+    cloud.vertices.push_back(v);
+  }
+  SSerializer::PointCloudOptions options;
+  options.finestGridBits = 2;
+  options.levelCount = 2;
+  ASSERT_TRUE(processor.process(cloud, options, levels));
+  ASSERT_EQ(levels.size(), 2u);
+  EXPECT_EQ(levels[0].numVertices, 3u);
+  ASSERT_EQ(levels[1].numVertices, 2u);
+  EXPECT_NEAR(levels[1].vertices[0].pos.x, 0.9f / 4.0f, 1e-6f);
+}
+
+TEST_F(PointCloudProcessorTest, RejectsInvalidInput) {
+  testing::internal::CaptureStderr();
+  SSerializer::MeshData empty;
+  EXPECT_FALSE(processor.mortonSort(empty));
+  SSerializer::MeshData cloud = makeLattice(2);
+  SSerializer::PointCloudOptions options;
+  options.finestGridBits = 30;
+  EXPECT_FALSE(processor.process(cloud, options, levels));
+  expectStderrContains({ "Point cloud has no vertices", "Finest grid bits must be in [1, 21]" });
+}
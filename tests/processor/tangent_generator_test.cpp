@@ -0,0 +1,105 @@
+#include "../test_helpers.hpp"
+
+#include "starlet-serializer/processor/mesh/tangent_generator.hpp"
+
+namespace {
+  SSerializer::MeshData makeTexturedMesh(const std::vector<std::array<float, 3>>& positions, const std::vector<std::array<float, 2>>& uvs, const std::vector<unsigned int>& indices) {
+    SSerializer::MeshData mesh = makeTriangleMesh(positions, indices);
+    for (size_t i = 0; i < mesh.vertices.size(); ++i) {
+      mesh.vertices[i].texCoord = { uvs[i][0], uvs[i][1] };
+      mesh.vertices[i].norm = { 0.0f, 0.0f, 1.0f };
+    }
+    mesh.hasTexCoords = mesh.hasNormals = true;
+    return mesh;
+  }
+}
+
+class TangentGeneratorTest : public ::testing::Test {
+protected:
+  SSerializer::TangentGenerator generator;
+};
+
+TEST_F(TangentGeneratorTest, QuadTangentFollowsU) {
+  SSerializer::MeshData mesh = makeTexturedMesh(
+    { {0,0,0}, {1,0,0}, {1,1,0}, {0,1,0} },
+    { {0,0}, {1,0}, {1,1}, {0,1} },
+    { 0,1,2, 0,2,3 });
+  ASSERT_TRUE(generator.generate(mesh));
+  EXPECT_TRUE(mesh.hasTangents);
+  ASSERT_EQ(mesh.tangents.size(), 4u);
+  for (const Starlet::Math::Vec4<float>& t : mesh.tangents) {
+    EXPECT_NEAR(t.x, 1.0f, 1e-6f);
+    EXPECT_NEAR(t.y, 0.0f, 1e-6f);
+    EXPECT_NEAR(t.z, 0.0f, 1e-6f);
+    EXPECT_FLOAT_EQ(t.w, 1.0f);
+  }
+}
+
+TEST_F(TangentGeneratorTest, FlippedVAxisGivesNegativeHandedness) {
+  SSerializer::MeshData mesh = makeTexturedMesh(
+    { {0,0,0}, {1,0,0}, {1,1,0}, {0,1,0} },
+    { {0,1}, {1,1}, {1,0}, {0,0} },
+    { 0,1,2, 0,2,3 });
+  ASSERT_TRUE(generator.generate(mesh));
+  EXPECT_EQ(mesh.numVertices, 4u);
+  for (const Starlet::Math::Vec4<float>& t : mesh.tangents)
+    EXPECT_FLOAT_EQ(t.w, -1.0f);
+}
+
+TEST_F(TangentGeneratorTest, MirroredUvsSplitSharedVertices) {
+  // Two quads share the edge x = 1; the right one mirrors U back towards the seam
+  SSerializer::MeshData mesh = makeTexturedMesh(
+    { {0,0,0}, {1,0,0}, {1,1,0}, {0,1,0}, {2,0,0}, {2,1,0} },
+    { {0,0}, {1,0}, {1,1}, {0,1}, {0,0}, {0,1} },
+    { 0,1,2, 0,2,3, 1,4,5, 1,5,2 });
+  ASSERT_TRUE(generator.generate(mesh));
+  EXPECT_EQ(mesh.numVertices, 8u);
+  EXPECT_EQ(mesh.tangents.size(), 8u);
+
+  for (size_t t = 0; t < mesh.indices.size() / 3; ++t) {
+    const float w = mesh.tangents[mesh.indices[t * 3]].w;
+    EXPECT_FLOAT_EQ(mesh.tangents[mesh.indices[t * 3 + 1]].w, w);
+    EXPECT_FLOAT_EQ(mesh.tangents[mesh.indices[t * 3 + 2]].w, w);
+  }
+  EXPECT_FLOAT_EQ(mesh.tangents[mesh.indices[0]].w, 1.0f);
+  EXPECT_FLOAT_EQ(mesh.tangents[mesh.indices[6]].w, -1.0f);
+}
+
+TEST_F(TangentGeneratorTest, DegenerateUvsStillGivePerpendicularTangent) {
+  SSerializer::MeshData mesh = makeTexturedMesh(
+    { {0,0,0}, {1,0,0}, {0,1,0} },
+    { {0,0}, {0,0}, {0,0} },
+    { 0,1,2 });
+  ASSERT_TRUE(generator.generate(mesh));
+  for (const Starlet::Math::Vec4<float>& t : mesh.tangents) {
+    EXPECT_NEAR(t.x * t.x + t.y * t.y + t.z * t.z, 1.0f, 1e-5f);
+    EXPECT_NEAR(t.z, 0.0f, 1e-6f);
+  }
+}
+
+TEST_F(TangentGeneratorTest, MissingTexCoordsFails) {
+  SSerializer::MeshData mesh = makeTriangleMesh({ {0,0,0}, {1,0,0}, {0,1,0} }, { 0,1,2 });
+  mesh.hasNormals = true;
+  testing::internal::CaptureStderr();
+  EXPECT_FALSE(generator.generate(mesh));
+  expectStderrContains({ "Mesh has no texture coordinates" });
+}
+
+TEST_F(TangentGeneratorTest, MissingNormalsFails) {
+  SSerializer::MeshData mesh = makeTexturedMesh({ {0,0,0}, {1,0,0}, {0,1,0} }, { {0,0}, {1,0}, {0,1} }, { 0,1,2 });
+  mesh.hasNormals = false;
+  testing::internal::CaptureStderr();
+  EXPECT_FALSE(generator.generate(mesh));
+  expectStderrContains({ "Mesh has no normals" });
+}
+
+TEST_F(MeshParserTest, ParseGeneratesTangentsForTexturedMesh) {
+  createTestFile("test_data/textured.obj", "v 0 0 0\nv 1 0 0\nv 0 1 0\nvt 0 0\nvt 1 0\nvt 0 1\nf 1/1 2/2 3/3\n");
+  SSerializer::MeshParseOptions options;
+  options.generateTangents = true;
+  ASSERT_TRUE(parser.parse("test_data/textured.obj", out, options));
+  EXPECT_TRUE(out.hasNormals);
+  EXPECT_TRUE(out.hasTangents);
+  ASSERT_EQ(out.tangents.size(), out.vertices.size());
+  EXPECT_NEAR(out.tangents[0].x, 1.0f, 1e-6f);
+}
@@ -0,0 +1,218 @@
+#include "../test_helpers.hpp"
+
+#include "starlet-serializer/processor/mesh/terrain_generator.hpp"
+#include "starlet-serializer/data/terrain_data.hpp"
+#include "starlet-serializer/data/image_data.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+class TerrainGeneratorTest : public ::testing::Test {
+protected:
+  SSerializer::TerrainGenerator generator;
+
+  // RGB heightmap whose green channel is a ramp along x and red channel a bump
+  SSerializer::ImageData makeHeightmap(int width, int height) {
+    SSerializer::ImageData image;
+    image.width = width;
+    image.height = height;
+    image.pixelSize = 3;
+    image.byteSize = static_cast<size_t>(width) * height * 3;
+    image.pixels.resize(image.byteSize);
+    for (int z = 0; z < height; ++z) {
+      for (int x = 0; x < width; ++x) {
+        uint8_t* p = &image.pixels[(static_cast<size_t>(z) * width + x) * 3];
+        const float dx = static_cast<float>(x - width / 2), dz = static_cast<float>(z - height / 2);
+        p[0] = static_cast<uint8_t>(255.0f * std::exp(-(dx * dx + dz * dz) / 40.0f));
+        p[1] = static_cast<uint8_t>(x % 256);
+        p[2] = 7;
+      }
+    }
+    return image;
+  }
+
+  const Starlet::Math::Vertex& vertexAt(const SSerializer::TerrainChunk& chunk, unsigned int x, unsigned int z, unsigned int cols) {
+    return chunk.mesh.vertices[z * cols + x];
+  }
+};
+
+TEST_F(TerrainGeneratorTest, RampHasExactHeightsAndNormals) {
+  SSerializer::TerrainOptions options;
+  options.channel = 1;
+  options.horizontalScale = 2.0f;
+  options.heightScale = 255.0f; // One unit per height step
+  options.chunkSize = 8;
+
+  SSerializer::TerrainData terrain;
+  ASSERT_TRUE(generator.generate(makeHeightmap(17, 9), options, terrain));
+  EXPECT_EQ(terrain.chunksX, 2u);
+  EXPECT_EQ(terrain.chunksZ, 1u);
+  ASSERT_EQ(terrain.chunks.size(), 2u);
+
+  const SSerializer::TerrainChunk& right = terrain.chunks[1];
+  EXPECT_EQ(right.chunkX, 1u);
+  EXPECT_EQ(right.mesh.numVertices, 81u);
+  EXPECT_EQ(right.mesh.numTriangles, 128u);
+  EXPECT_TRUE(right.mesh.hasNormals);
+
+  // Pixel (11, 4): x = 22, height 11; the ramp rises 1 per 2 units of x
+  const Starlet::Math::Vertex& v = vertexAt(right, 3, 4, 9);
+  EXPECT_FLOAT_EQ(v.pos.x, 22.0f);
+  EXPECT_FLOAT_EQ(v.pos.y, 11.0f);
+  EXPECT_FLOAT_EQ(v.pos.z, 8.0f);
+  const float n = 1.0f / std::sqrt(1.0f + 4.0f);
+  EXPECT_NEAR(v.norm.x, -n, 1e-6f);
+  EXPECT_NEAR(v.norm.y, 2.0f * n, 1e-6f);
+  EXPECT_NEAR(v.norm.z, 0.0f, 1e-6f);
+  EXPECT_FLOAT_EQ(v.texCoord.x, 11.0f / 16.0f);
+
+  // Chunks share their border vertices exactly, normals included
+  for (unsigned int z = 0; z < 9; ++z) {
+    const Starlet::Math::Vertex& a = vertexAt(terrain.chunks[0], 8, z, 9);
+    const Starlet::Math::Vertex& b = vertexAt(right, 0, z, 9);
+    EXPECT_FLOAT_EQ(a.pos.y, b.pos.y);
+    EXPECT_FLOAT_EQ(a.norm.x, b.norm.x);
+    EXPECT_FLOAT_EQ(a.norm.z, b.norm.z);
+  }
+  EXPECT_FLOAT_EQ(right.mesh.boundsMin.x, 16.0f);
+  EXPECT_FLOAT_EQ(right.mesh.boundsMax.y, 16.0f);
+}
+
+TEST_F(TerrainGeneratorTest, TrianglesFaceUpAndSkirtsFaceOut) {
+  SSerializer::TerrainOptions options;
+  options.chunkSize = 6;
+  options.skirtDepth = 1.0f;
+
+  SSerializer::TerrainData terrain;
+  ASSERT_TRUE(generator.generate(makeHeightmap(7, 7), options, terrain));
+  const SSerializer::MeshData& mesh = terrain.chunks[0].mesh;
+  EXPECT_EQ(mesh.numVertices, 49u + 28u);
+  EXPECT_LT(mesh.boundsMin.y, 0.0f); // Skirts hang a full unit below the lowest sample
+
+  const float centre[3] = { 3.0f, 0.0f, 3.0f };
+  for (size_t t = 0; t < mesh.indices.size(); t += 3) {
+    const auto& a = mesh.vertices[mesh.indices[t]].pos;
+    const auto& b = mesh.vertices[mesh.indices[t + 1]].pos;
+    const auto& c = mesh.vertices[mesh.indices[t + 2]].pos;
+    const float e1[3] = { b.x - a.x, b.y - a.y, b.z - a.z }, e2[3] = { c.x - a.x, c.y - a.y, c.z - a.z };
+    const float n[3] = { e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0] };
+    if (t < 6u * 36u) {
+      EXPECT_GT(n[1], 0.0f) << "surface triangle " << t / 3;
+    } else {
+      // Skirt walls point away from the chunk centre
+      const float out[2] = { (a.x + b.x + c.x) / 3.0f - centre[0], (a.z + b.z + c.z) / 3.0f - centre[2] };
+      EXPECT_GT(n[0] * out[0] + n[2] * out[1], 0.0f) << "skirt triangle " << t / 3;
+    }
+  }
+  EXPECT_EQ(mesh.numTriangles, 72u + 48u);
+}
+
+TEST_F(TerrainGeneratorTest, LodsHalveResolutionOverSharedVertices) {
+  SSerializer::TerrainOptions options;
+  options.chunkSize = 16;
+  options.lodCount = 3;
+  options.skirtDepth = 0.5f;
+
+  SSerializer::TerrainData terrain;
+  ASSERT_TRUE(generator.generate(makeHeightmap(17, 17), options, terrain));
+  const SSerializer::TerrainChunk& chunk = terrain.chunks[0];
+  ASSERT_EQ(chunk.lods.size(), 3u);
+  EXPECT_EQ(chunk.lods[0].indices, chunk.mesh.indices);
+  EXPECT_EQ(chunk.lods[0].numTriangles, 16u * 16u * 2u + 4u * 16u * 2u);
+  EXPECT_EQ(chunk.lods[1].numTriangles, 8u * 8u * 2u + 4u * 8u * 2u);
+  EXPECT_EQ(chunk.lods[2].numTriangles, 4u * 4u * 2u + 4u * 4u * 2u);
+  EXPECT_FLOAT_EQ(chunk.lods[0].error, 0.0f);
+  EXPECT_GT(chunk.lods[1].error, 0.0f);
+  EXPECT_GE(chunk.lods[2].error, chunk.lods[1].error);
+
+  // Coarse levels only reference every fourth grid vertex (and skirt vertices)
+  for (unsigned int i : chunk.lods[2].indices) {
+    if (i < 17u * 17u) {
+      EXPECT_EQ(i % 17 % 4, 0u);
+      EXPECT_EQ(i / 17 % 4, 0u);
+    }
+  }
+}
+
+TEST_F(TerrainGeneratorTest, PartialChunksKeepTheLastSample) {
+  SSerializer::TerrainOptions options;
+  options.chunkSize = 8;
+  options.lodCount = 3;
+
+  SSerializer::TerrainData terrain;
+  ASSERT_TRUE(generator.generate(makeHeightmap(12, 12), options, terrain));
+  ASSERT_EQ(terrain.chunks.size(), 4u);
+  const SSerializer::TerrainChunk& last = terrain.chunks[3];
+  EXPECT_EQ(last.mesh.numVertices, 16u); // 3 quads + 1 per side
+  EXPECT_EQ(last.lods[2].numTriangles, 2u);
+  EXPECT_FLOAT_EQ(last.mesh.boundsMax.x, 11.0f);
+}
+
+TEST_F(TerrainGeneratorTest, StreamingMatchesBatchOutput) {
+  SSerializer::TerrainOptions options;
+  options.chunkSize = 4;
+  const SSerializer::ImageData image = makeHeightmap(21, 13);
+
+  SSerializer::TerrainData terrain;
+  ASSERT_TRUE(generator.generate(image, options, terrain));
+
+  size_t next = 0;
+  ASSERT_TRUE(generator.generate(image, options, [&](SSerializer::TerrainChunk& chunk) {
+    const SSerializer::TerrainChunk& expected = terrain.chunks[next++];
+    EXPECT_EQ(chunk.chunkX, expected.chunkX);
+    EXPECT_EQ(chunk.chunkZ, expected.chunkZ);
+    EXPECT_EQ(chunk.mesh.indices, expected.mesh.indices);
+    EXPECT_FLOAT_EQ(chunk.mesh.vertices.back().pos.y, expected.mesh.vertices.back().pos.y);
+    return true;
+  }));
+  EXPECT_EQ(next, terrain.chunks.size());
+
+  testing::internal::CaptureStderr();
+  EXPECT_FALSE(generator.generate(image, options, [](SSerializer::TerrainChunk&) { return false; }));
+  expectStderrContains({ "Chunk sink stopped" });
+}
+
+TEST_F(TerrainGeneratorTest, BottomUpRowsMatchTopDown) {
+  SSerializer::TerrainOptions options;
+  options.chunkSize = 4;
+  options.channel = 2;
+  // The helper's channels are symmetric in z; a slope along z shows any mirroring
+  SSerializer::ImageData topDown = makeHeightmap(9, 11);
+  for (int z = 0; z < topDown.height; ++z)
+    for (int x = 0; x < topDown.width; ++x) topDown.pixels[(static_cast<size_t>(z) * topDown.width + x) * 3 + 2] = static_cast<uint8_t>(z * 20 + x);
+
+  // Same image with its rows stored last to first, as a native-layout BMP decodes
+  SSerializer::ImageData bottomUp = topDown;
+  bottomUp.bottomUp = true;
+  const size_t rowSize = static_cast<size_t>(topDown.width) * topDown.pixelSize;
+  for (int z = 0; z < topDown.height; ++z)
+    std::copy_n(topDown.pixels.begin() + z * rowSize, rowSize, bottomUp.pixels.begin() + (topDown.height - 1 - z) * rowSize);
+
+  SSerializer::TerrainData expected, flipped;
+  ASSERT_TRUE(generator.generate(topDown, options, expected));
+  ASSERT_TRUE(generator.generate(bottomUp, options, flipped));
+  ASSERT_EQ(flipped.chunks.size(), expected.chunks.size());
+  for (size_t c = 0; c < expected.chunks.size(); ++c) {
+    const std::vector<Starlet::Math::Vertex>& a = expected.chunks[c].mesh.vertices;
+    const std::vector<Starlet::Math::Vertex>& b = flipped.chunks[c].mesh.vertices;
+    ASSERT_EQ(a.size(), b.size());
+    for (size_t v = 0; v < a.size(); ++v) {
+      EXPECT_EQ(b[v].pos, a[v].pos) << "chunk " << c << " vertex " << v;
+      EXPECT_EQ(b[v].norm, a[v].norm) << "chunk " << c << " vertex " << v;
+    }
+  }
+}
+
+TEST_F(TerrainGeneratorTest, RejectsBadInput) {
+  SSerializer::TerrainData terrain;
+  SSerializer::TerrainOptions options;
+  testing::internal::CaptureStderr();
+  EXPECT_FALSE(generator.generate(makeHeightmap(1, 5), options, terrain));
+  options.channel = 3;
+  EXPECT_FALSE(generator.generate(makeHeightmap(5, 5), options, terrain));
+  options.channel = 0;
+  options.chunkSize = 4;
+  options.lodCount = 4;
+  EXPECT_FALSE(generator.generate(makeHeightmap(5, 5), options, terrain));
+  expectStderrContains({ "at least 2x2", "out of range for 3-byte pixels", "too high for chunk size 4" });
+}
@@ -0,0 +1,95 @@
+#include "../test_helpers.hpp"
+
+#include "starlet-serializer/processor/mesh/topology_builder.hpp"
+#include "starlet-serializer/data/topology_data.hpp"
+#include "starlet-serializer/utils/radix_sort.hpp"
+
+#include <random>
+
+class TopologyBuilderTest : public ::testing::Test {
+protected:
+  SSerializer::TopologyBuilder builder;
+  SSerializer::TopologyData out;
+};
+
+TEST_F(TopologyBuilderTest, GridEdgesAndBoundary) {
+  constexpr unsigned int size = 40;
+  const SSerializer::MeshData mesh = makeGridMesh(size);
+  ASSERT_TRUE(builder.build(mesh, out));
+
+  EXPECT_EQ(out.edgeCount, 2u * size * (size + 1) + size * size);
+  EXPECT_EQ(out.boundaryHalfEdges.size(), 4u * size);
+  EXPECT_TRUE(out.nonManifoldEdges.empty());
+  EXPECT_EQ(out.flippedEdges, 0u);
+
+  for (uint32_t h = 0; h < out.twins.size(); ++h) {
+    const uint32_t twin = out.twins[h];
+    if (twin == SSerializer::TopologyData::NO_TWIN) continue;
+    EXPECT_EQ(out.twins[twin], h);
+    EXPECT_EQ(mesh.indices[twin], mesh.indices[SSerializer::TopologyData::next(h)]);
+    EXPECT_EQ(mesh.indices[SSerializer::TopologyData::next(twin)], mesh.indices[h]);
+  }
+
+  // The two triangles of the first quad share their diagonal
+  EXPECT_EQ(out.neighbour(0, 2), 1u);
+  EXPECT_EQ(out.neighbour(1, 0), 0u);
+  EXPECT_EQ(out.neighbour(0, 0), SSerializer::TopologyData::NO_TWIN);
+}
+
+TEST_F(TopologyBuilderTest, ReportsNonManifoldEdges) {
+  // Three triangles hinged on edge 0-1
+  const SSerializer::MeshData mesh = makeTriangleMesh(
+    { { 0, 0, 0 }, { 1, 0, 0 }, { 0, 1, 0 }, { 0, -1, 0 }, { 0, 0, 1 } },
+    { 0, 1, 2, 1, 0, 3, 0, 1, 4 });
+  ASSERT_TRUE(builder.build(mesh, out));
+  ASSERT_EQ(out.nonManifoldEdges.size(), 1u);
+  EXPECT_EQ(out.nonManifoldEdges[0].v0, 0u);
+  EXPECT_EQ(out.nonManifoldEdges[0].v1, 1u);
+  EXPECT_EQ(out.nonManifoldEdges[0].faceCount, 3u);
+  EXPECT_EQ(out.twins[0], SSerializer::TopologyData::NO_TWIN);
+  EXPECT_EQ(out.boundaryHalfEdges.size(), 6u);
+  EXPECT_EQ(out.edgeCount, 7u);
+}
+
+TEST_F(TopologyBuilderTest, CountsFlippedWindingAndSkipsDegenerate) {
+  const SSerializer::MeshData mesh = makeTriangleMesh(
+    { { 0, 0, 0 }, { 1, 0, 0 }, { 0, 1, 0 }, { 1, 1, 0 } },
+    { 0, 1, 2, 1, 3, 2, 0, 0, 3 });
+  ASSERT_TRUE(builder.build(mesh, out));
+  EXPECT_EQ(out.flippedEdges, 0u);
+  EXPECT_EQ(out.twins[6], SSerializer::TopologyData::NO_TWIN);
+  EXPECT_EQ(out.edgeCount, 6u);
+
+  const SSerializer::MeshData flipped = makeTriangleMesh(
+    { { 0, 0, 0 }, { 1, 0, 0 }, { 0, 1, 0 }, { 1, 1, 0 } },
+    { 0, 1, 2, 2, 3, 1 });
+  ASSERT_TRUE(builder.build(flipped, out));
+  EXPECT_EQ(out.flippedEdges, 1u);
+  EXPECT_EQ(out.neighbour(0, 1), 1u);
+}
+
+TEST_F(TopologyBuilderTest, RejectsInvalidMesh) {
+  testing::internal::CaptureStderr();
+  EXPECT_FALSE(builder.build(SSerializer::MeshData{}, out));
+  EXPECT_FALSE(builder.build(makeTriangleMesh({ { 0, 0, 0 }, { 1, 0, 0 }, { 0, 1, 0 } }, { 0, 1, 3 }), out));
+  expectStderrContains({ "Mesh has no triangle list", "Index out of bounds at 2: 3" });
+}
+
+TEST(RadixSortTest, SortsPairsStably) {
+  std::mt19937_64 rng(5);
+  std::vector<uint64_t> keys(300000);
+  std::vector<uint32_t> values(keys.size());
+  for (size_t i = 0; i < keys.size(); ++i) {
+    keys[i] = rng() & ((uint64_t{ 1 } << 37) - 1) & ~uint64_t{ 0xFF }; // Many duplicate low digits
+    values[i] = static_cast<uint32_t>(i);
+  }
+  std::vector<std::pair<uint64_t, uint32_t>> expected(keys.size());
+  for (size_t i = 0; i < keys.size(); ++i) expected[i] = { keys[i], values[i] };
+  std::stable_sort(expected.begin(), expected.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+  SSerializer::Utils::radixSortPairs(keys, values, 37);
+  for (size_t i = 0; i < keys.size(); ++i) {
+    ASSERT_EQ(keys[i], expected[i].first);
+    ASSERT_EQ(values[i], expected[i].second);
+  }
+}
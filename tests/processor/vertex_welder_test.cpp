@@ -0,0 +1,132 @@
+#include "../test_helpers.hpp"
+
+#include "starlet-serializer/processor/mesh/vertex_welder.hpp"
+
+#include <random>
+
+class VertexWelderTest : public ::testing::Test {
+protected:
+  // Triangle soup: every triangle gets its own three vertices
+  static SSerializer::MeshData unweld(const SSerializer::MeshData& mesh) {
+    SSerializer::MeshData soup = mesh;
+    soup.vertices.clear();
+    for (unsigned int& i : soup.indices) {
+      soup.vertices.push_back(mesh.vertices[i]);
+      i = static_cast<unsigned int>(soup.vertices.size() - 1);
+    }
+    soup.numVertices = static_cast<unsigned int>(soup.vertices.size());
+    return soup;
+  }
+
+  SSerializer::VertexWelder welder;
+};
+
+TEST_F(VertexWelderTest, TriangleSoupWeldsBackToGrid) {
+  const SSerializer::MeshData grid = makeGridMesh(16);
+  SSerializer::MeshData mesh = unweld(grid);
+  ASSERT_EQ(mesh.numVertices, grid.numTriangles * 3);
+
+  std::vector<unsigned int> remap;
+  ASSERT_TRUE(welder.weld(mesh, {}, &remap));
+  EXPECT_EQ(mesh.numVertices, grid.numVertices);
+  EXPECT_EQ(mesh.vertices.size(), grid.vertices.size());
+  EXPECT_EQ(mesh.numTriangles, grid.numTriangles);
+  ASSERT_EQ(remap.size(), grid.numTriangles * 3u);
+
+  // First occurrence order is kept, so the soup of a grid maps back onto positions exactly
+  for (size_t i = 0; i < mesh.indices.size(); ++i) {
+    const Starlet::Math::Vec3<float>& expected = grid.vertices[grid.indices[i]].pos;
+    const Starlet::Math::Vec3<float>& actual = mesh.vertices[mesh.indices[i]].pos;
+    EXPECT_FLOAT_EQ(actual.x, expected.x);
+    EXPECT_FLOAT_EQ(actual.y, expected.y);
+    EXPECT_EQ(remap[i], mesh.indices[i]);
+  }
+}
+
+TEST_F(VertexWelderTest, MergesWithinEpsilonOnly) {
+  SSerializer::MeshData mesh = makeTriangleMesh(
+    { { 0, 0, 0 }, { 1, 0, 0 }, { 0, 1, 0 }, { 1.0000004f, 0, 0 }, { 0, 1.01f, 0 }, { 1, 1, 0 } },
+    { 0, 1, 2, 3, 5, 4 });
+  ASSERT_TRUE(welder.weld(mesh));
+  EXPECT_EQ(mesh.numVertices, 5u);
+  EXPECT_EQ(mesh.indices[3], mesh.indices[1]);
+  EXPECT_NE(mesh.indices[5], mesh.indices[2]);
+}
+
+TEST_F(VertexWelderTest, MergesTransitivelyInAnyIndexOrder) {
+  // v1 is beyond epsilon from v0 and only reaches it through the higher-index v2
+  SSerializer::MeshData mesh = makeTriangleMesh({ { 0, 0, 0 }, { 0.018f, 0, 0 }, { 0.009f, 0, 0 } }, { 0, 1, 2 });
+  SSerializer::WeldOptions options;
+  options.positionEpsilon = 0.01f;
+  options.removeDegenerate = false;
+  std::vector<unsigned int> remap;
+  ASSERT_TRUE(welder.weld(mesh, options, &remap));
+  EXPECT_EQ(mesh.numVertices, 1u);
+  EXPECT_EQ(remap, (std::vector<unsigned int>{ 0, 0, 0 }));
+  EXPECT_FLOAT_EQ(mesh.vertices[0].pos.x, 0.0f);
+}
+
+TEST_F(VertexWelderTest, KeepsAttributeSeams) {
+  SSerializer::MeshData mesh = makeTriangleMesh({ { 0, 0, 0 }, { 1, 0, 0 }, { 0, 1, 0 }, { 0, 0, 0 } }, { 0, 1, 2, 3, 2, 1 });
+  mesh.hasTexCoords = true;
+  mesh.vertices[3].texCoord = { 1.0f, 0.0f };
+  ASSERT_TRUE(welder.weld(mesh));
+  EXPECT_EQ(mesh.numVertices, 4u);
+
+  SSerializer::WeldOptions options;
+  options.positionOnly = true;
+  ASSERT_TRUE(welder.weld(mesh, options));
+  EXPECT_EQ(mesh.numVertices, 3u);
+}
+
+TEST_F(VertexWelderTest, RemovesCollapsedTriangles) {
+  SSerializer::MeshData mesh = makeTriangleMesh({ { 0, 0, 0 }, { 1, 0, 0 }, { 0, 1, 0 }, { 0, 0, 0 } }, { 0, 1, 2, 0, 3, 1 });
+  ASSERT_TRUE(welder.weld(mesh));
+  EXPECT_EQ(mesh.numTriangles, 1u);
+
+  mesh = makeTriangleMesh({ { 0, 0, 0 }, { 1, 0, 0 }, { 0, 1, 0 }, { 0, 0, 0 } }, { 0, 1, 2, 0, 3, 1 });
+  SSerializer::WeldOptions options;
+  options.removeDegenerate = false;
+  ASSERT_TRUE(welder.weld(mesh, options));
+  EXPECT_EQ(mesh.numTriangles, 2u);
+}
+
+TEST_F(VertexWelderTest, ClusteredPointsMatchBruteForce) {
+  std::mt19937 rng(3);
+  std::uniform_int_distribution<int> site(0, 49);
+  std::uniform_real_distribution<float> jitter(-0.001f, 0.001f);
+  std::vector<std::array<float, 3>> positions;
+  std::vector<unsigned int> indices;
+  for (unsigned int i = 0; i < 3000; ++i) {
+    const int s = site(rng);
+    positions.push_back({ static_cast<float>(s % 7) + jitter(rng), static_cast<float>(s / 7) + jitter(rng), jitter(rng) });
+    indices.push_back(i);
+  }
+  SSerializer::MeshData mesh = makeTriangleMesh(positions, indices);
+
+  SSerializer::WeldOptions options;
+  options.positionEpsilon = 0.01f;
+  options.removeDegenerate = false;
+  ASSERT_TRUE(welder.weld(mesh, options));
+  EXPECT_EQ(mesh.numVertices, 50u);
+}
+
+TEST_F(VertexWelderTest, RejectsInvalidInput) {
+  testing::internal::CaptureStderr();
+  SSerializer::MeshData empty;
+  EXPECT_FALSE(welder.weld(empty));
+  SSerializer::MeshData mesh = makeTriangleMesh({ { 0, 0, 0 }, { 1, 0, 0 }, { 0, 1, 0 } }, { 0, 1, 2 });
+  SSerializer::WeldOptions options;
+  options.positionEpsilon = 0.0f;
+  EXPECT_FALSE(welder.weld(mesh, options));
+  expectStderrContains({ "Mesh has no vertices", "Weld epsilon must be positive" });
+}
+
+TEST_F(MeshParserTest, ParseWeldsDuplicateVertices) {
+  createTestFile("test_data/duplicates.obj", "v 0 0 0\nv 1 0 0\nv 0 1 0\nv 1 0 0\nv 0 1 0\nv 1 1 0\nf 1 2 3\nf 4 6 5\n");
+  SSerializer::MeshParseOptions options;
+  options.weldVertices = true;
+  ASSERT_TRUE(parser.parse("test_data/duplicates.obj", out, options));
+  EXPECT_EQ(out.numVertices, 4u);
+  EXPECT_EQ(out.numTriangles, 2u);
+}
@@ -6,6 +6,7 @@
 #include "starlet-serializer/parser/mesh_parser.hpp"
 #include "starlet-serializer/data/mesh_data.hpp"
 
+#include <array>
 #include <filesystem>
 #include <fstream>
 
@@ -24,6 +25,37 @@ inline void createBinaryFile(const std::string& path, const std::vector<unsigned
   file.write(reinterpret_cast<const char*>(data.data()), data.size());
 }
 
+inline SSerializer::MeshData makeTriangleMesh(const std::vector<std::array<float, 3>>& positions, const std::vector<unsigned int>& indices) {
+  SSerializer::MeshData mesh;
+  for (const std::array<float, 3>& p : positions) {
+    Starlet::Math::Vertex v{};
+    v.pos = { p[0], p[1], p[2] };
+    mesh.vertices.push_back(v);
+  }
+  mesh.indices = indices;
+  mesh.numVertices = static_cast<unsigned int>(mesh.vertices.size());
+  mesh.numIndices = static_cast<unsigned int>(mesh.indices.size());
+  mesh.numTriangles = mesh.numIndices / 3;
+  return mesh;
+}
+
+// Flat (size x size) quad grid in the XY plane spanning [0, 1], two triangles per quad
+inline SSerializer::MeshData makeGridMesh(unsigned int size, float height = 0.0f) {
+  std::vector<std::array<float, 3>> positions;
+  std::vector<unsigned int> indices;
+  const unsigned int side = size + 1;
+  for (unsigned int y = 0; y < side; ++y)
+    for (unsigned int x = 0; x < side; ++x)
+      positions.push_back({ static_cast<float>(x) / size, static_cast<float>(y) / size, height });
+  for (unsigned int y = 0; y < size; ++y) {
+    for (unsigned int x = 0; x < size; ++x) {
+      const unsigned int i0 = y * side + x, i1 = i0 + 1, i2 = i0 + side + 1, i3 = i0 + side;
+      indices.insert(indices.end(), { i0, i1, i2, i0, i2, i3 });
+    }
+  }
+  return makeTriangleMesh(positions, indices);
+}
+
 inline void expectStderrContains(const std::vector<std::string>& expectedSubstrings) {
   std::string output = testing::internal::GetCapturedStderr();
   for (const std::string& substring : expectedSubstrings)
@@ -32,12 +64,12 @@ inline void expectStderrContains(const std::vector<std::string>& expectedSubstri
 
 class ImageParserTest : public ::testing::Test {
 protected:
-  void expectValidParse(const std::string& filename, uint32_t width, uint32_t height) {
+  void expectValidParse(const std::string& filename, uint32_t width, uint32_t height, uint8_t pixelSize = 3) {
     EXPECT_TRUE(parser.parse(filename, out));
     EXPECT_EQ(out.width, width);
     EXPECT_EQ(out.height, height);
-    EXPECT_EQ(out.pixelSize, 3);
-    EXPECT_EQ(out.byteSize, width * height * 3);
+    EXPECT_EQ(out.pixelSize, pixelSize);
+    EXPECT_EQ(out.byteSize, width * height * pixelSize);
     EXPECT_EQ(out.pixels.size(), out.byteSize);
   }
 